@@ -0,0 +1,245 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/*
+ * Priorit d'une requte : les blocs des requtes les plus prioritaires sont lus en premier
+ */
+enum class StreamPriority : uint8_t {
+	Background,
+	Normal,
+	High,
+	Critical
+};
+
+enum class StreamStatus : uint8_t {
+	Completed,
+	Cancelled,
+	Failed
+};
+
+/*
+ * Lecteur utilis : io_uring (Linux, si le noyau le permet) ou pool de threads faisant des lectures positionnes
+ */
+enum class StreamBackend : uint8_t {
+	Auto,
+	IoUring,
+	ThreadPool
+};
+
+const char* streamBackendName(StreamBackend backend);
+
+/*
+ * Rsultat d'une requte, pass au callback
+ */
+struct StreamResult {
+	uint64_t id{0};
+	StreamStatus status{StreamStatus::Completed};
+	// Octets lus (moins que demand si la fin du fichier est atteinte)
+	uint64_t bytesRead{0};
+	// Contenu lu quand la requte n'avait pas de destination (peut tre dplac par le callback)
+	std::vector<char> data;
+	std::string error;
+};
+
+/*
+ * Appel sur le thread d'entre/sortie, une fois la requte termine : plus aucune lecture n'crit alors dans
+ * sa destination. Doit rester court (il retarde les lectures suivantes) et ne pas appeler waitIdle().
+ */
+using StreamCallback = std::function<void(StreamResult& result)>;
+
+struct StreamRequest {
+	std::string path;
+	uint64_t offset{0};
+	// Octets  lire, 0 : jusqu' la fin du fichier
+	uint64_t size{0};
+	// Mmoire recevant directement les octets lus (ex: buffer de staging mapp), au moins size octets.
+	// nullptr : tampon allou par le streamer (StreamResult::data), size peut alors valoir 0.
+	void* destination{nullptr};
+	StreamPriority priority{StreamPriority::Normal};
+	StreamCallback callback;
+};
+
+struct AssetStreamerSettings {
+	StreamBackend backend{StreamBackend::Auto};
+	// Lectures en vol au plus : profondeur de la file io_uring, ou nombre de threads du pool
+	uint32_t queueDepth{32};
+	// Taille des lectures : une requte plus prioritaire passe devant entre deux blocs
+	uint32_t blockSize{1u << 20};
+};
+
+/*
+ * Compteurs depuis init()
+ */
+struct AssetStreamerStats {
+	uint64_t bytesRead{0};
+	uint64_t readsIssued{0};
+	uint64_t requestsCompleted{0};
+	uint64_t requestsCancelled{0};
+	uint64_t requestsFailed{0};
+	uint32_t peakReadsInFlight{0};
+};
+
+/*
+ * Service de lecture asynchrone des fichiers de ressources (scnes, textures, maillages, shaders).
+ * request() ne fait ni appel systme ni attente : la requte est range dans une file trie par priorit
+ * puis par ordre d'arrive, et un thread d'entre/sortie ddi la dcoupe en blocs qu'il garde en vol
+ * (queueDepth lectures au plus) pour occuper toute la bande passante du disque.
+ * Avec io_uring, les lectures sont soumises dans l'anneau partag avec le noyau (appels systme directs,
+ * sans liburing) ; sinon, ou si le noyau le refuse, un pool de threads fait des lectures positionnes.
+ * Les octets sont lus directement dans la destination de la requte : avec un buffer de staging mapp,
+ * aucune copie intermdiaire n'est faite avant la copie GPU.
+ * Une requte annule n'met plus de blocs ; son callback est appel quand ses lectures en vol sont termines.
+ */
+class CAssetStreamer {
+public:
+	static constexpr uint64_t INVALID_REQUEST = 0;
+
+	CAssetStreamer();
+	~CAssetStreamer();
+
+	CAssetStreamer(const CAssetStreamer&) = delete;
+	CAssetStreamer& operator=(const CAssetStreamer&) = delete;
+
+	/*
+	 * Dmarre le thread d'entre/sortie (et le pool de threads si io_uring n'est pas disponible)
+	 */
+	void init(const AssetStreamerSettings& settings = AssetStreamerSettings{});
+
+	/*
+	 * Annule les requtes restantes (callbacks appels avec Cancelled) et arrte les threads
+	 */
+	void shutdown();
+
+	[[nodiscard]]
+	bool isActive() const { return m_ioThread.joinable(); }
+
+	/*
+	 * Lecteur effectivement utilis (jamais Auto une fois actif)
+	 */
+	[[nodiscard]]
+	StreamBackend backend() const { return m_backend; }
+
+	/*
+	 * Ajoute une requte ; retourne son identifiant. Lve une exception si le streamer est arrt
+	 * ou si une destination est fournie sans taille.
+	 */
+	uint64_t request(StreamRequest request);
+
+	/*
+	 * Retourne false si la requte est inconnue, dj termine ou dj annule
+	 */
+	bool cancel(uint64_t id);
+
+	/*
+	 * Attend la fin de toutes les requtes (callbacks compris)
+	 */
+	void waitIdle();
+
+	[[nodiscard]]
+	AssetStreamerStats stats() const;
+
+private:
+	struct IoUring;
+
+	struct Request {
+		uint64_t id{0};
+		StreamRequest desc;
+		// Descripteur de fichier (POSIX) ou HANDLE (Windows), -1 tant que le fichier n'est pas ouvert
+		intptr_t file{-1};
+		// Prochain octet  lire et fin de la lecture (positions dans le fichier, connues  l'ouverture)
+		uint64_t next{0};
+		uint64_t end{0};
+		// Destination du prochain octet
+		char* target{nullptr};
+		uint32_t readsInFlight{0};
+		// Dans la file d'attente (m_queue), en cours d'ouverture par le thread d'entre/sortie
+		bool queued{false};
+		bool opening{false};
+		bool cancelled{false};
+		bool finished{false};
+		StreamResult result;
+	};
+
+	/*
+	 * Lecture d'un bloc, rutilise d'une requte  l'autre (queueDepth lectures)
+	 */
+	struct Read {
+		Request* request{nullptr};
+		char* target{nullptr};
+		uint64_t offset{0};
+		uint32_t size{0};
+		// Octets lus, ou code d'erreur ngatif
+		int64_t result{0};
+	};
+
+	// Cl de la file d'attente : priorit dcroissante puis ordre d'arrive (identifiant)
+	using QueueKey = std::pair<int, uint64_t>;
+
+	void ioLoop();
+	void workerLoop();
+
+	/*
+	 * Ouvre le fichier de la requte la plus prioritaire si besoin puis met son bloc suivant.
+	 * Retourne false si aucune lecture n'a pu tre mise.
+	 */
+	bool issueNext(std::unique_lock<std::mutex>& lock);
+	void submitRead(Read& read);
+	void completeRead(Read& read);
+
+	void enqueue(Request& request);
+	void dequeue(Request& request);
+	void cancelRequest(Request& request);
+
+	/*
+	 * Range la requte parmi les requtes termines si plus rien ne doit tre lu pour elle
+	 */
+	void tryFinish(Request& request);
+
+	/*
+	 * Appelle les callbacks des requtes termines (verrou relch pendant les appels)
+	 */
+	void deliverFinished(std::unique_lock<std::mutex>& lock);
+
+	bool initIoUring();
+	void destroyIoUring();
+
+	/*
+	 * Soumet les lectures prpares dans l'anneau puis attend (sans verrou) au moins une fin de lecture,
+	 * et traite les fins disponibles
+	 */
+	void waitIoUring(std::unique_lock<std::mutex>& lock);
+
+	AssetStreamerSettings m_settings;
+	StreamBackend m_backend{StreamBackend::Auto};
+	std::unique_ptr<IoUring> m_ring;
+	std::thread m_ioThread;
+	std::vector<std::thread> m_workers;
+	mutable std::mutex m_mutex;
+	// Rveille le thread d'entre/sortie : nouvelle requte, annulation, fin de lecture du pool, arrt
+	std::condition_variable m_condition;
+	std::condition_variable m_workerCondition;
+	std::condition_variable m_idleCondition;
+	std::map<uint64_t, std::unique_ptr<Request>> m_requests;
+	std::map<QueueKey, Request*> m_queue;
+	std::vector<Read> m_reads;
+	std::vector<Read*> m_freeReads;
+	// Pool de threads : lectures  faire et lectures faites
+	std::deque<Read*> m_pendingReads;
+	std::vector<Read*> m_doneReads;
+	std::vector<Request*> m_finished;
+	uint32_t m_readsInFlight{0};
+	uint64_t m_nextId{1};
+	bool m_stop{false};
+	bool m_stopWorkers{false};
+	AssetStreamerStats m_stats;
+};
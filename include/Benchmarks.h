@@ -0,0 +1,52 @@
+#pragma once
+#include <string>
+
+struct ApplicationSettings;
+
+/*
+ * Points d'entre des benchmarks (lancs depuis main via la ligne de commande)
+ */
+
+/*
+ * Microbenchmark du culling : objets culls par seconde de 10K  10M objets, pour chaque kernel
+ */
+int runCullingBenchmark();
+
+/*
+ * Dbit de la simulation de particules sur le GPU : temps de calcul et particules par seconde de 256K  16M
+ * particules, pour chaque taille de groupe de travail. base fournit les options communes (headless, device...).
+ */
+int runParticleBenchmark(const ApplicationSettings& base);
+
+/*
+ * Niveaux de dtail : triangles dessins et temps par frame avec et sans slection, de 256  4096 objets
+ */
+int runLodBenchmark(const ApplicationSettings& base);
+
+/*
+ * clairage par clusters : temps GPU de la rpartition et de la passe claire, lumires par cluster,
+ * de 64  16384 lumires, compar  l'valuation de toutes les lumires par chaque pixel
+ */
+int runLightingBenchmark(const ApplicationSettings& base);
+
+/*
+ * Multi-vues : temps par frame et temps GPU des vues en une passe (VK_KHR_multiview) et en N passes, de 2  6 vues
+ */
+int runMultiviewBenchmark(const ApplicationSettings& base);
+
+/*
+ * Post-traitement : temps GPU de chaque tape avec et sans fusion des effets, pour plusieurs combinaisons d'effets
+ */
+int runPostProcessBenchmark(const ApplicationSettings& base);
+
+/*
+ * Profondeur : invocations du fragment shader par pixel et temps par frame de la scne claire  niveaux de dtail,
+ * sans profondeur, avec profondeur inverse et avec pr-passe, pour 1024 et 4096 objets
+ */
+int runDepthBenchmark(const ApplicationSettings& base);
+
+/*
+ * Streaming : dbit de lecture du fichier path (Mo/s) et latence d'une requte prioritaire lance pendant la lecture,
+ * pour chaque lecteur (io_uring, pool de threads) et plusieurs profondeurs de file. Sans Vulkan.
+ */
+int runStreamingBenchmark(const std::string& path);
@@ -0,0 +1,180 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <VulkanUtils.h>
+#include <GpuTimer.h>
+#include <Math.h>
+#include <cstdint>
+#include <vector>
+
+/*
+ * Rglages de l'clairage par clusters
+ */
+struct LightingSettings {
+	// Lumires ponctuelles animes, rparties dans le volume pass  init()
+	uint32_t lightCount{1024};
+	// Porte des lumires : au-del, leur contribution est nulle
+	float lightRadius{3.0f};
+	// Grille de clusters : tuiles de l'cran (gridX * gridY) et tranches de profondeur (gridZ)
+	uint32_t gridX{16};
+	uint32_t gridY{9};
+	uint32_t gridZ{24};
+	// Profondeurs (espace vue) dlimitant les tranches, rparties de faon logarithmique ;
+	// la premire tranche descend jusqu' la camra, la dernire s'tend  l'infini
+	float nearDepth{0.5f};
+	float farDepth{200.0f};
+	// Lumires gardes au plus par cluster : borne le cot d'un pixel quel que soit le nombre de lumires
+	uint32_t maxLightsPerCluster{128};
+	// Taille de la liste d'indices partage par les clusters, en lumires par cluster en moyenne
+	uint32_t averageLightsPerCluster{64};
+	// Chaque pixel value toutes les lumires, sans passe de rpartition (comparaison)
+	bool bruteForce{false};
+};
+
+/*
+ * clairage forward par clusters : des milliers de lumires dynamiques au cot born par pixel.
+ * Le frustum est dcoup en une grille de clusters (tuiles de l'cran x tranches de profondeur logarithmiques).
+ * Chaque frame, un compute shader teste chaque lumire contre la bote englobante de chaque cluster (espace vue)
+ * et crit, pour chaque cluster, la plage de ses lumires dans une liste d'indices compacte : une seule allocation
+ * atomique par cluster dans la liste partage. Le fragment shader retrouve son cluster  partir de sa position
+ *  l'cran et de sa profondeur, et n'value que ses lumires.
+ * Les ressources sont dupliques par frame en vol ; les lumires sont crites par le CPU (update()) dans un buffer
+ * de staging puis copies sur le device avant la rpartition.
+ */
+class CClusteredLighting {
+public:
+	~CClusteredLighting() { cleanup(); }
+
+	/*
+	 * Cre les buffers, les descriptor sets de chaque frame en vol et la pipeline de rpartition.
+	 * boundsMin, boundsMax : volume (espace monde) o les lumires sont places
+	 */
+	void init(const DeviceContext& context, uint32_t queueFamily, uint32_t frameCount, const LightingSettings& settings,
+	          const Vec3& boundsMin, const Vec3& boundsMax);
+
+	/*
+	 * Le device doit tre inactif
+	 */
+	void cleanup();
+
+	[[nodiscard]]
+	bool isActive() const { return m_context.device != VK_NULL_HANDLE; }
+
+	/*
+	 * Layout du set lu par le fragment shader clair (set 0 de sa pipeline) et set de chaque frame en vol
+	 */
+	[[nodiscard]]
+	VkDescriptorSetLayout descriptorSetLayout() const { return m_descriptorSetLayout; }
+	[[nodiscard]]
+	VkDescriptorSet descriptorSet(uint32_t frame) const { return m_frames[frame].descriptorSet; }
+
+	[[nodiscard]]
+	bool bruteForce() const { return m_settings.bruteForce; }
+
+	/*
+	 *  appeler aprs l'attente de la fence de la frame : temps GPU et occupation des clusters
+	 */
+	void onFrameCompleted(uint32_t frame);
+
+	/*
+	 * Anime les lumires (time en secondes) et crit les paramtres de la frame pour la camra du dessin.
+	 * projection : perspective Vulkan (voir perspective()), view : matrice monde -> vue
+	 */
+	void update(uint32_t frame, double time, const Mat4& view, const Mat4& projection, const Vec3& eye);
+
+	/*
+	 * Copie des lumires et rpartition dans les clusters (hors render pass, avant le dessin clair)
+	 */
+	void recordCulling(VkCommandBuffer commandBuffer, uint32_t frame);
+
+	/*
+	 * Fin de la mesure de l'clairage (aprs la render pass).  n'enregistrer qu'une fois par frame.
+	 */
+	void recordShadingEnd(VkCommandBuffer commandBuffer, uint32_t frame);
+
+	/*
+	 * Temps GPU moyens de la rpartition et de la passe claire (copie et rpartition exclues)
+	 */
+	[[nodiscard]]
+	double averageCullingMs() const { return m_measuredFrames > 0 ? m_totalCullingMs / static_cast<double>(m_measuredFrames) : 0.0; }
+	[[nodiscard]]
+	double averageShadingMs() const { return m_measuredFrames > 0 ? m_totalShadingMs / static_cast<double>(m_measuredFrames) : 0.0; }
+
+	/*
+	 * Lumires par cluster : moyenne sur les frames mesures et maximum observ (avant la limite par cluster).
+	 * Clusters ayant dpass maxLightsPerCluster ou la liste d'indices depuis init().
+	 */
+	[[nodiscard]]
+	double averageLightsPerCluster() const;
+	[[nodiscard]]
+	uint32_t maxLightsPerCluster() const { return m_maxLightsPerCluster; }
+	[[nodiscard]]
+	uint64_t overflowedClusters() const { return m_overflowedClusters; }
+
+	[[nodiscard]]
+	uint32_t clusterCount() const { return m_settings.gridX * m_settings.gridY * m_settings.gridZ; }
+
+private:
+	struct Light {
+		float positionRadius[4];
+		float color[4];
+	};
+
+	/*
+	 * Compteurs crits par le compute shader (remis  zro avant chaque rpartition)
+	 */
+	struct ClusterStatistics {
+		uint32_t allocatedIndices;
+		uint32_t maxLightsPerCluster;
+		uint32_t overflowedClusters;
+		uint32_t padding;
+	};
+
+	struct FrameResources {
+		VkBuffer parametersBuffer{VK_NULL_HANDLE};
+		VkDeviceMemory parametersMemory{VK_NULL_HANDLE};
+		void* parameters{nullptr};
+		VkBuffer stagingBuffer{VK_NULL_HANDLE};
+		VkDeviceMemory stagingMemory{VK_NULL_HANDLE};
+		Light* staging{nullptr};
+		VkBuffer lightsBuffer{VK_NULL_HANDLE};
+		VkDeviceMemory lightsMemory{VK_NULL_HANDLE};
+		VkBuffer clustersBuffer{VK_NULL_HANDLE};
+		VkDeviceMemory clustersMemory{VK_NULL_HANDLE};
+		VkBuffer indicesBuffer{VK_NULL_HANDLE};
+		VkDeviceMemory indicesMemory{VK_NULL_HANDLE};
+		VkBuffer statisticsBuffer{VK_NULL_HANDLE};
+		VkDeviceMemory statisticsMemory{VK_NULL_HANDLE};
+		VkBuffer readbackBuffer{VK_NULL_HANDLE};
+		VkDeviceMemory readbackMemory{VK_NULL_HANDLE};
+		const ClusterStatistics* readback{nullptr};
+		VkDescriptorSet descriptorSet{VK_NULL_HANDLE};
+		// Frame mise  jour (donc soumise) depuis la dernire lecture de ses rsultats
+		bool pending{false};
+	};
+
+	void createLights(const Vec3& boundsMin, const Vec3& boundsMax);
+	void createFrameResources(FrameResources& frame);
+	void createDescriptors();
+	void createComputePipeline();
+
+	DeviceContext m_context;
+	LightingSettings m_settings;
+	uint32_t m_indexCapacity{0};
+	// Centre de l'orbite de chaque lumire, et orbite : rayon, vitesse angulaire, phase, amplitude verticale
+	std::vector<Vec3> m_lightCenters;
+	std::vector<Vec4> m_lightOrbits;
+	std::vector<Vec3> m_lightColors;
+	std::vector<FrameResources> m_frames;
+	VkDescriptorSetLayout m_descriptorSetLayout{VK_NULL_HANDLE};
+	VkDescriptorPool m_descriptorPool{VK_NULL_HANDLE};
+	VkPipelineLayout m_pipelineLayout{VK_NULL_HANDLE};
+	VkPipeline m_cullingPipeline{VK_NULL_HANDLE};
+	CGpuTimer m_timer;
+	double m_totalCullingMs{0.0};
+	double m_totalShadingMs{0.0};
+	uint64_t m_measuredFrames{0};
+	uint64_t m_totalAllocatedIndices{0};
+	uint64_t m_culledFrames{0};
+	uint32_t m_maxLightsPerCluster{0};
+	uint64_t m_overflowedClusters{0};
+};
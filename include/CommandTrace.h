@@ -0,0 +1,268 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <PipelineVariants.h>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
+
+/*
+ * Trace binaire du flux de commandes : un en-tte puis une suite d'enregistrements
+ * { TraceOp (1 octet), taille des donnes (4 octets), donnes }.
+ * Les objets sont identifis par la valeur de leur handle  la capture ; un handle rutilis aprs destruction
+ * dsigne l'objet cr par le dernier enregistrement de cration qui le porte.
+ * Les donnes sont crites dans l'ordre des octets de la machine de capture.
+ */
+enum class TraceOp : uint8_t {
+	// Cration d'objets
+	ShaderModule = 1,
+	PipelineState,
+	Pipeline,
+	Buffer,
+	// Contenu d'un buffer (criture CPU dans sa mmoire)
+	BufferData,
+	// Enregistrement d'un command buffer
+	BeginCommandBuffer,
+	BeginRenderPass,
+	SetViewport,
+	SetScissor,
+	BindPipeline,
+	Draw,
+	EndRenderPass,
+	EndCommandBuffer,
+	// Soumission et prsentation (horodates)
+	Submit,
+	Present
+};
+
+constexpr uint32_t TRACE_MAGIC = 0x52544B56; // "VKTR"
+constexpr uint32_t TRACE_VERSION = 2;
+
+struct TraceHeader {
+	uint32_t magic{TRACE_MAGIC};
+	uint32_t version{TRACE_VERSION};
+	// Format et dimensions de la cible de rendu  la capture
+	uint32_t format{0};
+	uint32_t width{0};
+	uint32_t height{0};
+};
+
+/*
+ * Donnes des enregistrements (taille fixe ; certaines sont suivies de donnes de taille variable)
+ */
+struct TraceShaderModule {
+	uint64_t id;
+	uint32_t stage;
+	// Suivi du code SPIR-V
+	uint32_t codeSize;
+};
+
+/*
+ * tat partag par les pipelines cres ensuite (voir GraphicsPipelineState)
+ */
+struct TracePipelineState {
+	uint64_t vertexShader;
+	uint64_t fragmentShader;
+	uint32_t topology;
+	uint32_t polygonMode;
+	uint32_t cullMode;
+	uint32_t frontFace;
+	uint32_t samples;
+	uint32_t colorWriteMask;
+	uint32_t blendEnable;
+	float lineWidth;
+};
+
+struct TracePipeline {
+	uint64_t id;
+	// 0 : constantes par dfaut des shaders
+	uint32_t specialized;
+	uint32_t constants[PipelineVariantKey::MAX_CONSTANTS];
+};
+
+struct TraceBuffer {
+	uint64_t id;
+	uint64_t size;
+	uint32_t usage;
+	uint32_t padding;
+};
+
+struct TraceBufferData {
+	uint64_t id;
+	uint64_t offset;
+	// Suivi de size octets
+	uint64_t size;
+};
+
+struct TraceRenderPass {
+	uint32_t width;
+	uint32_t height;
+	float clearColor[4];
+};
+
+struct TraceDraw {
+	uint32_t vertexCount;
+	uint32_t instanceCount;
+	uint32_t firstVertex;
+	uint32_t firstInstance;
+};
+
+/*
+ * Un enregistrement par VkSubmitInfo d'un vkQueueSubmit
+ */
+struct TraceSubmit {
+	// Nanosecondes depuis le dbut de la capture
+	uint64_t timeNs;
+	// Suivi des identifiants des command buffers, puis de ceux des smaphores attendus et signals
+	uint32_t commandBufferCount;
+	uint32_t waitSemaphoreCount;
+	uint32_t signalSemaphoreCount;
+	// Dernier VkSubmitInfo de l'appel (celui-ci porte la fence de la frame)
+	uint32_t lastInBatch;
+};
+
+struct TracePresent {
+	uint64_t timeNs;
+};
+
+/*
+ * Identifiant d'un objet Vulkan dans la trace (handles dispatchables ou non)
+ */
+template<typename Handle>
+uint64_t traceId(Handle handle) {
+	if constexpr (std::is_pointer_v<Handle>) { return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(handle)); }
+	else { return static_cast<uint64_t>(handle); }
+}
+
+/*
+ * criture de la trace autour des appels Vulkan de l'application (cration des objets, enregistrement des
+ * command buffers, soumissions et prsentations). Chaque mthode est sans effet si aucune trace n'est ouverte.
+ * Un seul thread  la fois doit l'utiliser (initialisation puis thread de rendu).
+ */
+class CCommandTraceWriter {
+public:
+	~CCommandTraceWriter() { close(); }
+
+	/*
+	 * Ouvre le fichier et crit l'en-tte ; les horodatages partent de cet appel
+	 */
+	void open(const std::string& path, VkFormat format, VkExtent2D extent);
+
+	void close();
+
+	[[nodiscard]]
+	bool isActive() const { return m_file.is_open(); }
+
+	[[nodiscard]]
+	uint64_t bytesWritten() const { return m_bytesWritten; }
+
+	void shaderModule(VkShaderModule module, VkShaderStageFlagBits stage, const std::vector<char>& code);
+
+	/*
+	 * Nouvel tat de pipeline : les pipelines traces auparavant sont oublies (handles rutilisables)
+	 */
+	void pipelineState(const GraphicsPipelineState& state);
+
+	void buffer(VkBuffer buffer, VkDeviceSize size, VkBufferUsageFlags usage);
+	void bufferData(VkBuffer buffer, VkDeviceSize offset, const void* data, VkDeviceSize size);
+
+	void beginCommandBuffer(VkCommandBuffer commandBuffer);
+	void beginRenderPass(VkExtent2D extent, const VkClearValue& clearValue);
+	void setViewport(const VkViewport& viewport);
+	void setScissor(const VkRect2D& scissor);
+
+	/*
+	 * key : variante de la pipeline (nullptr pour la pipeline gnrique). La pipeline est trace  sa premire
+	 * utilisation : les variantes compiles en arrire-plan n'ont pas  tre traces depuis les workers.
+	 */
+	void bindPipeline(VkPipeline pipeline, const PipelineVariantKey* key);
+
+	void draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance);
+	void endRenderPass();
+	void endCommandBuffer();
+	void submit(const VkSubmitInfo* submits, uint32_t submitCount);
+	void present();
+
+private:
+	template<typename T>
+	void write(TraceOp op, const T& payload, const void* extra = nullptr, size_t extraSize = 0) {
+		static_assert(std::is_trivially_copyable_v<T>);
+		writeRecord(op, &payload, sizeof(T), extra, extraSize);
+	}
+
+	void writeRecord(TraceOp op, const void* data, size_t size, const void* extra, size_t extraSize);
+
+	[[nodiscard]]
+	uint64_t elapsedNs() const;
+
+	std::ofstream m_file;
+	std::chrono::steady_clock::time_point m_start;
+	std::unordered_set<uint64_t> m_knownPipelines;
+	uint64_t m_bytesWritten{0};
+};
+
+/*
+ * Enregistrement lu dans une trace : data pointe dans le contenu charg par le lecteur
+ */
+struct TraceRecord {
+	TraceOp op{};
+	const char* data{nullptr};
+	uint32_t size{0};
+
+	/*
+	 * Donnes de taille fixe de l'enregistrement (lve une exception si l'enregistrement est trop court)
+	 */
+	template<typename T>
+	[[nodiscard]]
+	T payload() const {
+		static_assert(std::is_trivially_copyable_v<T>);
+		if (size < sizeof(T)) { throw std::runtime_error("Failed to read a truncated trace record"); }
+		T value;
+		std::memcpy(&value, data, sizeof(T));
+		return value;
+	}
+
+	/*
+	 * Donnes de taille variable qui suivent les donnes de taille fixe T
+	 */
+	template<typename T>
+	[[nodiscard]]
+	const char* trailing(size_t expectedSize) const {
+		if (size < sizeof(T) + expectedSize) { throw std::runtime_error("Failed to read a truncated trace record"); }
+		return data + sizeof(T);
+	}
+};
+
+/*
+ * Lecture squentielle d'une trace entirement charge en mmoire
+ */
+class CCommandTraceReader {
+public:
+	/*
+	 * Charge le fichier et vrifie son en-tte
+	 */
+	void open(const std::string& path);
+
+	[[nodiscard]]
+	const TraceHeader& header() const { return m_header; }
+
+	/*
+	 * Enregistrement suivant, false en fin de trace
+	 */
+	bool next(TraceRecord& record);
+
+	/*
+	 * Revient au premier enregistrement
+	 */
+	void rewind() { m_position = sizeof(TraceHeader); }
+
+private:
+	std::vector<char> m_content;
+	TraceHeader m_header;
+	size_t m_position{0};
+};
@@ -0,0 +1,92 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <VulkanUtils.h>
+
+/*
+ * Rglages du test de profondeur de la render pass principale
+ */
+struct DepthSettings {
+	// Attachement de profondeur (sinon : sans test, l'ordre de dessin seul dcide des pixels visibles)
+	bool enabled{true};
+	// Profondeur inverse : 1 au plan proche, 0 au plan lointain, efface  0 et test GREATER (voir perspectiveReverseZ())
+	bool reverseZ{true};
+	// Passe de profondeur seule avant la passe principale, qui teste alors EQUAL sans crire :
+	// chaque pixel n'est ombr qu'une fois quel que soit l'ordre de dessin
+	bool prePass{false};
+	// Profondeur demande par une option : signaler qu'elle est dsactive (elle l'est sans bruit sinon)
+	bool requested{false};
+
+	/*
+	 * Valeur d'effacement de l'attachement
+	 */
+	[[nodiscard]]
+	float clearDepth() const { return reverseZ ? 0.0f : 1.0f; }
+};
+
+/*
+ * Rle d'une pipeline vis--vis de la profondeur
+ */
+enum class DepthPass {
+	// Sans test ni criture (particules transparentes, triangle de dmonstration)
+	None,
+	// Pr-passe : test et criture, sans fragment shader
+	PrePass,
+	// Gomtrie opaque de la passe principale : test et criture, ou test EQUAL seul aprs la pr-passe
+	Main
+};
+
+/*
+ * tat de profondeur d'une pipeline de la render pass principale (test dsactiv si !settings.enabled)
+ */
+VkPipelineDepthStencilStateCreateInfo depthStencilState(const DepthSettings& settings, DepthPass pass);
+
+/*
+ * Attachement de profondeur partag par les framebuffers de la render pass principale (les render passes d'une mme
+ * queue s'excutent l'une aprs l'autre, la dpendance externe de la render pass ordonne les critures).
+ * Son contenu n'est jamais relu aprs la render pass : l'image est transiente et, si le device le permet
+ * (GPU  tuiles), en mmoire alloue paresseusement qui peut ne jamais tre rserve.
+ *  recrer avec la swapchain.
+ */
+class CDepthBuffer {
+public:
+	~CDepthBuffer() { cleanup(); }
+
+	/*
+	 * Premier format utilisable en attachement de profondeur, flottant de prfrence (D32, D32S8, D24, D24S8, D16).
+	 * VK_FORMAT_UNDEFINED si aucun.
+	 */
+	static VkFormat findFormat(VkPhysicalDevice physicalDevice);
+
+	/*
+	 * extent : au moins la taille de chaque framebuffer qui l'utilise
+	 */
+	void init(const DeviceContext& context, VkFormat format, VkExtent2D extent);
+
+	/*
+	 * Le device doit tre inactif
+	 */
+	void cleanup();
+
+	[[nodiscard]]
+	bool isActive() const { return m_context.device != VK_NULL_HANDLE; }
+
+	[[nodiscard]]
+	VkImageView view() const { return m_view; }
+
+	[[nodiscard]]
+	VkExtent2D extent() const { return m_extent; }
+
+	/*
+	 * L'image est-elle en mmoire alloue paresseusement ?
+	 */
+	[[nodiscard]]
+	bool lazilyAllocated() const { return m_lazilyAllocated; }
+
+private:
+	DeviceContext m_context;
+	VkExtent2D m_extent{};
+	VkImage m_image{VK_NULL_HANDLE};
+	VkDeviceMemory m_memory{VK_NULL_HANDLE};
+	VkImageView m_view{VK_NULL_HANDLE};
+	bool m_lazilyAllocated{false};
+};
@@ -0,0 +1,150 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <VulkanUtils.h>
+#include <GpuTimer.h>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/*
+ * Rglages de la rsolution dynamique
+ */
+struct DynamicResolutionSettings {
+	// Temps GPU vis par frame
+	float targetFrameMs{16.6f};
+	// Bornes de l'chelle applique  chaque dimension de la swapchain
+	float minScale{0.5f};
+	float maxScale{1.0f};
+	// Bande morte autour de la cible (0.1 = 10%) : aucune correction  l'intrieur
+	float hysteresis{0.1f};
+	// Pas d'chelle des cibles alloues : la cible n'est ralloue qu'en changeant de palier
+	float allocationStep{0.25f};
+};
+
+/*
+ * Contrleur de l'chelle de rendu  partir du temps GPU mesur.
+ * Le temps est liss (moyenne exponentielle) ; hors de la bande morte l'chelle est corrige en supposant un cot
+ * proportionnel au nombre de pixels, plus prudemment  la hausse qu' la baisse, puis gele quelques frames
+ * le temps que la mesure reflte la nouvelle taille.
+ */
+class CResolutionController {
+public:
+	explicit CResolutionController(const DynamicResolutionSettings& settings = DynamicResolutionSettings{});
+
+	/*
+	 * Intgre une mesure et retourne l'chelle  utiliser pour la prochaine frame
+	 */
+	float update(float gpuFrameMs);
+
+	[[nodiscard]]
+	float scale() const { return m_scale; }
+
+	[[nodiscard]]
+	float smoothedFrameMs() const { return m_smoothedMs; }
+
+	/*
+	 * chelle de la cible  allouer pour rendre  l'chelle scale, arrondie au palier suprieur.
+	 * Une cible plus grande dj alloue (currentAllocation) est conserve tant qu'elle n'a pas deux paliers de trop.
+	 */
+	[[nodiscard]]
+	float allocationScale(float scale, float currentAllocation) const;
+
+private:
+	// Nombre de frames sans correction aprs un changement d'chelle
+	static constexpr uint32_t COOLDOWN_FRAMES = 8;
+	// Hausse maximale de l'chelle par correction
+	static constexpr float MAX_INCREASE = 0.05f;
+	static constexpr float SMOOTHING = 0.15f;
+
+	DynamicResolutionSettings m_settings;
+	float m_scale;
+	float m_smoothedMs{0.0f};
+	bool m_hasSample{false};
+	uint32_t m_cooldown{0};
+};
+
+/*
+ * Rendu  rsolution dynamique : la scne est rendue dans une cible hors cran dont la zone utilise suit l'chelle
+ * du contrleur, puis agrandie dans l'image de la swapchain par un blit filtr.
+ * Chaque frame en vol a sa propre cible et son propre command buffer, renregistr  chaque frame ;
+ * une cible n'est ralloue que lorsque sa frame est termine (aprs sa fence) et qu'elle change de palier.
+ */
+class CDynamicResolution {
+public:
+	/*
+	 * Enregistre les commandes de dessin de la scne (dans la render pass, viewport et scissor dj dfinis)
+	 */
+	using RecordFunction = std::function<void(VkCommandBuffer commandBuffer)>;
+
+	~CDynamicResolution() { cleanup(); }
+
+	/*
+	 * Le format de la swapchain peut-il tre source et destination d'un blit filtr ?
+	 */
+	static bool isSupported(VkPhysicalDevice physicalDevice, VkFormat format);
+
+	/*
+	 * Render pass hors cran compatible avec renderPass (mme format) : les pipelines de l'application
+	 * peuvent y tre utiliss tels quels. Les images de la swapchain doivent avoir l'usage TRANSFER_DST.
+	 */
+	void init(const DeviceContext& context, uint32_t queueFamily, VkFormat format, VkExtent2D swapChainExtent,
+	          uint32_t frameCount, const DynamicResolutionSettings& settings);
+
+	/*
+	 * Le device doit tre inactif
+	 */
+	void cleanup();
+
+	[[nodiscard]]
+	bool isActive() const { return m_context.device != VK_NULL_HANDLE; }
+
+	/*
+	 *  appeler aprs l'attente de la fence frameInFlight : lit le temps GPU de la frame et met  jour l'chelle
+	 */
+	void onFrameCompleted(uint32_t frameInFlight);
+
+	/*
+	 * Enregistre la frame : rendu de la scne  l'chelle courante puis blit vers swapChainImage
+	 * (laisse en PRESENT_SRC_KHR). recordPrePass, s'il est fourni, est enregistr avant la render pass
+	 * (calculs dont dpend la scne). Retourne le command buffer  soumettre.
+	 */
+	VkCommandBuffer record(uint32_t frameInFlight, VkImage swapChainImage, const RecordFunction& recordScene,
+	                       const RecordFunction& recordPrePass = nullptr);
+
+	[[nodiscard]]
+	float scale() const { return m_controller.scale(); }
+
+	[[nodiscard]]
+	VkExtent2D renderExtent() const { return scaledExtent(m_controller.scale()); }
+
+	[[nodiscard]]
+	uint64_t reallocations() const { return m_reallocations; }
+
+private:
+	struct RenderTarget {
+		VkImage image{VK_NULL_HANDLE};
+		VkDeviceMemory memory{VK_NULL_HANDLE};
+		VkImageView view{VK_NULL_HANDLE};
+		VkFramebuffer framebuffer{VK_NULL_HANDLE};
+		float allocationScale{0.0f};
+		VkExtent2D extent{0, 0};
+	};
+
+	void createRenderPass();
+	void createTarget(RenderTarget& target, float allocationScale);
+	void destroyTarget(RenderTarget& target);
+
+	[[nodiscard]]
+	VkExtent2D scaledExtent(float scale) const;
+
+	DeviceContext m_context;
+	VkFormat m_format{VK_FORMAT_UNDEFINED};
+	VkExtent2D m_swapChainExtent{0, 0};
+	VkRenderPass m_renderPass{VK_NULL_HANDLE};
+	VkCommandPool m_commandPool{VK_NULL_HANDLE};
+	std::vector<VkCommandBuffer> m_commandBuffers;
+	std::vector<RenderTarget> m_targets;
+	CGpuTimer m_timer;
+	CResolutionController m_controller;
+	uint64_t m_reallocations{0};
+};
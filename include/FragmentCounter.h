@@ -0,0 +1,54 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <VulkanUtils.h>
+#include <cstdint>
+#include <vector>
+
+/*
+ * Invocations du fragment shader par frame, mesures par une requte de statistiques de pipeline
+ * (fonctionnalit pipelineStatisticsQuery du device). Rapportes au nombre de pixels, elles donnent le surcot
+ * d'ombrage (overdraw). Une requte par frame en vol, lue sans attente aprs le signal de sa fence.
+ */
+class CFragmentCounter {
+public:
+	~CFragmentCounter() { cleanup(); }
+
+	void init(const DeviceContext& context, uint32_t frameCount);
+
+	/*
+	 * Le device doit tre inactif
+	 */
+	void cleanup();
+
+	[[nodiscard]]
+	bool isActive() const { return m_context.device != VK_NULL_HANDLE; }
+
+	/*
+	 * Rinitialise et dmarre la requte de la frame (hors render pass, avant elle)
+	 */
+	void recordBegin(VkCommandBuffer commandBuffer, uint32_t frame);
+
+	/*
+	 * Termine la requte de la frame (hors render pass, aprs elle)
+	 */
+	void recordEnd(VkCommandBuffer commandBuffer, uint32_t frame);
+
+	/*
+	 *  appeler aprs l'attente de la fence de la frame
+	 */
+	void onFrameCompleted(uint32_t frame);
+
+	/*
+	 * Invocations du fragment shader par frame, en moyenne sur les frames mesures
+	 */
+	[[nodiscard]]
+	double averageInvocations() const { return m_measuredFrames > 0 ? static_cast<double>(m_totalInvocations) / static_cast<double>(m_measuredFrames) : 0.0; }
+
+private:
+	DeviceContext m_context;
+	VkQueryPool m_queryPool{VK_NULL_HANDLE};
+	// Frames dont la requte a t enregistre (les command buffers peuvent tre rutiliss tels quels)
+	std::vector<bool> m_written;
+	uint64_t m_totalInvocations{0};
+	uint64_t m_measuredFrames{0};
+};
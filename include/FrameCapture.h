@@ -0,0 +1,125 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <VulkanUtils.h>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * Format des fichiers crits par la capture
+ * PPM : image RGB 8 bits lisible par la plupart des outils
+ * Raw : octets de l'image tels que copis depuis le GPU (format de la swapchain)
+ */
+enum class CaptureFormat {
+	PPM,
+	Raw
+};
+
+/*
+ * Capture non bloquante des images de la swapchain.
+ * Chaque frame capture est copie dans un slot (buffer de relecture visible par le CPU) d'un anneau.
+ * Le slot n'est lu qu'aprs le signal de la fence de sa frame, puis encod et crit par un thread ddi :
+ * le thread de rendu n'attend jamais le disque. Si aucun slot n'est libre la frame est ignore (compte).
+ * En mode sans perte (tests de rgression), le rendu attend au contraire que le thread d'criture libre le slot.
+ */
+class CFrameCapture {
+public:
+	~CFrameCapture() { cleanup(); }
+
+	/*
+	 * Alloue les slots (catgorie Staging de la tlmtrie) et dmarre le thread d'criture.
+	 * lossless : attend un slot libre au lieu d'ignorer la frame (slotCount doit dpasser le nombre de frames en vol)
+	 */
+	void init(const DeviceContext& context, uint32_t queueFamily, VkExtent2D extent, VkFormat format,
+	          const std::string& directory, CaptureFormat fileFormat, bool lossless = false, size_t slotCount = 4);
+
+	/*
+	 * crit les captures restantes et libre les ressources (le device doit tre inactif)
+	 */
+	void cleanup();
+
+	[[nodiscard]]
+	bool isActive() const { return m_context.device != VK_NULL_HANDLE; }
+
+	/*
+	 * Enregistre la copie de image (layout PRESENT_SRC_KHR) vers un slot libre.
+	 * Retourne le command buffer  soumettre aprs celui du rendu, ou VK_NULL_HANDLE si la frame est ignore.
+	 */
+	VkCommandBuffer recordCapture(VkImage image, uint32_t frameInFlight);
+
+	/*
+	 *  appeler aprs l'attente de la fence frameInFlight : ses slots sont confis au thread d'criture
+	 */
+	void onFrameCompleted(uint32_t frameInFlight);
+
+	/*
+	 * Chemin du fichier correspondant  une frame
+	 */
+	[[nodiscard]]
+	std::string framePath(uint64_t frameNumber) const { return framePath(m_directory, m_fileFormat, frameNumber); }
+
+	[[nodiscard]]
+	static std::string framePath(const std::string& directory, CaptureFormat fileFormat, uint64_t frameNumber);
+
+	[[nodiscard]]
+	uint64_t capturedFrames() const { return m_capturedFrames; }
+
+	[[nodiscard]]
+	uint64_t droppedFrames() const { return m_droppedFrames; }
+
+private:
+	enum class SlotState {
+		Free,
+		// Copie soumise au GPU, en attente de la fence
+		Pending,
+		// Confi au thread d'criture
+		Writing
+	};
+
+	struct CaptureSlot {
+		VkBuffer buffer{VK_NULL_HANDLE};
+		VkDeviceMemory memory{VK_NULL_HANDLE};
+		const uint8_t* mapped{nullptr};
+		VkCommandBuffer commandBuffer{VK_NULL_HANDLE};
+		SlotState state{SlotState::Free};
+		uint32_t frameInFlight{0};
+		uint64_t frameNumber{0};
+	};
+
+	/*
+	 * Boucle du thread d'criture
+	 */
+	void writerLoop();
+
+	/*
+	 * Encode et crit le contenu d'un slot
+	 */
+	void writeSlot(const CaptureSlot& slot) const;
+
+	DeviceContext m_context;
+	VkCommandPool m_commandPool{VK_NULL_HANDLE};
+	VkExtent2D m_extent{};
+	VkFormat m_format{VK_FORMAT_UNDEFINED};
+	std::string m_directory;
+	CaptureFormat m_fileFormat{CaptureFormat::PPM};
+	bool m_lossless{false};
+
+	std::vector<CaptureSlot> m_slots;
+	size_t m_nextSlot{0};
+	uint64_t m_frameNumber{0};
+	uint64_t m_capturedFrames{0};
+	uint64_t m_droppedFrames{0};
+
+	// File des slots  crire, protge par m_mutex (ainsi que les tats des slots)
+	std::deque<size_t> m_writeQueue;
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	// Signal par le thread d'criture  chaque slot libr (mode sans perte)
+	std::condition_variable m_slotFreed;
+	std::thread m_writer;
+	bool m_stopWriter{false};
+};
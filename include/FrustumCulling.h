@@ -0,0 +1,119 @@
+#pragma once
+#include <Math.h>
+#include <JobSystem.h>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+/*
+ * Volumes englobants stocks en structure de tableaux (SoA) :
+ * chaque composante est contigu en mmoire ce qui permet aux kernels SIMD de charger 4/8 objets d'un coup.
+ */
+struct BoundingVolumes {
+	// Sphres englobantes
+	std::vector<float> centerX;
+	std::vector<float> centerY;
+	std::vector<float> centerZ;
+	std::vector<float> radius;
+	// AABB
+	std::vector<float> minX;
+	std::vector<float> minY;
+	std::vector<float> minZ;
+	std::vector<float> maxX;
+	std::vector<float> maxY;
+	std::vector<float> maxZ;
+
+	[[nodiscard]]
+	size_t size() const { return centerX.size(); }
+
+	void reserve(size_t count);
+	void clear();
+
+	/*
+	 * Ajoute un objet, la sphre est dduite de l'AABB
+	 */
+	uint32_t add(const Vec3& boxMin, const Vec3& boxMax);
+
+	/*
+	 * Ajoute un objet dcrit par sa sphre, l'AABB est celle de la sphre
+	 */
+	uint32_t addSphere(const Vec3& center, float sphereRadius);
+};
+
+/*
+ * Plans du frustum (a, b, c, d) normaliss, normales orientes vers l'intrieur
+ * Stocks en SoA pour tre diffuss (broadcast) dans les registres SIMD.
+ */
+struct FrustumPlanes {
+	float a[6];
+	float b[6];
+	float c[6];
+	float d[6];
+
+	/*
+	 * Extraction des plans depuis une matrice view-projection Vulkan (Gribb-Hartmann, z dans [0;w])
+	 */
+	static FrustumPlanes fromViewProjection(const Mat4& viewProjection);
+};
+
+/*
+ * Jeux d'instructions disponibles pour les kernels de culling
+ */
+enum class CullingKernel {
+	Scalar,
+	SSE,
+	AVX2
+};
+
+const char* cullingKernelName(CullingKernel kernel);
+
+/*
+ * Culling CPU des volumes englobants contre le frustum de la camra.
+ * Le travail est dcoup sur le CJobSystem puis compact en une liste d'indices visibles.
+ */
+class CFrustumCuller {
+public:
+	explicit CFrustumCuller(CJobSystem& jobSystem);
+
+	/*
+	 * Meilleur kernel support par le CPU courant (dtection  l'excution)
+	 */
+	static CullingKernel detectBestKernel();
+
+	/*
+	 * Force un kernel (benchmark) ; un kernel non support retombe sur le meilleur disponible
+	 */
+	void setKernel(CullingKernel kernel);
+
+	[[nodiscard]]
+	CullingKernel kernel() const { return m_kernel; }
+
+	/*
+	 * Taille des blocs distribus aux workers (au moins 1)
+	 */
+	void setGrainSize(size_t grain) { m_grain = std::max<size_t>(grain, 1); }
+
+	/*
+	 * Test des sphres englobantes : remplit visible avec les indices des objets visibles (ordre croissant)
+	 */
+	size_t cullSpheres(const FrustumPlanes& frustum, const BoundingVolumes& volumes, std::vector<uint32_t>& visible);
+
+	/*
+	 * Test des AABB (plus prcis, plus coteux)
+	 */
+	size_t cullBoxes(const FrustumPlanes& frustum, const BoundingVolumes& volumes, std::vector<uint32_t>& visible);
+
+private:
+	/*
+	 * Kernel : teste [begin; end[ et crit les indices visibles dans out, retourne le nombre crit
+	 */
+	using KernelFn = size_t (*)(const FrustumPlanes&, const BoundingVolumes&, size_t begin, size_t end, uint32_t* out);
+
+	size_t run(KernelFn fn, const FrustumPlanes& frustum, const BoundingVolumes& volumes, std::vector<uint32_t>& visible);
+
+	CJobSystem& m_jobSystem;
+	CullingKernel m_kernel;
+	size_t m_grain{16384};
+	// Nombre d'objets visibles par bloc avant compaction
+	std::vector<size_t> m_chunkCounts;
+};
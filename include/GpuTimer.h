@@ -0,0 +1,61 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <VulkanUtils.h>
+#include <cstdint>
+#include <vector>
+
+/*
+ * Mesure de dures GPU par timestamps.
+ * Chaque frame en vol possde timestampsPerFrame requtes dans un query pool commun ; les rsultats d'une frame
+ * sont lus sans attente aprs le signal de sa fence (resolve()).
+ */
+class CGpuTimer {
+public:
+	~CGpuTimer() { cleanup(); }
+
+	void init(const DeviceContext& context, uint32_t queueFamily, uint32_t frameCount, uint32_t timestampsPerFrame);
+
+	/*
+	 * Le device doit tre inactif
+	 */
+	void cleanup();
+
+	/*
+	 * La queue supporte-t-elle les timestamps ?
+	 */
+	[[nodiscard]]
+	bool isSupported() const { return m_queryPool != VK_NULL_HANDLE; }
+
+	/*
+	 * Rinitialise les requtes de la frame (hors render pass, en dbut de command buffer)
+	 */
+	void reset(VkCommandBuffer commandBuffer, uint32_t frame);
+
+	/*
+	 * crit le timestamp index de la frame une fois stage atteint
+	 */
+	void write(VkCommandBuffer commandBuffer, uint32_t frame, uint32_t index, VkPipelineStageFlagBits stage);
+
+	/*
+	 * Lit les timestamps de la frame ( appeler aprs l'attente de sa fence).
+	 * Retourne false si la frame n'a encore rien mesur ou si les rsultats ne sont pas disponibles.
+	 */
+	bool resolve(uint32_t frame);
+
+	/*
+	 * Dure en millisecondes entre deux timestamps lus par resolve()
+	 */
+	[[nodiscard]]
+	double elapsedMs(uint32_t frame, uint32_t from, uint32_t to) const;
+
+private:
+	DeviceContext m_context;
+	VkQueryPool m_queryPool{VK_NULL_HANDLE};
+	uint32_t m_timestampsPerFrame{0};
+	// Nanosecondes par tick et bits significatifs des timestamps
+	double m_period{1.0};
+	uint64_t m_validMask{~uint64_t{0}};
+	std::vector<uint64_t> m_results;
+	// Frames dont les requtes ont t enregistres (les command buffers peuvent tre rutiliss tels quels)
+	std::vector<bool> m_written;
+};
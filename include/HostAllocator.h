@@ -0,0 +1,140 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+/*
+ * Statistiques d'une porte d'allocation (VkSystemAllocationScope)
+ */
+struct HostAllocationStats {
+	// Allocations vivantes / total depuis le dmarrage
+	uint64_t liveCount{0};
+	uint64_t totalCount{0};
+	// Octets vivants et pic atteint
+	uint64_t liveBytes{0};
+	uint64_t peakBytes{0};
+};
+
+/*
+ * Allocateur hte pass au driver via VkAllocationCallbacks.
+ * Les petites allocations de porte COMMAND et OBJECT (les plus frquentes, notamment pendant la
+ * compilation des pipelines) sont servies par des chunks d'une seule classe de taille, propres  chaque thread :
+ * pas de verrou ni d'appel  malloc dans le cas courant. Un bloc libr par un autre thread retourne  son
+ * chunk (liste distante, sans verrou) ; un chunk redevenu entirement libre est rendu au systme.
+ * Les autres portes et les grosses allocations passent par l'allocateur systme align.
+ */
+class CHostAllocator {
+public:
+	CHostAllocator();
+	~CHostAllocator();
+
+	CHostAllocator(const CHostAllocator&) = delete;
+	CHostAllocator& operator=(const CHostAllocator&) = delete;
+
+	/*
+	 * Callbacks  passer en pAllocator
+	 */
+	[[nodiscard]]
+	const VkAllocationCallbacks* callbacks() const { return &m_callbacks; }
+
+	/*
+	 * Statistiques par porte (index = VkSystemAllocationScope)
+	 */
+	[[nodiscard]]
+	HostAllocationStats stats(VkSystemAllocationScope scope) const;
+
+	/*
+	 * Allocations internes signales par le driver (pfnInternalAllocation)
+	 */
+	[[nodiscard]]
+	HostAllocationStats internalStats() const;
+
+	/*
+	 * Affiche les statistiques dans la console
+	 */
+	void printReport() const;
+
+private:
+	static constexpr size_t SCOPE_COUNT = 5;
+	static constexpr size_t CLASS_COUNT = 9;
+	// Classes de taille : 16, 32, ..., 4096 octets (puissances de deux)
+	static constexpr size_t MIN_CLASS_SIZE = 16;
+	static constexpr size_t MAX_CLASS_SIZE = MIN_CLASS_SIZE << (CLASS_COUNT - 1);
+	// Les chunks sont aligns sur leur taille : l'en-tte d'un bloc se retrouve par masquage de son adresse
+	static constexpr size_t CHUNK_SIZE = 64 * 1024;
+
+	struct Chunk;
+
+	/*
+	 * Cache par thread : chunks (partiellement) libres de chaque classe, le premier servant les allocations
+	 */
+	struct ThreadCache {
+		// Allocateur servi et identifiant unique du cache (propritaire des chunks)
+		uint64_t allocator{0};
+		uint64_t id{0};
+		std::array<Chunk*, CLASS_COUNT> chunks{};
+	};
+
+	struct ScopeCounters {
+		std::atomic<uint64_t> liveCount{0};
+		std::atomic<uint64_t> totalCount{0};
+		std::atomic<uint64_t> liveBytes{0};
+		std::atomic<uint64_t> peakBytes{0};
+	};
+
+	static void* VKAPI_CALL allocation(void* pUserData, size_t size, size_t alignment,
+	                                   VkSystemAllocationScope scope);
+	static void* VKAPI_CALL reallocation(void* pUserData, void* pOriginal, size_t size, size_t alignment,
+	                                     VkSystemAllocationScope scope);
+	static void VKAPI_CALL free(void* pUserData, void* pMemory);
+	static void VKAPI_CALL internalAllocation(void* pUserData, size_t size, VkInternalAllocationType type,
+	                                          VkSystemAllocationScope scope);
+	static void VKAPI_CALL internalFree(void* pUserData, size_t size, VkInternalAllocationType type,
+	                                    VkSystemAllocationScope scope);
+
+	void* allocate(size_t size, size_t alignment, VkSystemAllocationScope scope);
+	void release(void* memory);
+
+	/*
+	 * Bloc de la classe classIndex pris dans les chunks du thread courant, nullptr si la mmoire manque
+	 */
+	void* allocateBlock(size_t classIndex);
+
+	/*
+	 * Rend un bloc  son chunk : directement pour le thread propritaire, via la liste distante sinon
+	 */
+	void releaseBlock(void* block);
+
+	/*
+	 * Cache du thread courant, rinitialis s'il servait un autre allocateur
+	 */
+	ThreadCache& threadCache();
+
+	/*
+	 * Nouveau chunk / chunk rendu au systme (seuls points de contention entre threads)
+	 */
+	Chunk* acquireChunk(ThreadCache& cache, size_t classIndex);
+	void releaseChunk(Chunk* chunk);
+	static void linkChunk(ThreadCache& cache, Chunk* chunk);
+	static void unlinkChunk(ThreadCache& cache, Chunk* chunk);
+
+	static void record(ScopeCounters& counters, uint64_t bytes);
+	static void unrecord(ScopeCounters& counters, uint64_t bytes);
+	static HostAllocationStats snapshot(const ScopeCounters& counters);
+
+	VkAllocationCallbacks m_callbacks{};
+	// Identifiant unique : invalide les caches des threads ayant servi un allocateur prcdent
+	uint64_t m_id;
+
+	std::array<ScopeCounters, SCOPE_COUNT> m_scopes;
+	ScopeCounters m_internal;
+
+	// Chunks vivants (librs  la destruction, y compris ceux des threads termins)
+	mutable std::mutex m_chunkMutex;
+	std::vector<Chunk*> m_chunks;
+
+	static thread_local ThreadCache t_cache;
+};
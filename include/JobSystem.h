@@ -0,0 +1,80 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * Pool de threads de travail partag par les systmes CPU (culling, scne, pipelines...)
+ * Le thread appelant participe  l'excution lors d'un parallelFor afin de ne jamais rester inactif.
+ * Les tches de fond (submitBackground()) ne passent qu'aprs les autres et ne sont excutes que par les workers :
+ * une tche longue ne retarde jamais le thread appelant d'un parallelFor.
+ */
+class CJobSystem {
+public:
+	/*
+	 * Tche dcoupe : [begin; end[ trait par le worker workerIndex
+	 */
+	using RangeJob = std::function<void(size_t begin, size_t end, size_t workerIndex)>;
+
+	/*
+	 * threadCount = 0 : un worker par coeur moins le thread appelant
+	 */
+	explicit CJobSystem(size_t threadCount = 0);
+	~CJobSystem();
+
+	CJobSystem(const CJobSystem&) = delete;
+	CJobSystem& operator=(const CJobSystem&) = delete;
+
+	/*
+	 * Nombre de threads pouvant excuter des tches (workers + thread appelant)
+	 */
+	[[nodiscard]]
+	size_t concurrency() const { return m_workers.size() + 1; }
+
+	/*
+	 * Nombre de workers (threads pouvant excuter des tches de fond)
+	 */
+	[[nodiscard]]
+	size_t workerCount() const { return m_workers.size(); }
+
+	/*
+	 * Excute une tche de manire asynchrone sur un worker
+	 */
+	void submit(std::function<void()> task);
+
+	/*
+	 * Excute une tche longue de basse priorit (ex: compilation de pipelines) sur un worker, quand la file
+	 * principale est vide. Jamais excute par le thread appelant d'un parallelFor.
+	 */
+	void submitBackground(std::function<void()> task);
+
+	/*
+	 * Dcoupe [0; count[ en blocs de taille grain et les excute en parallle.
+	 * Bloquant : retourne quand tous les blocs ont t traits.
+	 * Retourne le nombre de blocs (le workerIndex pass au job est l'index du bloc).
+	 */
+	size_t parallelFor(size_t count, size_t grain, const RangeJob& job);
+
+private:
+	/*
+	 * Boucle d'un worker : dpile et excute les tches jusqu' l'arrt
+	 */
+	void workerLoop();
+
+	/*
+	 * Dpile et excute une tche de la file principale si disponible (retourne false sinon)
+	 */
+	bool tryRunOne();
+
+	std::vector<std::thread> m_workers;
+	std::deque<std::function<void()>> m_tasks;
+	std::deque<std::function<void()>> m_backgroundTasks;
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	bool m_stop{false};
+};
@@ -0,0 +1,144 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <VulkanUtils.h>
+#include <DepthBuffer.h>
+#include <MeshLod.h>
+#include <FrustumCulling.h>
+#include <Math.h>
+#include <cstdint>
+#include <vector>
+
+/*
+ * Rglages de la scne  niveaux de dtail
+ */
+struct LodSettings {
+	// Slection du niveau de dtail par taille  l'cran (dsactive : niveau 0 pour tous les objets)
+	bool enabled{true};
+	// Instances hors du frustum de la camra non dessines (instanceCount nul)
+	bool frustumCulling{true};
+	uint32_t objectCount{1024};
+	// Niveaux gnrs et subdivisions du maillage de base (20 * 4^n triangles)
+	uint32_t levelCount{6};
+	uint32_t subdivisions{5};
+	// Erreur gomtrique tolre  l'cran
+	float thresholdPixels{1.0f};
+};
+
+/*
+ * Point de vue utilis  la fois pour le dessin et pour la slection des niveaux
+ */
+struct LodView {
+	Vec3 eye;
+	Mat4 view;
+	Mat4 projection;
+	Mat4 viewProjection;
+	// Pixels par unit  distance 1 (hauteur du viewport / (2 tan(fovY / 2)))
+	float pixelsPerUnit{1.0f};
+
+	/*
+	 * Camra fixe de la scne de dmonstration pour un viewport de dimensions extent.
+	 * reverseZ : projection  profondeur inverse (voir perspectiveReverseZ())
+	 */
+	static LodView forExtent(VkExtent2D extent, bool reverseZ = false);
+};
+
+/*
+ * clairage des objets par des lumires rparties en clusters (voir CClusteredLighting).
+ * setLayout : layout du set 0 lu par le fragment shader clair (VK_NULL_HANDLE : clairage directionnel fixe)
+ */
+struct LodLighting {
+	VkDescriptorSetLayout setLayout{VK_NULL_HANDLE};
+	// Chaque pixel value toutes les lumires (constante de spcialisation du fragment shader)
+	bool bruteForce{false};
+};
+
+/*
+ * Rendu d'objets instancis  niveaux de dtail.
+ * Les niveaux partagent un vertex buffer ; leurs indices sont concatns dans un index buffer.
+ * Un dessin indirect par instance est enregistr une fois dans les command buffers : chaque frame, select() rcrit
+ * les commandes indirectes de la frame (plage d'indices du niveau choisi) sans renregistrement.
+ */
+class CLodRenderer {
+public:
+	~CLodRenderer() { cleanup(); }
+
+	/*
+	 * Gnre les niveaux de dtail et les envoie sur le GPU (transfert bloquant sur queue).
+	 * instanceCount : nombre d'instances dessines ; features : fonctionnalits actives sur le device
+	 * (drawIndirectFirstInstance requis, multiDrawIndirect optionnel)
+	 */
+	void init(const DeviceContext& context, uint32_t queueFamily, VkQueue queue, const LodSettings& settings,
+	          uint32_t instanceCount, uint32_t frameCount, const VkPhysicalDeviceFeatures& features,
+	          const LodLighting& lighting = LodLighting{});
+
+	/*
+	 * Pipeline graphique pour renderPass ( recrer avec la swapchain), et pipeline de la pr-passe de profondeur
+	 * si depth.prePass. depth doit dcrire l'attachement de profondeur de renderPass (enabled : il en a un).
+	 */
+	void createGraphicsPipeline(VkRenderPass renderPass, const DepthSettings& depth);
+	void destroyGraphicsPipeline();
+
+	/*
+	 * Le device doit tre inactif
+	 */
+	void cleanup();
+
+	[[nodiscard]]
+	bool isActive() const { return m_context.device != VK_NULL_HANDLE; }
+
+	/*
+	 * Choisit le niveau de chaque instance et crit les commandes indirectes de la frame
+	 * (aprs l'attente de sa fence). Retourne le nombre de triangles dessins.
+	 * culler : teste les sphres englobantes des instances contre le frustum de view (nullptr : pas de culling)
+	 */
+	uint64_t select(uint32_t frame, const std::vector<Mat4>& instances, const LodView& view,
+	                CFrustumCuller* culler = nullptr);
+
+	/*
+	 * Dessin des instances (dans la render pass), prcd de la pr-passe de profondeur si elle est active.
+	 * instanceBuffer : matrices monde de la frame ; lightingSet : set de l'clairage de la frame
+	 * (requis si init() a reu un layout d'clairage)
+	 */
+	void recordDraw(VkCommandBuffer commandBuffer, uint32_t frame, VkBuffer instanceBuffer, const LodView& view,
+	                VkDescriptorSet lightingSet = VK_NULL_HANDLE) const;
+
+	/*
+	 * Triangles dessins en moyenne par frame depuis init()
+	 */
+	[[nodiscard]]
+	double averageTriangles() const { return m_selections > 0 ? static_cast<double>(m_totalTriangles) / static_cast<double>(m_selections) : 0.0; }
+
+	[[nodiscard]]
+	const LodChain& chain() const { return m_chain; }
+
+private:
+	void createIndirectBuffers(uint32_t frameCount);
+
+	/*
+	 * Commandes indirectes de la frame avec la pipeline lie
+	 */
+	void recordIndirectDraws(VkCommandBuffer commandBuffer, uint32_t frame) const;
+
+	DeviceContext m_context;
+	LodSettings m_settings;
+	LodLighting m_lighting;
+	LodChain m_chain;
+	uint32_t m_instanceCount{0};
+	bool m_multiDrawIndirect{false};
+	VkBuffer m_vertexBuffer{VK_NULL_HANDLE};
+	VkDeviceMemory m_vertexBufferMemory{VK_NULL_HANDLE};
+	VkBuffer m_indexBuffer{VK_NULL_HANDLE};
+	VkDeviceMemory m_indexBufferMemory{VK_NULL_HANDLE};
+	// Commandes indirectes par frame en vol, mappes en permanence
+	std::vector<VkBuffer> m_indirectBuffers;
+	std::vector<VkDeviceMemory> m_indirectBuffersMemory;
+	std::vector<VkDrawIndexedIndirectCommand*> m_indirectCommands;
+	VkPipelineLayout m_pipelineLayout{VK_NULL_HANDLE};
+	VkPipeline m_pipeline{VK_NULL_HANDLE};
+	VkPipeline m_prePassPipeline{VK_NULL_HANDLE};
+	// Sphres englobantes et instances visibles de la dernire slection (rutilises d'une frame  l'autre)
+	BoundingVolumes m_volumes;
+	std::vector<uint32_t> m_visible;
+	uint64_t m_totalTriangles{0};
+	uint64_t m_selections{0};
+};
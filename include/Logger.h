@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+
+/*
+ * Svrit des messages (ordre croissant)
+ */
+enum class LogLevel : uint8_t {
+	Verbose,
+	Info,
+	Warning,
+	Error
+};
+
+const char* logLevelName(LogLevel level);
+
+/*
+ * Compteurs du logger depuis le dmarrage
+ */
+struct LoggerStats {
+	// Messages crits sur la sortie
+	uint64_t written{0};
+	// Messages perdus car la file tait pleine
+	uint64_t dropped{0};
+	// Messages rpts retirs par la limitation de dbit
+	uint64_t suppressed{0};
+};
+
+/*
+ * Journal asynchrone partag par toute l'application.
+ * log() copie le message dans une file circulaire sans verrou (plusieurs producteurs, un consommateur) :
+ * pas d'allocation ni d'appel systme, le message est perdu si la file est pleine.
+ * Un thread ddi vide la file priodiquement, carte les rptitions d'un mme message
+ * (mme identifiant, ou mme texte) au-del de la limite par fentre de temps puis crit sur std::cerr par lots.
+ */
+class CLogger {
+public:
+	// Taille maximale d'un message (tronqu au-del)
+	static constexpr size_t MAX_MESSAGE_SIZE = 960;
+
+	/*
+	 * Ajoute un message  la file. messageId : identifiant du message (ex: messageIdNumber des validation layers),
+	 * 0 s'il n'en a pas. category doit rester court (tronqu  15 caractres).
+	 */
+	static void log(LogLevel level, std::string_view category, std::string_view message, int32_t messageId = 0);
+
+	/*
+	 * Les messages de svrit infrieure sont ignors ds l'appel  log()
+	 */
+	static void setMinimumLevel(LogLevel level);
+	static LogLevel minimumLevel();
+
+	/*
+	 * Ignore un identifiant de message (au plus MAX_MUTED_MESSAGES identifiants)
+	 */
+	static void muteMessage(int32_t messageId);
+
+	/*
+	 * Nombre d'occurrences d'un mme message affiches par seconde avant de les compter sans les crire
+	 */
+	static void setRepeatLimit(uint32_t limit);
+
+	/*
+	 * Attend que les messages dj dans la file soient crits
+	 */
+	static void flush();
+
+	static LoggerStats stats();
+
+	static constexpr size_t MAX_MUTED_MESSAGES = 32;
+};
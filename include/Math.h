@@ -0,0 +1,149 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+
+/*
+ * Types mathmatiques minimalistes (pas de dpendance externe).
+ * Les matrices sont stockes en column-major comme attendu par GLSL.
+ */
+
+struct Vec3 {
+	float x{0.0f};
+	float y{0.0f};
+	float z{0.0f};
+};
+
+struct Vec4 {
+	float x{0.0f};
+	float y{0.0f};
+	float z{0.0f};
+	float w{0.0f};
+};
+
+struct Quat {
+	float x{0.0f};
+	float y{0.0f};
+	float z{0.0f};
+	float w{1.0f};
+};
+
+struct Mat4 {
+	// m[colonne * 4 + ligne]
+	float m[16]{
+		1.0f, 0.0f, 0.0f, 0.0f,
+		0.0f, 1.0f, 0.0f, 0.0f,
+		0.0f, 0.0f, 1.0f, 0.0f,
+		0.0f, 0.0f, 0.0f, 1.0f
+	};
+
+	[[nodiscard]]
+	float at(int row, int column) const { return m[column * 4 + row]; }
+	float& at(int row, int column) { return m[column * 4 + row]; }
+};
+
+inline Vec3 operator+(const Vec3& a, const Vec3& b) { return { a.x + b.x, a.y + b.y, a.z + b.z }; }
+inline Vec3 operator-(const Vec3& a, const Vec3& b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+inline Vec3 operator*(const Vec3& a, float s) { return { a.x * s, a.y * s, a.z * s }; }
+
+inline float dot(const Vec3& a, const Vec3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+
+inline Vec3 cross(const Vec3& a, const Vec3& b) {
+	return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+}
+
+inline float length(const Vec3& v) { return std::sqrt(dot(v, v)); }
+
+inline Vec3 normalize(const Vec3& v) {
+	const auto len = length(v);
+	return len > 0.0f ? v * (1.0f / len) : v;
+}
+
+inline Mat4 operator*(const Mat4& a, const Mat4& b) {
+	auto r = Mat4{};
+	for (int c = 0; c < 4; c++) {
+		for (int l = 0; l < 4; l++) {
+			r.at(l, c) = a.at(l, 0) * b.at(0, c) + a.at(l, 1) * b.at(1, c)
+					+ a.at(l, 2) * b.at(2, c) + a.at(l, 3) * b.at(3, c);
+		}
+	}
+	return r;
+}
+
+inline Vec4 operator*(const Mat4& a, const Vec4& v) {
+	return {
+		a.at(0, 0) * v.x + a.at(0, 1) * v.y + a.at(0, 2) * v.z + a.at(0, 3) * v.w,
+		a.at(1, 0) * v.x + a.at(1, 1) * v.y + a.at(1, 2) * v.z + a.at(1, 3) * v.w,
+		a.at(2, 0) * v.x + a.at(2, 1) * v.y + a.at(2, 2) * v.z + a.at(2, 3) * v.w,
+		a.at(3, 0) * v.x + a.at(3, 1) * v.y + a.at(3, 2) * v.z + a.at(3, 3) * v.w
+	};
+}
+
+/*
+ * Matrice de transformation affine translation * rotation * chelle
+ */
+inline Mat4 composeTransform(const Vec3& t, const Quat& q, const Vec3& s) {
+	const auto xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+	const auto xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+	const auto wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+	auto r = Mat4{};
+	r.at(0, 0) = (1.0f - 2.0f * (yy + zz)) * s.x;
+	r.at(1, 0) = (2.0f * (xy + wz)) * s.x;
+	r.at(2, 0) = (2.0f * (xz - wy)) * s.x;
+	r.at(0, 1) = (2.0f * (xy - wz)) * s.y;
+	r.at(1, 1) = (1.0f - 2.0f * (xx + zz)) * s.y;
+	r.at(2, 1) = (2.0f * (yz + wx)) * s.y;
+	r.at(0, 2) = (2.0f * (xz + wy)) * s.z;
+	r.at(1, 2) = (2.0f * (yz - wx)) * s.z;
+	r.at(2, 2) = (1.0f - 2.0f * (xx + yy)) * s.z;
+	r.at(0, 3) = t.x;
+	r.at(1, 3) = t.y;
+	r.at(2, 3) = t.z;
+	return r;
+}
+
+/*
+ * Projection perspective pour Vulkan (profondeur dans [0;1], axe Y vers le bas)
+ */
+inline Mat4 perspective(float fovY, float aspect, float zNear, float zFar) {
+	const auto f = 1.0f / std::tan(fovY * 0.5f);
+	auto r = Mat4{};
+	r.at(0, 0) = f / aspect;
+	r.at(1, 1) = -f;
+	r.at(2, 2) = zFar / (zNear - zFar);
+	r.at(2, 3) = (zNear * zFar) / (zNear - zFar);
+	r.at(3, 2) = -1.0f;
+	r.at(3, 3) = 0.0f;
+	return r;
+}
+
+/*
+ * Projection perspective  profondeur inverse : 1 au plan proche, 0 au plan lointain (test GREATER, effacement  0).
+ * Avec un depth buffer flottant, la prcision perdue par la division perspective est compense par celle du flottant
+ * prs de 0 : elle reste  peu prs constante sur toute la distance.
+ */
+inline Mat4 perspectiveReverseZ(float fovY, float aspect, float zNear, float zFar) {
+	auto r = perspective(fovY, aspect, zNear, zFar);
+	r.at(2, 2) = zNear / (zFar - zNear);
+	r.at(2, 3) = (zNear * zFar) / (zFar - zNear);
+	return r;
+}
+
+inline Mat4 lookAt(const Vec3& eye, const Vec3& center, const Vec3& up) {
+	const auto f = normalize(center - eye);
+	const auto s = normalize(cross(f, up));
+	const auto u = cross(s, f);
+	auto r = Mat4{};
+	r.at(0, 0) = s.x;
+	r.at(0, 1) = s.y;
+	r.at(0, 2) = s.z;
+	r.at(1, 0) = u.x;
+	r.at(1, 1) = u.y;
+	r.at(1, 2) = u.z;
+	r.at(2, 0) = -f.x;
+	r.at(2, 1) = -f.y;
+	r.at(2, 2) = -f.z;
+	r.at(0, 3) = -dot(s, eye);
+	r.at(1, 3) = -dot(u, eye);
+	r.at(2, 3) = dot(f, eye);
+	return r;
+}
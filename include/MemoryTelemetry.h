@@ -0,0 +1,128 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Catgories d'allocations suivies
+ */
+enum class MemoryCategory {
+	Swapchain,
+	Buffer,
+	Image,
+	Staging,
+	Count
+};
+
+const char* memoryCategoryName(MemoryCategory category);
+
+/*
+ * tat d'un tas mmoire (heap) du GPU
+ */
+struct HeapBudget {
+	uint32_t heapIndex{0};
+	bool deviceLocal{false};
+	// Budget accord au processus par le driver (VK_EXT_memory_budget) ou estimation depuis la taille du tas
+	VkDeviceSize budget{0};
+	// Utilisation rapporte par le driver (ou somme des allocations suivies sans l'extension)
+	VkDeviceSize usage{0};
+	// Allocations faites par l'application, par catgorie
+	std::array<VkDeviceSize, static_cast<size_t>(MemoryCategory::Count)> trackedByCategory{};
+
+	[[nodiscard]]
+	float pressure() const { return budget > 0 ? static_cast<float>(usage) / static_cast<float>(budget) : 0.0f; }
+};
+
+/*
+ * Tlmtrie mmoire du device : toutes les allocations passent par allocate()/free() afin d'tre
+ * classes par catgorie et par tas ; update() interroge le budget du driver  chaque frame et
+ * dclenche un callback lorsqu'un tas franchit le seuil de pression configur.
+ */
+class CMemoryTelemetry {
+public:
+	using ThresholdCallback = std::function<void(const HeapBudget&)>;
+
+	/*
+	 * Extensions d'instance  activer (si disponibles) pour pouvoir interroger le budget
+	 */
+	static std::vector<const char*> optionalInstanceExtensions();
+
+	/*
+	 * Le device supporte-t-il VK_EXT_memory_budget ?
+	 */
+	static bool isBudgetExtensionSupported(VkPhysicalDevice physicalDevice);
+
+	/*
+	 * budgetEnabled : VK_EXT_memory_budget a t active  la cration du device
+	 */
+	void init(VkInstance instance, VkPhysicalDevice physicalDevice, bool budgetEnabled);
+
+	/*
+	 * Seuil de pression (usage / budget) au-del duquel callback est appel pour le tas concern
+	 */
+	void setThresholdCallback(float threshold, ThresholdCallback callback);
+
+	[[nodiscard]]
+	bool hasThresholdCallback() const { return static_cast<bool>(m_callback); }
+
+	/*
+	 * Alloue de la mmoire device et l'attribue  une catgorie
+	 */
+	VkResult allocate(VkDevice device, const VkMemoryAllocateInfo& allocInfo, MemoryCategory category,
+	                  const VkAllocationCallbacks* allocator, VkDeviceMemory* memory);
+
+	/*
+	 * Libre une mmoire alloue par allocate()
+	 */
+	void release(VkDevice device, VkDeviceMemory memory, const VkAllocationCallbacks* allocator);
+
+	/*
+	 * Mmoire alloue par le driver hors de allocate() (images de la swapchain), en octets estims.
+	 * Attribue au premier tas DEVICE_LOCAL.
+	 */
+	void setExternalUsage(MemoryCategory category, VkDeviceSize bytes);
+
+	/*
+	 * Rafrachit le budget de chaque tas (une fois par frame)
+	 */
+	void update();
+
+	[[nodiscard]]
+	const std::vector<HeapBudget>& heaps() const { return m_heaps; }
+
+	[[nodiscard]]
+	bool isBudgetEnabled() const { return m_budgetEnabled; }
+
+	/*
+	 * Affiche l'tat de chaque tas dans la console
+	 */
+	void printReport() const;
+
+private:
+	struct AllocationRecord {
+		VkDeviceSize size;
+		uint32_t heapIndex;
+		MemoryCategory category;
+	};
+
+	VkPhysicalDevice m_physicalDevice{VK_NULL_HANDLE};
+	VkPhysicalDeviceMemoryProperties m_memoryProperties{};
+	PFN_vkGetPhysicalDeviceMemoryProperties2KHR m_getMemoryProperties2{nullptr};
+	bool m_budgetEnabled{false};
+
+	// Allocations vivantes (les allocations peuvent venir de plusieurs threads)
+	std::mutex m_mutex;
+	std::unordered_map<VkDeviceMemory, AllocationRecord> m_allocations;
+	std::vector<std::array<VkDeviceSize, static_cast<size_t>(MemoryCategory::Count)>> m_tracked;
+	std::array<VkDeviceSize, static_cast<size_t>(MemoryCategory::Count)> m_external{};
+
+	std::vector<HeapBudget> m_heaps;
+	// Tas au-dessus du seuil (le callback n'est rappel qu'aprs tre repass sous le seuil)
+	std::vector<bool> m_overThreshold;
+	float m_threshold{0.9f};
+	ThresholdCallback m_callback;
+};
@@ -0,0 +1,54 @@
+#pragma once
+#include <Math.h>
+#include <cstdint>
+#include <vector>
+
+/*
+ * Maillage index (triangles, ordre anti-horaire vu de l'extrieur)
+ */
+struct MeshData {
+	std::vector<Vec3> positions;
+	std::vector<uint32_t> indices;
+};
+
+/*
+ * Niveau de dtail : plage d'indices dans LodChain::indices
+ */
+struct MeshLod {
+	uint32_t firstIndex{0};
+	uint32_t indexCount{0};
+	// Erreur gomtrique maximale par rapport au niveau 0, en units de l'objet
+	float error{0.0f};
+};
+
+/*
+ * Chane de niveaux de dtail partageant un unique tableau de sommets : seuls les indices diffrent,
+ * concatns niveau aprs niveau (du plus dtaill au plus grossier)
+ */
+struct LodChain {
+	std::vector<Vec3> positions;
+	std::vector<uint32_t> indices;
+	std::vector<MeshLod> levels;
+	// Rayon de la sphre englobante centre sur l'origine de l'objet
+	float radius{0.0f};
+};
+
+/*
+ * Icosadre subdivis projet sur la sphre unit, relief sinusodal d'amplitude bumpAmplitude
+ * (20 * 4^subdivisions triangles)
+ */
+MeshData makeIcosphere(uint32_t subdivisions, float bumpAmplitude);
+
+/*
+ * Gnration hors ligne des niveaux de dtail par contraction d'artes guide par les quadriques d'erreur
+ * (Garland & Heckbert). Chaque niveau vise reduction fois les triangles du prcdent ; une arte est contracte
+ * vers l'une de ses extrmits afin que tous les niveaux partagent les sommets d'origine.
+ * La gnration s'arrte avant levelCount si le maillage ne peut plus tre simplifi.
+ */
+LodChain buildLodChain(const MeshData& mesh, uint32_t levelCount, float reduction = 0.5f);
+
+/*
+ * Niveau le plus grossier dont l'erreur projete  l'cran reste sous thresholdPixels.
+ * pixelsPerUnit : taille en pixels d'une unit situe  distance 1 de la camra (hauteur / (2 tan(fovY / 2)))
+ */
+uint32_t selectLod(const LodChain& chain, float scale, float distance, float pixelsPerUnit, float thresholdPixels);
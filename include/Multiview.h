@@ -0,0 +1,128 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <VulkanUtils.h>
+#include <GpuTimer.h>
+#include <Math.h>
+#include <cstdint>
+#include <vector>
+
+/*
+ * Rglages du rendu multi-vues
+ */
+struct MultiviewSettings {
+	// Vues rendues (2 : stro, 6 : faces d'un cube...), au plus CMultiviewRenderer::MAX_VIEWS
+	uint32_t viewCount{2};
+	// Toutes les vues en une passe (VK_KHR_multiview) ; sinon une passe et une srie de dessins par vue (rfrence)
+	bool singlePass{true};
+	// Grille de triangles dessine en drawCount appels instancis
+	uint32_t triangleCount{16384};
+	uint32_t drawCount{256};
+};
+
+/*
+ * Rendu de plusieurs vues d'une mme scne dans les couches d'une image (une couche par vue).
+ * En une passe, la render pass porte un masque de vues (VK_KHR_multiview) : chaque dessin est diffus  toutes
+ * les vues et shader.vert (compil avec MULTIVIEW) choisit la matrice de sa vue par gl_ViewIndex.
+ * La rfrence en N passes rend chaque couche sparment avec les mmes dessins.
+ * Les vues sont ensuite copies en mosaque dans l'image de la swapchain ; comme pour la rsolution dynamique,
+ * chaque frame en vol a sa cible et son command buffer, renregistr  chaque frame.
+ */
+class CMultiviewRenderer {
+public:
+	// Nombre de vues garanti par VK_KHR_multiview (maxMultiviewViewCount >= 6)
+	static constexpr uint32_t MAX_VIEWS = 6;
+
+	~CMultiviewRenderer() { cleanup(); }
+
+	/*
+	 * Le device expose-t-il VK_KHR_multiview ? (la fonctionnalit multiview est alors garantie)
+	 */
+	static bool isSupported(VkPhysicalDevice physicalDevice);
+
+	/*
+	 * format : format de la swapchain, dont les images doivent avoir l'usage TRANSFER_DST.
+	 * En une passe, le device doit avoir t cr avec VK_KHR_multiview et la fonctionnalit multiview.
+	 */
+	void init(const DeviceContext& context, uint32_t queueFamily, VkFormat format, VkExtent2D swapChainExtent,
+	          uint32_t frameCount, const MultiviewSettings& settings);
+
+	/*
+	 * Le device doit tre inactif
+	 */
+	void cleanup();
+
+	[[nodiscard]]
+	bool isActive() const { return m_context.device != VK_NULL_HANDLE; }
+
+	/*
+	 *  appeler aprs l'attente de la fence frameInFlight : lit le temps GPU de la frame
+	 */
+	void onFrameCompleted(uint32_t frameInFlight);
+
+	/*
+	 * Enregistre la frame : rendu des vues puis copie en mosaque vers swapChainImage (laisse en PRESENT_SRC_KHR).
+	 * Retourne le command buffer  soumettre.
+	 */
+	VkCommandBuffer record(uint32_t frameInFlight, VkImage swapChainImage);
+
+	/*
+	 * Temps GPU moyen par frame (rendu des vues et copie) depuis init(), 0 sans timestamps
+	 */
+	[[nodiscard]]
+	double averageGpuMs() const { return m_measuredFrames > 0 ? m_totalGpuMs / static_cast<double>(m_measuredFrames) : 0.0; }
+
+private:
+	struct RenderTarget {
+		// Une couche par vue
+		VkImage image{VK_NULL_HANDLE};
+		VkDeviceMemory memory{VK_NULL_HANDLE};
+		// Une passe : une vue sur toutes les couches ; N passes : une vue et un framebuffer par couche
+		std::vector<VkImageView> views;
+		std::vector<VkFramebuffer> framebuffers;
+	};
+
+	/*
+	 * Push constants de shader.vert (MULTIVIEW) : vue de base ajoute  gl_ViewIndex, largeur de la grille
+	 */
+	struct PushConstants {
+		uint32_t firstView;
+		uint32_t columns;
+	};
+
+	void createRenderPass();
+	void createViewBuffer();
+	void createPipeline();
+	void createTarget(RenderTarget& target);
+	void destroyTarget(RenderTarget& target);
+	void recordViews(VkCommandBuffer commandBuffer, const RenderTarget& target) const;
+
+	/*
+	 * Matrices vue-projection : camras rparties sur un arc face  la grille (cart d'yeux en stro)
+	 */
+	[[nodiscard]]
+	std::vector<Mat4> viewMatrices() const;
+
+	DeviceContext m_context;
+	MultiviewSettings m_settings;
+	VkFormat m_format{VK_FORMAT_UNDEFINED};
+	VkExtent2D m_swapChainExtent{0, 0};
+	// Mosaque des vues dans la swapchain et taille d'une vue
+	uint32_t m_tileColumns{1};
+	uint32_t m_tileRows{1};
+	VkExtent2D m_viewExtent{0, 0};
+	uint32_t m_gridColumns{1};
+	VkRenderPass m_renderPass{VK_NULL_HANDLE};
+	VkBuffer m_viewBuffer{VK_NULL_HANDLE};
+	VkDeviceMemory m_viewBufferMemory{VK_NULL_HANDLE};
+	VkDescriptorSetLayout m_descriptorSetLayout{VK_NULL_HANDLE};
+	VkDescriptorPool m_descriptorPool{VK_NULL_HANDLE};
+	VkDescriptorSet m_descriptorSet{VK_NULL_HANDLE};
+	VkPipelineLayout m_pipelineLayout{VK_NULL_HANDLE};
+	VkPipeline m_pipeline{VK_NULL_HANDLE};
+	VkCommandPool m_commandPool{VK_NULL_HANDLE};
+	std::vector<VkCommandBuffer> m_commandBuffers;
+	std::vector<RenderTarget> m_targets;
+	CGpuTimer m_timer;
+	double m_totalGpuMs{0.0};
+	uint64_t m_measuredFrames{0};
+};
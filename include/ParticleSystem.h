@@ -0,0 +1,104 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <VulkanUtils.h>
+#include <GpuTimer.h>
+#include <cstdint>
+
+/*
+ * Rglages de la simulation de particules
+ */
+struct ParticleSettings {
+	uint32_t count{1u << 20};
+	// Taille des groupes de travail du compute shader (constante de spcialisation)
+	uint32_t workgroupSize{256};
+	// Pas de temps fixe : les command buffers sont enregistrs une seule fois
+	float deltaTime{1.0f / 60.0f};
+};
+
+/*
+ * Particules simules entirement sur le GPU.
+ * Positions et vitesses sont stockes en SoA (px, py, pz, vx, vy, vz) dans un storage buffer DEVICE_LOCAL :
+ * le compute shader les intgre, puis le vertex shader les lit directement pour les afficher en points,
+ * sans aller-retour par le CPU. Le temps GPU de la mise  jour est mesur par timestamps.
+ */
+class CParticleSystem {
+public:
+	~CParticleSystem() { cleanup(); }
+
+	/*
+	 * Alloue et initialise les particules (transfert bloquant sur queue), cre la pipeline de calcul.
+	 * timerSlots : nombre de command buffers pouvant enregistrer la mise  jour (une mesure chacun)
+	 */
+	void init(const DeviceContext& context, uint32_t queueFamily, VkQueue queue, const ParticleSettings& settings,
+	          uint32_t timerSlots);
+
+	/*
+	 * Pipeline graphique des particules pour renderPass ( recrer avec la swapchain)
+	 */
+	void createGraphicsPipeline(VkRenderPass renderPass);
+	void destroyGraphicsPipeline();
+
+	/*
+	 * Agrandit les mesures  timerSlots command buffers (swapchain recre avec plus d'images).
+	 * Le device doit tre inactif ; les mesures en attente sont perdues
+	 */
+	void reserveTimerSlots(uint32_t queueFamily, uint32_t timerSlots);
+
+	/*
+	 * Le device doit tre inactif
+	 */
+	void cleanup();
+
+	[[nodiscard]]
+	bool isActive() const { return m_context.device != VK_NULL_HANDLE; }
+
+	/*
+	 * Mise  jour des particules (hors render pass). timerSlot : index de la mesure associe  ce command buffer
+	 */
+	void recordUpdate(VkCommandBuffer commandBuffer, uint32_t timerSlot);
+
+	/*
+	 * Affichage des particules (dans la render pass)
+	 */
+	void recordDraw(VkCommandBuffer commandBuffer) const;
+
+	/*
+	 *  appeler quand le command buffer du slot a fini de s'excuter : accumule le temps de mise  jour
+	 */
+	void onUpdateCompleted(uint32_t timerSlot);
+
+	/*
+	 * Temps GPU moyen d'une mise  jour (0 si aucune mesure)
+	 */
+	[[nodiscard]]
+	double averageUpdateMs() const { return m_measuredUpdates > 0 ? m_totalUpdateMs / static_cast<double>(m_measuredUpdates) : 0.0; }
+
+	[[nodiscard]]
+	uint32_t count() const { return m_settings.count; }
+
+private:
+	struct PushConstants {
+		uint32_t count;
+		float deltaTime;
+	};
+
+	void createBuffer(VkQueue queue, uint32_t queueFamily);
+	void createDescriptors();
+	void createComputePipeline();
+
+	DeviceContext m_context;
+	ParticleSettings m_settings;
+	VkBuffer m_buffer{VK_NULL_HANDLE};
+	VkDeviceMemory m_memory{VK_NULL_HANDLE};
+	VkDescriptorSetLayout m_descriptorSetLayout{VK_NULL_HANDLE};
+	VkDescriptorPool m_descriptorPool{VK_NULL_HANDLE};
+	VkDescriptorSet m_descriptorSet{VK_NULL_HANDLE};
+	// Layout partag par les deux pipelines (mme buffer, mmes push constants)
+	VkPipelineLayout m_pipelineLayout{VK_NULL_HANDLE};
+	VkPipeline m_computePipeline{VK_NULL_HANDLE};
+	VkPipeline m_graphicsPipeline{VK_NULL_HANDLE};
+	CGpuTimer m_timer;
+	uint32_t m_timerSlots{0};
+	double m_totalUpdateMs{0.0};
+	uint64_t m_measuredUpdates{0};
+};
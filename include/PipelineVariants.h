@@ -0,0 +1,152 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <VulkanUtils.h>
+#include <JobSystem.h>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Variante d'une pipeline : valeurs des constantes de spcialisation (constant_id = index dans constants).
+ * La cl nulle dsigne la pipeline gnrique : les constantes des shaders valent 0 (false) par dfaut.
+ */
+struct PipelineVariantKey {
+	static constexpr uint32_t MAX_CONSTANTS = 4;
+	std::array<uint32_t, MAX_CONSTANTS> constants{};
+
+	bool operator==(const PipelineVariantKey& other) const { return constants == other.constants; }
+
+	/*
+	 * FNV-1a sur les valeurs des constantes
+	 */
+	[[nodiscard]]
+	uint64_t hash() const;
+};
+
+struct PipelineVariantKeyHash {
+	size_t operator()(const PipelineVariantKey& key) const { return static_cast<size_t>(key.hash()); }
+};
+
+/*
+ * tat fixe partag par toutes les variantes. Viewport et scissor sont toujours dynamiques.
+ * Les shader modules appartiennent au cache (dtruits par cleanup()) ; layout et render pass restent
+ *  l'appelant et doivent survivre au cache.
+ */
+struct GraphicsPipelineState {
+	VkShaderModule vertexShader{VK_NULL_HANDLE};
+	VkShaderModule fragmentShader{VK_NULL_HANDLE};
+	std::vector<VkVertexInputBindingDescription> vertexBindings;
+	std::vector<VkVertexInputAttributeDescription> vertexAttributes;
+	VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+	VkPipelineRasterizationStateCreateInfo rasterizer{};
+	VkPipelineMultisampleStateCreateInfo multisampling{};
+	VkPipelineColorBlendAttachmentState colorBlendAttachment{};
+	// sType nul : pas d'tat de profondeur (render pass sans attachement de profondeur)
+	VkPipelineDepthStencilStateCreateInfo depthStencil{};
+	VkPipelineLayout layout{VK_NULL_HANDLE};
+	VkRenderPass renderPass{VK_NULL_HANDLE};
+};
+
+/*
+ * Cre une pipeline  partir de l'tat partag, spcialise par key (nullptr : constantes par dfaut des shaders).
+ * Retourne VK_NULL_HANDLE en cas d'chec.
+ */
+VkPipeline createVariantPipeline(const DeviceContext& context, VkPipelineCache pipelineCache,
+                                 const GraphicsPipelineState& state, const PipelineVariantKey* key);
+
+/*
+ * Compteurs du cache de variantes
+ */
+struct PipelineVariantStats {
+	uint64_t compiled{0};
+	uint64_t failed{0};
+	// Demandes de variantes dj connues (cartes grce au hachage des cls)
+	uint64_t deduplicated{0};
+	uint64_t batches{0};
+	// Temps cumul des lots sur les workers
+	double compileMs{0.0};
+};
+
+/*
+ * Variantes de pipeline graphique slectionnes par constantes de spcialisation.
+ * La pipeline gnrique (constantes par dfaut des shaders) est compile de manire synchrone  l'initialisation ;
+ * les autres variantes sont compiles en arrire-plan par les workers du systme de tches (tches de fond, jamais
+ * excutes par un thread qui attend un parallelFor), par lots d'un appel vkCreateGraphicsPipelines chacun
+ * (VkPipelineCache partag). Tant qu'une variante n'est pas prte, pipeline()
+ * retourne la pipeline gnrique : une nouvelle variante ne bloque jamais le rendu.
+ */
+class CPipelineVariantCache {
+public:
+	~CPipelineVariantCache() { cleanup(); }
+
+	void init(const DeviceContext& context, CJobSystem& jobSystem, const GraphicsPipelineState& state);
+
+	/*
+	 * Attend les compilations en cours puis dtruit les pipelines et les shader modules.
+	 * Le device doit tre inactif.
+	 */
+	void cleanup();
+
+	[[nodiscard]]
+	bool isActive() const { return m_context.device != VK_NULL_HANDLE; }
+
+	/*
+	 * Lance la compilation des variantes inconnues, rparties en un lot par worker du systme de tches
+	 */
+	void request(const std::vector<PipelineVariantKey>& keys);
+
+	/*
+	 * Pipeline de la variante si elle est prte, pipeline gnrique sinon (la variante est alors demande).
+	 * Cl nulle : pipeline gnrique.
+	 */
+	VkPipeline pipeline(const PipelineVariantKey& key);
+
+	[[nodiscard]]
+	VkPipeline fallback() const { return m_fallback; }
+
+	/*
+	 * Incrmente  chaque lot termin : les command buffers enregistrs avec une gnration plus ancienne
+	 * peuvent tre renregistrs pour profiter des nouvelles variantes
+	 */
+	[[nodiscard]]
+	uint64_t generation() const { return m_generation.load(std::memory_order_acquire); }
+
+	/*
+	 * Appel sur le worker  la fin de chaque lot, une fois la gnration incrmente et hors du verrou du cache
+	 * (ex: demander une frame en rendu  la demande).  dfinir avant init() ; conserv par cleanup().
+	 */
+	void setBatchCallback(std::function<void()> callback) { m_batchCallback = std::move(callback); }
+
+	[[nodiscard]]
+	PipelineVariantStats stats() const;
+
+private:
+	struct Variant {
+		// VK_NULL_HANDLE tant que la variante n'est pas prte (ou si sa compilation a chou)
+		VkPipeline pipeline{VK_NULL_HANDLE};
+		bool failed{false};
+	};
+
+	/*
+	 * Tche d'un lot : compile les variantes en un appel et publie les pipelines
+	 */
+	void compileBatch(const std::vector<PipelineVariantKey>& keys);
+
+	DeviceContext m_context;
+	CJobSystem* m_jobSystem{nullptr};
+	GraphicsPipelineState m_state;
+	VkPipelineCache m_pipelineCache{VK_NULL_HANDLE};
+	VkPipeline m_fallback{VK_NULL_HANDLE};
+	std::unordered_map<PipelineVariantKey, Variant, PipelineVariantKeyHash> m_variants;
+	PipelineVariantStats m_stats;
+	mutable std::mutex m_mutex;
+	std::condition_variable m_batchesDone;
+	uint32_t m_pendingBatches{0};
+	std::atomic<uint64_t> m_generation{0};
+	std::function<void()> m_batchCallback;
+};
@@ -0,0 +1,270 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <VulkanUtils.h>
+#include <GpuTimer.h>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+/*
+ * Rglages du post-traitement
+ */
+struct PostProcessSettings {
+	// Effets appliqus, dans l'ordre : flou, bloom, tonemapping, talonnage
+	bool blur{false};
+	bool bloom{true};
+	bool tonemap{true};
+	bool colorGrading{true};
+	// Effets adjacents regroups dans un seul dispatch ; sinon un dispatch par effet (comparaison)
+	bool fused{true};
+	// Niveaux de la chane du bloom (le premier  la moiti de la rsolution), au moins 2
+	uint32_t bloomLevels{5};
+	float bloomThreshold{0.7f};
+	float bloomIntensity{0.6f};
+	// Rayon du flou gaussien en pixels (au plus CPostProcess::MAX_BLUR_RADIUS)
+	uint32_t blurRadius{4};
+	// Exposition automatique : la luminance moyenne est ramene  exposureKey, exposition borne  [1/max, max]
+	float exposureKey{0.18f};
+	float maxExposure{4.0f};
+	// talonnage : saturation, teinte multiplicative puis contraste
+	float saturation{1.1f};
+	std::array<float, 3> tint{ 1.0f, 0.98f, 0.94f };
+	float contrast{1.05f};
+};
+
+/*
+ * Temps GPU moyen d'une tape du post-traitement (un ou plusieurs dispatchs)
+ */
+struct PostProcessStageTime {
+	std::string name;
+	double averageMs{0.0};
+};
+
+/*
+ * Post-traitement en compute shaders : la scne est rendue dans une cible hors cran, puis
+ * - une premire rduction  demi-rsolution applique le seuil du bloom et accumule la luminance moyenne
+ *   (rduction par sous-groupes si le device le permet, sinon en mmoire partage) ;
+ * - la chane du bloom est rduite puis remonte niveau par niveau ;
+ * - la passe horizontale du flou sparable charge ses lignes en mmoire partage ;
+ * - un dernier dispatch fusionne la passe verticale du flou, la dernire remonte du bloom, le tonemapping
+ *   et l'talonnage, et crit directement dans l'image de la swapchain si elle a l'usage STORAGE
+ *   (sinon dans une image intermdiaire copie par un blit).
+ * Chaque frame en vol a ses propres images et son command buffer, renregistr  chaque frame.
+ * Le temps GPU de chaque tape est mesur par timestamps.
+ */
+class CPostProcess {
+public:
+	static constexpr uint32_t MAX_BLUR_RADIUS = 8;
+
+	/*
+	 * Enregistre les commandes de dessin de la scne (dans la render pass, viewport et scissor dj dfinis)
+	 */
+	using RecordFunction = std::function<void(VkCommandBuffer commandBuffer)>;
+
+	~CPostProcess() { cleanup(); }
+
+	/*
+	 * Le format de la swapchain peut-il tre rendu puis lu par les compute shaders ?
+	 * Le device doit aussi supporter shaderStorageImageWriteWithoutFormat.
+	 */
+	static bool isSupported(VkPhysicalDevice physicalDevice, VkFormat format);
+
+	/*
+	 * Les images de ce format peuvent-elles tre crites directement par le compute shader (sinon : blit) ?
+	 */
+	static bool canWriteDirectly(VkPhysicalDevice physicalDevice, VkFormat format);
+
+	/*
+	 * Rduction par sous-groupes : Vulkan 1.1 (instance et device), oprations arithmtiques en compute
+	 */
+	static bool supportsSubgroups(VkPhysicalDevice physicalDevice, uint32_t instanceApiVersion);
+
+	/*
+	 * Render pass hors cran compatible avec celle de l'application (mme format). Les images de la swapchain
+	 * doivent avoir l'usage STORAGE (criture directe) ou TRANSFER_DST (blit).
+	 */
+	void init(const DeviceContext& context, uint32_t queueFamily, VkFormat format, VkExtent2D extent,
+	          const std::vector<VkImage>& swapChainImages, VkImageUsageFlags swapChainUsage, uint32_t frameCount,
+	          bool subgroups, const PostProcessSettings& settings);
+
+	/*
+	 * Le device doit tre inactif
+	 */
+	void cleanup();
+
+	[[nodiscard]]
+	bool isActive() const { return m_context.device != VK_NULL_HANDLE; }
+
+	/*
+	 *  appeler aprs l'attente de la fence frameInFlight : accumule les temps GPU de la frame
+	 */
+	void onFrameCompleted(uint32_t frameInFlight);
+
+	/*
+	 * Enregistre la frame : rendu de la scne puis post-traitement vers l'image imageIndex de la swapchain
+	 * (laisse en PRESENT_SRC_KHR). recordPrePass, s'il est fourni, est enregistr avant la render pass.
+	 * Retourne le command buffer  soumettre.
+	 */
+	VkCommandBuffer record(uint32_t frameInFlight, uint32_t imageIndex, const RecordFunction& recordScene,
+	                       const RecordFunction& recordPrePass = nullptr);
+
+	/*
+	 * Temps GPU moyen de chaque tape, rendu de la scne compris (vide sans timestamps)
+	 */
+	[[nodiscard]]
+	std::vector<PostProcessStageTime> stageTimes() const;
+
+	/*
+	 * Temps GPU moyen du post-traitement seul (0 si aucune mesure)
+	 */
+	[[nodiscard]]
+	double averageGpuMs() const;
+
+	[[nodiscard]]
+	size_t dispatchCount() const { return m_dispatches.size(); }
+
+	[[nodiscard]]
+	bool writesDirectly() const { return m_directOutput; }
+
+private:
+	enum class Kernel : uint32_t {
+		Prefilter,
+		PrefilterSubgroups,
+		Downsample,
+		Upsample,
+		Blur,
+		Composite
+	};
+
+	/*
+	 * Constantes de spcialisation de postprocess_composite.comp (BLOOM et TONEMAP servent aussi  la premire
+	 * rduction : criture du bloom et accumulation de la luminance)
+	 */
+	enum CompositeFlags : uint32_t {
+		COMPOSITE_BLUR = 1u << 0,
+		COMPOSITE_BLOOM = 1u << 1,
+		COMPOSITE_TONEMAP = 1u << 2,
+		COMPOSITE_GRADE = 1u << 3,
+		COMPOSITE_FINAL = 1u << 4
+	};
+
+	/*
+	 * Identique au bloc push_constant des shaders
+	 */
+	struct PushConstants {
+		int32_t size[2];
+		float threshold;
+		float intensity;
+		// Teinte (rgb) et saturation (a)
+		float grade[4];
+		float contrast;
+		float key;
+		int32_t radius;
+		float maxExposure;
+	};
+
+	struct StorageImage {
+		VkImage image{VK_NULL_HANDLE};
+		VkDeviceMemory memory{VK_NULL_HANDLE};
+		VkImageView view{VK_NULL_HANDLE};
+		VkExtent2D extent{0, 0};
+	};
+
+	/*
+	 * Image lue ou crite par un dispatch
+	 */
+	struct ImageRef {
+		enum class Kind { Scene, Bloom, Blur, Stage, Dummy } kind{Kind::Dummy};
+		uint32_t index{0};
+	};
+
+	struct FrameResources {
+		// Cible du rendu de la scne (chantillonne par les compute shaders)
+		VkImage sceneImage{VK_NULL_HANDLE};
+		VkDeviceMemory sceneMemory{VK_NULL_HANDLE};
+		VkImageView sceneView{VK_NULL_HANDLE};
+		VkFramebuffer framebuffer{VK_NULL_HANDLE};
+		// Chane du bloom, passe horizontale du flou, rsultats intermdiaires sans fusion
+		std::vector<StorageImage> bloomLevels;
+		StorageImage blur;
+		std::array<StorageImage, 2> stages;
+		// Descripteurs sans effet (effet dsactiv) et sortie quand la swapchain n'est pas crite directement
+		StorageImage dummy;
+		StorageImage output;
+		VkBuffer luminanceBuffer{VK_NULL_HANDLE};
+		VkDeviceMemory luminanceMemory{VK_NULL_HANDLE};
+	};
+
+	struct Dispatch {
+		Kernel kernel{Kernel::Composite};
+		uint32_t flags{0};
+		ImageRef source;
+		ImageRef destination;
+		VkExtent2D extent{0, 0};
+		uint32_t groupCountX{0};
+		uint32_t groupCountY{0};
+		PushConstants parameters{};
+		// tape mesure (index dans m_stageNames)
+		uint32_t stage{0};
+		VkPipeline pipeline{VK_NULL_HANDLE};
+		// Un set par frame en vol, ou par frame et par image de la swapchain (sortie directe du dernier dispatch)
+		std::vector<VkDescriptorSet> sets;
+	};
+
+	void createRenderPass();
+	void createFrameResources(FrameResources& frame);
+	void destroyFrameResources(FrameResources& frame);
+	void createStorageImage(StorageImage& image, VkExtent2D extent, VkFormat format, VkImageUsageFlags usage);
+	void destroyStorageImage(StorageImage& image);
+	void createDescriptors();
+
+	/*
+	 * Liste des dispatchs selon les effets activs et la fusion
+	 */
+	void planDispatches();
+	void addDispatch(Kernel kernel, uint32_t flags, ImageRef source, ImageRef destination, VkExtent2D extent,
+	                 const std::string& stage);
+
+	/*
+	 * Pipeline de calcul d'un kernel et de ses constantes, cre  la premire demande
+	 */
+	VkPipeline pipeline(Kernel kernel, uint32_t flags);
+
+	[[nodiscard]]
+	const StorageImage& storageImage(const FrameResources& frame, ImageRef ref) const;
+
+	[[nodiscard]]
+	VkExtent2D bloomExtent(uint32_t level) const;
+
+	[[nodiscard]]
+	PushConstants pushConstants(VkExtent2D extent) const;
+
+	DeviceContext m_context;
+	PostProcessSettings m_settings;
+	VkFormat m_format{VK_FORMAT_UNDEFINED};
+	VkExtent2D m_extent{0, 0};
+	bool m_subgroups{false};
+	bool m_directOutput{false};
+	std::vector<VkImage> m_swapChainImages;
+	std::vector<VkImageView> m_swapChainViews;
+	VkRenderPass m_renderPass{VK_NULL_HANDLE};
+	VkSampler m_sampler{VK_NULL_HANDLE};
+	VkDescriptorSetLayout m_descriptorSetLayout{VK_NULL_HANDLE};
+	VkDescriptorPool m_descriptorPool{VK_NULL_HANDLE};
+	VkPipelineLayout m_pipelineLayout{VK_NULL_HANDLE};
+	std::map<uint32_t, VkPipeline> m_pipelines;
+	VkCommandPool m_commandPool{VK_NULL_HANDLE};
+	std::vector<VkCommandBuffer> m_commandBuffers;
+	std::vector<FrameResources> m_frames;
+	std::vector<Dispatch> m_dispatches;
+	// Transitions du dbut de frame (rutilis d'une frame  l'autre)
+	std::vector<VkImageMemoryBarrier> m_barriers;
+	// tapes mesures : rendu de la scne, groupes de dispatchs, copie ventuelle vers la swapchain
+	std::vector<std::string> m_stageNames;
+	CGpuTimer m_timer;
+	std::vector<double> m_stageTotalMs;
+	uint64_t m_measuredFrames{0};
+};
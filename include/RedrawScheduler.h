@@ -0,0 +1,139 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+/*
+ * Raisons de redessiner la fentre, combinables
+ */
+enum class RedrawReason : uint32_t {
+	None = 0,
+	// Clavier, souris, molette
+	Input = 1u << 0,
+	// Fentre redimensionne, restaure ou dont le contenu doit tre redessin
+	Resize = 1u << 1,
+	// Scne anime : chaque frame diffre de la prcdente
+	Animation = 1u << 2,
+	// Donnes affiches modifies (variantes de pipeline prtes, fichiers chargs, rafrachissement priodique)
+	DataUpdate = 1u << 3
+};
+
+constexpr uint32_t REDRAW_REASON_COUNT = 4;
+
+inline RedrawReason operator|(RedrawReason a, RedrawReason b) {
+	return static_cast<RedrawReason>(static_cast<uint32_t>(a) | static_cast<uint32_t>(b));
+}
+
+/*
+ * Nom de la raison d'indice index (bit 1 << index)
+ */
+const char* redrawReasonName(uint32_t index);
+
+/*
+ * Mesures du rendu  la demande
+ */
+struct RedrawStats {
+	uint64_t renderedFrames{0};
+	// Frames rendues pour chaque raison (bit 1 << i de RedrawReason) ; une frame peut en compter plusieurs
+	std::array<uint64_t, REDRAW_REASON_COUNT> framesByReason{};
+	// Rveils de la boucle d'vnements sans rien  redessiner (souris hors fentre, vnements ignors...)
+	uint64_t idleWakeups{0};
+	// Intervalles de rafrachissement de l'cran couls sans nouvelle frame
+	uint64_t idleFrames{0};
+	// Temps bloqu dans l'attente d'vnements, sur la dure totale mesure
+	double waitingMs{0.0};
+	double elapsedMs{0.0};
+
+	/*
+	 * Part des rafrachissements de l'cran sans frame (0 : rendu  chaque rafrachissement) et avec une frame
+	 */
+	[[nodiscard]]
+	double idleFrameRatio() const {
+		const auto total = renderedFrames + idleFrames;
+		return total > 0 ? static_cast<double>(idleFrames) / static_cast<double>(total) : 0.0;
+	}
+	[[nodiscard]]
+	double activeFrameRatio() const {
+		const auto total = renderedFrames + idleFrames;
+		return total > 0 ? static_cast<double>(renderedFrames) / static_cast<double>(total) : 0.0;
+	}
+};
+
+/*
+ * Invalidations du rendu  la demande.
+ * Toute source qui change l'image appelle invalidate(), depuis n'importe quel thread : la boucle d'vnements
+ * (thread principal) est rveille et ne produit une frame que si consume() retourne une raison. Entre deux frames
+ * elle attend les vnements sans limite, ou jusqu'au prochain rafrachissement priodique (timeout()).
+ * Une scne anime (setAnimating()) invalide toutes les frames.
+ */
+class CRedrawScheduler {
+public:
+	/*
+	 * Rveille la boucle d'vnements bloque (ex: glfwPostEmptyEvent), appele par invalidate().
+	 *  dfinir avant que d'autres threads puissent invalider.
+	 */
+	void setWakeFunction(std::function<void()> wake) { m_wake = std::move(wake); }
+
+	/*
+	 * Dbut de la boucle d'vnements : remet les mesures  zro et invalide la premire frame.
+	 * refreshRate : frquence de l'cran (Hz), pour compter les rafrachissements sans frame
+	 */
+	void start(double refreshRate);
+
+	/*
+	 * Fige la dure mesure (fin de la boucle d'vnements)
+	 */
+	void stop();
+
+	/*
+	 * Thread-safe
+	 */
+	void invalidate(RedrawReason reason);
+
+	/*
+	 * Thread principal : scne anime ou non
+	 */
+	void setAnimating(bool animating) { m_animating = animating; }
+
+	/*
+	 * Thread principal : invalide DataUpdate toutes les interval secondes (0 : jamais)
+	 */
+	void setRefreshInterval(double interval);
+
+	/*
+	 * Thread principal : raisons accumules depuis le dernier appel, remises  zro.
+	 * Une raison non nulle compte une frame rendue ; None aprs une attente compte un rveil inutile.
+	 */
+	RedrawReason consume();
+
+	/*
+	 * Secondes avant le prochain rafrachissement priodique (ngatif : aucun, attente sans limite)
+	 */
+	[[nodiscard]]
+	double timeout() const;
+
+	/*
+	 * Thread principal : dure d'une attente d'vnements
+	 */
+	void addWaitTime(double ms);
+
+	[[nodiscard]]
+	RedrawStats stats() const;
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	std::atomic<uint32_t> m_pending{0};
+	std::function<void()> m_wake;
+	bool m_animating{false};
+	bool m_waited{false};
+	double m_refreshRate{60.0};
+	double m_refreshInterval{0.0};
+	Clock::time_point m_start;
+	Clock::time_point m_stop;
+	bool m_stopped{false};
+	Clock::time_point m_nextRefresh;
+	RedrawStats m_stats;
+};
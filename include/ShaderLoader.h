@@ -1,7 +1,23 @@
 #pragma once
+#include <AssetStreamer.h>
 #include <vector>
 #include <string>
 class CShaderLoader {
 public:
+	/*
+	 * Contenu du fichier : servi depuis la mmoire s'il a t prcharg (en attendant la fin de sa lecture),
+	 * lu sur le disque sinon
+	 */
 	static std::vector<char> readFile(const std::string& filename);
+
+	/*
+	 * Lit les fichiers en arrire-plan : la cration des pipelines (y compris  la recration de la swapchain,
+	 * sur le thread de rendu) ne touche plus au disque. Un fichier illisible est lu normalement par readFile().
+	 */
+	static void preload(CAssetStreamer& streamer, const std::vector<std::string>& filenames);
+
+	/*
+	 * Libre les fichiers prchargs ; les lectures en cours doivent tre termines ou annules
+	 */
+	static void clearCache();
 };
@@ -0,0 +1,154 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <AssetStreamer.h>
+#include <VulkanUtils.h>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*
+ * Compteurs depuis init()
+ */
+struct StreamingUploadStats {
+	uint64_t uploadsCompleted{0};
+	// Envois en chec ou annuls
+	uint64_t uploadsFailed{0};
+	uint64_t bytesUploaded{0};
+	// Octets du buffer de staging occups au plus
+	VkDeviceSize peakStagingUsage{0};
+};
+
+/*
+ * Chargement de fichiers dans des buffers du GPU sans jamais bloquer le thread de rendu.
+ * Les lectures du CAssetStreamer crivent directement dans un buffer de staging mapp en permanence
+ * (mmoire cohrente), dcoup en zones alloues  la demande. Une zone lue est copie vers son buffer
+ * par le command buffer de transfert de la frame suivante (record()), puis libre quand la fence de cette
+ * frame est passe (onFrameCompleted()). Les parties qui ne trouvent pas de place dans le staging attendent,
+ * par ordre de priorit, qu'une zone se libre : la taille du staging borne les lectures en vol.
+ */
+class CStreamingUploader {
+public:
+	/*
+	 * Appel sur le thread de rendu (onFrameCompleted) quand les copies de l'envoi sont termines ct GPU,
+	 * ou quand il a chou ou t annul (success = false)
+	 */
+	using CompletionFunction = std::function<void(uint64_t id, bool success)>;
+
+	~CStreamingUploader() { cleanup(); }
+
+	/*
+	 * streamer doit rester actif jusqu' cleanup()
+	 */
+	void init(const DeviceContext& context, uint32_t queueFamily, uint32_t frameCount, CAssetStreamer& streamer,
+	          VkDeviceSize stagingSize);
+
+	/*
+	 * Le device doit tre inactif. Abandonne les envois restants et attend la fin des lectures en cours.
+	 */
+	void cleanup();
+
+	[[nodiscard]]
+	bool isActive() const { return m_context.device != VK_NULL_HANDLE; }
+
+	/*
+	 * Copie size octets du fichier ( partir de offset) dans buffer, qui doit avoir l'usage TRANSFER_DST.
+	 * Les envois plus grands que le quart du staging sont dcoups en parties. Retourne l'identifiant de l'envoi.
+	 */
+	uint64_t upload(const std::string& path, uint64_t offset, VkDeviceSize size, VkBuffer buffer, VkDeviceSize bufferOffset,
+	                StreamPriority priority = StreamPriority::Normal, CompletionFunction onCompleted = nullptr);
+
+	/*
+	 * Retourne false si l'envoi est inconnu ou dj termin
+	 */
+	bool cancel(uint64_t id);
+
+	/*
+	 *  appeler aprs l'attente de la fence frameInFlight : libre les zones copies par cette frame
+	 * et termine les envois complets
+	 */
+	void onFrameCompleted(uint32_t frameInFlight);
+
+	/*
+	 * Enregistre les copies des zones lues depuis la frame prcdente, suivies d'une barrire qui rend les buffers
+	 * visibles aux dessins et aux compute shaders. Retourne VK_NULL_HANDLE s'il n'y a rien  copier.
+	 */
+	VkCommandBuffer record(uint32_t frameInFlight);
+
+	/*
+	 * Aucun envoi en cours
+	 */
+	[[nodiscard]]
+	bool idle() const;
+
+	[[nodiscard]]
+	StreamingUploadStats stats() const;
+
+private:
+	struct Upload {
+		std::string path;
+		VkBuffer buffer{VK_NULL_HANDLE};
+		StreamPriority priority{StreamPriority::Normal};
+		CompletionFunction onCompleted;
+		uint32_t partsRemaining{0};
+		bool failed{false};
+		// Requtes du streamer en cours (annulation)
+		std::vector<uint64_t> requests;
+	};
+
+	struct Part {
+		uint64_t upload{0};
+		VkBuffer buffer{VK_NULL_HANDLE};
+		uint64_t fileOffset{0};
+		VkDeviceSize size{0};
+		VkDeviceSize bufferOffset{0};
+		// Zone du staging (si staged)
+		VkDeviceSize stagingOffset{0};
+		bool staged{false};
+		bool success{false};
+	};
+
+	struct FrameResources {
+		VkCommandBuffer commandBuffer{VK_NULL_HANDLE};
+		// Parties copies (ou abandonnes) par cette frame, libres  la fin de la frame
+		std::vector<Part> parts;
+	};
+
+	/*
+	 * met les lectures des parties en attente, dans l'ordre, tant que le staging a de la place
+	 */
+	void issueWaitingParts();
+	bool allocateStaging(VkDeviceSize size, VkDeviceSize& offset);
+	void freeStaging(VkDeviceSize offset, VkDeviceSize size);
+
+	DeviceContext m_context;
+	CAssetStreamer* m_streamer{nullptr};
+	VkBuffer m_stagingBuffer{VK_NULL_HANDLE};
+	VkDeviceMemory m_stagingMemory{VK_NULL_HANDLE};
+	char* m_mapped{nullptr};
+	VkDeviceSize m_stagingSize{0};
+	VkDeviceSize m_partSize{0};
+	// Zones libres du staging (dbut -> taille), fusionnes  la libration
+	std::map<VkDeviceSize, VkDeviceSize> m_freeRanges;
+	VkDeviceSize m_stagingUsage{0};
+	VkCommandPool m_commandPool{VK_NULL_HANDLE};
+	std::vector<FrameResources> m_frames;
+	// Copies de la frame en cours d'enregistrement (rutilis d'une frame  l'autre)
+	std::vector<VkBufferCopy> m_regions;
+	mutable std::mutex m_mutex;
+	// Rveille cleanup()  la fin d'une lecture
+	std::condition_variable m_condition;
+	std::map<uint64_t, Upload> m_uploads;
+	// Parties en attente de staging : priorit dcroissante puis ordre d'arrive
+	std::map<std::pair<int, uint64_t>, Part> m_waiting;
+	// Parties lues (ou abandonnes)  prendre par la prochaine frame
+	std::vector<Part> m_ready;
+	uint32_t m_readsInFlight{0};
+	uint64_t m_nextUpload{1};
+	uint64_t m_nextPart{0};
+	StreamingUploadStats m_stats;
+};
@@ -0,0 +1,112 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <VulkanUtils.h>
+#include <CommandTrace.h>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/*
+ * Options du rejeu
+ */
+struct TraceReplaySettings {
+	// Respecte les horodatages des prsentations de la capture ; sinon rejoue aussi vite que possible
+	bool paced{false};
+};
+
+/*
+ * Mesures d'un rejeu
+ */
+struct TraceReplayStats {
+	uint64_t frames{0};
+	uint64_t submits{0};
+	// Dessins enregistrs (un command buffer pr-enregistr peut tre soumis  plusieurs frames)
+	uint64_t draws{0};
+	// Command buffers soumis  la capture mais absents de la trace (copies de capture d'images...)
+	uint64_t skippedCommandBuffers{0};
+	// Dure du rejeu (cration des objets exclue)
+	double totalMs{0.0};
+	// Dure de la capture (horodatage de la dernire prsentation)
+	double capturedMs{0.0};
+};
+
+/*
+ * Rejeu d'une trace de CCommandTraceWriter sur un device, sans fentre.
+ * Les objets de la trace (shader modules, pipelines, buffers) sont tous crs par init() : le rejeu ne mesure
+ * que l'enregistrement des command buffers, l'criture du contenu des buffers, les soumissions et les attentes.
+ * Le rendu est fait dans une image hors cran au format et aux dimensions de la capture ; les prsentations
+ * dlimitent les frames (au plus FRAMES_IN_FLIGHT frames en vol, comme  la capture).
+ */
+class CTraceReplayer {
+public:
+	static constexpr uint32_t FRAMES_IN_FLIGHT = 2;
+
+	~CTraceReplayer() { cleanup(); }
+
+	void init(const DeviceContext& context, uint32_t queueFamily, VkQueue queue, const std::string& path);
+
+	/*
+	 * Le device doit tre inactif
+	 */
+	void cleanup();
+
+	[[nodiscard]]
+	bool isActive() const { return m_context.device != VK_NULL_HANDLE; }
+
+	/*
+	 * Rejoue toute la trace ; frameTimes reoit la dure de chaque frame (entre deux prsentations)
+	 */
+	TraceReplayStats replay(const TraceReplaySettings& settings, std::vector<float>& frameTimes);
+
+private:
+	struct ReplayBuffer {
+		VkBuffer buffer{VK_NULL_HANDLE};
+		VkDeviceMemory memory{VK_NULL_HANDLE};
+		void* mapped{nullptr};
+		VkDeviceSize size{0};
+	};
+
+	void createTarget();
+
+	/*
+	 * Cre les objets de la trace dans l'ordre de leurs enregistrements de cration
+	 */
+	void createObjects();
+
+	/*
+	 * Command buffer associ  l'identifiant de la capture, allou  sa premire utilisation
+	 */
+	VkCommandBuffer commandBuffer(uint64_t id);
+
+	/*
+	 * Attend la fin de la frame en vol slot si elle a t soumise
+	 */
+	void waitFrame(uint32_t slot);
+
+	DeviceContext m_context;
+	VkQueue m_queue{VK_NULL_HANDLE};
+	CCommandTraceReader m_reader;
+	VkExtent2D m_extent{0, 0};
+	VkImage m_targetImage{VK_NULL_HANDLE};
+	VkDeviceMemory m_targetMemory{VK_NULL_HANDLE};
+	VkImageView m_targetView{VK_NULL_HANDLE};
+	VkRenderPass m_renderPass{VK_NULL_HANDLE};
+	VkFramebuffer m_framebuffer{VK_NULL_HANDLE};
+	VkPipelineLayout m_pipelineLayout{VK_NULL_HANDLE};
+	VkCommandPool m_commandPool{VK_NULL_HANDLE};
+	std::array<VkFence, FRAMES_IN_FLIGHT> m_fences{};
+	std::array<bool, FRAMES_IN_FLIGHT> m_fenceSubmitted{};
+	// Objets crs par createObjects(), dans l'ordre de la trace
+	std::vector<VkShaderModule> m_shaderModules;
+	std::vector<VkPipeline> m_pipelines;
+	std::vector<ReplayBuffer> m_buffers;
+	// Objet dsign par chaque identifiant  la position courante du rejeu
+	std::unordered_map<uint64_t, VkPipeline> m_livePipelines;
+	std::unordered_map<uint64_t, size_t> m_liveBuffers;
+	std::unordered_map<uint64_t, VkCommandBuffer> m_commandBuffers;
+	// Command buffers soumis depuis la dernire attente complte de la queue
+	std::unordered_set<uint64_t> m_pendingCommandBuffers;
+};
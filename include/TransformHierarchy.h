@@ -0,0 +1,125 @@
+#pragma once
+#include <Math.h>
+#include <JobSystem.h>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/*
+ * Identifiant stable d'un noeud (l'index dense change lorsque la hirarchie est rordonne)
+ */
+using NodeId = uint32_t;
+constexpr NodeId INVALID_NODE = std::numeric_limits<NodeId>::max();
+
+/*
+ * Hirarchie de transformations oriente donnes.
+ * Les noeuds sont stocks en SoA et tris par profondeur (parcours en largeur) : les enfants d'un noeud
+ * sont contigus dans le niveau suivant et un parent est toujours mis  jour avant ses enfants.
+ * Seuls les sous-arbres marqus "dirty" sont recalculs, niveau par niveau, en parallle.
+ */
+class CTransformHierarchy {
+public:
+	/*
+	 * Cre un noeud (parent = INVALID_NODE pour une racine)
+	 */
+	NodeId createNode(NodeId parent = INVALID_NODE);
+
+	/*
+	 * Modifie la transformation locale et marque le sous-arbre  recalculer
+	 */
+	void setLocalTransform(NodeId node, const Vec3& translation, const Quat& rotation, const Vec3& scale);
+	void setLocalTranslation(NodeId node, const Vec3& translation);
+
+	/*
+	 * Recalcule les matrices monde des sous-arbres modifis.
+	 * Retourne le nombre de matrices recalcules.
+	 */
+	size_t update(CJobSystem& jobSystem);
+
+	[[nodiscard]]
+	size_t size() const { return m_ids.size(); }
+
+	/*
+	 * Index de l'instance dans le buffer GPU (= index dense aprs update())
+	 */
+	[[nodiscard]]
+	uint32_t instanceIndex(NodeId node) const { return m_idToIndex[node]; }
+
+	[[nodiscard]]
+	const Mat4& worldMatrix(NodeId node) const { return m_world[m_idToIndex[node]]; }
+
+	/*
+	 * Matrices monde en ordre dense, directement copiables dans un buffer d'instances
+	 */
+	[[nodiscard]]
+	const std::vector<Mat4>& worldMatrices() const { return m_world; }
+
+	/*
+	 * Gnration courante (incrmente par chaque update() qui recalcule au moins une matrice)
+	 */
+	[[nodiscard]]
+	uint64_t generation() const { return m_generation; }
+
+	/*
+	 * Met  jour une copie mappe du buffer d'instances synchronise  la gnration syncedGeneration.
+	 * Seules les matrices modifies depuis sont copies ; une copie complte est faite si l'historique
+	 * ne remonte pas assez loin ou si la hirarchie a t rordonne.
+	 * Retourne le nombre de matrices copies et avance syncedGeneration.
+	 */
+	size_t writeInstances(Mat4* mapped, uint64_t& syncedGeneration) const;
+
+	/*
+	 * Ajoute  changed les index des matrices modifies par les gnrations (since, generation()] (un index peut
+	 * apparatre plusieurs fois). Retourne false si l'historique ne remonte pas assez loin ou si la hirarchie
+	 * a t rordonne depuis : toutes les matrices sont alors  recopier.
+	 */
+	bool changedSince(uint64_t since, std::vector<uint32_t>& changed) const;
+
+private:
+	/*
+	 * Nombre de gnrations dont on garde la liste des noeuds modifis (>= nombre de frames en vol)
+	 */
+	static constexpr size_t HISTORY_LENGTH = 4;
+
+	/*
+	 * Reconstruit l'ordre en largeur aprs ajout de noeuds
+	 */
+	void rebuildOrder();
+
+	/*
+	 * L'historique couvre-t-il les gnrations (since, m_generation] sans rordonnancement ?
+	 */
+	[[nodiscard]]
+	bool isHistoryAvailable(uint64_t since) const { return since >= m_orderGeneration && m_generation - since <= HISTORY_LENGTH; }
+
+	/*
+	 * Marque un noeud pour recalcul (index dense)
+	 */
+	void markDirty(uint32_t index);
+
+	// Donnes tries par profondeur (index dense)
+	std::vector<NodeId> m_ids;
+	std::vector<uint32_t> m_parent;
+	std::vector<uint32_t> m_firstChild;
+	std::vector<uint32_t> m_childCount;
+	std::vector<Vec3> m_translation;
+	std::vector<Quat> m_rotation;
+	std::vector<Vec3> m_scale;
+	std::vector<Mat4> m_world;
+	std::vector<uint8_t> m_dirty;
+	// Dbut de chaque niveau de profondeur dans les tableaux denses
+	std::vector<uint32_t> m_levelOffsets;
+
+	// Correspondance id stable -> index dense et parent dclar par id
+	std::vector<uint32_t> m_idToIndex;
+	std::vector<NodeId> m_parentId;
+
+	// Noeuds marqus directement, regroups par niveau
+	std::vector<std::vector<uint32_t>> m_dirtyByLevel;
+	bool m_orderDirty{false};
+
+	// Historique des noeuds modifis par gnration
+	uint64_t m_generation{0};
+	uint64_t m_orderGeneration{0};
+	std::vector<uint32_t> m_changedHistory[HISTORY_LENGTH];
+};
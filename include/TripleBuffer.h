@@ -0,0 +1,52 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/*
+ * Triple buffer sans verrou entre un producteur et un consommateur.
+ * Le producteur remplit writeBuffer() puis publish() ; le consommateur rcupre la dernire publication
+ * avec acquire() et la lit via readBuffer() tant qu'il n'appelle pas acquire()  nouveau.
+ * Aucun des deux ne bloque l'autre : une publication non consomme est remplace par la suivante.
+ */
+template <typename T>
+class CTripleBuffer {
+public:
+	/*
+	 * Tampon rserv au producteur. Il contient une ancienne publication (pas forcment la dernire).
+	 */
+	T& writeBuffer() { return m_buffers[m_back]; }
+
+	/*
+	 * Rend writeBuffer() visible au consommateur et rcupre un autre tampon pour l'criture suivante
+	 */
+	void publish() {
+		m_back = m_middle.exchange(static_cast<uint8_t>(m_back | FRESH_BIT), std::memory_order_acq_rel) & INDEX_MASK;
+	}
+
+	/*
+	 * Rcupre la dernire publication si elle est nouvelle. Retourne false si rien n'a t publi depuis.
+	 */
+	bool acquire() {
+		if ((m_middle.load(std::memory_order_relaxed) & FRESH_BIT) == 0) { return false; }
+		m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & INDEX_MASK;
+		return true;
+	}
+
+	/*
+	 * Tampon rserv au consommateur (dernire publication rcupre)
+	 */
+	const T& readBuffer() const { return m_buffers[m_front]; }
+
+private:
+	static constexpr uint8_t INDEX_MASK = 0x3;
+	// Le tampon du milieu contient une publication que le consommateur n'a pas encore rcupre
+	static constexpr uint8_t FRESH_BIT = 0x4;
+
+	std::array<T, 3> m_buffers{};
+	// Index possd par le producteur / le consommateur
+	uint8_t m_back{0};
+	alignas(64) uint8_t m_front{1};
+	// Index chang entre les deux threads
+	alignas(64) std::atomic<uint8_t> m_middle{2};
+};
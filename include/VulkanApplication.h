@@ -2,12 +2,46 @@
 #include <vulkan/vulkan.h>
 #define GLFW_INCLUDE_VULKAN
 #include <GLFW/glfw3.h>
+#include <JobSystem.h>
+#include <FrustumCulling.h>
+#include <AssetStreamer.h>
+#include <StreamingUploader.h>
+#include <TransformHierarchy.h>
+#include <FrameCapture.h>
+#include <DynamicResolution.h>
+#include <DepthBuffer.h>
+#include <FragmentCounter.h>
+#include <Multiview.h>
+#include <PostProcess.h>
+#include <CommandTrace.h>
+#include <TraceReplayer.h>
+#include <ParticleSystem.h>
+#include <LodRenderer.h>
+#include <ClusteredLighting.h>
+#include <PipelineVariants.h>
+#include <RedrawScheduler.h>
+#include <MemoryTelemetry.h>
+#include <HostAllocator.h>
+#include <VulkanUtils.h>
+#include <Logger.h>
+#include <TripleBuffer.h>
 #include <vector>
 #include <optional>
+#include <string>
+#include <chrono>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
 
 const int WINDOW_HEIGHT{600};
 const int WINDOW_WIDTH{800};
 const int MAX_FRAMES_IN_FLIGHTS = 2;
+// Capacit initiale du buffer d'instances (double si la scne la dpasse)
+const size_t INITIAL_INSTANCE_CAPACITY = 1024;
+// Modes de couleur du triangle (constante de spcialisation 0 de shader.frag)
+const uint32_t TRIANGLE_COLOR_MODES = 3;
 
 // Activation des validations layers en fonction du mode de compilation (release/debug)
 const std::vector<const char*> validation_layers = { "VK_LAYER_KHRONOS_validation" };
@@ -34,14 +68,253 @@ struct SwapChainSupportDetails {
 	std::vector<VkPresentModeKHR> presentModes;
 };
 
+/*
+ * Sortie supplmentaire (fentre ou surface headless) rendue par le mme device que la fentre principale.
+ * Elle partage la render pass de la fentre principale : le format de sa swapchain doit tre identique.
+ */
+struct OutputSurface {
+	GLFWwindow* window{nullptr};
+	VkSurfaceKHR surface{VK_NULL_HANDLE};
+	VkSwapchainKHR swapchain{VK_NULL_HANDLE};
+	VkExtent2D extent{};
+	// Taille de la fentre lue par le thread principal (publie dans les snapshots), utilise par le thread de rendu
+	VkExtent2D framebufferExtent{};
+	std::vector<VkImage> images;
+	std::vector<VkImageView> imageViews;
+	std::vector<VkFramebuffer> framebuffers;
+	// Un par couple (image, frame en vol), comme les command buffers de la fentre principale
+	std::vector<VkCommandBuffer> commandBuffers;
+	std::vector<uint64_t> commandBufferGenerations;
+	// Un par frame en vol
+	std::vector<VkSemaphore> imageAvailableSemaphores;
+	std::vector<VkSemaphore> renderFinishedSemaphores;
+	// Swapchain refuse (OUT_OF_DATE) ou sous-optimale : recre seule au dbut de la frame suivante
+	bool outdated{false};
+};
+
+/*
+ * Soumission et prsentation groupes d'une frame : une entre par sortie prsente.
+ * Les tableaux sont conservs d'une frame  l'autre pour viter les allocations.
+ */
+struct PresentBatch {
+	std::vector<VkSemaphore> waitSemaphores;
+	std::vector<VkSemaphore> signalSemaphores;
+	std::vector<VkSwapchainKHR> swapchains;
+	std::vector<uint32_t> imageIndices;
+	std::vector<VkResult> results;
+	// Sortie supplmentaire de chaque entre (nullptr : fentre principale, toujours l'entre 0)
+	std::vector<OutputSurface*> outputs;
+	// Command buffers de toutes les sorties, contigus par sortie  partir de firstCommandBuffers[sortie]
+	std::vector<VkCommandBuffer> commandBuffers;
+	std::vector<size_t> firstCommandBuffers;
+	std::vector<VkSubmitInfo> submits;
+
+	void clear() {
+		waitSemaphores.clear();
+		signalSemaphores.clear();
+		swapchains.clear();
+		imageIndices.clear();
+		outputs.clear();
+		commandBuffers.clear();
+		firstCommandBuffers.clear();
+	}
+
+	/*
+	 * Ajoute une sortie ; ses command buffers sont ajouts ensuite  commandBuffers
+	 */
+	void addOutput(VkSemaphore imageAvailable, VkSemaphore renderFinished, VkSwapchainKHR swapchain, uint32_t imageIndex,
+	               OutputSurface* output = nullptr) {
+		waitSemaphores.push_back(imageAvailable);
+		signalSemaphores.push_back(renderFinished);
+		swapchains.push_back(swapchain);
+		imageIndices.push_back(imageIndex);
+		outputs.push_back(output);
+		firstCommandBuffers.push_back(commandBuffers.size());
+	}
+};
+
+/*
+ * Scne affiche
+ */
+enum class SceneType {
+	// Triangle de dmonstration
+	Triangle,
+	// Particules simules par compute shader (voir CParticleSystem)
+	Particles,
+	// Grille d'objets  niveaux de dtail (voir CLodRenderer)
+	Lod
+};
+
+/*
+ * Options de lancement de l'application
+ */
+struct ApplicationSettings {
+	// Capture des frames rendues vers des fichiers images (ajoute TRANSFER_SRC aux images de la swapchain)
+	bool captureFrames{false};
+	std::string captureDirectory{"captures"};
+	CaptureFormat captureFormat{CaptureFormat::PPM};
+	// Le rendu attend l'criture des captures au lieu d'ignorer des frames (comparaisons d'images reproductibles)
+	bool captureLossless{false};
+	// Rendu sans fentre (VK_EXT_headless_surface), utilis par la suite de rgression
+	bool headless{false};
+	uint32_t width{WINDOW_WIDTH};
+	uint32_t height{WINDOW_HEIGHT};
+	// Nombre de frames  rendre avant de quitter (0 : jusqu' la fermeture de la fentre)
+	uint64_t maxFrames{0};
+	// Temps simul coul par frame en secondes (0 : temps rel) : animations reproductibles d'une excution  l'autre
+	double fixedFrameTime{0.0};
+	// Rendu  la demande (fentre uniquement) : une frame seulement quand l'image change (entres, redimensionnement,
+	// animation, donnes), attente bloquante des vnements entre deux frames. La fentre principale devient
+	// redimensionnable. onDemandRefreshInterval : rafrachissement priodique en secondes (0 : aucun)
+	bool onDemand{false};
+	double onDemandRefreshInterval{0.0};
+	// Ne retient que les cartes graphiques dont le nom contient cette chane (ex: "llvmpipe")
+	std::string deviceFilter;
+	// Pression mmoire (usage / budget d'un tas) dclenchant le callback de la tlmtrie
+	float memoryPressureThreshold{0.9f};
+	// Affiche l'tat des tas mmoire  la fermeture
+	bool memoryReport{false};
+	// Allocations hte du driver servies par CHostAllocator (sinon : allocateur interne du driver)
+	bool customHostAllocator{true};
+	// Affiche les statistiques de l'allocateur hte  la fermeture
+	bool hostAllocatorReport{false};
+	// Svrit minimale des messages (validation layers comprises) et identifiants de messages ignors
+	LogLevel logLevel{LogLevel::Info};
+	std::vector<int32_t> mutedMessages;
+	// Rendu dans une cible hors cran dont la taille suit le temps GPU mesur, agrandie vers la swapchain
+	bool dynamicResolution{false};
+	DynamicResolutionSettings dynamicResolutionSettings;
+	// Plusieurs vues de la scne rendues en mosaque (scne Triangle uniquement ; remplace la rsolution dynamique)
+	bool multiview{false};
+	MultiviewSettings multiviewSettings;
+	// Post-traitement en compute shaders (sans rsolution dynamique ni multi-vues)
+	bool postProcess{false};
+	PostProcessSettings postProcessSettings;
+	// Test de profondeur de la render pass principale (sans rsolution dynamique ni post-traitement) :
+	// profondeur inverse, pr-passe de profondeur de la scne Lod
+	DepthSettings depth;
+	// Compte les invocations du fragment shader de chaque frame (fonctionnalit pipelineStatisticsQuery)
+	bool countFragments{false};
+	// Nombre de sorties (fentres, ou surfaces headless) rendues chaque frame ; la premire est la fentre principale
+	uint32_t outputCount{1};
+	SceneType scene{SceneType::Triangle};
+	ParticleSettings particleSettings;
+	LodSettings lodSettings;
+	// Objets de la scne Lod clairs par des lumires ponctuelles rparties en clusters (voir CClusteredLighting)
+	bool lighting{false};
+	LightingSettings lightingSettings;
+	// Trace binaire du flux de commandes crite dans ce fichier (scne Triangle uniquement, vide : pas de trace)
+	std::string commandTrace;
+	// Rejoue cette trace au lieu de rendre la scne (voir CTraceReplayer), aux horodatages de la capture si replayPaced
+	std::string replayTrace;
+	bool replayPaced{false};
+	// Variante de la pipeline du triangle : constante 0 = mode de couleur (0 couleurs des sommets, 1 niveaux de gris,
+	// 2 invers), constante 1 = correction gamma
+	PipelineVariantKey triangleVariant;
+	// Lecteur des fichiers : shaders lus en arrire-plan ds le lancement, fichiers de streamFiles
+	AssetStreamerSettings streamerSettings;
+	// Fichiers chargs en arrire-plan dans des buffers du GPU pendant le rendu (maillages, textures...)
+	std::vector<std::string> streamFiles;
+	// Taille du buffer de staging du streaming : borne les octets lus et pas encore copis
+	VkDeviceSize streamingStagingSize{64ull << 20};
+};
+
+/*
+ * tat d'une frame produit par le thread principal (simulation) et consomm tel quel par le thread de rendu
+ */
+struct FrameSnapshot {
+	uint64_t frameNumber{0};
+	// Secondes coules depuis le lancement au moment de la simulation
+	double time{0.0};
+	// Matrices monde de toutes les instances et gnration de la scne qu'elles refltent
+	std::vector<Mat4> instances;
+	uint64_t sceneGeneration{0};
+	// Index des matrices modifies par les gnrations (changesSince, sceneGeneration] : un buffer d'instances
+	// synchronis  une gnration antrieure  changesSince est recopi entirement
+	std::vector<uint32_t> changedInstances;
+	uint64_t changesSince{0};
+	// Taille de la fentre principale lue par le thread principal (swapchain recre si elle change)
+	VkExtent2D framebufferExtent{};
+	// Idem pour chaque sortie supplmentaire (mme ordre que m_extraOutputs, vide en headless)
+	std::vector<VkExtent2D> outputExtents;
+};
+
+/*
+ * Mesures de performance d'une excution
+ */
+struct FrameStatistics {
+	// Temps entre le lancement et la prsentation de la premire frame
+	double startupMs{0.0};
+	// Temps CPU par frame (attente de la fence incluse)
+	double averageFrameMs{0.0};
+	double medianFrameMs{0.0};
+	uint64_t frameCount{0};
+	// Temps GPU moyen de la simulation des particules (0 hors scne de particules ou sans timestamps)
+	double gpuComputeMs{0.0};
+	// Triangles dessins par frame (scne  niveaux de dtail)
+	double averageTriangles{0.0};
+	// Temps GPU moyen du rendu multi-vues (0 hors mode multi-vues ou sans timestamps)
+	double gpuMultiviewMs{0.0};
+	// Temps GPU moyen du post-traitement (scne exclue) et de chacune de ses tapes
+	double gpuPostProcessMs{0.0};
+	std::vector<PostProcessStageTime> postProcessStages;
+	// Octets de ApplicationSettings::streamFiles copis dans les buffers du GPU, et temps entre le lancement des
+	// lectures et la fin de la dernire copie (0 si le streaming n'est pas termin)
+	uint64_t streamedBytes{0};
+	double streamingMs{0.0};
+	// clairage par clusters : temps GPU de la rpartition des lumires et de la passe claire,
+	// lumires par cluster en moyenne et au plus (0 sans clairage ou en valuation exhaustive)
+	double gpuLightCullingMs{0.0};
+	double gpuLightShadingMs{0.0};
+	double averageLightsPerCluster{0.0};
+	uint32_t maxLightsPerCluster{0};
+	// Invocations du fragment shader par frame et par pixel de la fentre principale (0 sans ApplicationSettings::countFragments)
+	double fragmentInvocations{0.0};
+	double fragmentsPerPixel{0.0};
+	// Rendu  la demande : frames rendues par raison, rafrachissements de l'cran sans frame, temps d'attente
+	RedrawStats redraw;
+};
+
 class CVulkanApplication {
 public:
+	explicit CVulkanApplication(ApplicationSettings settings = ApplicationSettings{}) : m_settings(std::move(settings)) {}
+
 	void run();
+
+	/*
+	 * Mesures de la dernire excution de run()
+	 */
+	[[nodiscard]]
+	FrameStatistics statistics() const;
+
+	/*
+	 * Tlmtrie mmoire : budget par tas mis  jour  chaque frame.
+	 * Les systmes de streaming peuvent y enregistrer un callback de pression mmoire avant run().
+	 */
+	CMemoryTelemetry& memoryTelemetry() { return m_memoryTelemetry; }
+
+	/*
+	 * Mesures du dernier rejeu (ApplicationSettings::replayTrace)
+	 */
+	[[nodiscard]]
+	const TraceReplayStats& traceReplayStats() const { return m_traceReplayStats; }
 private:
 	/*************************
 	 	Membres
 	**************************/
 
+	/*
+	 * Options de lancement
+	 */
+	ApplicationSettings m_settings;
+
+	/*
+	 * Allocateur hte pass  toutes les fonctions vkCreate et vkDestroy.
+	 * m_allocator vaut nullptr si m_settings.customHostAllocator est dsactiv.
+	 */
+	CHostAllocator m_hostAllocator;
+	const VkAllocationCallbacks* m_allocator{nullptr};
+
 	/*
 	 * Fentre GLFW
 	 */
@@ -51,6 +324,13 @@ private:
 	 * Instance de Vulkan
 	 */
 	VkInstance m_instance;
+	// Version de Vulkan demande  la cration de l'instance
+	uint32_t m_apiVersion{VK_API_VERSION_1_0};
+
+	/*
+	 * Fonctions de l'instance (messager)
+	 */
+	InstanceDispatch m_instanceDispatch;
 
 	/*
 	 * Messager
@@ -68,6 +348,17 @@ private:
 	 */
 	VkDevice m_device;
 
+	/*
+	 * Fonctions du device charges aprs sa cration, utilises sur les chemins appels  chaque frame
+	 */
+	DeviceDispatch m_dispatch;
+
+	/*
+	 * Suivi des allocations et du budget mmoire (VK_EXT_memory_budget si disponible)
+	 */
+	CMemoryTelemetry m_memoryTelemetry;
+	bool m_memoryBudgetEnabled{false};
+
 	/*
 	 * Rfrences aux queues
 	 */
@@ -86,26 +377,53 @@ private:
 	std::vector<VkImage> m_swapChainImages;
 	VkFormat m_swapChainImageFormat;
 	VkExtent2D m_swapChainExtent;
+	VkImageUsageFlags m_swapChainUsage{0};
 	std::vector<VkFramebuffer> m_swapChainFramebuffers;
 	/*
 	 * ImageView: permet de manipuler les VkImage
 	 */
 	std::vector<VkImageView> m_swapChainImagesViews;
 
+	/*
+	 * Sorties supplmentaires (ApplicationSettings::outputCount - 1)
+	 */
+	std::vector<OutputSurface> m_extraOutputs;
+
+	/*
+	 * Soumission et prsentation de la frame en cours (thread de rendu)
+	 */
+	PresentBatch m_presentBatch;
+
 	/*
 	 * Pipeline layout
 	 */
 	VkPipelineLayout m_pipelineLayout;
 
 	/*
-	 * Passe de rendu
+	 * Passe de rendu et format de couleur pour lequel elle a t cre. Elle ne dpend pas de la taille de la
+	 * swapchain : conserve (avec m_pipelineLayout et les variantes de pipeline) tant que ce format ne change pas.
 	 */
 	VkRenderPass m_renderPass;
+	VkFormat m_renderPassFormat{VK_FORMAT_UNDEFINED};
+
+	/*
+	 * Attachement de profondeur de la render pass principale (partag par toutes les sorties).
+	 * m_depth : rglages effectifs (m_settings.depth sans la profondeur si aucun format ne convient ou si la scne est
+	 * rendue hors de la render pass principale)
+	 */
+	CDepthBuffer m_depthBuffer;
+	DepthSettings m_depth;
+	VkFormat m_depthFormat{VK_FORMAT_UNDEFINED};
+
+	/*
+	 * Invocations du fragment shader de la render pass principale (actif si m_settings.countFragments)
+	 */
+	CFragmentCounter m_fragmentCounter;
 
 	/*
-	 * Pipeline graphique
+	 * Variantes de la pipeline graphique du triangle (compiles sur le systme de tches)
 	 */
-	VkPipeline m_pipeline;
+	CPipelineVariantCache m_pipelineVariants;
 
 	/*
 	 * Pool de commandes
@@ -113,10 +431,16 @@ private:
 	VkCommandPool m_commandPool;
 
 	/*
-	 * Command buffers
+	 * Command buffers pr-enregistrs, un par couple (image de la swapchain, frame en vol) :
+	 * index image * MAX_FRAMES_IN_FLIGHTS + frame. Ils peuvent ainsi lire les buffers de leur frame en vol.
 	 */
 	std::vector<VkCommandBuffer> m_commandBuffers;
 
+	/*
+	 * Gnration du cache de variantes lors de l'enregistrement de chaque command buffer
+	 */
+	std::vector<uint64_t> m_commandBufferGenerations;
+
 	/*
 	 * Smaphores (synchronisation des oprations d'affichage)
 	 */
@@ -133,6 +457,132 @@ private:
 	 */
 	std::vector<VkFence> m_inFlightFences;
 
+	/*
+	 * Systme de tches partag (culling, mise  jour de la scne...)
+	 */
+	CJobSystem m_jobSystem;
+
+	/*
+	 * Culling CPU des instances de la scne  niveaux de dtail (thread de rendu)
+	 */
+	CFrustumCuller m_frustumCuller{m_jobSystem};
+
+	/*
+	 * Scne : hirarchie de transformations
+	 */
+	CTransformHierarchy m_scene;
+
+	/*
+	 * Snapshots changs entre le thread principal et le thread de rendu
+	 */
+	CTripleBuffer<FrameSnapshot> m_snapshots;
+
+	/*
+	 * Thread de rendu : attente des fences, acquisition, soumission et prsentation.
+	 * m_acquiredSnapshots : nombre de snapshots consomms (cadence le thread principal)
+	 * m_renderError : exception leve sur le thread de rendu, relance par le thread principal
+	 */
+	std::thread m_renderThread;
+	std::atomic<bool> m_stopRendering{false};
+	std::atomic<bool> m_renderingDone{false};
+	std::atomic<uint64_t> m_acquiredSnapshots{0};
+	std::exception_ptr m_renderError;
+
+	/*
+	 * Rendu  la demande (m_settings.onDemand) : invalidations de la fentre
+	 */
+	CRedrawScheduler m_redraw;
+
+	/*
+	 * Attentes sans scruter entre les deux threads (compteurs modifis sous m_snapshotMutex) :
+	 * m_snapshotPublished rveille le thread de rendu  chaque publication (ou  l'arrt),
+	 * m_snapshotAcquired le thread principal en mode headless  chaque acquisition (ou  la fin du rendu).
+	 * Avec une fentre, le thread principal attend les vnements GLFW et est rveill par glfwPostEmptyEvent.
+	 */
+	std::mutex m_snapshotMutex;
+	std::condition_variable m_snapshotPublished;
+	std::condition_variable m_snapshotAcquired;
+	std::atomic<uint64_t> m_publishedSnapshots{0};
+
+	/*
+	 * Taille de la fentre principale pour laquelle la swapchain a t cre (thread de rendu aprs l'initialisation).
+	 * m_swapChainOutdated : prsentation refuse (VK_ERROR_OUT_OF_DATE_KHR), swapchain  recrer
+	 */
+	VkExtent2D m_framebufferExtent{};
+	bool m_swapChainOutdated{false};
+
+	/*
+	 * Buffers d'instances (matrices monde), une copie par frame en vol mappe en permanence.
+	 * m_instanceBuffersGeneration : gnration de la scne synchronise dans chaque copie
+	 */
+	std::vector<VkBuffer> m_instanceBuffers;
+	std::vector<VkDeviceMemory> m_instanceBuffersMemory;
+	std::vector<Mat4*> m_instanceBuffersMapped;
+	std::vector<uint64_t> m_instanceBuffersGeneration;
+	size_t m_instanceCapacity{0};
+
+	/*
+	 * Capture des frames (active si m_settings.captureFrames)
+	 */
+	CFrameCapture m_frameCapture;
+
+	/*
+	 * Rsolution dynamique (active si m_settings.dynamicResolution et si le format de la swapchain le permet)
+	 */
+	CDynamicResolution m_dynamicResolution;
+
+	/*
+	 * Rendu multi-vues (actif si m_settings.multiview en scne Triangle)
+	 */
+	CMultiviewRenderer m_multiview;
+
+	/*
+	 * Post-traitement (actif si m_settings.postProcess, sans rsolution dynamique ni multi-vues)
+	 */
+	CPostProcess m_postProcess;
+
+	/*
+	 * Lectures asynchrones des fichiers et chargement de m_settings.streamFiles dans m_streamedBuffers
+	 * (un buffer par fichier). m_pendingStreams et m_streamingMs ne sont modifis que par le thread de rendu.
+	 */
+	CAssetStreamer m_assetStreamer;
+	CStreamingUploader m_streamingUploader;
+	std::vector<VkBuffer> m_streamedBuffers;
+	std::vector<VkDeviceMemory> m_streamedBuffersMemory;
+	uint32_t m_pendingStreams{0};
+	std::chrono::steady_clock::time_point m_streamingStart;
+	double m_streamingMs{0.0};
+
+	/*
+	 * Trace du flux de commandes (active si m_settings.commandTrace) et rejeu d'une trace (m_settings.replayTrace)
+	 */
+	CCommandTraceWriter m_commandTrace;
+	CTraceReplayer m_traceReplayer;
+	TraceReplayStats m_traceReplayStats;
+
+	/*
+	 * Particules (scne SceneType::Particles).
+	 * m_particleTimerSlots : mesure de temps associe au command buffer soumis par chaque frame en vol
+	 */
+	CParticleSystem m_particles;
+	std::vector<uint32_t> m_particleTimerSlots;
+
+	/*
+	 * Objets  niveaux de dtail (scne SceneType::Lod), anims par le dplacement de m_lodRoot,
+	 * et leur clairage (actif si m_settings.lighting).
+	 * m_enabledFeatures : fonctionnalits actives sur le device (dessins indirects)
+	 */
+	CLodRenderer m_lodRenderer;
+	CClusteredLighting m_lighting;
+	NodeId m_lodRoot{INVALID_NODE};
+	VkPhysicalDeviceFeatures m_enabledFeatures{};
+
+	/*
+	 * Mesures de temps (dmarrage et dure des frames)
+	 */
+	std::chrono::steady_clock::time_point m_startTime;
+	double m_startupMs{0.0};
+	std::vector<float> m_frameTimes;
 
 	/*************************
 		Mthodes
@@ -151,19 +601,52 @@ private:
 
 	/*
 	* Boucle indfiniment tant que le programme est actif.
-	* s'occupe d'couter les vnements sur la fentre GLFW
+	* s'occupe d'couter les vnements sur la fentre GLFW et de simuler la scne, le rendu tant fait
+	* sur le thread de rendu
 	*/
 	void mainLoop();
 
+	/*
+	 * Traitement des vnements et simulation sur le thread principal jusqu' la fermeture ou la fin du rendu
+	 */
+	void simulationLoop();
+
+	/*
+	 * Boucle du thread de rendu : rend chaque nouveau snapshot publi par le thread principal
+	 */
+	void renderLoop();
+
+	/*
+	 * Rendu  la demande : bloque le thread principal dans l'attente des vnements jusqu' ce que la fentre soit
+	 * invalide. Retourne false si la fentre est ferme.
+	 */
+	bool waitForRedraw();
+
+	/*
+	 * Fentre principale rduite ou de taille nulle : aucune frame n'est rendue
+	 */
+	[[nodiscard]]
+	bool windowMinimized() const;
+
+	/*
+	 * Callbacks GLFW de la fentre principale : invalident la frame en rendu  la demande
+	 */
+	void installWindowCallbacks();
+
+	/*
+	 * Rejoue m_settings.replayTrace  la place de mainLoop() (sans simulation ni prsentation)
+	 */
+	void replayCommandTrace();
+
 	/*
 	* Dsallocation de mmoire lorsque l'application se ferme
 	*/
 	void cleanup();
 
 	/*
-	 * Rend la frame courante
+	 * Rend la frame courante  partir d'un snapshot (thread de rendu)
 	 */
-	void drawFrame();
+	void drawFrame(const FrameSnapshot& snapshot);
 
 	/*
 	* Crer une instance Vulkan
@@ -173,10 +656,39 @@ private:
 	void createInstance();
 
 	/*
-	* Crer une surface (gr par GLFW)
+	* Crer une surface (gr par GLFW, ou VK_EXT_headless_surface sans fentre)
 	*/
 	void createSurface();
 
+	/*
+	 * Surface d'une fentre GLFW (surface headless si window vaut nullptr)
+	 */
+	VkSurfaceKHR createOutputSurface(GLFWwindow* window);
+
+	/*
+	 * Cre la swapchain, les framebuffers, les command buffers et les smaphores des sorties supplmentaires
+	 * (aprs la render pass et la command pool)
+	 */
+	void createOutputSwapChains();
+	void createOutputSwapChain(OutputSurface& output);
+
+	/*
+	 * Dtruit les objets crs par createOutputSwapChains() (fentres et surfaces conserves)
+	 */
+	void destroyOutputSwapChains();
+	void destroyOutputSwapChain(OutputSurface& output);
+
+	/*
+	 * Recre la swapchain d'une sortie refuse par l'acquisition ou la prsentation, sans toucher aux autres
+	 * (toutes les swapchains si elle ne tient plus dans l'attachement de profondeur partag)
+	 */
+	void recreateOutputSwapChain(OutputSurface& output);
+
+	/*
+	 * Estimation de la mmoire des swapchains (4 octets par pixel), fentre principale comprise
+	 */
+	void updateSwapchainMemory();
+
 	/*
 	* Crer la swapchain
 	*/
@@ -212,6 +724,63 @@ private:
 	 */
 	void cleanupSwapChain();
 
+	/*
+	 * Destruction de la render pass, du pipeline layout et des variantes de pipeline du triangle
+	 * (fin de l'application ou changement du format de la swapchain)
+	 */
+	void destroyRenderPass();
+
+	/*
+	 * Objets du device partags avec les modules (capture, buffers...)
+	 */
+	[[nodiscard]]
+	DeviceContext deviceContext() { return DeviceContext{ m_physicalDevice, m_device, m_allocator, &m_memoryTelemetry, &m_dispatch }; }
+
+	/*
+	 * Dmarre la capture des frames aux dimensions de la swapchain courante
+	 */
+	void createFrameCapture();
+
+	/*
+	 * Ouvre la trace du flux de commandes (avant la cration des objets tracs)
+	 */
+	void createCommandTrace();
+
+	/*
+	 * Dmarre la rsolution dynamique aux dimensions de la swapchain courante
+	 */
+	void createDynamicResolution();
+
+	/*
+	 * Dmarre le rendu multi-vues aux dimensions de la swapchain courante
+	 */
+	void createMultiview();
+
+	/*
+	 * Dmarre le post-traitement aux dimensions de la swapchain courante
+	 */
+	void createPostProcess();
+
+	/*
+	 * Fichiers SPIR-V utiliss par la configuration (lus en arrire-plan ds le lancement)
+	 */
+	std::vector<std::string> shaderFiles() const;
+
+	/*
+	 * Cre les buffers de m_settings.streamFiles et lance leur chargement
+	 */
+	void createStreaming();
+
+	/*
+	 * Initialise les particules au premier appel puis (re)cre leur pipeline graphique pour la render pass courante
+	 */
+	void createParticleSystem();
+
+	/*
+	 * Cre au premier appel les objets de la scne  niveaux de dtail puis (re)cre leur pipeline graphique
+	 */
+	void createLodScene();
+
 	/*
 	* Crer les image views
 	*/
@@ -232,6 +801,16 @@ private:
 	*/
 	void createFramebuffers();
 
+	/*
+	 * Attachement de profondeur couvrant la fentre principale et les sorties supplmentaires (avant les framebuffers)
+	 */
+	void createDepthBuffer();
+
+	/*
+	 * Requtes de statistiques de pipeline (avant l'enregistrement des command buffers)
+	 */
+	void createFragmentCounter();
+
 	/*
 	 * Crer les pools de commandes (oprations d'affichage et de transfert mmoire)
 	 */
@@ -242,15 +821,56 @@ private:
 	 */
 	void createCommandBuffers();
 
+	/*
+	 * (R)enregistre le command buffer pr-enregistr d'index index (il ne doit pas tre en cours d'excution)
+	 */
+	void recordCommandBuffer(size_t index);
+
+	/*
+	 * (R)enregistre le command buffer d'index index d'une sortie supplmentaire (dessin de la scne uniquement)
+	 */
+	void recordOutputCommandBuffer(OutputSurface& output, size_t index);
+
+	/*
+	 * Render pass complte dessinant la scne dans framebuffer
+	 */
+	void recordRenderPass(VkCommandBuffer commandBuffer, VkFramebuffer framebuffer, VkExtent2D extent, uint32_t frame);
+
+	/*
+	 * Commandes de dessin de la scne pour la frame en vol frame (dans la render pass, viewport et scissor dfinis)
+	 */
+	void recordScene(VkCommandBuffer commandBuffer, uint32_t frame);
+
 	/*
 	 * Crer les objets de sync (smaphores et fences)
 	 */
 	void createSyncObjects();
 
+	/*
+	 * Crer les buffers d'instances pouvant contenir capacity matrices
+	 */
+	void createInstanceBuffers(size_t capacity);
+
+	/*
+	 * Dtruire les buffers d'instances
+	 */
+	void destroyInstanceBuffers();
+
+	/*
+	 * Met  jour la scne et recopie uniquement les matrices modifies dans le snapshot (thread principal)
+	 */
+	void simulate(FrameSnapshot& snapshot, uint64_t frameNumber);
+
+	/*
+	 * Recopie les matrices du snapshot dans le buffer d'instances de la frame courante si elles ont chang
+	 */
+	void uploadInstances(const FrameSnapshot& snapshot);
+
 	/*
 	* Rcupre les extensions requises par l'application
 	*/
-	static std::vector<const char*> getRequiredExtensions();
+	[[nodiscard]]
+	std::vector<const char*> getRequiredExtensions() const;
 
 	/*
 	* Attribue un score aux cartes graphiques en fonction des extensions, fonctionnalits supports
@@ -273,9 +893,9 @@ private:
 	QueueFamilyIndices findQueueFamilies(VkPhysicalDevice device);
 
 	/*
-	* Rcupration des dtails du support de la swapchain de la carte graphique
+	* Rcupration des dtails du support de la swapchain de la carte graphique (surface principale par dfaut)
 	*/
-	SwapChainSupportDetails querySwapChainSupport(VkPhysicalDevice device) const;
+	SwapChainSupportDetails querySwapChainSupport(VkPhysicalDevice device, VkSurfaceKHR surface = VK_NULL_HANDLE) const;
 
 	/*
 	* Dfini quel format va tre utilis parmis ceux disponible (sRGB)
@@ -288,9 +908,9 @@ private:
 	static VkPresentModeKHR chooseSwapPresentMode(const std::vector<VkPresentModeKHR>& availablePresentModes);
 
 	/*
-	* Dfini les dimensions de l'affichage
+	* Dfini les dimensions de l'affichage pour une fentre de taille framebufferExtent (lue par le thread principal)
 	*/
-	VkExtent2D chooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabilities) const;
+	VkExtent2D chooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabilities, VkExtent2D framebufferExtent) const;
 
 	/*
 	* Cration d'un VkShaderModule
@@ -0,0 +1,87 @@
+#pragma once
+#include <vulkan/vulkan.h>
+
+/*
+ * Tables de fonctions Vulkan charges une fois pour toutes, gnres  partir des listes ci-dessous.
+ * Un appel par la table va directement au driver au lieu de passer par le trampoline export par le loader,
+ * qui retrouve la table du device  chaque appel : le gain compte sur les chemins appels  chaque frame
+ * (enregistrement des commandes, soumission, prsentation, attentes). Les fonctions de cration et de
+ * destruction restent appeles par le loader.
+ * Les membres portent le nom de la fonction sans le prfixe vk : dispatch.CmdDraw(...) appelle vkCmdDraw.
+ */
+
+/*
+ * Fonctions de niveau instance (vkGetInstanceProcAddr). Fonctions d'extensions : nullptr si l'extension est absente.
+ */
+#define VULKAN_INSTANCE_FUNCTIONS(X) \
+	X(GetDeviceProcAddr) \
+	X(CreateDebugUtilsMessengerEXT) \
+	X(DestroyDebugUtilsMessengerEXT)
+
+/*
+ * Fonctions de niveau device (vkGetDeviceProcAddr), toutes obligatoires
+ */
+#define VULKAN_DEVICE_FUNCTIONS(X) \
+	/* Synchronisation, soumission et prsentation */ \
+	X(WaitForFences) \
+	X(ResetFences) \
+	X(AcquireNextImageKHR) \
+	X(QueueSubmit) \
+	X(QueuePresentKHR) \
+	X(QueueWaitIdle) \
+	X(DeviceWaitIdle) \
+	X(GetQueryPoolResults) \
+	/* Enregistrement des command buffers */ \
+	X(BeginCommandBuffer) \
+	X(EndCommandBuffer) \
+	X(ResetCommandBuffer) \
+	X(CmdBeginRenderPass) \
+	X(CmdEndRenderPass) \
+	X(CmdSetViewport) \
+	X(CmdSetScissor) \
+	X(CmdBindPipeline) \
+	X(CmdBindDescriptorSets) \
+	X(CmdBindVertexBuffers) \
+	X(CmdBindIndexBuffer) \
+	X(CmdPushConstants) \
+	X(CmdDraw) \
+	X(CmdDrawIndexedIndirect) \
+	X(CmdDispatch) \
+	X(CmdPipelineBarrier) \
+	X(CmdCopyBuffer) \
+	X(CmdCopyImage) \
+	X(CmdCopyImageToBuffer) \
+	X(CmdBlitImage) \
+	X(CmdClearColorImage) \
+	X(CmdFillBuffer) \
+	X(CmdResetQueryPool) \
+	X(CmdBeginQuery) \
+	X(CmdEndQuery) \
+	X(CmdWriteTimestamp)
+
+#define VULKAN_DISPATCH_MEMBER(name) PFN_vk##name name{nullptr};
+
+struct InstanceDispatch {
+	VULKAN_INSTANCE_FUNCTIONS(VULKAN_DISPATCH_MEMBER)
+
+	/*
+	 * Charge les fonctions de instance
+	 */
+	void load(VkInstance instance);
+};
+
+/*
+ * Table d'un device : chaque device a la sienne (les pointeurs chargs pour un device ne sont valides que pour lui
+ * et ses objets). Les modules la reoivent par DeviceContext::dispatch.
+ */
+struct DeviceDispatch {
+	VkDevice device{VK_NULL_HANDLE};
+	VULKAN_DEVICE_FUNCTIONS(VULKAN_DISPATCH_MEMBER)
+
+	/*
+	 * Charge les fonctions de device ; lve une exception si l'une d'elles est absente
+	 */
+	void load(const InstanceDispatch& instance, VkDevice device);
+};
+
+#undef VULKAN_DISPATCH_MEMBER
@@ -0,0 +1,77 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <MemoryTelemetry.h>
+#include <VulkanDispatch.h>
+#include <vector>
+
+/*
+ * Fonctions utilitaires partages par les modules qui allouent des ressources Vulkan
+ */
+
+/*
+ * Objets partags par les modules qui crent des ressources sur le device
+ */
+struct DeviceContext {
+	VkPhysicalDevice physicalDevice{VK_NULL_HANDLE};
+	VkDevice device{VK_NULL_HANDLE};
+	// Callbacks d'allocation hte  passer  toutes les fonctions vkCreate et vkDestroy (nullptr : allocateur du driver)
+	const VkAllocationCallbacks* allocator{nullptr};
+	// Tlmtrie des allocations device (optionnelle)
+	CMemoryTelemetry* telemetry{nullptr};
+	// Fonctions du device appeles  chaque frame (enregistrement des commandes, soumissions, attentes)
+	const DeviceDispatch* dispatch{nullptr};
+};
+
+/*
+ * Recherche un type de mmoire compatible avec typeFilter et possdant les proprits demandes
+ */
+uint32_t findMemoryType(VkPhysicalDevice physicalDevice, uint32_t typeFilter, VkMemoryPropertyFlags properties);
+
+/*
+ * Cre un buffer et alloue/lie sa mmoire.
+ * Si le contexte a une tlmtrie, l'allocation est comptabilise dans la catgorie donne.
+ */
+void createBuffer(const DeviceContext& context, VkDeviceSize size, VkBufferUsageFlags usage,
+                  VkMemoryPropertyFlags properties, VkBuffer& buffer, VkDeviceMemory& bufferMemory,
+                  MemoryCategory category = MemoryCategory::Buffer);
+
+/*
+ * Alloue une mmoire device (en passant par la tlmtrie si le contexte en a une)
+ */
+VkResult allocateMemory(const DeviceContext& context, const VkMemoryAllocateInfo& allocInfo, MemoryCategory category,
+                        VkDeviceMemory* memory);
+
+/*
+ * Libre une mmoire device
+ */
+void freeMemory(const DeviceContext& context, VkDeviceMemory memory);
+
+/*
+ * Dtruit un buffer et libre sa mmoire
+ */
+void destroyBuffer(const DeviceContext& context, VkBuffer buffer, VkDeviceMemory memory);
+
+/*
+ * Copie size octets de data dans buffer (usage TRANSFER_DST) via un buffer de staging.
+ * Transfert bloquant sur queue : rserv  l'initialisation.
+ */
+void uploadToBuffer(const DeviceContext& context, uint32_t queueFamily, VkQueue queue, VkBuffer buffer,
+                    const void* data, VkDeviceSize size);
+
+/*
+ * Cre un shader module  partir de code SPIR-V
+ */
+VkShaderModule createShaderModule(const DeviceContext& context, const std::vector<char>& code);
+
+/*
+ * Cre une image 2D (tiling optimal, un seul niveau de mip) et alloue/lie sa mmoire.
+ * arrayLayers > 1 : image  plusieurs couches
+ */
+void createImage(const DeviceContext& context, VkExtent2D extent, VkFormat format, VkImageUsageFlags usage,
+                 VkMemoryPropertyFlags properties, VkImage& image, VkDeviceMemory& imageMemory,
+                 MemoryCategory category = MemoryCategory::Image, uint32_t arrayLayers = 1);
+
+/*
+ * Dtruit une image et libre sa mmoire
+ */
+void destroyImage(const DeviceContext& context, VkImage image, VkDeviceMemory memory);
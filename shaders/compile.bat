@@ -1,3 +1,18 @@
 C:/3DDev/VulkanSDK/1.1.108.0/Bin32/glslangValidator.exe -V shader.vert
 C:/3DDev/VulkanSDK/1.1.108.0/Bin32/glslangValidator.exe -V shader.frag
+C:/3DDev/VulkanSDK/1.1.108.0/Bin32/glslangValidator.exe -V -DMULTIVIEW shader.vert -o multiview_vert.spv
+C:/3DDev/VulkanSDK/1.1.108.0/Bin32/glslangValidator.exe -V -DMULTIVIEW -DPASS_PER_VIEW shader.vert -o multiview_passes_vert.spv
+C:/3DDev/VulkanSDK/1.1.108.0/Bin32/glslangValidator.exe -V particles.comp -o particles_comp.spv
+C:/3DDev/VulkanSDK/1.1.108.0/Bin32/glslangValidator.exe -V particles.vert -o particles_vert.spv
+C:/3DDev/VulkanSDK/1.1.108.0/Bin32/glslangValidator.exe -V particles.frag -o particles_frag.spv
+C:/3DDev/VulkanSDK/1.1.108.0/Bin32/glslangValidator.exe -V lod.vert -o lod_vert.spv
+C:/3DDev/VulkanSDK/1.1.108.0/Bin32/glslangValidator.exe -V lod.frag -o lod_frag.spv
+C:/3DDev/VulkanSDK/1.1.108.0/Bin32/glslangValidator.exe -V -DCLUSTERED lod.frag -o lod_lit_frag.spv
+C:/3DDev/VulkanSDK/1.1.108.0/Bin32/glslangValidator.exe -V lighting_cull.comp -o lighting_cull_comp.spv
+C:/3DDev/VulkanSDK/1.1.108.0/Bin32/glslangValidator.exe -V postprocess_prefilter.comp -o postprocess_prefilter_comp.spv
+C:/3DDev/VulkanSDK/1.1.108.0/Bin32/glslangValidator.exe -V --target-env vulkan1.1 -DSUBGROUPS postprocess_prefilter.comp -o postprocess_prefilter_subgroup_comp.spv
+C:/3DDev/VulkanSDK/1.1.108.0/Bin32/glslangValidator.exe -V postprocess_downsample.comp -o postprocess_downsample_comp.spv
+C:/3DDev/VulkanSDK/1.1.108.0/Bin32/glslangValidator.exe -V postprocess_upsample.comp -o postprocess_upsample_comp.spv
+C:/3DDev/VulkanSDK/1.1.108.0/Bin32/glslangValidator.exe -V postprocess_blur.comp -o postprocess_blur_comp.spv
+C:/3DDev/VulkanSDK/1.1.108.0/Bin32/glslangValidator.exe -V postprocess_composite.comp -o postprocess_composite_comp.spv
 pause
@@ -0,0 +1,88 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout(location = 0) in vec3 worldPosition;
+
+layout(location = 0) out vec4 outColor;
+
+#ifdef CLUSTERED
+// Eclairage par les lumieres ponctuelles reparties en clusters (voir lighting_cull.comp)
+layout(location = 1) in vec4 clipPosition;
+
+// Toutes les lumieres evaluees par chaque pixel, sans les listes des clusters (comparaison)
+layout(constant_id = 0) const bool BRUTE_FORCE = false;
+
+struct Light {
+    vec4 positionRadius;
+    vec4 color;
+};
+
+layout(std140, set = 0, binding = 0) uniform Parameters {
+    mat4 view;
+    // P00, P11, profondeur de la premiere tranche, log(farDepth / nearDepth)
+    vec4 projection;
+    vec4 eye;
+    // Dimensions de la grille, nombre de lumieres
+    uvec4 grid;
+    uvec4 limits;
+} params;
+
+layout(std430, set = 0, binding = 1) readonly buffer Lights {
+    Light lights[];
+};
+
+layout(std430, set = 0, binding = 2) readonly buffer Clusters {
+    uvec2 clusters[];
+};
+
+layout(std430, set = 0, binding = 3) readonly buffer LightIndices {
+    uint lightIndices[];
+};
+
+// Attenuation fenetree : nulle au-dela du rayon, ce qui rend exact le test de la repartition
+vec3 shade(Light light, vec3 normal) {
+    vec3 toLight = light.positionRadius.xyz - worldPosition;
+    float distanceSquared = dot(toLight, toLight);
+    float radius = light.positionRadius.w;
+    float falloff = clamp(1.0 - distanceSquared / (radius * radius), 0.0, 1.0);
+    falloff *= falloff;
+    float lambert = max(dot(normal, toLight * inversesqrt(max(distanceSquared, 1e-4))), 0.0);
+    return light.color.rgb * (light.color.a * falloff * lambert);
+}
+
+// Cluster du fragment : tuile de l'ecran et tranche de profondeur (w de decoupage = profondeur en espace vue)
+uint clusterIndex() {
+    vec2 ndc = clipPosition.xy / clipPosition.w;
+    uvec2 tile = uvec2(clamp((ndc * 0.5 + 0.5) * vec2(params.grid.xy), vec2(0.0), vec2(params.grid.xy) - 1.0));
+    float slice = log(max(clipPosition.w, 1e-4) / params.projection.z) / params.projection.w * float(params.grid.z);
+    uint depthSlice = uint(clamp(slice, 0.0, float(params.grid.z) - 1.0));
+    return (depthSlice * params.grid.y + tile.y) * params.grid.x + tile.x;
+}
+#endif
+
+void main() {
+    // Eclairage par face : la normale est reconstruite a partir des derivees (pas d'attribut de normale)
+    vec3 normal = normalize(cross(dFdx(worldPosition), dFdy(worldPosition)));
+#ifdef CLUSTERED
+    // Normale orientee vers la camera (le sens du produit vectoriel depend de l'orientation de l'ecran)
+    if (dot(normal, params.eye.xyz - worldPosition) < 0.0) {
+        normal = -normal;
+    }
+    vec3 light = vec3(0.05);
+    if (BRUTE_FORCE) {
+        for (uint i = 0; i < params.grid.w; i++) {
+            light += shade(lights[i], normal);
+        }
+    }
+    else {
+        uvec2 range = clusters[clusterIndex()];
+        for (uint i = 0; i < range.y; i++) {
+            light += shade(lights[lightIndices[range.x + i]], normal);
+        }
+    }
+    outColor = vec4(vec3(0.85, 0.8, 0.7) * light, 1.0);
+#else
+    float light = 0.2 + 0.8 * abs(dot(normal, normalize(vec3(0.4, 0.8, 0.3))));
+    outColor = vec4(vec3(0.85, 0.8, 0.7) * light, 1.0);
+#endif
+}
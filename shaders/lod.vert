@@ -0,0 +1,25 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+// Positions partagees par tous les niveaux de detail
+layout(location = 0) in vec3 inPosition;
+// Matrice monde de l'instance (locations 1 a 4)
+layout(location = 1) in mat4 inWorld;
+
+layout(push_constant) uniform Camera {
+    mat4 viewProjection;
+} camera;
+
+layout(location = 0) out vec3 worldPosition;
+// Position de decoupage : la variante eclairee en deduit le cluster du fragment
+layout(location = 1) out vec4 clipPosition;
+
+// Meme position dans la pre-passe de profondeur et dans la passe principale (test EQUAL)
+invariant gl_Position;
+
+void main() {
+    vec4 world = inWorld * vec4(inPosition, 1.0);
+    worldPosition = world.xyz;
+    clipPosition = camera.viewProjection * world;
+    gl_Position = clipPosition;
+}
@@ -0,0 +1,27 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+// Lecture directe du buffer mis a jour par le compute shader (pas de vertex buffer)
+layout(std430, binding = 0) readonly buffer Particles {
+    float data[];
+};
+
+layout(push_constant) uniform Parameters {
+    uint count;
+    float deltaTime;
+} parameters;
+
+layout(location = 0) out vec3 fragColor;
+
+void main() {
+    uint i = gl_VertexIndex;
+    uint n = parameters.count;
+    vec3 position = vec3(data[i], data[n + i], data[2 * n + i]);
+    vec3 velocity = vec3(data[3 * n + i], data[4 * n + i], data[5 * n + i]);
+    // Disque dans le plan XZ vu de dessus
+    gl_Position = vec4(position.x, position.z, 0.5 + position.y * 0.25, 1.0);
+    gl_PointSize = 1.0;
+    // Couleur selon la vitesse
+    float speed = clamp(length(velocity), 0.0, 1.0);
+    fragColor = mix(vec3(0.1, 0.3, 1.0), vec3(1.0, 0.6, 0.1), speed);
+}
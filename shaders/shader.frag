@@ -1,10 +1,26 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
 
+// Variantes de pipeline (valeurs par defaut : pipeline generique)
+// 0 : couleurs des sommets, 1 : niveaux de gris, 2 : couleurs inversees
+layout(constant_id = 0) const uint COLOR_MODE = 0;
+// Correction gamma (sortie lineaire vers sRGB approchee)
+layout(constant_id = 1) const bool GAMMA = false;
+
 layout(location = 0) in vec3 fragColor;
 
 layout(location = 0) out vec4 outColor;
 
 void main() {
-    outColor = vec4(fragColor, 1.0);
+    vec3 color = fragColor;
+    // Branches eliminees a la compilation de chaque variante
+    if (COLOR_MODE == 1) {
+        color = vec3(dot(color, vec3(0.2126, 0.7152, 0.0722)));
+    } else if (COLOR_MODE == 2) {
+        color = vec3(1.0) - color;
+    }
+    if (GAMMA) {
+        color = pow(color, vec3(1.0 / 2.2));
+    }
+    outColor = vec4(color, 1.0);
 }
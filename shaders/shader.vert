@@ -1,5 +1,16 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
+#ifdef MULTIVIEW
+// Compile avec -DMULTIVIEW (multiview_vert.spv) : une matrice par vue, choisie par gl_ViewIndex
+// Avec aussi -DPASS_PER_VIEW (multiview_passes_vert.spv) : une passe par vue, sans VK_KHR_multiview,
+// la vue est choisie par pass.firstView seul
+#ifdef PASS_PER_VIEW
+#define VIEW_INDEX 0
+#else
+#extension GL_EXT_multiview : enable
+#define VIEW_INDEX gl_ViewIndex
+#endif
+#endif
 
 layout(location = 0) out vec3 fragColor;
 
@@ -15,7 +26,26 @@ vec3 colors[3] = vec3[](
     vec3(0.0, 0.0, 1.0)
 );
 
+#ifdef MULTIVIEW
+layout(set = 0, binding = 0) uniform Views {
+    mat4 viewProjection[6];
+} views;
+
+// firstView : vue de base du rendu en une passe par vue (VIEW_INDEX vaut alors 0)
+layout(push_constant) uniform Pass {
+    uint firstView;
+    uint columns;
+} pass;
+#endif
+
 void main() {
+#ifdef MULTIVIEW
+    // Grille de triangles centree sur l'origine, une instance par case
+    vec2 cell = vec2(gl_InstanceIndex % pass.columns, gl_InstanceIndex / pass.columns) - vec2(pass.columns) * 0.5 + 0.5;
+    vec3 world = vec3(positions[gl_VertexIndex] * 0.8 + cell, 0.0);
+    gl_Position = views.viewProjection[VIEW_INDEX + pass.firstView] * vec4(world, 1.0);
+#else
     gl_Position = vec4(positions[gl_VertexIndex], 0.0, 1.0);
+#endif
     fragColor = colors[gl_VertexIndex];
 }
@@ -0,0 +1,566 @@
+#include <AssetStreamer.h>
+#include <Logger.h>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define ASSET_STREAMER_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+
+namespace {
+	constexpr intptr_t INVALID_FILE = -1;
+	// Au-del, io_uring_setup refuse la taille de l'anneau sur les anciens noyaux
+	constexpr uint32_t MAX_QUEUE_DEPTH = 4096;
+	constexpr uint32_t MAX_WORKERS = 64;
+	constexpr uint32_t MIN_BLOCK_SIZE = 4096;
+
+	std::string errorString(int64_t error) {
+#ifdef _WIN32
+		return "error " + std::to_string(error);
+#else
+		return std::strerror(static_cast<int>(error));
+#endif
+	}
+
+	/*
+	 * Ouvre le fichier en lecture et retourne sa taille ; INVALID_FILE en cas d'chec (error renseign)
+	 */
+	intptr_t openFile(const std::string& path, uint64_t& size, std::string& error) {
+#ifdef _WIN32
+		const auto handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+		                                FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (handle == INVALID_HANDLE_VALUE) {
+			error = "Failed to open file: " + path + " (" + errorString(GetLastError()) + ")";
+			return INVALID_FILE;
+		}
+		auto fileSize = LARGE_INTEGER{};
+		if (!GetFileSizeEx(handle, &fileSize)) {
+			error = "Failed to query the size of " + path + " (" + errorString(GetLastError()) + ")";
+			CloseHandle(handle);
+			return INVALID_FILE;
+		}
+		size = static_cast<uint64_t>(fileSize.QuadPart);
+		return reinterpret_cast<intptr_t>(handle);
+#else
+		const auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (fd < 0) {
+			error = "Failed to open file: " + path + " (" + errorString(errno) + ")";
+			return INVALID_FILE;
+		}
+		struct stat status{};
+		if (fstat(fd, &status) != 0) {
+			error = "Failed to query the size of " + path + " (" + errorString(errno) + ")";
+			::close(fd);
+			return INVALID_FILE;
+		}
+		size = static_cast<uint64_t>(status.st_size);
+#ifdef POSIX_FADV_SEQUENTIAL
+		// Lecture anticipe plus agressive du noyau : les blocs d'une requte sont lus dans l'ordre
+		posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+		return fd;
+#endif
+	}
+
+	void closeFile(intptr_t file) {
+#ifdef _WIN32
+		CloseHandle(reinterpret_cast<HANDLE>(file));
+#else
+		::close(static_cast<int>(file));
+#endif
+	}
+
+	/*
+	 * Lecture positionne (sans dplacer de curseur partag) ; retourne les octets lus, moins que size  la fin
+	 * du fichier, ou un code d'erreur ngatif
+	 */
+	int64_t readAt(intptr_t file, char* target, uint32_t size, uint64_t offset) {
+		uint32_t done = 0;
+		while (done < size) {
+#ifdef _WIN32
+			auto overlapped = OVERLAPPED{};
+			overlapped.Offset = static_cast<DWORD>(offset + done);
+			overlapped.OffsetHigh = static_cast<DWORD>((offset + done) >> 32);
+			DWORD read = 0;
+			if (!ReadFile(reinterpret_cast<HANDLE>(file), target + done, size - done, &read, &overlapped)) {
+				const auto error = GetLastError();
+				if (error == ERROR_HANDLE_EOF) { break; }
+				return -static_cast<int64_t>(error);
+			}
+			if (read == 0) { break; }
+			done += read;
+#else
+			const auto read = ::pread(static_cast<int>(file), target + done, size - done, static_cast<off_t>(offset + done));
+			if (read < 0) {
+				if (errno == EINTR) { continue; }
+				return -static_cast<int64_t>(errno);
+			}
+			if (read == 0) { break; }
+			done += static_cast<uint32_t>(read);
+#endif
+		}
+		return done;
+	}
+}
+
+const char* streamBackendName(StreamBackend backend) {
+	switch (backend) {
+	case StreamBackend::IoUring: return "io_uring";
+	case StreamBackend::ThreadPool: return "thread pool";
+	default: return "auto";
+	}
+}
+
+#ifdef ASSET_STREAMER_IO_URING
+/*
+ * Anneaux de soumission et de compltion partags avec le noyau
+ */
+struct CAssetStreamer::IoUring {
+	int fd{-1};
+	void* sqRing{nullptr};
+	size_t sqRingSize{0};
+	void* cqRing{nullptr};
+	size_t cqRingSize{0};
+	io_uring_sqe* sqes{nullptr};
+	size_t sqesSize{0};
+	unsigned* sqTail{nullptr};
+	unsigned* sqArray{nullptr};
+	unsigned sqMask{0};
+	unsigned* cqHead{nullptr};
+	unsigned* cqTail{nullptr};
+	unsigned cqMask{0};
+	io_uring_cqe* cqes{nullptr};
+	// Un vecteur d'entre/sortie par lecture (index dans m_reads)
+	std::vector<iovec> iovecs;
+	// Entres ajoutes  l'anneau et pas encore soumises au noyau
+	unsigned toSubmit{0};
+};
+#else
+struct CAssetStreamer::IoUring {};
+#endif
+
+CAssetStreamer::CAssetStreamer() = default;
+
+CAssetStreamer::~CAssetStreamer() {
+	shutdown();
+}
+
+void CAssetStreamer::init(const AssetStreamerSettings& settings) {
+	if (isActive()) { throw std::runtime_error("Failed to start the asset streamer: already running"); }
+	m_settings = settings;
+	m_settings.queueDepth = std::clamp(m_settings.queueDepth, 1u, MAX_QUEUE_DEPTH);
+	m_settings.blockSize = std::max(m_settings.blockSize, MIN_BLOCK_SIZE);
+	m_stats = AssetStreamerStats{};
+	m_reads = std::vector<Read>(m_settings.queueDepth);
+	m_freeReads.clear();
+	for (auto& read : m_reads) { m_freeReads.push_back(&read); }
+	m_backend = StreamBackend::ThreadPool;
+	if (m_settings.backend != StreamBackend::ThreadPool && initIoUring()) {
+		m_backend = StreamBackend::IoUring;
+	}
+	else {
+		if (m_settings.backend == StreamBackend::IoUring) {
+			CLogger::log(LogLevel::Warning, "Streamer", "io_uring is not available, falling back to the thread pool");
+		}
+		const auto workerCount = std::min(m_settings.queueDepth, MAX_WORKERS);
+		for (uint32_t i = 0; i < workerCount; i++) { m_workers.emplace_back([this] { workerLoop(); }); }
+	}
+	m_ioThread = std::thread{[this] { ioLoop(); }};
+	CLogger::log(LogLevel::Info, "Streamer", std::string{"Backend: "} + streamBackendName(m_backend) + ", queue depth "
+	             + std::to_string(m_settings.queueDepth) + ", block size " + std::to_string(m_settings.blockSize));
+}
+
+void CAssetStreamer::shutdown() {
+	if (!isActive()) { return; }
+	{
+		auto lock = std::lock_guard{m_mutex};
+		m_stop = true;
+		for (auto& [id, request] : m_requests) { cancelRequest(*request); }
+	}
+	m_condition.notify_one();
+	m_ioThread.join();
+	{
+		auto lock = std::lock_guard{m_mutex};
+		m_stopWorkers = true;
+	}
+	m_workerCondition.notify_all();
+	for (auto& worker : m_workers) { worker.join(); }
+	m_workers.clear();
+	destroyIoUring();
+	m_freeReads.clear();
+	m_reads.clear();
+	m_stop = false;
+	m_stopWorkers = false;
+}
+
+uint64_t CAssetStreamer::request(StreamRequest desc) {
+	if (desc.destination != nullptr && desc.size == 0) {
+		throw std::runtime_error("Failed to stream " + desc.path + ": a destination requires a size");
+	}
+	auto lock = std::lock_guard{m_mutex};
+	if (!isActive() || m_stop) { throw std::runtime_error("Failed to stream " + desc.path + ": the streamer is not running"); }
+	auto request = std::make_unique<Request>();
+	request->id = m_nextId++;
+	request->desc = std::move(desc);
+	request->result.id = request->id;
+	auto& queued = *request;
+	m_requests.emplace(queued.id, std::move(request));
+	enqueue(queued);
+	m_condition.notify_one();
+	return queued.id;
+}
+
+bool CAssetStreamer::cancel(uint64_t id) {
+	auto lock = std::lock_guard{m_mutex};
+	const auto it = m_requests.find(id);
+	if (it == m_requests.end() || it->second->cancelled || it->second->finished) { return false; }
+	cancelRequest(*it->second);
+	m_condition.notify_one();
+	return true;
+}
+
+void CAssetStreamer::waitIdle() {
+	auto lock = std::unique_lock{m_mutex};
+	m_idleCondition.wait(lock, [this] { return m_requests.empty(); });
+}
+
+AssetStreamerStats CAssetStreamer::stats() const {
+	auto lock = std::lock_guard{m_mutex};
+	return m_stats;
+}
+
+void CAssetStreamer::enqueue(Request& request) {
+	m_queue.emplace(QueueKey{-static_cast<int>(request.desc.priority), request.id}, &request);
+	request.queued = true;
+}
+
+void CAssetStreamer::dequeue(Request& request) {
+	if (!request.queued) { return; }
+	m_queue.erase(QueueKey{-static_cast<int>(request.desc.priority), request.id});
+	request.queued = false;
+}
+
+void CAssetStreamer::cancelRequest(Request& request) {
+	if (request.cancelled || request.finished) { return; }
+	request.cancelled = true;
+	if (request.result.status == StreamStatus::Completed) { request.result.status = StreamStatus::Cancelled; }
+	dequeue(request);
+	tryFinish(request);
+}
+
+void CAssetStreamer::tryFinish(Request& request) {
+	if (request.finished || request.queued || request.opening || request.readsInFlight > 0) { return; }
+	const auto done = request.cancelled || request.result.status == StreamStatus::Failed
+		|| (request.file != INVALID_FILE && request.next >= request.end);
+	if (!done) { return; }
+	request.finished = true;
+	m_finished.push_back(&request);
+}
+
+void CAssetStreamer::ioLoop() {
+	auto lock = std::unique_lock{m_mutex};
+	while (true) {
+		// Blocs des requtes les plus prioritaires tant que des lectures sont disponibles
+		while (issueNext(lock)) {}
+		deliverFinished(lock);
+		if (m_stop && m_requests.empty()) { break; }
+		// io_uring : l'attente se fait dans le noyau tant que des lectures sont en vol. Une nouvelle requte
+		// attend alors la fin d'une lecture, donc au plus la dure de lecture d'un bloc.
+		if (m_ring != nullptr && m_readsInFlight > 0) {
+			waitIoUring(lock);
+			continue;
+		}
+		m_condition.wait(lock, [this] {
+			return (m_stop && m_requests.empty()) || !m_finished.empty() || !m_doneReads.empty()
+				|| (!m_queue.empty() && !m_freeReads.empty());
+		});
+		// Lectures termines par le pool de threads
+		for (auto* read : m_doneReads) { completeRead(*read); }
+		m_doneReads.clear();
+	}
+}
+
+void CAssetStreamer::workerLoop() {
+	auto lock = std::unique_lock{m_mutex};
+	while (true) {
+		m_workerCondition.wait(lock, [this] { return m_stopWorkers || !m_pendingReads.empty(); });
+		if (m_pendingReads.empty()) { return; }
+		auto* read = m_pendingReads.front();
+		m_pendingReads.pop_front();
+		lock.unlock();
+		read->result = readAt(read->request->file, read->target, read->size, read->offset);
+		lock.lock();
+		m_doneReads.push_back(read);
+		m_condition.notify_one();
+	}
+}
+
+bool CAssetStreamer::issueNext(std::unique_lock<std::mutex>& lock) {
+	if (m_queue.empty() || m_freeReads.empty()) { return false; }
+	auto& request = *m_queue.begin()->second;
+	if (request.file == INVALID_FILE) {
+		// Ouverture hors verrou : request() et cancel() n'attendent pas le systme de fichiers
+		dequeue(request);
+		request.opening = true;
+		lock.unlock();
+		uint64_t fileSize = 0;
+		auto error = std::string{};
+		const auto file = openFile(request.desc.path, fileSize, error);
+		const auto begin = std::min(request.desc.offset, fileSize);
+		const auto end = request.desc.size == 0 ? fileSize : std::min(fileSize, begin + request.desc.size);
+		if (file != INVALID_FILE && request.desc.destination == nullptr) { request.result.data.resize(end - begin); }
+		lock.lock();
+		request.opening = false;
+		if (file == INVALID_FILE) {
+			if (!request.cancelled) {
+				request.result.status = StreamStatus::Failed;
+				request.result.error = std::move(error);
+			}
+			tryFinish(request);
+			return true;
+		}
+		request.file = file;
+		request.next = begin;
+		request.end = end;
+		request.target = request.desc.destination != nullptr ? static_cast<char*>(request.desc.destination)
+		                                                     : request.result.data.data();
+		// Reprend sa place dans la file (mme priorit, mme ordre d'arrive)
+		if (!request.cancelled && request.next < request.end) { enqueue(request); }
+		tryFinish(request);
+		return true;
+	}
+	auto& read = *m_freeReads.back();
+	m_freeReads.pop_back();
+	read.request = &request;
+	read.target = request.target;
+	read.offset = request.next;
+	read.size = static_cast<uint32_t>(std::min<uint64_t>(m_settings.blockSize, request.end - request.next));
+	read.result = 0;
+	request.next += read.size;
+	request.target += read.size;
+	if (request.next >= request.end) { dequeue(request); }
+	request.readsInFlight++;
+	m_readsInFlight++;
+	m_stats.peakReadsInFlight = std::max(m_stats.peakReadsInFlight, m_readsInFlight);
+	submitRead(read);
+	return true;
+}
+
+void CAssetStreamer::submitRead(Read& read) {
+	m_stats.readsIssued++;
+#ifdef ASSET_STREAMER_IO_URING
+	if (m_ring != nullptr) {
+		auto& ring = *m_ring;
+		auto& iov = ring.iovecs[static_cast<size_t>(&read - m_reads.data())];
+		iov.iov_base = read.target;
+		iov.iov_len = read.size;
+		// Seul ce thread crit la queue de l'anneau : le noyau ne lit les entres qu'aprs la publication
+		const auto tail = *ring.sqTail;
+		const auto index = tail & ring.sqMask;
+		auto& sqe = ring.sqes[index];
+		std::memset(&sqe, 0, sizeof(sqe));
+		sqe.opcode = IORING_OP_READV;
+		sqe.fd = static_cast<int>(read.request->file);
+		sqe.off = read.offset;
+		sqe.addr = reinterpret_cast<uint64_t>(&iov);
+		sqe.len = 1;
+		sqe.user_data = reinterpret_cast<uint64_t>(&read);
+		ring.sqArray[index] = index;
+		__atomic_store_n(ring.sqTail, tail + 1, __ATOMIC_RELEASE);
+		ring.toSubmit++;
+		return;
+	}
+#endif
+	m_pendingReads.push_back(&read);
+	m_workerCondition.notify_one();
+}
+
+void CAssetStreamer::completeRead(Read& read) {
+	auto& request = *read.request;
+	if (read.result < 0) {
+		if (!request.cancelled && request.result.status != StreamStatus::Failed) {
+			request.result.status = StreamStatus::Failed;
+			request.result.error = "Failed to read " + request.desc.path + " (" + errorString(-read.result) + ")";
+		}
+		dequeue(request);
+	}
+	else {
+		const auto bytes = static_cast<uint32_t>(read.result);
+		request.result.bytesRead += bytes;
+		m_stats.bytesRead += bytes;
+		// Lecture incomplte : la suite du bloc est redemande, sauf  la fin du fichier (raccourci depuis l'ouverture)
+		if (bytes < read.size && !request.cancelled && request.result.status != StreamStatus::Failed) {
+			if (bytes > 0) {
+				read.target += bytes;
+				read.offset += bytes;
+				read.size -= bytes;
+				read.result = 0;
+				submitRead(read);
+				return;
+			}
+			dequeue(request);
+			request.next = request.end;
+		}
+	}
+	request.readsInFlight--;
+	m_readsInFlight--;
+	m_freeReads.push_back(&read);
+	tryFinish(request);
+}
+
+void CAssetStreamer::deliverFinished(std::unique_lock<std::mutex>& lock) {
+	while (!m_finished.empty()) {
+		auto finished = std::vector<Request*>{};
+		finished.swap(m_finished);
+		lock.unlock();
+		for (auto* request : finished) {
+			if (request->file != INVALID_FILE) {
+				closeFile(request->file);
+				request->file = INVALID_FILE;
+			}
+			auto& result = request->result;
+			if (request->desc.destination == nullptr) { result.data.resize(result.bytesRead); }
+			if (result.status == StreamStatus::Failed) { CLogger::log(LogLevel::Warning, "Streamer", result.error); }
+			if (!request->desc.callback) { continue; }
+			try {
+				request->desc.callback(result);
+			}
+			catch (const std::exception& e) {
+				CLogger::log(LogLevel::Error, "Streamer", "Stream callback failed: " + std::string{e.what()});
+			}
+		}
+		lock.lock();
+		for (auto* request : finished) {
+			switch (request->result.status) {
+			case StreamStatus::Completed: m_stats.requestsCompleted++; break;
+			case StreamStatus::Cancelled: m_stats.requestsCancelled++; break;
+			case StreamStatus::Failed: m_stats.requestsFailed++; break;
+			}
+			m_requests.erase(request->id);
+		}
+		m_idleCondition.notify_all();
+	}
+}
+
+bool CAssetStreamer::initIoUring() {
+#ifdef ASSET_STREAMER_IO_URING
+	auto params = io_uring_params{};
+	const auto fd = static_cast<int>(syscall(__NR_io_uring_setup, m_settings.queueDepth, &params));
+	if (fd < 0) {
+		CLogger::log(LogLevel::Info, "Streamer", "io_uring_setup failed (" + errorString(errno) + ")");
+		return false;
+	}
+	m_ring = std::make_unique<IoUring>();
+	auto& ring = *m_ring;
+	ring.fd = fd;
+	ring.iovecs.resize(m_settings.queueDepth);
+	ring.sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+	ring.cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+	// Noyaux rcents : les deux anneaux partagent une seule projection
+	const auto singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+	if (singleMmap) { ring.sqRingSize = ring.cqRingSize = std::max(ring.sqRingSize, ring.cqRingSize); }
+	const auto map = [fd](size_t size, off_t offset) -> void* {
+		const auto address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+		return address == MAP_FAILED ? nullptr : address;
+	};
+	ring.sqRing = map(ring.sqRingSize, IORING_OFF_SQ_RING);
+	ring.cqRing = singleMmap ? ring.sqRing : map(ring.cqRingSize, IORING_OFF_CQ_RING);
+	ring.sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+	ring.sqes = static_cast<io_uring_sqe*>(map(ring.sqesSize, IORING_OFF_SQES));
+	if (ring.sqRing == nullptr || ring.cqRing == nullptr || ring.sqes == nullptr) {
+		CLogger::log(LogLevel::Info, "Streamer", "Failed to map the io_uring rings");
+		destroyIoUring();
+		return false;
+	}
+	auto* sq = static_cast<char*>(ring.sqRing);
+	ring.sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+	ring.sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+	ring.sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+	auto* cq = static_cast<char*>(ring.cqRing);
+	ring.cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+	ring.cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+	ring.cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+	ring.cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+	return true;
+#else
+	return false;
+#endif
+}
+
+void CAssetStreamer::destroyIoUring() {
+#ifdef ASSET_STREAMER_IO_URING
+	if (m_ring == nullptr) { return; }
+	auto& ring = *m_ring;
+	if (ring.sqes != nullptr) { munmap(ring.sqes, ring.sqesSize); }
+	if (ring.cqRing != nullptr && ring.cqRing != ring.sqRing) { munmap(ring.cqRing, ring.cqRingSize); }
+	if (ring.sqRing != nullptr) { munmap(ring.sqRing, ring.sqRingSize); }
+	::close(ring.fd);
+#endif
+	m_ring.reset();
+}
+
+void CAssetStreamer::waitIoUring(std::unique_lock<std::mutex>& lock) {
+#ifdef ASSET_STREAMER_IO_URING
+	auto& ring = *m_ring;
+	auto pending = ring.toSubmit;
+	ring.toSubmit = 0;
+	lock.unlock();
+	auto error = 0;
+	while (true) {
+		const auto result = syscall(__NR_io_uring_enter, ring.fd, pending, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+		if (result >= 0) {
+			pending -= std::min(static_cast<unsigned>(result), pending);
+			if (pending == 0) { break; }
+			continue;
+		}
+		if (errno == EINTR) { continue; }
+		// Anneau de compltion plein : les fins disponibles sont traites avant de soumettre le reste
+		if (errno != EAGAIN && errno != EBUSY) { error = errno; }
+		break;
+	}
+	lock.lock();
+	ring.toSubmit += pending;
+	if (error != 0 && pending > 0) {
+		// Entres refuses par le noyau : retires de l'anneau et termines en chec
+		CLogger::log(LogLevel::Error, "Streamer", "io_uring_enter failed (" + errorString(error) + ")");
+		const auto tail = *ring.sqTail;
+		auto rejected = std::vector<Read*>{};
+		for (unsigned i = 1; i <= pending; i++) {
+			rejected.push_back(reinterpret_cast<Read*>(ring.sqes[ring.sqArray[(tail - i) & ring.sqMask]].user_data));
+		}
+		__atomic_store_n(ring.sqTail, tail - pending, __ATOMIC_RELEASE);
+		ring.toSubmit = 0;
+		for (auto* read : rejected) {
+			read->result = -error;
+			completeRead(*read);
+		}
+	}
+	auto head = *ring.cqHead;
+	const auto tail = __atomic_load_n(ring.cqTail, __ATOMIC_ACQUIRE);
+	while (head != tail) {
+		const auto& cqe = ring.cqes[head & ring.cqMask];
+		auto& read = *reinterpret_cast<Read*>(cqe.user_data);
+		read.result = cqe.res;
+		head++;
+		completeRead(read);
+	}
+	__atomic_store_n(ring.cqHead, head, __ATOMIC_RELEASE);
+#else
+	(void)lock;
+#endif
+}
@@ -0,0 +1,350 @@
+#include <ClusteredLighting.h>
+#include <ShaderLoader.h>
+#include <Logger.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+namespace {
+	// Clusters traits par groupe de travail (local_size_x de lighting_cull.comp)
+	constexpr uint32_t CULLING_WORKGROUP_SIZE = 64;
+	// Timestamps par frame : dbut de la rpartition, fin de la rpartition, fin de la passe claire
+	constexpr uint32_t TIMESTAMP_BEGIN = 0;
+	constexpr uint32_t TIMESTAMP_CULLED = 1;
+	constexpr uint32_t TIMESTAMP_END = 2;
+
+	/*
+	 * Paramtres de la frame (uniform buffer, disposition std140)
+	 */
+	struct ClusterParameters {
+		Mat4 view;
+		// P00, P11 de la projection, profondeur de la premire tranche, log(farDepth / nearDepth)
+		float projection[4];
+		float eye[4];
+		// gridX, gridY, gridZ, nombre de lumires
+		uint32_t grid[4];
+		// Taille de la liste d'indices
+		uint32_t limits[4];
+	};
+}
+
+void CClusteredLighting::init(const DeviceContext& context, uint32_t queueFamily, uint32_t frameCount,
+                              const LightingSettings& settings, const Vec3& boundsMin, const Vec3& boundsMax) {
+	uint32_t queueFamilyCount = 0;
+	vkGetPhysicalDeviceQueueFamilyProperties(context.physicalDevice, &queueFamilyCount, nullptr);
+	std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+	vkGetPhysicalDeviceQueueFamilyProperties(context.physicalDevice, &queueFamilyCount, queueFamilies.data());
+	// Rpartition et dessin sur la mme queue : pas de transfert de proprit des buffers
+	if (!(queueFamilies[queueFamily].queueFlags & VK_QUEUE_COMPUTE_BIT)) {
+		throw std::runtime_error("Failed to find compute support on the graphics queue");
+	}
+	if (settings.lightCount == 0 || settings.maxLightsPerCluster == 0 || settings.gridX == 0 || settings.gridY == 0
+		|| settings.gridZ == 0 || settings.nearDepth <= 0.0f || settings.farDepth <= settings.nearDepth) {
+		throw std::runtime_error("Invalid clustered lighting settings");
+	}
+	const auto indexCapacity = settings.gridX * settings.gridY * settings.gridZ * std::max(settings.averageLightsPerCluster, 1u);
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(context.physicalDevice, &properties);
+	if (static_cast<VkDeviceSize>(settings.lightCount) * sizeof(Light) > properties.limits.maxStorageBufferRange
+		|| static_cast<VkDeviceSize>(indexCapacity) * sizeof(uint32_t) > properties.limits.maxStorageBufferRange) {
+		throw std::runtime_error("Light count exceeds maxStorageBufferRange");
+	}
+	m_context = context;
+	m_settings = settings;
+	m_indexCapacity = indexCapacity;
+	createLights(boundsMin, boundsMax);
+	m_frames.resize(frameCount);
+	for (auto& frame : m_frames) { createFrameResources(frame); }
+	createDescriptors();
+	createComputePipeline();
+	m_timer.init(m_context, queueFamily, frameCount, 3);
+	m_totalCullingMs = 0.0;
+	m_totalShadingMs = 0.0;
+	m_measuredFrames = 0;
+	m_totalAllocatedIndices = 0;
+	m_culledFrames = 0;
+	m_maxLightsPerCluster = 0;
+	m_overflowedClusters = 0;
+	CLogger::log(LogLevel::Info, "Lighting", std::to_string(settings.lightCount) + " lights, "
+	             + (settings.bruteForce ? std::string{"brute force"} : std::to_string(clusterCount()) + " clusters ("
+	             + std::to_string(settings.gridX) + "x" + std::to_string(settings.gridY) + "x" + std::to_string(settings.gridZ) + ")"));
+}
+
+void CClusteredLighting::cleanup() {
+	if (m_context.device == VK_NULL_HANDLE) { return; }
+	m_timer.cleanup();
+	vkDestroyPipeline(m_context.device, m_cullingPipeline, m_context.allocator);
+	vkDestroyPipelineLayout(m_context.device, m_pipelineLayout, m_context.allocator);
+	vkDestroyDescriptorPool(m_context.device, m_descriptorPool, m_context.allocator);
+	vkDestroyDescriptorSetLayout(m_context.device, m_descriptorSetLayout, m_context.allocator);
+	for (auto& frame : m_frames) {
+		vkUnmapMemory(m_context.device, frame.parametersMemory);
+		vkUnmapMemory(m_context.device, frame.stagingMemory);
+		vkUnmapMemory(m_context.device, frame.readbackMemory);
+		destroyBuffer(m_context, frame.parametersBuffer, frame.parametersMemory);
+		destroyBuffer(m_context, frame.stagingBuffer, frame.stagingMemory);
+		destroyBuffer(m_context, frame.lightsBuffer, frame.lightsMemory);
+		destroyBuffer(m_context, frame.clustersBuffer, frame.clustersMemory);
+		destroyBuffer(m_context, frame.indicesBuffer, frame.indicesMemory);
+		destroyBuffer(m_context, frame.statisticsBuffer, frame.statisticsMemory);
+		destroyBuffer(m_context, frame.readbackBuffer, frame.readbackMemory);
+	}
+	m_frames.clear();
+	m_cullingPipeline = VK_NULL_HANDLE;
+	m_pipelineLayout = VK_NULL_HANDLE;
+	m_descriptorPool = VK_NULL_HANDLE;
+	m_descriptorSetLayout = VK_NULL_HANDLE;
+	m_context.device = VK_NULL_HANDLE;
+}
+
+void CClusteredLighting::createLights(const Vec3& boundsMin, const Vec3& boundsMax) {
+	// Rpartition reproductible : les mesures restent comparables d'une excution  l'autre
+	std::mt19937 rng{7};
+	std::uniform_real_distribution<float> unit{0.0f, 1.0f};
+	const auto count = static_cast<size_t>(m_settings.lightCount);
+	m_lightCenters.resize(count);
+	m_lightOrbits.resize(count);
+	m_lightColors.resize(count);
+	for (size_t i = 0; i < count; i++) {
+		m_lightCenters[i] = {
+			boundsMin.x + (boundsMax.x - boundsMin.x) * unit(rng),
+			boundsMin.y + (boundsMax.y - boundsMin.y) * unit(rng),
+			boundsMin.z + (boundsMax.z - boundsMin.z) * unit(rng)
+		};
+		const auto direction = unit(rng) < 0.5f ? -1.0f : 1.0f;
+		m_lightOrbits[i] = { 0.5f + 2.0f * unit(rng), direction * (0.3f + 0.9f * unit(rng)), 6.2831853f * unit(rng), 0.5f * unit(rng) };
+		// Couleur sature d'intensit constante (composante la plus forte  1)
+		auto color = Vec3{ unit(rng), unit(rng), unit(rng) };
+		const auto strongest = std::max({ color.x, color.y, color.z, 1e-3f });
+		m_lightColors[i] = color * (1.0f / strongest);
+	}
+}
+
+void CClusteredLighting::createFrameResources(FrameResources& frame) {
+	const auto hostVisible = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+	const auto lightsSize = static_cast<VkDeviceSize>(m_settings.lightCount) * sizeof(Light);
+	createBuffer(m_context, sizeof(ClusterParameters), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, hostVisible,
+	             frame.parametersBuffer, frame.parametersMemory);
+	vkMapMemory(m_context.device, frame.parametersMemory, 0, sizeof(ClusterParameters), 0, &frame.parameters);
+	// Lumires crites par le CPU, copies dans un buffer DEVICE_LOCAL lu par la rpartition et par chaque pixel
+	createBuffer(m_context, lightsSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, hostVisible, frame.stagingBuffer,
+	             frame.stagingMemory, MemoryCategory::Staging);
+	void* staging;
+	vkMapMemory(m_context.device, frame.stagingMemory, 0, lightsSize, 0, &staging);
+	frame.staging = static_cast<Light*>(staging);
+	createBuffer(m_context, lightsSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+	             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, frame.lightsBuffer, frame.lightsMemory);
+	// Plage (dbut, nombre) de chaque cluster dans la liste d'indices
+	createBuffer(m_context, static_cast<VkDeviceSize>(clusterCount()) * 2 * sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+	             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, frame.clustersBuffer, frame.clustersMemory);
+	createBuffer(m_context, static_cast<VkDeviceSize>(m_indexCapacity) * sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+	             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, frame.indicesBuffer, frame.indicesMemory);
+	createBuffer(m_context, sizeof(ClusterStatistics), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT
+	             | VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, frame.statisticsBuffer, frame.statisticsMemory);
+	createBuffer(m_context, sizeof(ClusterStatistics), VK_BUFFER_USAGE_TRANSFER_DST_BIT, hostVisible, frame.readbackBuffer,
+	             frame.readbackMemory, MemoryCategory::Staging);
+	void* readback;
+	vkMapMemory(m_context.device, frame.readbackMemory, 0, sizeof(ClusterStatistics), 0, &readback);
+	frame.readback = static_cast<const ClusterStatistics*>(readback);
+	frame.pending = false;
+}
+
+void CClusteredLighting::createDescriptors() {
+	// 0 : paramtres, 1 : lumires, 2 : plages des clusters, 3 : liste d'indices, 4 : compteurs (rpartition seulement)
+	VkDescriptorSetLayoutBinding bindings[5] = {};
+	for (uint32_t i = 0; i < 5; i++) {
+		bindings[i].binding = i;
+		bindings[i].descriptorType = i == 0 ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		bindings[i].descriptorCount = 1;
+		bindings[i].stageFlags = i == 4 ? VK_SHADER_STAGE_COMPUTE_BIT : VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+	}
+	auto layoutInfo = VkDescriptorSetLayoutCreateInfo{};
+	layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+	layoutInfo.bindingCount = 5;
+	layoutInfo.pBindings = bindings;
+	if (vkCreateDescriptorSetLayout(m_context.device, &layoutInfo, m_context.allocator, &m_descriptorSetLayout) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create the lighting descriptor set layout");
+	}
+	const auto frameCount = static_cast<uint32_t>(m_frames.size());
+	VkDescriptorPoolSize poolSizes[2] = {
+		{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, frameCount },
+		{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4 * frameCount }
+	};
+	auto poolInfo = VkDescriptorPoolCreateInfo{};
+	poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	poolInfo.maxSets = frameCount;
+	poolInfo.poolSizeCount = 2;
+	poolInfo.pPoolSizes = poolSizes;
+	if (vkCreateDescriptorPool(m_context.device, &poolInfo, m_context.allocator, &m_descriptorPool) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create the lighting descriptor pool");
+	}
+	const auto layouts = std::vector<VkDescriptorSetLayout>(frameCount, m_descriptorSetLayout);
+	auto sets = std::vector<VkDescriptorSet>(frameCount);
+	auto allocInfo = VkDescriptorSetAllocateInfo{};
+	allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	allocInfo.descriptorPool = m_descriptorPool;
+	allocInfo.descriptorSetCount = frameCount;
+	allocInfo.pSetLayouts = layouts.data();
+	if (vkAllocateDescriptorSets(m_context.device, &allocInfo, sets.data()) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to allocate the lighting descriptor sets");
+	}
+	for (uint32_t f = 0; f < frameCount; f++) {
+		auto& frame = m_frames[f];
+		frame.descriptorSet = sets[f];
+		VkDescriptorBufferInfo bufferInfos[5] = {
+			{ frame.parametersBuffer, 0, VK_WHOLE_SIZE },
+			{ frame.lightsBuffer, 0, VK_WHOLE_SIZE },
+			{ frame.clustersBuffer, 0, VK_WHOLE_SIZE },
+			{ frame.indicesBuffer, 0, VK_WHOLE_SIZE },
+			{ frame.statisticsBuffer, 0, VK_WHOLE_SIZE }
+		};
+		VkWriteDescriptorSet writes[5] = {};
+		for (uint32_t i = 0; i < 5; i++) {
+			writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			writes[i].dstSet = frame.descriptorSet;
+			writes[i].dstBinding = i;
+			writes[i].descriptorCount = 1;
+			writes[i].descriptorType = bindings[i].descriptorType;
+			writes[i].pBufferInfo = &bufferInfos[i];
+		}
+		vkUpdateDescriptorSets(m_context.device, 5, writes, 0, nullptr);
+	}
+	auto pipelineLayoutInfo = VkPipelineLayoutCreateInfo{};
+	pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+	pipelineLayoutInfo.setLayoutCount = 1;
+	pipelineLayoutInfo.pSetLayouts = &m_descriptorSetLayout;
+	if (vkCreatePipelineLayout(m_context.device, &pipelineLayoutInfo, m_context.allocator, &m_pipelineLayout) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create the lighting pipeline layout");
+	}
+}
+
+void CClusteredLighting::createComputePipeline() {
+	const auto shaderModule = createShaderModule(m_context, CShaderLoader::readFile("shaders/lighting_cull_comp.spv"));
+	// constant_id = 0 : taille de la liste prive de chaque cluster
+	auto specializationEntry = VkSpecializationMapEntry{ 0, 0, sizeof(uint32_t) };
+	auto specializationInfo = VkSpecializationInfo{};
+	specializationInfo.mapEntryCount = 1;
+	specializationInfo.pMapEntries = &specializationEntry;
+	specializationInfo.dataSize = sizeof(uint32_t);
+	specializationInfo.pData = &m_settings.maxLightsPerCluster;
+	auto pipelineInfo = VkComputePipelineCreateInfo{};
+	pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+	pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+	pipelineInfo.stage.module = shaderModule;
+	pipelineInfo.stage.pName = "main";
+	pipelineInfo.stage.pSpecializationInfo = &specializationInfo;
+	pipelineInfo.layout = m_pipelineLayout;
+	const auto result = vkCreateComputePipelines(m_context.device, VK_NULL_HANDLE, 1, &pipelineInfo, m_context.allocator,
+	                                             &m_cullingPipeline);
+	vkDestroyShaderModule(m_context.device, shaderModule, m_context.allocator);
+	if (result != VK_SUCCESS) { throw std::runtime_error("Failed to create the light culling pipeline"); }
+}
+
+void CClusteredLighting::update(uint32_t frame, double time, const Mat4& view, const Mat4& projection, const Vec3& eye) {
+	auto& resources = m_frames[frame];
+	resources.pending = true;
+	for (size_t i = 0; i < m_lightCenters.size(); i++) {
+		const auto& center = m_lightCenters[i];
+		const auto& orbit = m_lightOrbits[i];
+		const auto angle = static_cast<float>(std::fmod(static_cast<double>(orbit.y) * time + static_cast<double>(orbit.z), 6.283185307179586));
+		const auto& color = m_lightColors[i];
+		resources.staging[i] = {
+			{ center.x + orbit.x * std::cos(angle), center.y + orbit.w * std::sin(2.0f * angle), center.z + orbit.x * std::sin(angle),
+			  m_settings.lightRadius },
+			{ color.x, color.y, color.z, 1.0f }
+		};
+	}
+	auto parameters = ClusterParameters{};
+	parameters.view = view;
+	parameters.projection[0] = projection.at(0, 0);
+	parameters.projection[1] = projection.at(1, 1);
+	parameters.projection[2] = m_settings.nearDepth;
+	parameters.projection[3] = std::log(m_settings.farDepth / m_settings.nearDepth);
+	parameters.eye[0] = eye.x;
+	parameters.eye[1] = eye.y;
+	parameters.eye[2] = eye.z;
+	parameters.grid[0] = m_settings.gridX;
+	parameters.grid[1] = m_settings.gridY;
+	parameters.grid[2] = m_settings.gridZ;
+	parameters.grid[3] = m_settings.lightCount;
+	parameters.limits[0] = m_indexCapacity;
+	std::memcpy(resources.parameters, &parameters, sizeof(parameters));
+}
+
+void CClusteredLighting::recordCulling(VkCommandBuffer commandBuffer, uint32_t frame) {
+	const auto& resources = m_frames[frame];
+	const auto* dispatch = m_context.dispatch;
+	auto copy = VkBufferCopy{ 0, 0, static_cast<VkDeviceSize>(m_settings.lightCount) * sizeof(Light) };
+	dispatch->CmdCopyBuffer(commandBuffer, resources.stagingBuffer, resources.lightsBuffer, 1, &copy);
+	dispatch->CmdFillBuffer(commandBuffer, resources.statisticsBuffer, 0, VK_WHOLE_SIZE, 0);
+	// Lumires et compteurs crits avant d'tre lus par la rpartition et par les pixels
+	auto barrier = VkMemoryBarrier{};
+	barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+	dispatch->CmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+	                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+	                             0, 1, &barrier, 0, nullptr, 0, nullptr);
+	if (m_timer.isSupported()) {
+		m_timer.reset(commandBuffer, frame);
+		m_timer.write(commandBuffer, frame, TIMESTAMP_BEGIN, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+	}
+	if (!m_settings.bruteForce) {
+		dispatch->CmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_cullingPipeline);
+		dispatch->CmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipelineLayout, 0, 1,
+		                                &resources.descriptorSet, 0, nullptr);
+		dispatch->CmdDispatch(commandBuffer, (clusterCount() + CULLING_WORKGROUP_SIZE - 1) / CULLING_WORKGROUP_SIZE, 1, 1);
+	}
+	if (m_timer.isSupported()) {
+		m_timer.write(commandBuffer, frame, TIMESTAMP_CULLED, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+	}
+	if (m_settings.bruteForce) { return; }
+	// Listes des clusters lues par les pixels, compteurs recopis pour le CPU
+	barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+	barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT;
+	dispatch->CmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+	                             VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+	                             0, 1, &barrier, 0, nullptr, 0, nullptr);
+	copy.size = sizeof(ClusterStatistics);
+	dispatch->CmdCopyBuffer(commandBuffer, resources.statisticsBuffer, resources.readbackBuffer, 1, &copy);
+	barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+	dispatch->CmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+	                             0, 1, &barrier, 0, nullptr, 0, nullptr);
+}
+
+void CClusteredLighting::recordShadingEnd(VkCommandBuffer commandBuffer, uint32_t frame) {
+	if (m_timer.isSupported()) {
+		m_timer.write(commandBuffer, frame, TIMESTAMP_END, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+	}
+}
+
+void CClusteredLighting::onFrameCompleted(uint32_t frame) {
+	auto& resources = m_frames[frame];
+	if (!resources.pending) { return; }
+	resources.pending = false;
+	if (m_timer.isSupported() && m_timer.resolve(frame)) {
+		m_totalCullingMs += m_timer.elapsedMs(frame, TIMESTAMP_BEGIN, TIMESTAMP_CULLED);
+		m_totalShadingMs += m_timer.elapsedMs(frame, TIMESTAMP_CULLED, TIMESTAMP_END);
+		m_measuredFrames++;
+	}
+	if (m_settings.bruteForce) { return; }
+	const auto statistics = *resources.readback;
+	m_totalAllocatedIndices += std::min(statistics.allocatedIndices, m_indexCapacity);
+	m_culledFrames++;
+	m_maxLightsPerCluster = std::max(m_maxLightsPerCluster, statistics.maxLightsPerCluster);
+	if (statistics.overflowedClusters > 0 && m_overflowedClusters == 0) {
+		CLogger::log(LogLevel::Warning, "Lighting", std::to_string(statistics.overflowedClusters)
+		             + " clusters dropped lights: raise maxLightsPerCluster or averageLightsPerCluster");
+	}
+	m_overflowedClusters += statistics.overflowedClusters;
+}
+
+double CClusteredLighting::averageLightsPerCluster() const {
+	if (m_culledFrames == 0) { return 0.0; }
+	return static_cast<double>(m_totalAllocatedIndices) / static_cast<double>(m_culledFrames) / static_cast<double>(clusterCount());
+}
@@ -0,0 +1,176 @@
+#include <CommandTrace.h>
+#include <limits>
+
+/*************************
+	criture
+**************************/
+
+void CCommandTraceWriter::open(const std::string& path, VkFormat format, VkExtent2D extent) {
+	m_file.open(path, std::ios::binary | std::ios::trunc);
+	if (!m_file.is_open()) { throw std::runtime_error("Failed to open the command trace " + path); }
+	auto header = TraceHeader{};
+	header.format = static_cast<uint32_t>(format);
+	header.width = extent.width;
+	header.height = extent.height;
+	m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	m_bytesWritten = sizeof(header);
+	m_knownPipelines.clear();
+	m_start = std::chrono::steady_clock::now();
+}
+
+void CCommandTraceWriter::close() {
+	if (!m_file.is_open()) { return; }
+	m_file.close();
+}
+
+void CCommandTraceWriter::shaderModule(VkShaderModule module, VkShaderStageFlagBits stage, const std::vector<char>& code) {
+	if (!isActive()) { return; }
+	const auto record = TraceShaderModule{ traceId(module), static_cast<uint32_t>(stage), static_cast<uint32_t>(code.size()) };
+	write(TraceOp::ShaderModule, record, code.data(), code.size());
+}
+
+void CCommandTraceWriter::pipelineState(const GraphicsPipelineState& state) {
+	if (!isActive()) { return; }
+	auto record = TracePipelineState{};
+	record.vertexShader = traceId(state.vertexShader);
+	record.fragmentShader = traceId(state.fragmentShader);
+	record.topology = static_cast<uint32_t>(state.inputAssembly.topology);
+	record.polygonMode = static_cast<uint32_t>(state.rasterizer.polygonMode);
+	record.cullMode = state.rasterizer.cullMode;
+	record.frontFace = static_cast<uint32_t>(state.rasterizer.frontFace);
+	record.samples = static_cast<uint32_t>(state.multisampling.rasterizationSamples);
+	record.colorWriteMask = state.colorBlendAttachment.colorWriteMask;
+	record.blendEnable = state.colorBlendAttachment.blendEnable;
+	record.lineWidth = state.rasterizer.lineWidth;
+	write(TraceOp::PipelineState, record);
+	m_knownPipelines.clear();
+}
+
+void CCommandTraceWriter::buffer(VkBuffer buffer, VkDeviceSize size, VkBufferUsageFlags usage) {
+	if (!isActive()) { return; }
+	write(TraceOp::Buffer, TraceBuffer{ traceId(buffer), size, usage, 0 });
+}
+
+void CCommandTraceWriter::bufferData(VkBuffer buffer, VkDeviceSize offset, const void* data, VkDeviceSize size) {
+	if (!isActive() || size == 0) { return; }
+	write(TraceOp::BufferData, TraceBufferData{ traceId(buffer), offset, size }, data, static_cast<size_t>(size));
+}
+
+void CCommandTraceWriter::beginCommandBuffer(VkCommandBuffer commandBuffer) {
+	if (!isActive()) { return; }
+	write(TraceOp::BeginCommandBuffer, traceId(commandBuffer));
+}
+
+void CCommandTraceWriter::beginRenderPass(VkExtent2D extent, const VkClearValue& clearValue) {
+	if (!isActive()) { return; }
+	auto record = TraceRenderPass{};
+	record.width = extent.width;
+	record.height = extent.height;
+	for (int i = 0; i < 4; i++) { record.clearColor[i] = clearValue.color.float32[i]; }
+	write(TraceOp::BeginRenderPass, record);
+}
+
+void CCommandTraceWriter::setViewport(const VkViewport& viewport) {
+	if (!isActive()) { return; }
+	write(TraceOp::SetViewport, viewport);
+}
+
+void CCommandTraceWriter::setScissor(const VkRect2D& scissor) {
+	if (!isActive()) { return; }
+	write(TraceOp::SetScissor, scissor);
+}
+
+void CCommandTraceWriter::bindPipeline(VkPipeline pipeline, const PipelineVariantKey* key) {
+	if (!isActive()) { return; }
+	const auto id = traceId(pipeline);
+	if (m_knownPipelines.insert(id).second) {
+		auto record = TracePipeline{};
+		record.id = id;
+		record.specialized = key != nullptr ? 1 : 0;
+		for (uint32_t i = 0; key != nullptr && i < PipelineVariantKey::MAX_CONSTANTS; i++) { record.constants[i] = key->constants[i]; }
+		write(TraceOp::Pipeline, record);
+	}
+	write(TraceOp::BindPipeline, id);
+}
+
+void CCommandTraceWriter::draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance) {
+	if (!isActive()) { return; }
+	write(TraceOp::Draw, TraceDraw{ vertexCount, instanceCount, firstVertex, firstInstance });
+}
+
+void CCommandTraceWriter::endRenderPass() {
+	if (!isActive()) { return; }
+	writeRecord(TraceOp::EndRenderPass, nullptr, 0, nullptr, 0);
+}
+
+void CCommandTraceWriter::endCommandBuffer() {
+	if (!isActive()) { return; }
+	writeRecord(TraceOp::EndCommandBuffer, nullptr, 0, nullptr, 0);
+}
+
+void CCommandTraceWriter::submit(const VkSubmitInfo* submits, uint32_t submitCount) {
+	if (!isActive()) { return; }
+	const auto timeNs = elapsedNs();
+	std::vector<uint64_t> ids;
+	for (uint32_t i = 0; i < submitCount; i++) {
+		const auto& submitInfo = submits[i];
+		ids.clear();
+		for (uint32_t c = 0; c < submitInfo.commandBufferCount; c++) { ids.push_back(traceId(submitInfo.pCommandBuffers[c])); }
+		for (uint32_t w = 0; w < submitInfo.waitSemaphoreCount; w++) { ids.push_back(traceId(submitInfo.pWaitSemaphores[w])); }
+		for (uint32_t s = 0; s < submitInfo.signalSemaphoreCount; s++) { ids.push_back(traceId(submitInfo.pSignalSemaphores[s])); }
+		const auto record = TraceSubmit{ timeNs, submitInfo.commandBufferCount, submitInfo.waitSemaphoreCount,
+		                                 submitInfo.signalSemaphoreCount, i + 1 == submitCount ? 1u : 0u };
+		write(TraceOp::Submit, record, ids.data(), ids.size() * sizeof(uint64_t));
+	}
+}
+
+void CCommandTraceWriter::present() {
+	if (!isActive()) { return; }
+	write(TraceOp::Present, TracePresent{ elapsedNs() });
+}
+
+void CCommandTraceWriter::writeRecord(TraceOp op, const void* data, size_t size, const void* extra, size_t extraSize) {
+	const auto total = size + extraSize;
+	if (total > std::numeric_limits<uint32_t>::max()) { throw std::runtime_error("Failed to trace a record larger than 4 GiB"); }
+	const auto recordSize = static_cast<uint32_t>(total);
+	m_file.put(static_cast<char>(op));
+	m_file.write(reinterpret_cast<const char*>(&recordSize), sizeof(recordSize));
+	if (size > 0) { m_file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size)); }
+	if (extraSize > 0) { m_file.write(static_cast<const char*>(extra), static_cast<std::streamsize>(extraSize)); }
+	m_bytesWritten += 1 + sizeof(recordSize) + total;
+}
+
+uint64_t CCommandTraceWriter::elapsedNs() const {
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count());
+}
+
+/*************************
+	Lecture
+**************************/
+
+void CCommandTraceReader::open(const std::string& path) {
+	auto file = std::ifstream{ path, std::ios::binary | std::ios::ate };
+	if (!file.is_open()) { throw std::runtime_error("Failed to open the command trace " + path); }
+	const auto size = static_cast<size_t>(file.tellg());
+	m_content.resize(size);
+	file.seekg(0);
+	file.read(m_content.data(), static_cast<std::streamsize>(size));
+	if (!file || size < sizeof(TraceHeader)) { throw std::runtime_error("Failed to read the command trace " + path); }
+	std::memcpy(&m_header, m_content.data(), sizeof(TraceHeader));
+	if (m_header.magic != TRACE_MAGIC || m_header.version != TRACE_VERSION) {
+		throw std::runtime_error("Failed to read the command trace " + path + ": unknown format or version");
+	}
+	rewind();
+}
+
+bool CCommandTraceReader::next(TraceRecord& record) {
+	constexpr auto recordHeaderSize = 1 + sizeof(uint32_t);
+	if (m_position + recordHeaderSize > m_content.size()) { return false; }
+	record.op = static_cast<TraceOp>(m_content[m_position]);
+	std::memcpy(&record.size, m_content.data() + m_position + 1, sizeof(uint32_t));
+	// Trace interrompue (application arrte pendant l'criture) : le dernier enregistrement est ignor
+	if (m_position + recordHeaderSize + record.size > m_content.size()) { return false; }
+	record.data = m_content.data() + m_position + recordHeaderSize;
+	m_position += recordHeaderSize + record.size;
+	return true;
+}
@@ -0,0 +1,60 @@
+#include <Benchmarks.h>
+#include <FrustumCulling.h>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+namespace {
+	/*
+	 * Scne alatoire : objets rpartis dans un cube de 200 units autour de la camra
+	 */
+	BoundingVolumes makeRandomVolumes(size_t count) {
+		auto volumes = BoundingVolumes{};
+		volumes.reserve(count);
+		std::mt19937 rng{1234};
+		std::uniform_real_distribution<float> position{-100.0f, 100.0f};
+		std::uniform_real_distribution<float> extent{0.1f, 2.0f};
+		for (size_t i = 0; i < count; i++) {
+			const auto center = Vec3{ position(rng), position(rng), position(rng) };
+			const auto half = Vec3{ extent(rng), extent(rng), extent(rng) };
+			volumes.add(center - half, center + half);
+		}
+		return volumes;
+	}
+}
+
+int runCullingBenchmark() {
+	CJobSystem jobSystem;
+	CFrustumCuller culler{jobSystem};
+	const auto viewProjection = perspective(1.0f, 16.0f / 9.0f, 0.1f, 150.0f)
+			* lookAt({ 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, -1.0f }, { 0.0f, 1.0f, 0.0f });
+	const auto frustum = FrustumPlanes::fromViewProjection(viewProjection);
+	const auto bestKernel = CFrustumCuller::detectBestKernel();
+	std::cout << "[Culling benchmark] " << jobSystem.concurrency() << " threads, best kernel: "
+			<< cullingKernelName(bestKernel) << std::endl;
+	std::vector<uint32_t> visible;
+	for (size_t count : { size_t{10000}, size_t{100000}, size_t{1000000}, size_t{10000000} }) {
+		const auto volumes = makeRandomVolumes(count);
+		// Assez d'itrations pour mesurer au moins ~50M de tests
+		const auto iterations = std::max<size_t>(3, 50000000 / count);
+		for (auto kernel : { CullingKernel::Scalar, CullingKernel::SSE, CullingKernel::AVX2 }) {
+			if (kernel > bestKernel) { continue; }
+			culler.setKernel(kernel);
+			for (auto boxes : { false, true }) {
+				size_t visibleCount = 0;
+				const auto start = std::chrono::steady_clock::now();
+				for (size_t i = 0; i < iterations; i++) {
+					visibleCount = boxes ? culler.cullBoxes(frustum, volumes, visible)
+					                     : culler.cullSpheres(frustum, volumes, visible);
+				}
+				const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+				const auto rate = static_cast<double>(count * iterations) / seconds;
+				std::cout << std::setw(9) << count << " objects | " << std::setw(6) << cullingKernelName(kernel)
+						<< " | " << (boxes ? "AABB  " : "sphere") << " | " << std::fixed << std::setprecision(1)
+						<< rate / 1.0e6 << " M objects/s | visible: " << visibleCount << std::endl;
+			}
+		}
+	}
+	return 0;
+}
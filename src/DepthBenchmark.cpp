@@ -0,0 +1,51 @@
+#include <Benchmarks.h>
+#include <VulkanApplication.h>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+	constexpr uint64_t BENCHMARK_FRAMES = 240;
+
+	struct DepthConfiguration {
+		const char* name;
+		bool enabled;
+		bool prePass;
+	};
+}
+
+int runDepthBenchmark(const ApplicationSettings& base) {
+	std::cout << "[Depth benchmark] " << BENCHMARK_FRAMES << " frames per configuration" << std::endl;
+	const DepthConfiguration configurations[] = {
+		{ "no depth  ", false, false },
+		{ "depth     ", true, false },
+		{ "pre-pass  ", true, true }
+	};
+	for (uint32_t count : { 1024u, 4096u }) {
+		for (const auto& configuration : configurations) {
+			auto settings = base;
+			// clairage par clusters : un fragment shader assez coteux pour que l'overdraw se voie
+			settings.scene = SceneType::Lod;
+			settings.lighting = true;
+			settings.lodSettings.objectCount = count;
+			settings.depth.enabled = configuration.enabled;
+			settings.depth.prePass = configuration.prePass;
+			settings.countFragments = true;
+			settings.maxFrames = BENCHMARK_FRAMES;
+			std::cout << std::setw(5) << count << " objects | " << configuration.name << " | ";
+			auto app = CVulkanApplication{settings};
+			try {
+				app.run();
+			}
+			catch (std::exception const& e) {
+				CLogger::flush();
+				std::cout << "skipped (" << e.what() << ")" << std::endl;
+				continue;
+			}
+			const auto stats = app.statistics();
+			std::cout << std::fixed << std::setprecision(0) << stats.fragmentInvocations << " fragments/frame | "
+					<< std::setprecision(2) << stats.fragmentsPerPixel << " per pixel | " << std::setprecision(3)
+					<< stats.averageFrameMs << " ms/frame" << std::endl;
+		}
+	}
+	return 0;
+}
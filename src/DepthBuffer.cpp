@@ -0,0 +1,74 @@
+#include <DepthBuffer.h>
+#include <stdexcept>
+
+VkPipelineDepthStencilStateCreateInfo depthStencilState(const DepthSettings& settings, DepthPass pass) {
+	auto state = VkPipelineDepthStencilStateCreateInfo{};
+	state.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+	state.minDepthBounds = 0.0f;
+	state.maxDepthBounds = 1.0f;
+	if (!settings.enabled || pass == DepthPass::None) { return state; }
+	state.depthTestEnable = VK_TRUE;
+	// Aprs la pr-passe, seul le fragment le plus proche a exactement la profondeur crite
+	const auto equal = pass == DepthPass::Main && settings.prePass;
+	state.depthWriteEnable = equal ? VK_FALSE : VK_TRUE;
+	if (equal) { state.depthCompareOp = VK_COMPARE_OP_EQUAL; }
+	else { state.depthCompareOp = settings.reverseZ ? VK_COMPARE_OP_GREATER : VK_COMPARE_OP_LESS; }
+	return state;
+}
+
+VkFormat CDepthBuffer::findFormat(VkPhysicalDevice physicalDevice) {
+	// Le flottant d'abord : c'est lui qui donne sa prcision  la profondeur inverse
+	const VkFormat candidates[] = {
+		VK_FORMAT_D32_SFLOAT,
+		VK_FORMAT_D32_SFLOAT_S8_UINT,
+		VK_FORMAT_X8_D24_UNORM_PACK32,
+		VK_FORMAT_D24_UNORM_S8_UINT,
+		VK_FORMAT_D16_UNORM
+	};
+	for (const auto format : candidates) {
+		VkFormatProperties properties;
+		vkGetPhysicalDeviceFormatProperties(physicalDevice, format, &properties);
+		if (properties.optimalTilingFeatures & VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT) { return format; }
+	}
+	return VK_FORMAT_UNDEFINED;
+}
+
+void CDepthBuffer::init(const DeviceContext& context, VkFormat format, VkExtent2D extent) {
+	m_context = context;
+	m_extent = extent;
+	// Jamais relue ni copie : transiente, en mmoire paresseuse si un type de mmoire le permet
+	const auto usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+	try {
+		createImage(m_context, extent, format, usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT,
+		            m_image, m_memory, MemoryCategory::Image);
+		m_lazilyAllocated = true;
+	}
+	catch (const std::runtime_error&) {
+		createImage(m_context, extent, format, usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_image, m_memory,
+		            MemoryCategory::Image);
+		m_lazilyAllocated = false;
+	}
+	// Les formats combins sont attachs avec leurs deux aspects (le stencil n'est pas utilis)
+	const auto hasStencil = format == VK_FORMAT_D32_SFLOAT_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT;
+	auto viewInfo = VkImageViewCreateInfo{};
+	viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+	viewInfo.image = m_image;
+	viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+	viewInfo.format = format;
+	viewInfo.subresourceRange = { static_cast<VkImageAspectFlags>(VK_IMAGE_ASPECT_DEPTH_BIT | (hasStencil ? VK_IMAGE_ASPECT_STENCIL_BIT : 0)),
+	                              0, 1, 0, 1 };
+	if (vkCreateImageView(m_context.device, &viewInfo, m_context.allocator, &m_view) != VK_SUCCESS) {
+		cleanup();
+		throw std::runtime_error("Failed to create the depth image view");
+	}
+}
+
+void CDepthBuffer::cleanup() {
+	if (m_context.device == VK_NULL_HANDLE) { return; }
+	if (m_view != VK_NULL_HANDLE) { vkDestroyImageView(m_context.device, m_view, m_context.allocator); }
+	if (m_image != VK_NULL_HANDLE) { destroyImage(m_context, m_image, m_memory); }
+	m_view = VK_NULL_HANDLE;
+	m_image = VK_NULL_HANDLE;
+	m_memory = VK_NULL_HANDLE;
+	m_context.device = VK_NULL_HANDLE;
+}
@@ -0,0 +1,282 @@
+#include <DynamicResolution.h>
+#include <Logger.h>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace {
+	// Timestamps crits par frame : dbut du rendu, fin du blit
+	constexpr uint32_t TIMESTAMP_BEGIN = 0;
+	constexpr uint32_t TIMESTAMP_END = 1;
+}
+
+/*************************
+	Contrleur
+**************************/
+
+CResolutionController::CResolutionController(const DynamicResolutionSettings& settings)
+	: m_settings(settings), m_scale(settings.maxScale) {}
+
+float CResolutionController::update(float gpuFrameMs) {
+	m_smoothedMs = m_hasSample ? m_smoothedMs + SMOOTHING * (gpuFrameMs - m_smoothedMs) : gpuFrameMs;
+	m_hasSample = true;
+	if (m_cooldown > 0) {
+		m_cooldown--;
+		return m_scale;
+	}
+	const auto target = m_settings.targetFrameMs;
+	// Dans la bande morte : pas de correction (vite les oscillations autour de la cible)
+	if (m_smoothedMs <= target * (1.0f + m_settings.hysteresis) && m_smoothedMs >= target * (1.0f - m_settings.hysteresis)) {
+		return m_scale;
+	}
+	// Cot proportionnel  la surface : l'chelle de chaque dimension suit la racine du rapport des temps
+	auto desired = m_scale * std::sqrt(target / std::max(m_smoothedMs, 0.01f));
+	// Hausse progressive : une hausse trop forte ferait repasser au-dessus de la cible
+	desired = std::min(desired, m_scale + MAX_INCREASE);
+	desired = std::clamp(desired, m_settings.minScale, m_settings.maxScale);
+	if (std::abs(desired - m_scale) < 0.01f) { return m_scale; }
+	m_scale = desired;
+	m_cooldown = COOLDOWN_FRAMES;
+	return m_scale;
+}
+
+float CResolutionController::allocationScale(float scale, float currentAllocation) const {
+	const auto step = m_settings.allocationStep;
+	const auto needed = std::min(std::ceil(scale / step - 0.001f) * step, std::max(m_settings.maxScale, step));
+	// Agrandissement immdiat, rduction seulement si la cible a au moins deux paliers de trop
+	if (needed > currentAllocation || currentAllocation - needed >= 2.0f * step - 0.001f) { return needed; }
+	return currentAllocation;
+}
+
+/*************************
+	Rendu
+**************************/
+
+bool CDynamicResolution::isSupported(VkPhysicalDevice physicalDevice, VkFormat format) {
+	VkFormatProperties properties;
+	vkGetPhysicalDeviceFormatProperties(physicalDevice, format, &properties);
+	const VkFormatFeatureFlags required = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT
+			| VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT | VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BIT;
+	return (properties.optimalTilingFeatures & required) == required;
+}
+
+void CDynamicResolution::init(const DeviceContext& context, uint32_t queueFamily, VkFormat format,
+                              VkExtent2D swapChainExtent, uint32_t frameCount,
+                              const DynamicResolutionSettings& settings) {
+	m_context = context;
+	m_format = format;
+	m_swapChainExtent = swapChainExtent;
+	m_controller = CResolutionController{settings};
+	createRenderPass();
+	auto poolInfo = VkCommandPoolCreateInfo{};
+	poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	poolInfo.queueFamilyIndex = queueFamily;
+	// Les command buffers sont renregistrs  chaque frame
+	poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+	if (vkCreateCommandPool(m_context.device, &poolInfo, m_context.allocator, &m_commandPool) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create the dynamic resolution command pool");
+	}
+	m_commandBuffers.resize(frameCount);
+	auto allocInfo = VkCommandBufferAllocateInfo{};
+	allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	allocInfo.commandPool = m_commandPool;
+	allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	allocInfo.commandBufferCount = frameCount;
+	if (vkAllocateCommandBuffers(m_context.device, &allocInfo, m_commandBuffers.data()) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to allocate the dynamic resolution command buffers");
+	}
+	// Les cibles sont alloues  la premire utilisation de chaque frame
+	m_targets.assign(frameCount, RenderTarget{});
+	m_timer.init(m_context, queueFamily, frameCount, 2);
+	if (!m_timer.isSupported()) {
+		CLogger::log(LogLevel::Warning, "Resolution", "GPU timestamps unsupported: render scale stays fixed");
+	}
+}
+
+void CDynamicResolution::cleanup() {
+	if (m_context.device == VK_NULL_HANDLE) { return; }
+	for (auto& target : m_targets) { destroyTarget(target); }
+	m_targets.clear();
+	m_timer.cleanup();
+	vkDestroyCommandPool(m_context.device, m_commandPool, m_context.allocator);
+	m_commandBuffers.clear();
+	vkDestroyRenderPass(m_context.device, m_renderPass, m_context.allocator);
+	m_context.device = VK_NULL_HANDLE;
+}
+
+void CDynamicResolution::onFrameCompleted(uint32_t frameInFlight) {
+	if (!m_timer.isSupported() || !m_timer.resolve(frameInFlight)) { return; }
+	m_controller.update(static_cast<float>(m_timer.elapsedMs(frameInFlight, TIMESTAMP_BEGIN, TIMESTAMP_END)));
+}
+
+VkCommandBuffer CDynamicResolution::record(uint32_t frameInFlight, VkImage swapChainImage,
+                                           const RecordFunction& recordScene, const RecordFunction& recordPrePass) {
+	auto& target = m_targets[frameInFlight];
+	// La frame est termine (fence attendue) : sa cible peut tre ralloue sans attente
+	const auto allocation = m_controller.allocationScale(m_controller.scale(), target.allocationScale);
+	if (allocation != target.allocationScale) {
+		destroyTarget(target);
+		createTarget(target, allocation);
+	}
+	auto extent = scaledExtent(m_controller.scale());
+	extent.width = std::min(extent.width, target.extent.width);
+	extent.height = std::min(extent.height, target.extent.height);
+	auto commandBuffer = m_commandBuffers[frameInFlight];
+	m_context.dispatch->ResetCommandBuffer(commandBuffer, 0);
+	auto beginInfo = VkCommandBufferBeginInfo{};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	if (m_context.dispatch->BeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to begin a dynamic resolution command buffer");
+	}
+	if (m_timer.isSupported()) {
+		m_timer.reset(commandBuffer, frameInFlight);
+		m_timer.write(commandBuffer, frameInFlight, TIMESTAMP_BEGIN, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+	}
+	if (recordPrePass) { recordPrePass(commandBuffer); }
+	// Rendu de la scne dans le coin suprieur gauche de la cible
+	auto renderPassInfo = VkRenderPassBeginInfo{};
+	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+	renderPassInfo.renderPass = m_renderPass;
+	renderPassInfo.framebuffer = target.framebuffer;
+	renderPassInfo.renderArea.offset = { 0, 0 };
+	renderPassInfo.renderArea.extent = extent;
+	auto clearColor = VkClearValue{ 0.0f, 0.0f, 0.0f, 1.0f };
+	renderPassInfo.clearValueCount = 1;
+	renderPassInfo.pClearValues = &clearColor;
+	m_context.dispatch->CmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+	auto viewport = VkViewport{ 0.0f, 0.0f, static_cast<float>(extent.width), static_cast<float>(extent.height), 0.0f, 1.0f };
+	m_context.dispatch->CmdSetViewport(commandBuffer, 0, 1, &viewport);
+	auto scissor = VkRect2D{ { 0, 0 }, extent };
+	m_context.dispatch->CmdSetScissor(commandBuffer, 0, 1, &scissor);
+	recordScene(commandBuffer);
+	// La render pass laisse la cible en TRANSFER_SRC_OPTIMAL
+	m_context.dispatch->CmdEndRenderPass(commandBuffer);
+	// Image de la swapchain : UNDEFINED -> TRANSFER_DST. Le stage source est celui attendu par le smaphore
+	// d'acquisition (COLOR_ATTACHMENT_OUTPUT) afin de chaner les dpendances.
+	auto barrier = VkImageMemoryBarrier{};
+	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	barrier.srcAccessMask = 0;
+	barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.image = swapChainImage;
+	barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+	m_context.dispatch->CmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+	                                       0, 0, nullptr, 0, nullptr, 1, &barrier);
+	// Agrandissement filtr vers toute l'image de la swapchain
+	auto blit = VkImageBlit{};
+	blit.srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+	blit.srcOffsets[1] = { static_cast<int32_t>(extent.width), static_cast<int32_t>(extent.height), 1 };
+	blit.dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+	blit.dstOffsets[1] = { static_cast<int32_t>(m_swapChainExtent.width), static_cast<int32_t>(m_swapChainExtent.height), 1 };
+	m_context.dispatch->CmdBlitImage(commandBuffer, target.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, swapChainImage,
+	                                 VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
+	barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.dstAccessMask = 0;
+	barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barrier.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+	m_context.dispatch->CmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+	                                       0, 0, nullptr, 0, nullptr, 1, &barrier);
+	if (m_timer.isSupported()) {
+		m_timer.write(commandBuffer, frameInFlight, TIMESTAMP_END, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+	}
+	if (m_context.dispatch->EndCommandBuffer(commandBuffer) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to end a dynamic resolution command buffer");
+	}
+	return commandBuffer;
+}
+
+void CDynamicResolution::createRenderPass() {
+	auto colorAttachment = VkAttachmentDescription{};
+	colorAttachment.format = m_format;
+	colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+	colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+	colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+	colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+	colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	// Prte pour le blit vers la swapchain
+	colorAttachment.finalLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+	auto colorAttachmentRef = VkAttachmentReference{};
+	colorAttachmentRef.attachment = 0;
+	colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+	auto subpass = VkSubpassDescription{};
+	subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+	subpass.colorAttachmentCount = 1;
+	subpass.pColorAttachments = &colorAttachmentRef;
+	VkSubpassDependency dependencies[2] = {};
+	// Le blit prcdent de cette cible doit avoir fini de la lire
+	dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+	dependencies[0].dstSubpass = 0;
+	dependencies[0].srcStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+	dependencies[0].srcAccessMask = 0;
+	dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	// Le blit lit ce que la passe a crit
+	dependencies[1].srcSubpass = 0;
+	dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+	dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	dependencies[1].dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+	dependencies[1].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+	auto renderPassInfo = VkRenderPassCreateInfo{};
+	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+	renderPassInfo.attachmentCount = 1;
+	renderPassInfo.pAttachments = &colorAttachment;
+	renderPassInfo.subpassCount = 1;
+	renderPassInfo.pSubpasses = &subpass;
+	renderPassInfo.dependencyCount = 2;
+	renderPassInfo.pDependencies = dependencies;
+	if (vkCreateRenderPass(m_context.device, &renderPassInfo, m_context.allocator, &m_renderPass) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create the dynamic resolution render pass");
+	}
+}
+
+void CDynamicResolution::createTarget(RenderTarget& target, float allocationScale) {
+	target.allocationScale = allocationScale;
+	target.extent = scaledExtent(allocationScale);
+	createImage(m_context, target.extent, m_format, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+	            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, target.image, target.memory, MemoryCategory::Image);
+	auto viewInfo = VkImageViewCreateInfo{};
+	viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+	viewInfo.image = target.image;
+	viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+	viewInfo.format = m_format;
+	viewInfo.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+	if (vkCreateImageView(m_context.device, &viewInfo, m_context.allocator, &target.view) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create a dynamic resolution image view");
+	}
+	auto framebufferInfo = VkFramebufferCreateInfo{};
+	framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+	framebufferInfo.renderPass = m_renderPass;
+	framebufferInfo.attachmentCount = 1;
+	framebufferInfo.pAttachments = &target.view;
+	framebufferInfo.width = target.extent.width;
+	framebufferInfo.height = target.extent.height;
+	framebufferInfo.layers = 1;
+	if (vkCreateFramebuffer(m_context.device, &framebufferInfo, m_context.allocator, &target.framebuffer) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create a dynamic resolution framebuffer");
+	}
+	m_reallocations++;
+	CLogger::log(LogLevel::Info, "Resolution", "Render target allocated at " + std::to_string(target.extent.width) + "x"
+	             + std::to_string(target.extent.height));
+}
+
+void CDynamicResolution::destroyTarget(RenderTarget& target) {
+	if (target.image == VK_NULL_HANDLE) { return; }
+	vkDestroyFramebuffer(m_context.device, target.framebuffer, m_context.allocator);
+	vkDestroyImageView(m_context.device, target.view, m_context.allocator);
+	destroyImage(m_context, target.image, target.memory);
+	target = RenderTarget{};
+}
+
+VkExtent2D CDynamicResolution::scaledExtent(float scale) const {
+	return {
+		std::max(1u, static_cast<uint32_t>(std::lround(static_cast<float>(m_swapChainExtent.width) * scale))),
+		std::max(1u, static_cast<uint32_t>(std::lround(static_cast<float>(m_swapChainExtent.height) * scale)))
+	};
+}
@@ -0,0 +1,45 @@
+#include <FragmentCounter.h>
+#include <stdexcept>
+
+void CFragmentCounter::init(const DeviceContext& context, uint32_t frameCount) {
+	auto poolInfo = VkQueryPoolCreateInfo{};
+	poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+	poolInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+	poolInfo.queryCount = frameCount;
+	poolInfo.pipelineStatistics = VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+	if (vkCreateQueryPool(context.device, &poolInfo, context.allocator, &m_queryPool) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create a pipeline statistics query pool");
+	}
+	m_context = context;
+	m_written.assign(frameCount, false);
+	m_totalInvocations = 0;
+	m_measuredFrames = 0;
+}
+
+void CFragmentCounter::cleanup() {
+	if (m_context.device == VK_NULL_HANDLE) { return; }
+	vkDestroyQueryPool(m_context.device, m_queryPool, m_context.allocator);
+	m_queryPool = VK_NULL_HANDLE;
+	m_context.device = VK_NULL_HANDLE;
+}
+
+void CFragmentCounter::recordBegin(VkCommandBuffer commandBuffer, uint32_t frame) {
+	m_context.dispatch->CmdResetQueryPool(commandBuffer, m_queryPool, frame, 1);
+	m_context.dispatch->CmdBeginQuery(commandBuffer, m_queryPool, frame, 0);
+	m_written[frame] = true;
+}
+
+void CFragmentCounter::recordEnd(VkCommandBuffer commandBuffer, uint32_t frame) {
+	m_context.dispatch->CmdEndQuery(commandBuffer, m_queryPool, frame);
+}
+
+void CFragmentCounter::onFrameCompleted(uint32_t frame) {
+	if (!m_written[frame]) { return; }
+	// La fence de la frame est signale : le rsultat est disponible, pas besoin de WAIT
+	uint64_t invocations = 0;
+	const auto result = m_context.dispatch->GetQueryPoolResults(m_context.device, m_queryPool, frame, 1, sizeof(invocations),
+	                                                            &invocations, sizeof(invocations), VK_QUERY_RESULT_64_BIT);
+	if (result != VK_SUCCESS) { return; }
+	m_totalInvocations += invocations;
+	m_measuredFrames++;
+}
@@ -0,0 +1,221 @@
+#include <FrameCapture.h>
+#include <VulkanUtils.h>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+void CFrameCapture::init(const DeviceContext& context, uint32_t queueFamily, VkExtent2D extent, VkFormat format,
+                         const std::string& directory, CaptureFormat fileFormat, bool lossless, size_t slotCount) {
+	m_context = context;
+	m_extent = extent;
+	m_format = format;
+	m_directory = directory;
+	m_fileFormat = fileFormat;
+	m_lossless = lossless;
+	std::filesystem::create_directories(m_directory);
+	// Les command buffers de copie sont renregistrs  chaque capture
+	auto poolInfo = VkCommandPoolCreateInfo{};
+	poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	poolInfo.queueFamilyIndex = queueFamily;
+	poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+	if (vkCreateCommandPool(m_context.device, &poolInfo, m_context.allocator, &m_commandPool) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create the capture command pool");
+	}
+	// Swapchain en 8 bits par canal (B8G8R8A8 / R8G8B8A8)
+	const auto size = static_cast<VkDeviceSize>(extent.width) * extent.height * 4;
+	m_slots.resize(slotCount);
+	for (auto& slot : m_slots) {
+		// Mmoire "cached" de prfrence : la lecture CPU d'une mmoire write-combined est trs lente
+		try {
+			createBuffer(m_context, size, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			             VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+			             | VK_MEMORY_PROPERTY_HOST_CACHED_BIT, slot.buffer, slot.memory, MemoryCategory::Staging);
+		}
+		catch (const std::runtime_error&) {
+			createBuffer(m_context, size, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			             VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			             slot.buffer, slot.memory, MemoryCategory::Staging);
+		}
+		void* data;
+		vkMapMemory(m_context.device, slot.memory, 0, size, 0, &data);
+		slot.mapped = static_cast<const uint8_t*>(data);
+		auto allocInfo = VkCommandBufferAllocateInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocInfo.commandPool = m_commandPool;
+		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		allocInfo.commandBufferCount = 1;
+		if (vkAllocateCommandBuffers(m_context.device, &allocInfo, &slot.commandBuffer) != VK_SUCCESS) {
+			throw std::runtime_error("Failed to allocate a capture command buffer");
+		}
+	}
+	m_stopWriter = false;
+	m_writer = std::thread{[this] { writerLoop(); }};
+}
+
+void CFrameCapture::cleanup() {
+	if (m_context.device == VK_NULL_HANDLE) { return; }
+	{
+		// Le device est inactif : toutes les copies soumises sont termines
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (size_t i = 0; i < m_slots.size(); i++) {
+			if (m_slots[i].state == SlotState::Pending) {
+				m_slots[i].state = SlotState::Writing;
+				m_writeQueue.push_back(i);
+			}
+		}
+		m_stopWriter = true;
+	}
+	m_condition.notify_one();
+	m_writer.join();
+	for (auto& slot : m_slots) {
+		vkUnmapMemory(m_context.device, slot.memory);
+		destroyBuffer(m_context, slot.buffer, slot.memory);
+	}
+	m_slots.clear();
+	vkDestroyCommandPool(m_context.device, m_commandPool, m_context.allocator);
+	m_context.device = VK_NULL_HANDLE;
+}
+
+VkCommandBuffer CFrameCapture::recordCapture(VkImage image, uint32_t frameInFlight) {
+	const auto frameNumber = m_frameNumber++;
+	size_t slotIndex;
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		if (m_lossless) {
+			// Un slot en cours d'criture sera libr par le thread d'criture ; un slot Pending attend une fence
+			// que ce thread doit lui-mme traiter : il ne peut qu'tre ignor (moins de slots que de frames en vol)
+			m_slotFreed.wait(lock, [this] { return m_slots[m_nextSlot].state != SlotState::Writing; });
+		}
+		if (m_slots[m_nextSlot].state != SlotState::Free) {
+			// Le thread d'criture est en retard : on ignore la frame plutt que de bloquer le rendu
+			m_droppedFrames++;
+			return VK_NULL_HANDLE;
+		}
+		slotIndex = m_nextSlot;
+		m_nextSlot = (m_nextSlot + 1) % m_slots.size();
+	}
+	auto& slot = m_slots[slotIndex];
+	slot.frameInFlight = frameInFlight;
+	slot.frameNumber = frameNumber;
+	m_context.dispatch->ResetCommandBuffer(slot.commandBuffer, 0);
+	auto beginInfo = VkCommandBufferBeginInfo{};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	if (m_context.dispatch->BeginCommandBuffer(slot.commandBuffer, &beginInfo) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to begin a capture command buffer");
+	}
+	// PRESENT_SRC -> TRANSFER_SRC aprs l'criture de la passe de rendu (ou du blit de la rsolution dynamique)
+	auto barrier = VkImageMemoryBarrier{};
+	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+	barrier.oldLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+	barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.image = image;
+	barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+	m_context.dispatch->CmdPipelineBarrier(slot.commandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+	                                       VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+	auto region = VkBufferImageCopy{};
+	region.bufferOffset = 0;
+	region.bufferRowLength = 0;
+	region.bufferImageHeight = 0;
+	region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+	region.imageOffset = { 0, 0, 0 };
+	region.imageExtent = { m_extent.width, m_extent.height, 1 };
+	m_context.dispatch->CmdCopyImageToBuffer(slot.commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, slot.buffer, 1, &region);
+	// Retour en PRESENT_SRC pour la prsentation
+	barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+	barrier.dstAccessMask = 0;
+	barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+	barrier.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+	// Rend l'criture du transfert visible pour la lecture CPU
+	auto bufferBarrier = VkBufferMemoryBarrier{};
+	bufferBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+	bufferBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	bufferBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+	bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	bufferBarrier.buffer = slot.buffer;
+	bufferBarrier.offset = 0;
+	bufferBarrier.size = VK_WHOLE_SIZE;
+	m_context.dispatch->CmdPipelineBarrier(slot.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+	                                       VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT | VK_PIPELINE_STAGE_HOST_BIT, 0, 0, nullptr,
+	                                       1, &bufferBarrier, 1, &barrier);
+	if (m_context.dispatch->EndCommandBuffer(slot.commandBuffer) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to end a capture command buffer");
+	}
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		slot.state = SlotState::Pending;
+	}
+	m_capturedFrames++;
+	return slot.commandBuffer;
+}
+
+void CFrameCapture::onFrameCompleted(uint32_t frameInFlight) {
+	auto queued{false};
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (size_t i = 0; i < m_slots.size(); i++) {
+			if (m_slots[i].state == SlotState::Pending && m_slots[i].frameInFlight == frameInFlight) {
+				m_slots[i].state = SlotState::Writing;
+				m_writeQueue.push_back(i);
+				queued = true;
+			}
+		}
+	}
+	if (queued) { m_condition.notify_one(); }
+}
+
+std::string CFrameCapture::framePath(const std::string& directory, CaptureFormat fileFormat, uint64_t frameNumber) {
+	char name[64];
+	std::snprintf(name, sizeof(name), "frame_%06llu.%s", static_cast<unsigned long long>(frameNumber),
+	              fileFormat == CaptureFormat::PPM ? "ppm" : "raw");
+	return (std::filesystem::path{directory} / name).string();
+}
+
+void CFrameCapture::writerLoop() {
+	for (;;) {
+		size_t slotIndex;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_condition.wait(lock, [this] { return m_stopWriter || !m_writeQueue.empty(); });
+			if (m_writeQueue.empty()) { return; }
+			slotIndex = m_writeQueue.front();
+			m_writeQueue.pop_front();
+		}
+		// Le slot n'est touch par personne d'autre tant qu'il est dans l'tat Writing
+		writeSlot(m_slots[slotIndex]);
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_slots[slotIndex].state = SlotState::Free;
+		}
+		m_slotFreed.notify_one();
+	}
+}
+
+void CFrameCapture::writeSlot(const CaptureSlot& slot) const {
+	auto file = std::ofstream{ framePath(slot.frameNumber), std::ios::binary };
+	if (!file.is_open()) { return; }
+	const auto pixelCount = static_cast<size_t>(m_extent.width) * m_extent.height;
+	if (m_fileFormat == CaptureFormat::Raw) {
+		file.write(reinterpret_cast<const char*>(slot.mapped), static_cast<std::streamsize>(pixelCount * 4));
+		return;
+	}
+	file << "P6\n" << m_extent.width << " " << m_extent.height << "\n255\n";
+	// Conversion ligne par ligne vers du RGB (les formats BGRA sont inverss)
+	const auto bgra = m_format == VK_FORMAT_B8G8R8A8_UNORM || m_format == VK_FORMAT_B8G8R8A8_SRGB;
+	std::vector<char> row(static_cast<size_t>(m_extent.width) * 3);
+	for (uint32_t y = 0; y < m_extent.height; y++) {
+		const auto* src = slot.mapped + static_cast<size_t>(y) * m_extent.width * 4;
+		for (uint32_t x = 0; x < m_extent.width; x++) {
+			row[x * 3 + 0] = static_cast<char>(src[x * 4 + (bgra ? 2 : 0)]);
+			row[x * 3 + 1] = static_cast<char>(src[x * 4 + 1]);
+			row[x * 3 + 2] = static_cast<char>(src[x * 4 + (bgra ? 0 : 2)]);
+		}
+		file.write(row.data(), static_cast<std::streamsize>(row.size()));
+	}
+}
@@ -0,0 +1,312 @@
+#include <FrustumCulling.h>
+#include <algorithm>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define CULLING_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define CULLING_TARGET_SSE
+#define CULLING_TARGET_AVX2
+#else
+#define CULLING_TARGET_SSE __attribute__((target("sse2")))
+#define CULLING_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+/*************************
+	Volumes / plans
+**************************/
+
+void BoundingVolumes::reserve(size_t count) {
+	for (auto* component : { &centerX, &centerY, &centerZ, &radius, &minX, &minY, &minZ, &maxX, &maxY, &maxZ }) {
+		component->reserve(count);
+	}
+}
+
+void BoundingVolumes::clear() {
+	for (auto* component : { &centerX, &centerY, &centerZ, &radius, &minX, &minY, &minZ, &maxX, &maxY, &maxZ }) {
+		component->clear();
+	}
+}
+
+uint32_t BoundingVolumes::add(const Vec3& boxMin, const Vec3& boxMax) {
+	const auto index = static_cast<uint32_t>(size());
+	const auto center = (boxMin + boxMax) * 0.5f;
+	centerX.push_back(center.x);
+	centerY.push_back(center.y);
+	centerZ.push_back(center.z);
+	radius.push_back(length(boxMax - center));
+	minX.push_back(boxMin.x);
+	minY.push_back(boxMin.y);
+	minZ.push_back(boxMin.z);
+	maxX.push_back(boxMax.x);
+	maxY.push_back(boxMax.y);
+	maxZ.push_back(boxMax.z);
+	return index;
+}
+
+uint32_t BoundingVolumes::addSphere(const Vec3& center, float sphereRadius) {
+	const auto index = add(center - Vec3{ sphereRadius, sphereRadius, sphereRadius },
+	                       center + Vec3{ sphereRadius, sphereRadius, sphereRadius });
+	// Rayon exact plutt que celui de l'AABB (plus grand d'un facteur racine de 3)
+	radius.back() = sphereRadius;
+	return index;
+}
+
+FrustumPlanes FrustumPlanes::fromViewProjection(const Mat4& vp) {
+	auto planes = FrustumPlanes{};
+	// Lignes de la matrice combines : gauche, droite, bas, haut, proche (z >= 0), lointain (z <= w)
+	const float rows[6][4] = {
+		{ vp.at(3, 0) + vp.at(0, 0), vp.at(3, 1) + vp.at(0, 1), vp.at(3, 2) + vp.at(0, 2), vp.at(3, 3) + vp.at(0, 3) },
+		{ vp.at(3, 0) - vp.at(0, 0), vp.at(3, 1) - vp.at(0, 1), vp.at(3, 2) - vp.at(0, 2), vp.at(3, 3) - vp.at(0, 3) },
+		{ vp.at(3, 0) + vp.at(1, 0), vp.at(3, 1) + vp.at(1, 1), vp.at(3, 2) + vp.at(1, 2), vp.at(3, 3) + vp.at(1, 3) },
+		{ vp.at(3, 0) - vp.at(1, 0), vp.at(3, 1) - vp.at(1, 1), vp.at(3, 2) - vp.at(1, 2), vp.at(3, 3) - vp.at(1, 3) },
+		{ vp.at(2, 0), vp.at(2, 1), vp.at(2, 2), vp.at(2, 3) },
+		{ vp.at(3, 0) - vp.at(2, 0), vp.at(3, 1) - vp.at(2, 1), vp.at(3, 2) - vp.at(2, 2), vp.at(3, 3) - vp.at(2, 3) }
+	};
+	for (int p = 0; p < 6; p++) {
+		const auto len = length({ rows[p][0], rows[p][1], rows[p][2] });
+		const auto inv = len > 0.0f ? 1.0f / len : 0.0f;
+		planes.a[p] = rows[p][0] * inv;
+		planes.b[p] = rows[p][1] * inv;
+		planes.c[p] = rows[p][2] * inv;
+		planes.d[p] = rows[p][3] * inv;
+	}
+	return planes;
+}
+
+const char* cullingKernelName(CullingKernel kernel) {
+	switch (kernel) {
+	case CullingKernel::AVX2: return "AVX2";
+	case CullingKernel::SSE: return "SSE";
+	default: return "Scalar";
+	}
+}
+
+/*************************
+	Kernels
+**************************/
+
+namespace {
+	/*
+	 * Sommet "positif" de l'AABB pour chaque plan : le coin le plus avanc dans la direction de la normale.
+	 * Le choix min/max ne dpend que du signe du plan, il est donc rsolu une fois hors de la boucle.
+	 */
+	struct BoxPlaneInputs {
+		const float* x[6];
+		const float* y[6];
+		const float* z[6];
+	};
+
+	BoxPlaneInputs selectBoxInputs(const FrustumPlanes& f, const BoundingVolumes& v) {
+		auto inputs = BoxPlaneInputs{};
+		for (int p = 0; p < 6; p++) {
+			inputs.x[p] = f.a[p] >= 0.0f ? v.maxX.data() : v.minX.data();
+			inputs.y[p] = f.b[p] >= 0.0f ? v.maxY.data() : v.minY.data();
+			inputs.z[p] = f.c[p] >= 0.0f ? v.maxZ.data() : v.minZ.data();
+		}
+		return inputs;
+	}
+
+	size_t sphereScalar(const FrustumPlanes& f, const BoundingVolumes& v, size_t begin, size_t end, uint32_t* out) {
+		size_t count = 0;
+		for (size_t i = begin; i < end; i++) {
+			auto inside = true;
+			for (int p = 0; p < 6; p++) {
+				const auto distance = f.a[p] * v.centerX[i] + f.b[p] * v.centerY[i] + f.c[p] * v.centerZ[i] + f.d[p];
+				inside &= distance >= -v.radius[i];
+			}
+			// criture sans branche : l'indice est cras au prochain tour s'il n'est pas visible
+			out[count] = static_cast<uint32_t>(i);
+			count += inside ? 1 : 0;
+		}
+		return count;
+	}
+
+	size_t boxScalar(const FrustumPlanes& f, const BoundingVolumes& v, size_t begin, size_t end, uint32_t* out) {
+		const auto inputs = selectBoxInputs(f, v);
+		size_t count = 0;
+		for (size_t i = begin; i < end; i++) {
+			auto inside = true;
+			for (int p = 0; p < 6; p++) {
+				const auto distance = f.a[p] * inputs.x[p][i] + f.b[p] * inputs.y[p][i] + f.c[p] * inputs.z[p][i] + f.d[p];
+				inside &= distance >= 0.0f;
+			}
+			out[count] = static_cast<uint32_t>(i);
+			count += inside ? 1 : 0;
+		}
+		return count;
+	}
+
+#ifdef CULLING_X86
+	/*
+	 * crit les indices correspondant aux bits du masque (4 ou 8 voies)
+	 */
+	inline size_t writeMask(int mask, int lanes, size_t base, uint32_t* out) {
+		size_t count = 0;
+		for (int lane = 0; lane < lanes; lane++) {
+			out[count] = static_cast<uint32_t>(base + lane);
+			count += (mask >> lane) & 1;
+		}
+		return count;
+	}
+
+	CULLING_TARGET_SSE
+	size_t sphereSSE(const FrustumPlanes& f, const BoundingVolumes& v, size_t begin, size_t end, uint32_t* out) {
+		size_t count = 0;
+		auto i = begin;
+		for (; i + 4 <= end; i += 4) {
+			const auto cx = _mm_loadu_ps(v.centerX.data() + i);
+			const auto cy = _mm_loadu_ps(v.centerY.data() + i);
+			const auto cz = _mm_loadu_ps(v.centerZ.data() + i);
+			const auto negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(v.radius.data() + i));
+			auto inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+			for (int p = 0; p < 6; p++) {
+				auto distance = _mm_mul_ps(cx, _mm_set1_ps(f.a[p]));
+				distance = _mm_add_ps(distance, _mm_mul_ps(cy, _mm_set1_ps(f.b[p])));
+				distance = _mm_add_ps(distance, _mm_mul_ps(cz, _mm_set1_ps(f.c[p])));
+				distance = _mm_add_ps(distance, _mm_set1_ps(f.d[p]));
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negRadius));
+			}
+			count += writeMask(_mm_movemask_ps(inside), 4, i, out + count);
+		}
+		return count + sphereScalar(f, v, i, end, out + count);
+	}
+
+	CULLING_TARGET_SSE
+	size_t boxSSE(const FrustumPlanes& f, const BoundingVolumes& v, size_t begin, size_t end, uint32_t* out) {
+		const auto inputs = selectBoxInputs(f, v);
+		size_t count = 0;
+		auto i = begin;
+		for (; i + 4 <= end; i += 4) {
+			auto inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+			for (int p = 0; p < 6; p++) {
+				auto distance = _mm_mul_ps(_mm_loadu_ps(inputs.x[p] + i), _mm_set1_ps(f.a[p]));
+				distance = _mm_add_ps(distance, _mm_mul_ps(_mm_loadu_ps(inputs.y[p] + i), _mm_set1_ps(f.b[p])));
+				distance = _mm_add_ps(distance, _mm_mul_ps(_mm_loadu_ps(inputs.z[p] + i), _mm_set1_ps(f.c[p])));
+				distance = _mm_add_ps(distance, _mm_set1_ps(f.d[p]));
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, _mm_setzero_ps()));
+			}
+			count += writeMask(_mm_movemask_ps(inside), 4, i, out + count);
+		}
+		return count + boxScalar(f, v, i, end, out + count);
+	}
+
+	CULLING_TARGET_AVX2
+	size_t sphereAVX2(const FrustumPlanes& f, const BoundingVolumes& v, size_t begin, size_t end, uint32_t* out) {
+		size_t count = 0;
+		auto i = begin;
+		for (; i + 8 <= end; i += 8) {
+			const auto cx = _mm256_loadu_ps(v.centerX.data() + i);
+			const auto cy = _mm256_loadu_ps(v.centerY.data() + i);
+			const auto cz = _mm256_loadu_ps(v.centerZ.data() + i);
+			const auto negRadius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(v.radius.data() + i));
+			auto inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+			for (int p = 0; p < 6; p++) {
+				auto distance = _mm256_mul_ps(cx, _mm256_set1_ps(f.a[p]));
+				distance = _mm256_add_ps(distance, _mm256_mul_ps(cy, _mm256_set1_ps(f.b[p])));
+				distance = _mm256_add_ps(distance, _mm256_mul_ps(cz, _mm256_set1_ps(f.c[p])));
+				distance = _mm256_add_ps(distance, _mm256_set1_ps(f.d[p]));
+				inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, negRadius, _CMP_GE_OQ));
+			}
+			count += writeMask(_mm256_movemask_ps(inside), 8, i, out + count);
+		}
+		return count + sphereScalar(f, v, i, end, out + count);
+	}
+
+	CULLING_TARGET_AVX2
+	size_t boxAVX2(const FrustumPlanes& f, const BoundingVolumes& v, size_t begin, size_t end, uint32_t* out) {
+		const auto inputs = selectBoxInputs(f, v);
+		size_t count = 0;
+		auto i = begin;
+		for (; i + 8 <= end; i += 8) {
+			auto inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+			for (int p = 0; p < 6; p++) {
+				auto distance = _mm256_mul_ps(_mm256_loadu_ps(inputs.x[p] + i), _mm256_set1_ps(f.a[p]));
+				distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_loadu_ps(inputs.y[p] + i), _mm256_set1_ps(f.b[p])));
+				distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_loadu_ps(inputs.z[p] + i), _mm256_set1_ps(f.c[p])));
+				distance = _mm256_add_ps(distance, _mm256_set1_ps(f.d[p]));
+				inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, _mm256_setzero_ps(), _CMP_GE_OQ));
+			}
+			count += writeMask(_mm256_movemask_ps(inside), 8, i, out + count);
+		}
+		return count + boxScalar(f, v, i, end, out + count);
+	}
+#endif
+}
+
+/*************************
+	CFrustumCuller
+**************************/
+
+CFrustumCuller::CFrustumCuller(CJobSystem& jobSystem) : m_jobSystem(jobSystem), m_kernel(detectBestKernel()) {}
+
+CullingKernel CFrustumCuller::detectBestKernel() {
+#ifdef CULLING_X86
+#if defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 1);
+	const auto osxsave = (info[2] & (1 << 27)) != 0;
+	const auto avx = (info[2] & (1 << 28)) != 0;
+	// L'OS doit sauvegarder les registres YMM lors des changements de contexte
+	const auto ymmEnabled = osxsave && (_xgetbv(0) & 0x6) == 0x6;
+	__cpuidex(info, 7, 0);
+	const auto avx2 = (info[1] & (1 << 5)) != 0;
+	if (avx && ymmEnabled && avx2) { return CullingKernel::AVX2; }
+	return CullingKernel::SSE;
+#else
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) { return CullingKernel::AVX2; }
+	if (__builtin_cpu_supports("sse")) { return CullingKernel::SSE; }
+#endif
+#endif
+	return CullingKernel::Scalar;
+}
+
+void CFrustumCuller::setKernel(CullingKernel kernel) {
+	m_kernel = std::min(kernel, detectBestKernel());
+}
+
+size_t CFrustumCuller::cullSpheres(const FrustumPlanes& frustum, const BoundingVolumes& volumes,
+                                   std::vector<uint32_t>& visible) {
+	auto fn = KernelFn{sphereScalar};
+#ifdef CULLING_X86
+	if (m_kernel == CullingKernel::AVX2) { fn = sphereAVX2; }
+	else if (m_kernel == CullingKernel::SSE) { fn = sphereSSE; }
+#endif
+	return run(fn, frustum, volumes, visible);
+}
+
+size_t CFrustumCuller::cullBoxes(const FrustumPlanes& frustum, const BoundingVolumes& volumes,
+                                 std::vector<uint32_t>& visible) {
+	auto fn = KernelFn{boxScalar};
+#ifdef CULLING_X86
+	if (m_kernel == CullingKernel::AVX2) { fn = boxAVX2; }
+	else if (m_kernel == CullingKernel::SSE) { fn = boxSSE; }
+#endif
+	return run(fn, frustum, volumes, visible);
+}
+
+size_t CFrustumCuller::run(KernelFn fn, const FrustumPlanes& frustum, const BoundingVolumes& volumes,
+                           std::vector<uint32_t>& visible) {
+	const auto count = volumes.size();
+	// Chaque bloc crit  partir de son propre offset, pas de synchronisation entre workers
+	visible.resize(count);
+	m_chunkCounts.assign((count + m_grain - 1) / m_grain, 0);
+	m_jobSystem.parallelFor(count, m_grain, [&](size_t begin, size_t end, size_t chunk) {
+		m_chunkCounts[chunk] = fn(frustum, volumes, begin, end, visible.data() + begin);
+	});
+	// Compaction squentielle (memmove de blocs dj tris)
+	size_t total = 0;
+	for (size_t chunk = 0; chunk < m_chunkCounts.size(); chunk++) {
+		const auto begin = chunk * m_grain;
+		if (begin != total) {
+			std::memmove(visible.data() + total, visible.data() + begin, m_chunkCounts[chunk] * sizeof(uint32_t));
+		}
+		total += m_chunkCounts[chunk];
+	}
+	visible.resize(total);
+	return total;
+}
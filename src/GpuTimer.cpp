@@ -0,0 +1,60 @@
+#include <GpuTimer.h>
+#include <stdexcept>
+
+void CGpuTimer::init(const DeviceContext& context, uint32_t queueFamily, uint32_t frameCount, uint32_t timestampsPerFrame) {
+	uint32_t queueFamilyCount = 0;
+	vkGetPhysicalDeviceQueueFamilyProperties(context.physicalDevice, &queueFamilyCount, nullptr);
+	std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+	vkGetPhysicalDeviceQueueFamilyProperties(context.physicalDevice, &queueFamilyCount, queueFamilies.data());
+	const auto validBits = queueFamilies[queueFamily].timestampValidBits;
+	// Pas de timestamps sur cette queue : isSupported() reste faux
+	if (validBits == 0) { return; }
+	m_validMask = validBits >= 64 ? ~uint64_t{0} : (uint64_t{1} << validBits) - 1;
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(context.physicalDevice, &properties);
+	m_period = static_cast<double>(properties.limits.timestampPeriod);
+	m_context = context;
+	m_timestampsPerFrame = timestampsPerFrame;
+	auto poolInfo = VkQueryPoolCreateInfo{};
+	poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+	poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+	poolInfo.queryCount = frameCount * timestampsPerFrame;
+	if (vkCreateQueryPool(m_context.device, &poolInfo, m_context.allocator, &m_queryPool) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create a timestamp query pool");
+	}
+	m_results.assign(poolInfo.queryCount, 0);
+	m_written.assign(frameCount, false);
+}
+
+void CGpuTimer::cleanup() {
+	if (m_queryPool == VK_NULL_HANDLE) { return; }
+	vkDestroyQueryPool(m_context.device, m_queryPool, m_context.allocator);
+	m_queryPool = VK_NULL_HANDLE;
+}
+
+void CGpuTimer::reset(VkCommandBuffer commandBuffer, uint32_t frame) {
+	m_context.dispatch->CmdResetQueryPool(commandBuffer, m_queryPool, frame * m_timestampsPerFrame, m_timestampsPerFrame);
+	m_written[frame] = true;
+}
+
+void CGpuTimer::write(VkCommandBuffer commandBuffer, uint32_t frame, uint32_t index, VkPipelineStageFlagBits stage) {
+	m_context.dispatch->CmdWriteTimestamp(commandBuffer, stage, m_queryPool, frame * m_timestampsPerFrame + index);
+}
+
+bool CGpuTimer::resolve(uint32_t frame) {
+	if (!m_written[frame]) { return false; }
+	// La fence de la frame est signale : les rsultats sont disponibles, pas besoin de WAIT
+	const auto result = m_context.dispatch->GetQueryPoolResults(m_context.device, m_queryPool, frame * m_timestampsPerFrame,
+	                                                            m_timestampsPerFrame, m_timestampsPerFrame * sizeof(uint64_t),
+	                                                            &m_results[frame * m_timestampsPerFrame], sizeof(uint64_t),
+	                                                            VK_QUERY_RESULT_64_BIT);
+	return result == VK_SUCCESS;
+}
+
+double CGpuTimer::elapsedMs(uint32_t frame, uint32_t from, uint32_t to) const {
+	const auto begin = m_results[frame * m_timestampsPerFrame + from] & m_validMask;
+	const auto end = m_results[frame * m_timestampsPerFrame + to] & m_validMask;
+	// Compteur reboucl entre les deux mesures
+	const auto ticks = end >= begin ? end - begin : end + (m_validMask - begin) + 1;
+	return static_cast<double>(ticks) * m_period / 1e6;
+}
@@ -0,0 +1,321 @@
+#include <HostAllocator.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+
+namespace {
+	/*
+	 * En-tte plac juste avant chaque pointeur rendu au driver
+	 */
+	struct BlockHeader {
+		// Taille demande par le driver
+		uint64_t size;
+		// Distance entre le dbut du bloc et le pointeur rendu
+		uint32_t offset;
+		uint8_t classIndex;
+		uint8_t scope;
+		uint16_t padding;
+	};
+	static_assert(sizeof(BlockHeader) == 16, "BlockHeader must keep 16 byte alignment");
+
+	constexpr uint8_t SYSTEM_BLOCK = 0xFF;
+
+	std::atomic<uint64_t> g_nextAllocatorId{1};
+	std::atomic<uint64_t> g_nextThreadCacheId{1};
+
+	void* systemAlignedAlloc(size_t size, size_t alignment) {
+#ifdef _MSC_VER
+		return _aligned_malloc(size, alignment);
+#else
+		// aligned_alloc exige une taille multiple de l'alignement
+		return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+	}
+
+	void systemAlignedFree(void* memory) {
+#ifdef _MSC_VER
+		_aligned_free(memory);
+#else
+		std::free(memory);
+#endif
+	}
+
+	BlockHeader* headerOf(void* memory) {
+		return reinterpret_cast<BlockHeader*>(static_cast<uint8_t*>(memory) - sizeof(BlockHeader));
+	}
+}
+
+/*
+ * En-tte plac au dbut de chaque chunk, suivi de blocs d'une seule classe de taille
+ */
+struct CHostAllocator::Chunk {
+	// Identifiant du cache propritaire : seul son thread touche aux champs non atomiques
+	uint64_t owner{0};
+	Chunk* prev{nullptr};
+	Chunk* next{nullptr};
+	// Blocs libres (le premier mot d'un bloc libre pointe vers le suivant)
+	void* freeList{nullptr};
+	// Blocs librs par les autres threads, rcuprs d'un coup par le propritaire
+	std::atomic<void*> remoteFrees{nullptr};
+	// Zone jamais dcoupe
+	uint8_t* bumpCursor{nullptr};
+	// Blocs sortis du chunk (rendus  distance compris tant qu'ils n'ont pas t rcuprs)
+	uint32_t used{0};
+	uint32_t classIndex{0};
+};
+
+thread_local CHostAllocator::ThreadCache CHostAllocator::t_cache;
+
+CHostAllocator::CHostAllocator() : m_id(g_nextAllocatorId.fetch_add(1)) {
+	m_callbacks.pUserData = this;
+	m_callbacks.pfnAllocation = allocation;
+	m_callbacks.pfnReallocation = reallocation;
+	m_callbacks.pfnFree = free;
+	m_callbacks.pfnInternalAllocation = internalAllocation;
+	m_callbacks.pfnInternalFree = internalFree;
+}
+
+CHostAllocator::~CHostAllocator() {
+	for (auto* chunk : m_chunks) { systemAlignedFree(chunk); }
+	// Les caches des autres threads pointent dans les chunks librs : ils seront rinitialiss (id diffrent)
+	if (t_cache.allocator == m_id) { t_cache = ThreadCache{}; }
+}
+
+/*************************
+	Callbacks Vulkan
+**************************/
+
+void* VKAPI_CALL CHostAllocator::allocation(void* pUserData, size_t size, size_t alignment,
+                                            VkSystemAllocationScope scope) {
+	return static_cast<CHostAllocator*>(pUserData)->allocate(size, alignment, scope);
+}
+
+void* VKAPI_CALL CHostAllocator::reallocation(void* pUserData, void* pOriginal, size_t size, size_t alignment,
+                                              VkSystemAllocationScope scope) {
+	auto* self = static_cast<CHostAllocator*>(pUserData);
+	if (pOriginal == nullptr) { return self->allocate(size, alignment, scope); }
+	if (size == 0) {
+		self->release(pOriginal);
+		return nullptr;
+	}
+	auto* memory = self->allocate(size, alignment, scope);
+	if (memory == nullptr) { return nullptr; }
+	std::memcpy(memory, pOriginal, std::min<size_t>(size, headerOf(pOriginal)->size));
+	self->release(pOriginal);
+	return memory;
+}
+
+void VKAPI_CALL CHostAllocator::free(void* pUserData, void* pMemory) {
+	if (pMemory != nullptr) { static_cast<CHostAllocator*>(pUserData)->release(pMemory); }
+}
+
+void VKAPI_CALL CHostAllocator::internalAllocation(void* pUserData, size_t size, VkInternalAllocationType,
+                                                   VkSystemAllocationScope) {
+	record(static_cast<CHostAllocator*>(pUserData)->m_internal, size);
+}
+
+void VKAPI_CALL CHostAllocator::internalFree(void* pUserData, size_t size, VkInternalAllocationType,
+                                             VkSystemAllocationScope) {
+	unrecord(static_cast<CHostAllocator*>(pUserData)->m_internal, size);
+}
+
+/*************************
+	Allocation
+**************************/
+
+void* CHostAllocator::allocate(size_t size, size_t alignment, VkSystemAllocationScope scope) {
+	if (size == 0) { return nullptr; }
+	// L'en-tte occupe 16 octets avant le pointeur ; un alignement plus grand largit cet espace
+	const auto pad = std::max(sizeof(BlockHeader), alignment);
+	uint8_t* block;
+	uint8_t classIndex = SYSTEM_BLOCK;
+	const auto pooled = (scope == VK_SYSTEM_ALLOCATION_SCOPE_COMMAND || scope == VK_SYSTEM_ALLOCATION_SCOPE_OBJECT)
+			&& size + pad <= MAX_CLASS_SIZE;
+	if (pooled) {
+		classIndex = 0;
+		while ((MIN_CLASS_SIZE << classIndex) < size + pad) { classIndex++; }
+		block = static_cast<uint8_t*>(allocateBlock(classIndex));
+		if (block == nullptr) { return nullptr; }
+	}
+	else {
+		block = static_cast<uint8_t*>(systemAlignedAlloc(size + pad, pad));
+		if (block == nullptr) { return nullptr; }
+	}
+	// Les blocs d'une classe de taille S sont aligns sur S >= pad : block + pad respecte l'alignement
+	auto* memory = block + pad;
+	auto* header = headerOf(memory);
+	header->size = size;
+	header->offset = static_cast<uint32_t>(pad);
+	header->classIndex = classIndex;
+	header->scope = static_cast<uint8_t>(scope);
+	record(m_scopes[scope], size);
+	return memory;
+}
+
+void CHostAllocator::release(void* memory) {
+	const auto* header = headerOf(memory);
+	unrecord(m_scopes[header->scope], header->size);
+	auto* block = static_cast<uint8_t*>(memory) - header->offset;
+	if (header->classIndex == SYSTEM_BLOCK) {
+		systemAlignedFree(block);
+		return;
+	}
+	releaseBlock(block);
+}
+
+/*************************
+	Chunks
+**************************/
+
+CHostAllocator::ThreadCache& CHostAllocator::threadCache() {
+	// Un cache servant un autre allocateur est abandonn : ses chunks restent  cet allocateur jusqu' sa destruction
+	if (t_cache.allocator != m_id) { t_cache = ThreadCache{ m_id, g_nextThreadCacheId.fetch_add(1) }; }
+	return t_cache;
+}
+
+void* CHostAllocator::allocateBlock(size_t classIndex) {
+	auto& cache = threadCache();
+	const auto blockSize = MIN_CLASS_SIZE << classIndex;
+	auto* chunk = cache.chunks[classIndex];
+	for (; chunk != nullptr; chunk = chunk->next) {
+		// Blocs locaux puiss : rcupration de ceux librs par les autres threads
+		if (chunk->freeList == nullptr) {
+			auto* block = chunk->remoteFrees.exchange(nullptr, std::memory_order_acquire);
+			chunk->freeList = block;
+			for (; block != nullptr; block = *static_cast<void**>(block)) { chunk->used--; }
+		}
+		if (chunk->freeList != nullptr
+			|| chunk->bumpCursor + blockSize <= reinterpret_cast<uint8_t*>(chunk) + CHUNK_SIZE) { break; }
+	}
+	if (chunk == nullptr) {
+		chunk = acquireChunk(cache, classIndex);
+		if (chunk == nullptr) { return nullptr; }
+	}
+	// Le chunk qui a servi passe en tte : les allocations suivantes le trouvent sans parcours
+	else if (chunk != cache.chunks[classIndex]) {
+		unlinkChunk(cache, chunk);
+		linkChunk(cache, chunk);
+	}
+	void* block;
+	if (chunk->freeList != nullptr) {
+		block = chunk->freeList;
+		chunk->freeList = *static_cast<void**>(block);
+	}
+	else {
+		block = chunk->bumpCursor;
+		chunk->bumpCursor += blockSize;
+	}
+	chunk->used++;
+	return block;
+}
+
+void CHostAllocator::releaseBlock(void* block) {
+	auto* chunk = reinterpret_cast<Chunk*>(reinterpret_cast<uintptr_t>(block) & ~static_cast<uintptr_t>(CHUNK_SIZE - 1));
+	if (t_cache.allocator == m_id && chunk->owner == t_cache.id) {
+		*static_cast<void**>(block) = chunk->freeList;
+		chunk->freeList = block;
+		// Chunk vide rendu au systme, sauf le premier de sa classe (il serait rallou aussitt)
+		if (--chunk->used == 0 && chunk != t_cache.chunks[chunk->classIndex]) {
+			unlinkChunk(t_cache, chunk);
+			releaseChunk(chunk);
+		}
+		return;
+	}
+	// Bloc d'un autre thread : pile sans verrou, vide en une fois par le propritaire (pas d'ABA)
+	auto* head = chunk->remoteFrees.load(std::memory_order_relaxed);
+	do { *static_cast<void**>(block) = head; }
+	while (!chunk->remoteFrees.compare_exchange_weak(head, block, std::memory_order_release, std::memory_order_relaxed));
+}
+
+CHostAllocator::Chunk* CHostAllocator::acquireChunk(ThreadCache& cache, size_t classIndex) {
+	// Pas d'exception  travers les callbacks du driver : nullptr signale l'chec
+	auto* memory = static_cast<uint8_t*>(systemAlignedAlloc(CHUNK_SIZE, CHUNK_SIZE));
+	if (memory == nullptr) { return nullptr; }
+	auto* chunk = new (memory) Chunk{};
+	chunk->owner = cache.id;
+	chunk->classIndex = static_cast<uint32_t>(classIndex);
+	// Premier bloc aprs l'en-tte, align sur la taille de sa classe
+	const auto blockSize = MIN_CLASS_SIZE << classIndex;
+	chunk->bumpCursor = memory + (sizeof(Chunk) + blockSize - 1) / blockSize * blockSize;
+	{
+		std::lock_guard<std::mutex> lock(m_chunkMutex);
+		m_chunks.push_back(chunk);
+	}
+	linkChunk(cache, chunk);
+	return chunk;
+}
+
+void CHostAllocator::releaseChunk(Chunk* chunk) {
+	{
+		std::lock_guard<std::mutex> lock(m_chunkMutex);
+		const auto it = std::find(m_chunks.begin(), m_chunks.end(), chunk);
+		*it = m_chunks.back();
+		m_chunks.pop_back();
+	}
+	systemAlignedFree(chunk);
+}
+
+void CHostAllocator::linkChunk(ThreadCache& cache, Chunk* chunk) {
+	auto*& head = cache.chunks[chunk->classIndex];
+	chunk->prev = nullptr;
+	chunk->next = head;
+	if (head != nullptr) { head->prev = chunk; }
+	head = chunk;
+}
+
+void CHostAllocator::unlinkChunk(ThreadCache& cache, Chunk* chunk) {
+	if (chunk->prev != nullptr) { chunk->prev->next = chunk->next; }
+	else { cache.chunks[chunk->classIndex] = chunk->next; }
+	if (chunk->next != nullptr) { chunk->next->prev = chunk->prev; }
+}
+
+/*************************
+	Statistiques
+**************************/
+
+void CHostAllocator::record(ScopeCounters& counters, uint64_t bytes) {
+	counters.liveCount.fetch_add(1, std::memory_order_relaxed);
+	counters.totalCount.fetch_add(1, std::memory_order_relaxed);
+	const auto live = counters.liveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+	auto peak = counters.peakBytes.load(std::memory_order_relaxed);
+	while (live > peak && !counters.peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+}
+
+void CHostAllocator::unrecord(ScopeCounters& counters, uint64_t bytes) {
+	counters.liveCount.fetch_sub(1, std::memory_order_relaxed);
+	counters.liveBytes.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+HostAllocationStats CHostAllocator::snapshot(const ScopeCounters& counters) {
+	auto stats = HostAllocationStats{};
+	stats.liveCount = counters.liveCount.load(std::memory_order_relaxed);
+	stats.totalCount = counters.totalCount.load(std::memory_order_relaxed);
+	stats.liveBytes = counters.liveBytes.load(std::memory_order_relaxed);
+	stats.peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+	return stats;
+}
+
+HostAllocationStats CHostAllocator::stats(VkSystemAllocationScope scope) const {
+	return snapshot(m_scopes[scope]);
+}
+
+HostAllocationStats CHostAllocator::internalStats() const {
+	return snapshot(m_internal);
+}
+
+void CHostAllocator::printReport() const {
+	static const char* scopeNames[SCOPE_COUNT] = { "command", "object", "cache", "device", "instance" };
+	{
+		std::lock_guard<std::mutex> lock(m_chunkMutex);
+		std::cout << "[Host allocator] " << m_chunks.size() << " arena chunks of " << CHUNK_SIZE / 1024 << " KB" << std::endl;
+	}
+	for (size_t scope = 0; scope < SCOPE_COUNT; scope++) {
+		const auto s = snapshot(m_scopes[scope]);
+		std::cout << "  " << scopeNames[scope] << ": " << s.totalCount << " allocations, " << s.liveCount
+				<< " live (" << s.liveBytes << " bytes), peak " << s.peakBytes << " bytes" << std::endl;
+	}
+	const auto s = snapshot(m_internal);
+	std::cout << "  internal: " << s.totalCount << " allocations, peak " << s.peakBytes << " bytes" << std::endl;
+}
@@ -0,0 +1,98 @@
+#include <JobSystem.h>
+#include <algorithm>
+
+CJobSystem::CJobSystem(size_t threadCount) {
+	if (threadCount == 0) {
+		const auto hardware = static_cast<size_t>(std::thread::hardware_concurrency());
+		threadCount = hardware > 1 ? hardware - 1 : 1;
+	}
+	m_workers.reserve(threadCount);
+	for (size_t i = 0; i < threadCount; i++) {
+		m_workers.emplace_back([this] { workerLoop(); });
+	}
+}
+
+CJobSystem::~CJobSystem() {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_condition.notify_all();
+	for (auto& worker : m_workers) { worker.join(); }
+}
+
+void CJobSystem::submit(std::function<void()> task) {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_tasks.push_back(std::move(task));
+	}
+	m_condition.notify_one();
+}
+
+void CJobSystem::submitBackground(std::function<void()> task) {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_backgroundTasks.push_back(std::move(task));
+	}
+	m_condition.notify_one();
+}
+
+size_t CJobSystem::parallelFor(size_t count, size_t grain, const RangeJob& job) {
+	if (count == 0) { return 0; }
+	grain = std::max<size_t>(grain, 1);
+	const auto chunkCount = (count + grain - 1) / grain;
+	// Un seul bloc : pas besoin de passer par les workers
+	if (chunkCount == 1) {
+		job(0, count, 0);
+		return 1;
+	}
+	std::atomic<size_t> remaining{chunkCount};
+	std::mutex doneMutex;
+	std::condition_variable doneCondition;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (size_t chunk = 0; chunk < chunkCount; chunk++) {
+			m_tasks.emplace_back([&, chunk] {
+				const auto begin = chunk * grain;
+				job(begin, std::min(begin + grain, count), chunk);
+				// Dcrment sous verrou : l'appelant ne peut pas dtruire doneMutex avant notre sortie
+				std::lock_guard<std::mutex> doneLock(doneMutex);
+				if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) { doneCondition.notify_all(); }
+			});
+		}
+	}
+	m_condition.notify_all();
+	// Le thread appelant aide  vider la file plutt que d'attendre
+	while (remaining.load(std::memory_order_acquire) > 0 && tryRunOne()) {}
+	std::unique_lock<std::mutex> lock(doneMutex);
+	doneCondition.wait(lock, [&] { return remaining.load(std::memory_order_acquire) == 0; });
+	return chunkCount;
+}
+
+void CJobSystem::workerLoop() {
+	for (;;) {
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_condition.wait(lock, [this] { return m_stop || !m_tasks.empty() || !m_backgroundTasks.empty(); });
+			if (m_stop && m_tasks.empty() && m_backgroundTasks.empty()) { return; }
+			// Tches de fond seulement lorsque la file principale est vide
+			auto& queue = m_tasks.empty() ? m_backgroundTasks : m_tasks;
+			task = std::move(queue.front());
+			queue.pop_front();
+		}
+		task();
+	}
+}
+
+bool CJobSystem::tryRunOne() {
+	std::function<void()> task;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_tasks.empty()) { return false; }
+		task = std::move(m_tasks.front());
+		m_tasks.pop_front();
+	}
+	task();
+	return true;
+}
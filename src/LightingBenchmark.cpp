@@ -0,0 +1,45 @@
+#include <Benchmarks.h>
+#include <VulkanApplication.h>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+	// Frames rendues par configuration : les lumires parcourent une partie de leur orbite
+	constexpr uint64_t BENCHMARK_FRAMES = 240;
+	// Au-del, l'valuation exhaustive prend plusieurs secondes par frame
+	constexpr uint32_t MAX_BRUTE_FORCE_LIGHTS = 4096;
+}
+
+int runLightingBenchmark(const ApplicationSettings& base) {
+	std::cout << "[Lighting benchmark] " << BENCHMARK_FRAMES << " frames per configuration" << std::endl;
+	for (uint32_t count : { 64u, 256u, 1024u, 4096u, 16384u }) {
+		for (auto bruteForce : { false, true }) {
+			if (bruteForce && count > MAX_BRUTE_FORCE_LIGHTS) { continue; }
+			auto settings = base;
+			settings.scene = SceneType::Lod;
+			settings.lighting = true;
+			settings.lightingSettings.lightCount = count;
+			settings.lightingSettings.bruteForce = bruteForce;
+			settings.maxFrames = BENCHMARK_FRAMES;
+			std::cout << std::setw(5) << count << " lights | " << (bruteForce ? "brute force" : "clustered  ") << " | ";
+			auto app = CVulkanApplication{settings};
+			try {
+				app.run();
+			}
+			catch (std::exception const& e) {
+				CLogger::flush();
+				std::cout << "skipped (" << e.what() << ")" << std::endl;
+				continue;
+			}
+			const auto stats = app.statistics();
+			std::cout << std::fixed << std::setprecision(3) << "culling " << stats.gpuLightCullingMs << " ms | shading "
+					<< stats.gpuLightShadingMs << " ms | " << stats.averageFrameMs << " ms/frame";
+			if (!bruteForce) {
+				std::cout << " | " << std::setprecision(1) << stats.averageLightsPerCluster << " lights/cluster (max "
+						<< stats.maxLightsPerCluster << ")";
+			}
+			std::cout << std::endl;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,37 @@
+#include <Benchmarks.h>
+#include <VulkanApplication.h>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+	// Frames rendues par configuration : la grille parcourt une partie de son aller-retour
+	constexpr uint64_t BENCHMARK_FRAMES = 240;
+}
+
+int runLodBenchmark(const ApplicationSettings& base) {
+	std::cout << "[LOD benchmark] " << BENCHMARK_FRAMES << " frames per configuration" << std::endl;
+	for (uint32_t count : { 256u, 1024u, 4096u }) {
+		for (auto enabled : { false, true }) {
+			auto settings = base;
+			settings.scene = SceneType::Lod;
+			settings.lodSettings.objectCount = count;
+			settings.lodSettings.enabled = enabled;
+			settings.maxFrames = BENCHMARK_FRAMES;
+			std::cout << std::setw(5) << count << " objects | LOD " << (enabled ? "on " : "off") << " | ";
+			auto app = CVulkanApplication{settings};
+			try {
+				app.run();
+			}
+			catch (std::exception const& e) {
+				CLogger::flush();
+				std::cout << "skipped (" << e.what() << ")" << std::endl;
+				continue;
+			}
+			const auto stats = app.statistics();
+			std::cout << std::fixed << std::setprecision(0) << stats.averageTriangles << " triangles/frame | "
+					<< std::setprecision(3) << stats.averageFrameMs << " ms/frame (median " << stats.medianFrameMs
+					<< ")" << std::endl;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,302 @@
+#include <LodRenderer.h>
+#include <ShaderLoader.h>
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+	// Camra de la scne de dmonstration
+	constexpr float CAMERA_FOV_Y = 1.0f;
+	constexpr float CAMERA_NEAR = 0.1f;
+	constexpr float CAMERA_FAR = 1000.0f;
+	// Relief du maillage de base : assez marqu pour que la simplification ait un cot visible
+	constexpr float BUMP_AMPLITUDE = 0.08f;
+
+	Vec3 translationOf(const Mat4& world) { return { world.at(0, 3), world.at(1, 3), world.at(2, 3) }; }
+
+	/*
+	 * chelle la plus forte des trois axes : l'erreur projete et la sphre englobante ne sont jamais sous-estimes
+	 */
+	float maxScaleOf(const Mat4& world) {
+		return std::max({
+			length({ world.at(0, 0), world.at(1, 0), world.at(2, 0) }),
+			length({ world.at(0, 1), world.at(1, 1), world.at(2, 1) }),
+			length({ world.at(0, 2), world.at(1, 2), world.at(2, 2) })
+		});
+	}
+}
+
+LodView LodView::forExtent(VkExtent2D extent, bool reverseZ) {
+	const auto aspect = static_cast<float>(extent.width) / static_cast<float>(std::max(extent.height, 1u));
+	auto view = LodView{};
+	view.eye = { 0.0f, 6.0f, 12.0f };
+	view.view = lookAt(view.eye, { 0.0f, 0.0f, -40.0f }, { 0.0f, 1.0f, 0.0f });
+	view.projection = reverseZ ? perspectiveReverseZ(CAMERA_FOV_Y, aspect, CAMERA_NEAR, CAMERA_FAR)
+	                           : perspective(CAMERA_FOV_Y, aspect, CAMERA_NEAR, CAMERA_FAR);
+	view.viewProjection = view.projection * view.view;
+	view.pixelsPerUnit = static_cast<float>(extent.height) / (2.0f * std::tan(CAMERA_FOV_Y * 0.5f));
+	return view;
+}
+
+void CLodRenderer::init(const DeviceContext& context, uint32_t queueFamily, VkQueue queue, const LodSettings& settings,
+                        uint32_t instanceCount, uint32_t frameCount, const VkPhysicalDeviceFeatures& features,
+                        const LodLighting& lighting) {
+	// firstInstance sert d'index dans le buffer d'instances
+	if (!features.drawIndirectFirstInstance) {
+		throw std::runtime_error("Failed to find drawIndirectFirstInstance support for the LOD scene");
+	}
+	m_context = context;
+	m_settings = settings;
+	m_lighting = lighting;
+	m_instanceCount = instanceCount;
+	m_multiDrawIndirect = features.multiDrawIndirect == VK_TRUE;
+	m_chain = buildLodChain(makeIcosphere(settings.subdivisions, BUMP_AMPLITUDE), settings.levelCount);
+	const auto vertexSize = static_cast<VkDeviceSize>(m_chain.positions.size() * sizeof(Vec3));
+	createBuffer(m_context, vertexSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+	             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_vertexBuffer, m_vertexBufferMemory);
+	uploadToBuffer(m_context, queueFamily, queue, m_vertexBuffer, m_chain.positions.data(), vertexSize);
+	const auto indexSize = static_cast<VkDeviceSize>(m_chain.indices.size() * sizeof(uint32_t));
+	createBuffer(m_context, indexSize, VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+	             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_indexBuffer, m_indexBufferMemory);
+	uploadToBuffer(m_context, queueFamily, queue, m_indexBuffer, m_chain.indices.data(), indexSize);
+	createIndirectBuffers(frameCount);
+	auto pushConstantRange = VkPushConstantRange{};
+	pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+	pushConstantRange.offset = 0;
+	pushConstantRange.size = sizeof(Mat4);
+	auto pipelineLayoutInfo = VkPipelineLayoutCreateInfo{};
+	pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+	if (m_lighting.setLayout != VK_NULL_HANDLE) {
+		pipelineLayoutInfo.setLayoutCount = 1;
+		pipelineLayoutInfo.pSetLayouts = &m_lighting.setLayout;
+	}
+	pipelineLayoutInfo.pushConstantRangeCount = 1;
+	pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+	if (vkCreatePipelineLayout(m_context.device, &pipelineLayoutInfo, m_context.allocator, &m_pipelineLayout) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create the LOD pipeline layout");
+	}
+	m_totalTriangles = 0;
+	m_selections = 0;
+}
+
+void CLodRenderer::createIndirectBuffers(uint32_t frameCount) {
+	const auto size = static_cast<VkDeviceSize>(std::max(m_instanceCount, 1u) * sizeof(VkDrawIndexedIndirectCommand));
+	m_indirectBuffers.resize(frameCount);
+	m_indirectBuffersMemory.resize(frameCount);
+	m_indirectCommands.resize(frameCount);
+	for (uint32_t i = 0; i < frameCount; i++) {
+		createBuffer(m_context, size, VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+		             VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+		             m_indirectBuffers[i], m_indirectBuffersMemory[i]);
+		void* data;
+		vkMapMemory(m_context.device, m_indirectBuffersMemory[i], 0, size, 0, &data);
+		m_indirectCommands[i] = static_cast<VkDrawIndexedIndirectCommand*>(data);
+		// Rien n'est dessin avant la premire slection
+		std::fill_n(m_indirectCommands[i], std::max(m_instanceCount, 1u), VkDrawIndexedIndirectCommand{});
+	}
+}
+
+void CLodRenderer::cleanup() {
+	if (m_context.device == VK_NULL_HANDLE) { return; }
+	destroyGraphicsPipeline();
+	vkDestroyPipelineLayout(m_context.device, m_pipelineLayout, m_context.allocator);
+	for (size_t i = 0; i < m_indirectBuffers.size(); i++) {
+		vkUnmapMemory(m_context.device, m_indirectBuffersMemory[i]);
+		destroyBuffer(m_context, m_indirectBuffers[i], m_indirectBuffersMemory[i]);
+	}
+	m_indirectBuffers.clear();
+	m_indirectBuffersMemory.clear();
+	m_indirectCommands.clear();
+	destroyBuffer(m_context, m_indexBuffer, m_indexBufferMemory);
+	destroyBuffer(m_context, m_vertexBuffer, m_vertexBufferMemory);
+	m_context.device = VK_NULL_HANDLE;
+}
+
+void CLodRenderer::createGraphicsPipeline(VkRenderPass renderPass, const DepthSettings& depth) {
+	const auto vertShaderModule = createShaderModule(m_context, CShaderLoader::readFile("shaders/lod_vert.spv"));
+	const auto lit = m_lighting.setLayout != VK_NULL_HANDLE;
+	const auto fragShaderModule = createShaderModule(m_context, CShaderLoader::readFile(lit ? "shaders/lod_lit_frag.spv" : "shaders/lod_frag.spv"));
+	VkPipelineShaderStageCreateInfo shaderStages[2] = {};
+	shaderStages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	shaderStages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+	shaderStages[0].module = vertShaderModule;
+	shaderStages[0].pName = "main";
+	shaderStages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+	shaderStages[1].module = fragShaderModule;
+	shaderStages[1].pName = "main";
+	// constant_id = 0 de la variante claire : valuation de toutes les lumires
+	const auto bruteForce = static_cast<VkBool32>(m_lighting.bruteForce ? VK_TRUE : VK_FALSE);
+	auto specializationEntry = VkSpecializationMapEntry{ 0, 0, sizeof(VkBool32) };
+	auto specializationInfo = VkSpecializationInfo{};
+	specializationInfo.mapEntryCount = 1;
+	specializationInfo.pMapEntries = &specializationEntry;
+	specializationInfo.dataSize = sizeof(VkBool32);
+	specializationInfo.pData = &bruteForce;
+	if (lit) { shaderStages[1].pSpecializationInfo = &specializationInfo; }
+	// Binding 0 : positions partages par les niveaux ; binding 1 : matrice monde par instance (4 colonnes)
+	VkVertexInputBindingDescription bindings[2] = {
+		{ 0, sizeof(Vec3), VK_VERTEX_INPUT_RATE_VERTEX },
+		{ 1, sizeof(Mat4), VK_VERTEX_INPUT_RATE_INSTANCE }
+	};
+	VkVertexInputAttributeDescription attributes[5] = {
+		{ 0, 0, VK_FORMAT_R32G32B32_SFLOAT, 0 },
+		{ 1, 1, VK_FORMAT_R32G32B32A32_SFLOAT, 0 },
+		{ 2, 1, VK_FORMAT_R32G32B32A32_SFLOAT, 4 * sizeof(float) },
+		{ 3, 1, VK_FORMAT_R32G32B32A32_SFLOAT, 8 * sizeof(float) },
+		{ 4, 1, VK_FORMAT_R32G32B32A32_SFLOAT, 12 * sizeof(float) }
+	};
+	auto vertexInputInfo = VkPipelineVertexInputStateCreateInfo{};
+	vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+	vertexInputInfo.vertexBindingDescriptionCount = 2;
+	vertexInputInfo.pVertexBindingDescriptions = bindings;
+	vertexInputInfo.vertexAttributeDescriptionCount = 5;
+	vertexInputInfo.pVertexAttributeDescriptions = attributes;
+	auto inputAssembly = VkPipelineInputAssemblyStateCreateInfo{};
+	inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+	inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+	auto viewportState = VkPipelineViewportStateCreateInfo{};
+	viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+	viewportState.viewportCount = 1;
+	viewportState.scissorCount = 1;
+	VkDynamicState dynamicStates[] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+	auto dynamicState = VkPipelineDynamicStateCreateInfo{};
+	dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+	dynamicState.dynamicStateCount = 2;
+	dynamicState.pDynamicStates = dynamicStates;
+	// Maillages ferms, anti-horaires vus de l'extrieur ; la projection inverse l'axe Y
+	auto rasterizer = VkPipelineRasterizationStateCreateInfo{};
+	rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+	rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+	rasterizer.lineWidth = 1.0f;
+	rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
+	rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+	auto multisampling = VkPipelineMultisampleStateCreateInfo{};
+	multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+	multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+	multisampling.minSampleShading = 1.0f;
+	auto colorBlendAttachment = VkPipelineColorBlendAttachmentState{};
+	colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT
+			| VK_COLOR_COMPONENT_A_BIT;
+	auto colorBlending = VkPipelineColorBlendStateCreateInfo{};
+	colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+	colorBlending.attachmentCount = 1;
+	colorBlending.pAttachments = &colorBlendAttachment;
+	auto depthStencil = depthStencilState(depth, DepthPass::Main);
+	auto pipelineInfo = VkGraphicsPipelineCreateInfo{};
+	pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+	pipelineInfo.stageCount = 2;
+	pipelineInfo.pStages = shaderStages;
+	pipelineInfo.pVertexInputState = &vertexInputInfo;
+	pipelineInfo.pInputAssemblyState = &inputAssembly;
+	pipelineInfo.pViewportState = &viewportState;
+	pipelineInfo.pRasterizationState = &rasterizer;
+	pipelineInfo.pMultisampleState = &multisampling;
+	pipelineInfo.pDepthStencilState = &depthStencil;
+	pipelineInfo.pColorBlendState = &colorBlending;
+	pipelineInfo.pDynamicState = &dynamicState;
+	pipelineInfo.layout = m_pipelineLayout;
+	pipelineInfo.renderPass = renderPass;
+	pipelineInfo.subpass = 0;
+	pipelineInfo.basePipelineIndex = -1;
+	auto result = vkCreateGraphicsPipelines(m_context.device, VK_NULL_HANDLE, 1, &pipelineInfo, m_context.allocator,
+	                                        &m_pipeline);
+	// Pr-passe : mme vertex shader (position invariante, profondeurs identiques au bit prs), sans fragment shader
+	// ni criture de couleur
+	if (result == VK_SUCCESS && depth.enabled && depth.prePass) {
+		pipelineInfo.stageCount = 1;
+		colorBlendAttachment.colorWriteMask = 0;
+		depthStencil = depthStencilState(depth, DepthPass::PrePass);
+		result = vkCreateGraphicsPipelines(m_context.device, VK_NULL_HANDLE, 1, &pipelineInfo, m_context.allocator,
+		                                   &m_prePassPipeline);
+	}
+	vkDestroyShaderModule(m_context.device, fragShaderModule, m_context.allocator);
+	vkDestroyShaderModule(m_context.device, vertShaderModule, m_context.allocator);
+	if (result != VK_SUCCESS) {
+		destroyGraphicsPipeline();
+		throw std::runtime_error("Failed to create the LOD graphics pipeline");
+	}
+}
+
+void CLodRenderer::destroyGraphicsPipeline() {
+	if (m_prePassPipeline != VK_NULL_HANDLE) {
+		vkDestroyPipeline(m_context.device, m_prePassPipeline, m_context.allocator);
+		m_prePassPipeline = VK_NULL_HANDLE;
+	}
+	if (m_pipeline == VK_NULL_HANDLE) { return; }
+	vkDestroyPipeline(m_context.device, m_pipeline, m_context.allocator);
+	m_pipeline = VK_NULL_HANDLE;
+}
+
+uint64_t CLodRenderer::select(uint32_t frame, const std::vector<Mat4>& instances, const LodView& view,
+                              CFrustumCuller* culler) {
+	auto* commands = m_indirectCommands[frame];
+	const auto count = std::min(static_cast<uint32_t>(instances.size()), m_instanceCount);
+	// Culling avant la slection : les instances hors champ ne cotent ni slection ni dessin
+	const auto culled = culler != nullptr && m_settings.frustumCulling;
+	if (culled) {
+		m_volumes.clear();
+		for (uint32_t i = 0; i < count; i++) {
+			m_volumes.addSphere(translationOf(instances[i]), m_chain.radius * maxScaleOf(instances[i]));
+		}
+		culler->cullSpheres(FrustumPlanes::fromViewProjection(view.viewProjection), m_volumes, m_visible);
+	}
+	uint64_t triangles = 0;
+	size_t nextVisible = 0;
+	for (uint32_t i = 0; i < count; i++) {
+		// Indices visibles croissants : un seul parcours suffit
+		if (culled) {
+			if (nextVisible == m_visible.size() || m_visible[nextVisible] != i) {
+				commands[i] = { 0, 0, 0, 0, i };
+				continue;
+			}
+			nextVisible++;
+		}
+		const auto& world = instances[i];
+		uint32_t level = 0;
+		if (m_settings.enabled) {
+			level = selectLod(m_chain, maxScaleOf(world), length(translationOf(world) - view.eye), view.pixelsPerUnit,
+			                  m_settings.thresholdPixels);
+		}
+		const auto& lod = m_chain.levels[level];
+		commands[i] = { lod.indexCount, 1, lod.firstIndex, 0, i };
+		triangles += lod.indexCount / 3;
+	}
+	// Instances absentes de la scne : commandes vides
+	for (uint32_t i = count; i < m_instanceCount; i++) { commands[i] = { 0, 0, 0, 0, 0 }; }
+	m_totalTriangles += triangles;
+	m_selections++;
+	return triangles;
+}
+
+void CLodRenderer::recordDraw(VkCommandBuffer commandBuffer, uint32_t frame, VkBuffer instanceBuffer,
+                              const LodView& view, VkDescriptorSet lightingSet) const {
+	// Layout commun aux deux pipelines : constantes et buffers restent lis d'une passe  l'autre
+	m_context.dispatch->CmdPushConstants(commandBuffer, m_pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(Mat4), view.viewProjection.m);
+	VkBuffer vertexBuffers[] = { m_vertexBuffer, instanceBuffer };
+	VkDeviceSize offsets[] = { 0, 0 };
+	m_context.dispatch->CmdBindVertexBuffers(commandBuffer, 0, 2, vertexBuffers, offsets);
+	m_context.dispatch->CmdBindIndexBuffer(commandBuffer, m_indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+	// Pr-passe : profondeur de la surface visible de chaque pixel, avant les dessins ombrs
+	if (m_prePassPipeline != VK_NULL_HANDLE) {
+		m_context.dispatch->CmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_prePassPipeline);
+		recordIndirectDraws(commandBuffer, frame);
+	}
+	m_context.dispatch->CmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline);
+	if (lightingSet != VK_NULL_HANDLE) {
+		m_context.dispatch->CmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineLayout, 0, 1,
+		                                          &lightingSet, 0, nullptr);
+	}
+	recordIndirectDraws(commandBuffer, frame);
+}
+
+void CLodRenderer::recordIndirectDraws(VkCommandBuffer commandBuffer, uint32_t frame) const {
+	const auto stride = static_cast<uint32_t>(sizeof(VkDrawIndexedIndirectCommand));
+	if (m_multiDrawIndirect) {
+		m_context.dispatch->CmdDrawIndexedIndirect(commandBuffer, m_indirectBuffers[frame], 0, m_instanceCount, stride);
+		return;
+	}
+	// Sans multiDrawIndirect : une commande indirecte par appel
+	for (uint32_t i = 0; i < m_instanceCount; i++) {
+		m_context.dispatch->CmdDrawIndexedIndirect(commandBuffer, m_indirectBuffers[frame], static_cast<VkDeviceSize>(i) * stride, 1, stride);
+	}
+}
@@ -0,0 +1,284 @@
+#include <Logger.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+	using Clock = std::chrono::steady_clock;
+
+	constexpr size_t QUEUE_CAPACITY = 1024;
+	constexpr size_t CATEGORY_SIZE = 16;
+	// Intervalle de vidage de la file : le consommateur dort plutt que d'tre rveill par les producteurs
+	constexpr auto FLUSH_INTERVAL = std::chrono::milliseconds{5};
+	constexpr auto REPEAT_WINDOW = std::chrono::seconds{1};
+
+	/*
+	 * Emplacement de la file. sequence indique  qui appartient l'emplacement :
+	 * == position : libre pour le producteur de cette position, == position + 1 : prt pour le consommateur
+	 */
+	struct alignas(64) LogRecord {
+		std::atomic<uint64_t> sequence{0};
+		int64_t timestamp{0};
+		int32_t messageId{0};
+		uint16_t length{0};
+		LogLevel level{LogLevel::Info};
+		char category[CATEGORY_SIZE]{};
+		char text[CLogger::MAX_MESSAGE_SIZE]{};
+	};
+
+	/*
+	 * Occurrences d'un mme message dans la fentre courante
+	 */
+	struct RepeatEntry {
+		Clock::time_point windowStart;
+		uint32_t count{0};
+		uint32_t suppressed{0};
+		LogLevel level{LogLevel::Info};
+		std::string category;
+		std::string preview;
+	};
+
+	uint64_t hashMessage(const char* category, const char* text, size_t length) {
+		// FNV-1a
+		auto hash = uint64_t{14695981039346656037ull};
+		for (const auto* c = category; *c != '\0'; c++) { hash = (hash ^ static_cast<uint8_t>(*c)) * 1099511628211ull; }
+		for (size_t i = 0; i < length; i++) { hash = (hash ^ static_cast<uint8_t>(text[i])) * 1099511628211ull; }
+		// Bit de poids fort rserv aux identifiants de messages
+		return hash & ~(uint64_t{1} << 63);
+	}
+
+	class CLogQueue {
+	public:
+		CLogQueue() : m_records(std::make_unique<LogRecord[]>(QUEUE_CAPACITY)), m_start(Clock::now()) {
+			for (size_t i = 0; i < QUEUE_CAPACITY; i++) { m_records[i].sequence.store(i, std::memory_order_relaxed); }
+			m_consumer = std::thread{[this] { consumerLoop(); }};
+		}
+
+		~CLogQueue() {
+			m_stop.store(true, std::memory_order_release);
+			m_consumer.join();
+		}
+
+		void push(LogLevel level, std::string_view category, std::string_view message, int32_t messageId) {
+			if (level < m_minimumLevel.load(std::memory_order_relaxed)) { return; }
+			if (messageId != 0) {
+				const auto mutedCount = m_mutedCount.load(std::memory_order_acquire);
+				for (size_t i = 0; i < mutedCount; i++) {
+					if (m_muted[i].load(std::memory_order_relaxed) == messageId) { return; }
+				}
+			}
+			// Rservation d'un emplacement (file borne de Vyukov)
+			auto position = m_enqueuePosition.load(std::memory_order_relaxed);
+			LogRecord* record;
+			for (;;) {
+				record = &m_records[position & (QUEUE_CAPACITY - 1)];
+				const auto sequence = record->sequence.load(std::memory_order_acquire);
+				const auto difference = static_cast<int64_t>(sequence) - static_cast<int64_t>(position);
+				if (difference == 0) {
+					if (m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) { break; }
+				}
+				else if (difference < 0) {
+					// File pleine : le message est perdu plutt que de bloquer le thread appelant
+					m_dropped.fetch_add(1, std::memory_order_relaxed);
+					return;
+				}
+				else { position = m_enqueuePosition.load(std::memory_order_relaxed); }
+			}
+			// steady_clock passe par le vDSO : pas d'appel systme
+			record->timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - m_start).count();
+			record->messageId = messageId;
+			record->level = level;
+			const auto categoryLength = std::min(category.size(), CATEGORY_SIZE - 1);
+			std::memcpy(record->category, category.data(), categoryLength);
+			record->category[categoryLength] = '\0';
+			const auto length = std::min(message.size(), CLogger::MAX_MESSAGE_SIZE);
+			std::memcpy(record->text, message.data(), length);
+			record->length = static_cast<uint16_t>(length);
+			record->sequence.store(position + 1, std::memory_order_release);
+		}
+
+		void flush() {
+			const auto target = m_enqueuePosition.load(std::memory_order_acquire);
+			while (m_consumed.load(std::memory_order_acquire) < target) { std::this_thread::sleep_for(FLUSH_INTERVAL); }
+		}
+
+		void muteMessage(int32_t messageId) {
+			std::lock_guard<std::mutex> lock(m_muteMutex);
+			const auto count = m_mutedCount.load(std::memory_order_relaxed);
+			if (count == CLogger::MAX_MUTED_MESSAGES) { return; }
+			m_muted[count].store(messageId, std::memory_order_relaxed);
+			m_mutedCount.store(count + 1, std::memory_order_release);
+		}
+
+		std::atomic<LogLevel> m_minimumLevel{LogLevel::Info};
+		std::atomic<uint32_t> m_repeatLimit{3};
+		std::atomic<uint64_t> m_written{0};
+		std::atomic<uint64_t> m_dropped{0};
+		std::atomic<uint64_t> m_suppressed{0};
+
+	private:
+		void consumerLoop() {
+			auto lastSweep = Clock::now();
+			for (;;) {
+				// Lecture de m_stop avant de vider la file : aucun message publi avant l'arrt n'est perdu
+				const auto stopping = m_stop.load(std::memory_order_acquire);
+				drain();
+				const auto now = Clock::now();
+				if (now - lastSweep >= REPEAT_WINDOW || stopping) {
+					sweepRepeats(now, stopping);
+					lastSweep = now;
+				}
+				const auto dropped = m_dropped.load(std::memory_order_relaxed);
+				if (dropped != m_reportedDropped) {
+					m_output.append("[Logger] ").append(std::to_string(dropped - m_reportedDropped))
+							.append(" messages dropped (queue full)\n");
+					m_reportedDropped = dropped;
+				}
+				if (!m_output.empty()) {
+					std::cerr.write(m_output.data(), static_cast<std::streamsize>(m_output.size()));
+					std::cerr.flush();
+					m_output.clear();
+				}
+				if (stopping) { return; }
+				std::this_thread::sleep_for(FLUSH_INTERVAL);
+			}
+		}
+
+		void drain() {
+			for (;;) {
+				auto& record = m_records[m_dequeuePosition & (QUEUE_CAPACITY - 1)];
+				if (record.sequence.load(std::memory_order_acquire) != m_dequeuePosition + 1) { return; }
+				process(record);
+				record.sequence.store(m_dequeuePosition + QUEUE_CAPACITY, std::memory_order_release);
+				m_dequeuePosition++;
+				m_consumed.store(m_dequeuePosition, std::memory_order_release);
+			}
+		}
+
+		void process(const LogRecord& record) {
+			const auto key = record.messageId != 0
+					? (uint64_t{1} << 63) | static_cast<uint32_t>(record.messageId)
+					: hashMessage(record.category, record.text, record.length);
+			const auto now = Clock::now();
+			auto& entry = m_repeats[key];
+			if (entry.count == 0 || now - entry.windowStart >= REPEAT_WINDOW) {
+				if (entry.suppressed > 0) { appendRepeatSummary(entry); }
+				entry.windowStart = now;
+				entry.count = 0;
+				entry.suppressed = 0;
+				entry.level = record.level;
+				entry.category = record.category;
+				entry.preview.assign(record.text, std::min<size_t>(record.length, 80));
+			}
+			entry.count++;
+			if (entry.count > m_repeatLimit.load(std::memory_order_relaxed)) {
+				entry.suppressed++;
+				m_suppressed.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+			char prefix[64];
+			const auto prefixLength = std::snprintf(prefix, sizeof(prefix), "[%10.3f ms] [%s] [%s] ",
+			                                        static_cast<double>(record.timestamp) / 1e6,
+			                                        logLevelName(record.level), record.category);
+			m_output.append(prefix, static_cast<size_t>(std::clamp(prefixLength, 0, static_cast<int>(sizeof(prefix)) - 1)));
+			m_output.append(record.text, record.length);
+			if (record.length == CLogger::MAX_MESSAGE_SIZE) { m_output.append("..."); }
+			m_output.push_back('\n');
+			m_written.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		void appendRepeatSummary(const RepeatEntry& entry) {
+			m_output.append("[").append(logLevelName(entry.level)).append("] [").append(entry.category).append("] ... repeated ")
+					.append(std::to_string(entry.suppressed)).append(" more times: ").append(entry.preview).append("\n");
+		}
+
+		/*
+		 * Signale les rptitions des fentres termines et oublie les messages inactifs
+		 */
+		void sweepRepeats(Clock::time_point now, bool all) {
+			for (auto it = m_repeats.begin(); it != m_repeats.end();) {
+				if (all || now - it->second.windowStart >= REPEAT_WINDOW) {
+					if (it->second.suppressed > 0) { appendRepeatSummary(it->second); }
+					it = m_repeats.erase(it);
+				}
+				else { ++it; }
+			}
+		}
+
+		std::unique_ptr<LogRecord[]> m_records;
+		Clock::time_point m_start;
+		alignas(64) std::atomic<uint64_t> m_enqueuePosition{0};
+		alignas(64) std::atomic<uint64_t> m_consumed{0};
+		uint64_t m_dequeuePosition{0};
+
+		std::mutex m_muteMutex;
+		std::array<std::atomic<int32_t>, CLogger::MAX_MUTED_MESSAGES> m_muted{};
+		std::atomic<size_t> m_mutedCount{0};
+
+		// Utiliss uniquement par le thread consommateur
+		std::unordered_map<uint64_t, RepeatEntry> m_repeats;
+		std::string m_output;
+		uint64_t m_reportedDropped{0};
+
+		std::atomic<bool> m_stop{false};
+		std::thread m_consumer;
+	};
+
+	CLogQueue& queue() {
+		// Cre au premier message, dtruite (et vide)  la fin du programme
+		static CLogQueue instance;
+		return instance;
+	}
+}
+
+const char* logLevelName(LogLevel level) {
+	switch (level) {
+		case LogLevel::Verbose: return "V";
+		case LogLevel::Info: return "I";
+		case LogLevel::Warning: return "W";
+		case LogLevel::Error: return "E";
+	}
+	return "?";
+}
+
+void CLogger::log(LogLevel level, std::string_view category, std::string_view message, int32_t messageId) {
+	queue().push(level, category, message, messageId);
+}
+
+void CLogger::setMinimumLevel(LogLevel level) {
+	queue().m_minimumLevel.store(level, std::memory_order_relaxed);
+}
+
+LogLevel CLogger::minimumLevel() {
+	return queue().m_minimumLevel.load(std::memory_order_relaxed);
+}
+
+void CLogger::muteMessage(int32_t messageId) {
+	queue().muteMessage(messageId);
+}
+
+void CLogger::setRepeatLimit(uint32_t limit) {
+	queue().m_repeatLimit.store(std::max<uint32_t>(limit, 1), std::memory_order_relaxed);
+}
+
+void CLogger::flush() {
+	queue().flush();
+}
+
+LoggerStats CLogger::stats() {
+	auto& q = queue();
+	auto stats = LoggerStats{};
+	stats.written = q.m_written.load(std::memory_order_relaxed);
+	stats.dropped = q.m_dropped.load(std::memory_order_relaxed);
+	stats.suppressed = q.m_suppressed.load(std::memory_order_relaxed);
+	return stats;
+}
@@ -0,0 +1,151 @@
+#include <MemoryTelemetry.h>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+const char* memoryCategoryName(MemoryCategory category) {
+	switch (category) {
+	case MemoryCategory::Swapchain: return "swapchain";
+	case MemoryCategory::Buffer: return "buffers";
+	case MemoryCategory::Image: return "images";
+	case MemoryCategory::Staging: return "staging";
+	default: return "?";
+	}
+}
+
+std::vector<const char*> CMemoryTelemetry::optionalInstanceExtensions() {
+	// VK_EXT_memory_budget s'appuie sur vkGetPhysicalDeviceMemoryProperties2 (core en 1.1)
+	uint32_t count = 0;
+	vkEnumerateInstanceExtensionProperties(nullptr, &count, nullptr);
+	auto available = std::vector<VkExtensionProperties>{count};
+	vkEnumerateInstanceExtensionProperties(nullptr, &count, available.data());
+	for (const auto& extension : available) {
+		if (strcmp(extension.extensionName, VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME) == 0) {
+			return { VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME };
+		}
+	}
+	return {};
+}
+
+bool CMemoryTelemetry::isBudgetExtensionSupported(VkPhysicalDevice physicalDevice) {
+	uint32_t count = 0;
+	vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &count, nullptr);
+	auto available = std::vector<VkExtensionProperties>{count};
+	vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &count, available.data());
+	for (const auto& extension : available) {
+		if (strcmp(extension.extensionName, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME) == 0) { return true; }
+	}
+	return false;
+}
+
+void CMemoryTelemetry::init(VkInstance instance, VkPhysicalDevice physicalDevice, bool budgetEnabled) {
+	m_physicalDevice = physicalDevice;
+	vkGetPhysicalDeviceMemoryProperties(physicalDevice, &m_memoryProperties);
+	m_getMemoryProperties2 = reinterpret_cast<PFN_vkGetPhysicalDeviceMemoryProperties2KHR>(vkGetInstanceProcAddr(
+		instance, "vkGetPhysicalDeviceMemoryProperties2KHR"));
+	m_budgetEnabled = budgetEnabled && m_getMemoryProperties2 != nullptr;
+	const auto heapCount = m_memoryProperties.memoryHeapCount;
+	m_tracked.assign(heapCount, {});
+	m_heaps.assign(heapCount, {});
+	m_overThreshold.assign(heapCount, false);
+	for (uint32_t i = 0; i < heapCount; i++) {
+		m_heaps[i].heapIndex = i;
+		m_heaps[i].deviceLocal = (m_memoryProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+	}
+	update();
+}
+
+void CMemoryTelemetry::setThresholdCallback(float threshold, ThresholdCallback callback) {
+	m_threshold = threshold;
+	m_callback = std::move(callback);
+}
+
+VkResult CMemoryTelemetry::allocate(VkDevice device, const VkMemoryAllocateInfo& allocInfo, MemoryCategory category,
+                                    const VkAllocationCallbacks* allocator, VkDeviceMemory* memory) {
+	const auto result = vkAllocateMemory(device, &allocInfo, allocator, memory);
+	if (result != VK_SUCCESS) { return result; }
+	const auto heapIndex = m_memoryProperties.memoryTypes[allocInfo.memoryTypeIndex].heapIndex;
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_allocations[*memory] = { allocInfo.allocationSize, heapIndex, category };
+	m_tracked[heapIndex][static_cast<size_t>(category)] += allocInfo.allocationSize;
+	return result;
+}
+
+void CMemoryTelemetry::release(VkDevice device, VkDeviceMemory memory, const VkAllocationCallbacks* allocator) {
+	if (memory == VK_NULL_HANDLE) { return; }
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		const auto it = m_allocations.find(memory);
+		if (it != m_allocations.end()) {
+			m_tracked[it->second.heapIndex][static_cast<size_t>(it->second.category)] -= it->second.size;
+			m_allocations.erase(it);
+		}
+	}
+	vkFreeMemory(device, memory, allocator);
+}
+
+void CMemoryTelemetry::setExternalUsage(MemoryCategory category, VkDeviceSize bytes) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_external[static_cast<size_t>(category)] = bytes;
+}
+
+void CMemoryTelemetry::update() {
+	auto budgetProperties = VkPhysicalDeviceMemoryBudgetPropertiesEXT{};
+	budgetProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+	if (m_budgetEnabled) {
+		auto properties = VkPhysicalDeviceMemoryProperties2{};
+		properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+		properties.pNext = &budgetProperties;
+		m_getMemoryProperties2(m_physicalDevice, &properties);
+	}
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		auto externalAssigned{false};
+		for (auto& heap : m_heaps) {
+			heap.trackedByCategory = m_tracked[heap.heapIndex];
+			// Les images de la swapchain sont en mmoire device : premier tas DEVICE_LOCAL
+			if (heap.deviceLocal && !externalAssigned) {
+				for (size_t c = 0; c < m_external.size(); c++) { heap.trackedByCategory[c] += m_external[c]; }
+				externalAssigned = true;
+			}
+			VkDeviceSize tracked = 0;
+			for (const auto bytes : heap.trackedByCategory) { tracked += bytes; }
+			if (m_budgetEnabled) {
+				heap.budget = budgetProperties.heapBudget[heap.heapIndex];
+				heap.usage = budgetProperties.heapUsage[heap.heapIndex];
+			}
+			else {
+				// Sans l'extension : 80% de la taille du tas, seules nos allocations sont connues
+				heap.budget = m_memoryProperties.memoryHeaps[heap.heapIndex].size / 10 * 8;
+				heap.usage = tracked;
+			}
+		}
+	}
+	if (!m_callback) { return; }
+	for (auto& heap : m_heaps) {
+		const auto pressure = heap.pressure();
+		// Hystrsis de 5% pour ne pas rappeler  chaque frame autour du seuil
+		if (!m_overThreshold[heap.heapIndex] && pressure >= m_threshold) {
+			m_overThreshold[heap.heapIndex] = true;
+			m_callback(heap);
+		}
+		else if (m_overThreshold[heap.heapIndex] && pressure < m_threshold - 0.05f) {
+			m_overThreshold[heap.heapIndex] = false;
+		}
+	}
+}
+
+void CMemoryTelemetry::printReport() const {
+	constexpr auto MB = 1024.0 * 1024.0;
+	std::cout << "[Memory] budget " << (m_budgetEnabled ? "from VK_EXT_memory_budget" : "estimated") << std::endl;
+	for (const auto& heap : m_heaps) {
+		std::cout << "  heap " << heap.heapIndex << (heap.deviceLocal ? " (device local)" : "") << ": "
+				<< std::fixed << std::setprecision(1) << heap.usage / MB << " / " << heap.budget / MB << " MB";
+		for (size_t c = 0; c < heap.trackedByCategory.size(); c++) {
+			if (heap.trackedByCategory[c] == 0) { continue; }
+			std::cout << " | " << memoryCategoryName(static_cast<MemoryCategory>(c)) << " "
+					<< heap.trackedByCategory[c] / MB << " MB";
+		}
+		std::cout << std::endl;
+	}
+}
@@ -0,0 +1,320 @@
+#include <MeshLod.h>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iterator>
+#include <queue>
+#include <unordered_map>
+
+namespace {
+	/*
+	 * Quadrique d'erreur : somme des carrs des distances aux plans accumuls (matrice 4x4 symtrique)
+	 */
+	struct Quadric {
+		double a2{0.0}, ab{0.0}, ac{0.0}, ad{0.0}, b2{0.0}, bc{0.0}, bd{0.0}, c2{0.0}, cd{0.0}, d2{0.0};
+
+		static Quadric fromPlane(double a, double b, double c, double d) {
+			return { a * a, a * b, a * c, a * d, b * b, b * c, b * d, c * c, c * d, d * d };
+		}
+
+		Quadric& operator+=(const Quadric& q) {
+			a2 += q.a2; ab += q.ab; ac += q.ac; ad += q.ad; b2 += q.b2;
+			bc += q.bc; bd += q.bd; c2 += q.c2; cd += q.cd; d2 += q.d2;
+			return *this;
+		}
+
+		[[nodiscard]]
+		double evaluate(const Vec3& p) const {
+			const double x = p.x, y = p.y, z = p.z;
+			return a2 * x * x + 2.0 * ab * x * y + 2.0 * ac * x * z + 2.0 * ad * x
+					+ b2 * y * y + 2.0 * bc * y * z + 2.0 * bd * y
+					+ c2 * z * z + 2.0 * cd * z + d2;
+		}
+	};
+
+	Quadric operator+(Quadric a, const Quadric& b) { return a += b; }
+
+	/*
+	 * Contraction candidate de l'arte from -> to. Les versions invalident les candidats dont une extrmit
+	 * a chang depuis (file de priorit sans mise  jour en place)
+	 */
+	struct Collapse {
+		double cost;
+		uint32_t from;
+		uint32_t to;
+		uint32_t fromVersion;
+		uint32_t toVersion;
+
+		bool operator>(const Collapse& other) const { return cost > other.cost; }
+	};
+
+	/*
+	 * Simplification incrmentale : simplify() peut tre appele avec des cibles dcroissantes,
+	 * les quadriques restant celles du maillage d'origine
+	 */
+	class CQuadricSimplifier {
+	public:
+		CQuadricSimplifier(const std::vector<Vec3>& positions, const std::vector<uint32_t>& indices);
+
+		/*
+		 * Contracte les artes de moindre cot jusqu' targetTriangles ou jusqu' ce qu'aucune ne soit valide
+		 */
+		void simplify(size_t targetTriangles);
+
+		[[nodiscard]]
+		std::vector<uint32_t> indices() const;
+
+		[[nodiscard]]
+		size_t triangleCount() const { return m_aliveTriangles; }
+
+		/*
+		 * Erreur maximale des contractions effectues (distance)
+		 */
+		[[nodiscard]]
+		float error() const { return static_cast<float>(std::sqrt(std::max(m_maxCost, 0.0))); }
+
+	private:
+		void pushEdges(uint32_t vertex);
+		void pushCollapse(uint32_t from, uint32_t to);
+		void collectNeighbors(uint32_t vertex, std::vector<uint32_t>& neighbors) const;
+		[[nodiscard]]
+		bool isCollapseValid(uint32_t from, uint32_t to) const;
+		void collapse(uint32_t from, uint32_t to);
+
+		const std::vector<Vec3>& m_positions;
+		std::vector<uint32_t> m_triangles;
+		std::vector<uint8_t> m_triangleAlive;
+		std::vector<std::vector<uint32_t>> m_vertexTriangles;
+		std::vector<Quadric> m_quadrics;
+		std::vector<uint32_t> m_versions;
+		std::vector<uint8_t> m_removed;
+		// Sommets du bord d'un maillage ouvert : jamais dplacs, pour conserver la silhouette
+		std::vector<uint8_t> m_border;
+		std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> m_queue;
+		size_t m_aliveTriangles{0};
+		double m_maxCost{0.0};
+	};
+
+	CQuadricSimplifier::CQuadricSimplifier(const std::vector<Vec3>& positions, const std::vector<uint32_t>& indices)
+		: m_positions(positions), m_triangles(indices) {
+		const auto vertexCount = positions.size();
+		const auto triangleCount = indices.size() / 3;
+		m_triangleAlive.assign(triangleCount, 0);
+		m_vertexTriangles.resize(vertexCount);
+		m_quadrics.resize(vertexCount);
+		m_versions.assign(vertexCount, 0);
+		m_removed.assign(vertexCount, 0);
+		m_border.assign(vertexCount, 0);
+		std::unordered_map<uint64_t, uint32_t> edgeUses;
+		for (uint32_t t = 0; t < triangleCount; t++) {
+			const auto* tri = &m_triangles[t * 3];
+			if (tri[0] == tri[1] || tri[1] == tri[2] || tri[0] == tri[2]) { continue; }
+			m_triangleAlive[t] = 1;
+			m_aliveTriangles++;
+			const auto& p0 = positions[tri[0]];
+			const auto normal = cross(positions[tri[1]] - p0, positions[tri[2]] - p0);
+			const auto area = length(normal);
+			if (area > 0.0f) {
+				const auto n = normal * (1.0f / area);
+				const auto plane = Quadric::fromPlane(n.x, n.y, n.z, -dot(n, p0));
+				for (int i = 0; i < 3; i++) { m_quadrics[tri[i]] += plane; }
+			}
+			for (int i = 0; i < 3; i++) {
+				m_vertexTriangles[tri[i]].push_back(t);
+				const auto a = std::min(tri[i], tri[(i + 1) % 3]);
+				const auto b = std::max(tri[i], tri[(i + 1) % 3]);
+				edgeUses[(static_cast<uint64_t>(a) << 32) | b]++;
+			}
+		}
+		for (const auto& [edge, uses] : edgeUses) {
+			if (uses != 1) { continue; }
+			m_border[edge >> 32] = 1;
+			m_border[edge & 0xFFFFFFFFu] = 1;
+		}
+		for (uint32_t v = 0; v < vertexCount; v++) { pushEdges(v); }
+	}
+
+	void CQuadricSimplifier::pushCollapse(uint32_t from, uint32_t to) {
+		if (m_border[from]) { return; }
+		const auto cost = (m_quadrics[from] + m_quadrics[to]).evaluate(m_positions[to]);
+		m_queue.push({ cost, from, to, m_versions[from], m_versions[to] });
+	}
+
+	void CQuadricSimplifier::pushEdges(uint32_t vertex) {
+		for (const auto t : m_vertexTriangles[vertex]) {
+			if (!m_triangleAlive[t]) { continue; }
+			const auto* tri = &m_triangles[t * 3];
+			// Les artes intrieures sont vues deux fois : les doublons sont carts  la contraction
+			for (int i = 0; i < 3; i++) {
+				if (tri[i] == vertex) { continue; }
+				pushCollapse(vertex, tri[i]);
+				pushCollapse(tri[i], vertex);
+			}
+		}
+	}
+
+	void CQuadricSimplifier::collectNeighbors(uint32_t vertex, std::vector<uint32_t>& neighbors) const {
+		neighbors.clear();
+		for (const auto t : m_vertexTriangles[vertex]) {
+			if (!m_triangleAlive[t]) { continue; }
+			for (int i = 0; i < 3; i++) {
+				const auto v = m_triangles[t * 3 + i];
+				if (v != vertex) { neighbors.push_back(v); }
+			}
+		}
+		std::sort(neighbors.begin(), neighbors.end());
+		neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+	}
+
+	bool CQuadricSimplifier::isCollapseValid(uint32_t from, uint32_t to) const {
+		// Condition de lien : deux voisins communs exactement (sinon la contraction pince le maillage)
+		std::vector<uint32_t> fromNeighbors;
+		std::vector<uint32_t> toNeighbors;
+		collectNeighbors(from, fromNeighbors);
+		if (!std::binary_search(fromNeighbors.begin(), fromNeighbors.end(), to)) { return false; }
+		collectNeighbors(to, toNeighbors);
+		std::vector<uint32_t> common;
+		std::set_intersection(fromNeighbors.begin(), fromNeighbors.end(), toNeighbors.begin(), toNeighbors.end(),
+		                      std::back_inserter(common));
+		if (common.size() > 2) { return false; }
+		// Aucun triangle conserv ne doit se retourner
+		for (const auto t : m_vertexTriangles[from]) {
+			if (!m_triangleAlive[t]) { continue; }
+			const auto* tri = &m_triangles[t * 3];
+			if (tri[0] == to || tri[1] == to || tri[2] == to) { continue; }
+			Vec3 before[3];
+			Vec3 after[3];
+			for (int i = 0; i < 3; i++) {
+				before[i] = m_positions[tri[i]];
+				after[i] = m_positions[tri[i] == from ? to : tri[i]];
+			}
+			const auto n0 = cross(before[1] - before[0], before[2] - before[0]);
+			const auto n1 = cross(after[1] - after[0], after[2] - after[0]);
+			if (dot(n0, n1) <= 0.0f) { return false; }
+		}
+		return true;
+	}
+
+	void CQuadricSimplifier::collapse(uint32_t from, uint32_t to) {
+		m_quadrics[to] += m_quadrics[from];
+		auto& toTriangles = m_vertexTriangles[to];
+		for (const auto t : m_vertexTriangles[from]) {
+			if (!m_triangleAlive[t]) { continue; }
+			auto* tri = &m_triangles[t * 3];
+			// Triangles ports par l'arte : dgnrs aprs contraction
+			if (tri[0] == to || tri[1] == to || tri[2] == to) {
+				m_triangleAlive[t] = 0;
+				m_aliveTriangles--;
+				continue;
+			}
+			for (int i = 0; i < 3; i++) {
+				if (tri[i] == from) { tri[i] = to; }
+			}
+			toTriangles.push_back(t);
+		}
+		m_vertexTriangles[from].clear();
+		m_vertexTriangles[from].shrink_to_fit();
+		toTriangles.erase(std::remove_if(toTriangles.begin(), toTriangles.end(),
+		                                 [this](uint32_t t) { return !m_triangleAlive[t]; }), toTriangles.end());
+		m_removed[from] = 1;
+		m_versions[to]++;
+		pushEdges(to);
+	}
+
+	void CQuadricSimplifier::simplify(size_t targetTriangles) {
+		while (m_aliveTriangles > targetTriangles && !m_queue.empty()) {
+			const auto candidate = m_queue.top();
+			m_queue.pop();
+			if (m_removed[candidate.from] || m_removed[candidate.to]
+				|| m_versions[candidate.from] != candidate.fromVersion || m_versions[candidate.to] != candidate.toVersion) {
+				continue;
+			}
+			if (!isCollapseValid(candidate.from, candidate.to)) { continue; }
+			m_maxCost = std::max(m_maxCost, candidate.cost);
+			collapse(candidate.from, candidate.to);
+		}
+	}
+
+	std::vector<uint32_t> CQuadricSimplifier::indices() const {
+		std::vector<uint32_t> result;
+		result.reserve(m_aliveTriangles * 3);
+		for (size_t t = 0; t < m_triangleAlive.size(); t++) {
+			if (!m_triangleAlive[t]) { continue; }
+			result.insert(result.end(), m_triangles.begin() + t * 3, m_triangles.begin() + t * 3 + 3);
+		}
+		return result;
+	}
+}
+
+MeshData makeIcosphere(uint32_t subdivisions, float bumpAmplitude) {
+	const auto t = (1.0f + std::sqrt(5.0f)) * 0.5f;
+	auto mesh = MeshData{};
+	mesh.positions = {
+		{ -1, t, 0 }, { 1, t, 0 }, { -1, -t, 0 }, { 1, -t, 0 },
+		{ 0, -1, t }, { 0, 1, t }, { 0, -1, -t }, { 0, 1, -t },
+		{ t, 0, -1 }, { t, 0, 1 }, { -t, 0, -1 }, { -t, 0, 1 }
+	};
+	mesh.indices = {
+		0, 11, 5, 0, 5, 1, 0, 1, 7, 0, 7, 10, 0, 10, 11,
+		1, 5, 9, 5, 11, 4, 11, 10, 2, 10, 7, 6, 7, 1, 8,
+		3, 9, 4, 3, 4, 2, 3, 2, 6, 3, 6, 8, 3, 8, 9,
+		4, 9, 5, 2, 4, 11, 6, 2, 10, 8, 6, 7, 9, 8, 1
+	};
+	for (auto& p : mesh.positions) { p = normalize(p); }
+	for (uint32_t s = 0; s < subdivisions; s++) {
+		// Milieux partags entre les deux triangles de chaque arte
+		std::unordered_map<uint64_t, uint32_t> midpoints;
+		const auto midpoint = [&](uint32_t a, uint32_t b) {
+			const auto key = (static_cast<uint64_t>(std::min(a, b)) << 32) | std::max(a, b);
+			const auto found = midpoints.find(key);
+			if (found != midpoints.end()) { return found->second; }
+			const auto index = static_cast<uint32_t>(mesh.positions.size());
+			mesh.positions.push_back(normalize((mesh.positions[a] + mesh.positions[b]) * 0.5f));
+			midpoints.emplace(key, index);
+			return index;
+		};
+		std::vector<uint32_t> indices;
+		indices.reserve(mesh.indices.size() * 4);
+		for (size_t i = 0; i < mesh.indices.size(); i += 3) {
+			const auto a = mesh.indices[i], b = mesh.indices[i + 1], c = mesh.indices[i + 2];
+			const auto ab = midpoint(a, b), bc = midpoint(b, c), ca = midpoint(c, a);
+			indices.insert(indices.end(), { a, ab, ca, b, bc, ab, c, ca, bc, ab, bc, ca });
+		}
+		mesh.indices = std::move(indices);
+	}
+	for (auto& p : mesh.positions) {
+		p = p * (1.0f + bumpAmplitude * std::sin(6.0f * p.x) * std::sin(6.0f * p.y) * std::sin(6.0f * p.z));
+	}
+	return mesh;
+}
+
+LodChain buildLodChain(const MeshData& mesh, uint32_t levelCount, float reduction) {
+	auto chain = LodChain{};
+	chain.positions = mesh.positions;
+	for (const auto& p : mesh.positions) { chain.radius = std::max(chain.radius, length(p)); }
+	chain.indices = mesh.indices;
+	chain.levels.push_back({ 0, static_cast<uint32_t>(mesh.indices.size()), 0.0f });
+	CQuadricSimplifier simplifier{mesh.positions, mesh.indices};
+	auto triangles = simplifier.triangleCount();
+	for (uint32_t level = 1; level < levelCount; level++) {
+		simplifier.simplify(static_cast<size_t>(static_cast<float>(triangles) * reduction));
+		// Plus aucune contraction valide
+		if (simplifier.triangleCount() >= triangles) { break; }
+		triangles = simplifier.triangleCount();
+		const auto indices = simplifier.indices();
+		chain.levels.push_back({ static_cast<uint32_t>(chain.indices.size()), static_cast<uint32_t>(indices.size()),
+		                         simplifier.error() });
+		chain.indices.insert(chain.indices.end(), indices.begin(), indices.end());
+	}
+	return chain;
+}
+
+uint32_t selectLod(const LodChain& chain, float scale, float distance, float pixelsPerUnit, float thresholdPixels) {
+	// Camra  l'intrieur de la sphre englobante : pleine rsolution
+	if (distance <= chain.radius * scale) { return 0; }
+	const auto pixelsPerObjectUnit = scale * pixelsPerUnit / distance;
+	for (auto level = static_cast<uint32_t>(chain.levels.size()) - 1; level > 0; level--) {
+		if (chain.levels[level].error * pixelsPerObjectUnit <= thresholdPixels) { return level; }
+	}
+	return 0;
+}
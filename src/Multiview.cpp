@@ -0,0 +1,435 @@
+#include <Multiview.h>
+#include <ShaderLoader.h>
+#include <Logger.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace {
+	// Timestamps crits par frame : dbut du rendu des vues, fin de la copie
+	constexpr uint32_t TIMESTAMP_BEGIN = 0;
+	constexpr uint32_t TIMESTAMP_END = 1;
+	constexpr float CAMERA_FOV_Y = 1.0471976f;
+	// cart angulaire entre deux camras voisines (stro : cart d'yeux)
+	constexpr float STEREO_ANGLE = 0.035f;
+	constexpr float CAMERA_ARC_STEP = 0.2f;
+}
+
+bool CMultiviewRenderer::isSupported(VkPhysicalDevice physicalDevice) {
+	uint32_t count = 0;
+	vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &count, nullptr);
+	auto available = std::vector<VkExtensionProperties>{count};
+	vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &count, available.data());
+	for (const auto& extension : available) {
+		if (strcmp(extension.extensionName, VK_KHR_MULTIVIEW_EXTENSION_NAME) == 0) { return true; }
+	}
+	return false;
+}
+
+void CMultiviewRenderer::init(const DeviceContext& context, uint32_t queueFamily, VkFormat format,
+                              VkExtent2D swapChainExtent, uint32_t frameCount, const MultiviewSettings& settings) {
+	m_context = context;
+	m_settings = settings;
+	m_settings.viewCount = std::clamp(settings.viewCount, 1u, MAX_VIEWS);
+	m_settings.drawCount = std::clamp(settings.drawCount, 1u, std::max(settings.triangleCount, 1u));
+	m_format = format;
+	m_swapChainExtent = swapChainExtent;
+	// Mosaque : une ligne jusqu' deux vues, deux lignes au-del
+	const auto viewCount = m_settings.viewCount;
+	m_tileColumns = viewCount <= 2 ? viewCount : (viewCount + 1) / 2;
+	m_tileRows = (viewCount + m_tileColumns - 1) / m_tileColumns;
+	m_viewExtent = { std::max(1u, swapChainExtent.width / m_tileColumns), std::max(1u, swapChainExtent.height / m_tileRows) };
+	m_gridColumns = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(std::max(m_settings.triangleCount, 1u)))));
+	m_totalGpuMs = 0.0;
+	m_measuredFrames = 0;
+	createRenderPass();
+	createViewBuffer();
+	createPipeline();
+	auto poolInfo = VkCommandPoolCreateInfo{};
+	poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	poolInfo.queueFamilyIndex = queueFamily;
+	// Les command buffers sont renregistrs  chaque frame
+	poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+	if (vkCreateCommandPool(m_context.device, &poolInfo, m_context.allocator, &m_commandPool) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create the multiview command pool");
+	}
+	m_commandBuffers.resize(frameCount);
+	auto allocInfo = VkCommandBufferAllocateInfo{};
+	allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	allocInfo.commandPool = m_commandPool;
+	allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	allocInfo.commandBufferCount = frameCount;
+	if (vkAllocateCommandBuffers(m_context.device, &allocInfo, m_commandBuffers.data()) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to allocate the multiview command buffers");
+	}
+	m_targets.assign(frameCount, RenderTarget{});
+	for (auto& target : m_targets) { createTarget(target); }
+	m_timer.init(m_context, queueFamily, frameCount, 2);
+	CLogger::log(LogLevel::Info, "Multiview", std::to_string(viewCount) + " views of " + std::to_string(m_viewExtent.width)
+	             + "x" + std::to_string(m_viewExtent.height) + (m_settings.singlePass ? " in one pass" : " in one pass per view"));
+}
+
+void CMultiviewRenderer::cleanup() {
+	if (m_context.device == VK_NULL_HANDLE) { return; }
+	for (auto& target : m_targets) { destroyTarget(target); }
+	m_targets.clear();
+	m_timer.cleanup();
+	vkDestroyCommandPool(m_context.device, m_commandPool, m_context.allocator);
+	m_commandBuffers.clear();
+	vkDestroyPipeline(m_context.device, m_pipeline, m_context.allocator);
+	vkDestroyPipelineLayout(m_context.device, m_pipelineLayout, m_context.allocator);
+	vkDestroyDescriptorPool(m_context.device, m_descriptorPool, m_context.allocator);
+	vkDestroyDescriptorSetLayout(m_context.device, m_descriptorSetLayout, m_context.allocator);
+	destroyBuffer(m_context, m_viewBuffer, m_viewBufferMemory);
+	vkDestroyRenderPass(m_context.device, m_renderPass, m_context.allocator);
+	m_context.device = VK_NULL_HANDLE;
+}
+
+void CMultiviewRenderer::onFrameCompleted(uint32_t frameInFlight) {
+	if (!m_timer.isSupported() || !m_timer.resolve(frameInFlight)) { return; }
+	m_totalGpuMs += m_timer.elapsedMs(frameInFlight, TIMESTAMP_BEGIN, TIMESTAMP_END);
+	m_measuredFrames++;
+}
+
+VkCommandBuffer CMultiviewRenderer::record(uint32_t frameInFlight, VkImage swapChainImage) {
+	const auto& target = m_targets[frameInFlight];
+	auto commandBuffer = m_commandBuffers[frameInFlight];
+	m_context.dispatch->ResetCommandBuffer(commandBuffer, 0);
+	auto beginInfo = VkCommandBufferBeginInfo{};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	if (m_context.dispatch->BeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to begin a multiview command buffer");
+	}
+	if (m_timer.isSupported()) {
+		m_timer.reset(commandBuffer, frameInFlight);
+		m_timer.write(commandBuffer, frameInFlight, TIMESTAMP_BEGIN, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+	}
+	// Les render passes laissent toutes les couches en TRANSFER_SRC_OPTIMAL
+	recordViews(commandBuffer, target);
+	// Image de la swapchain : UNDEFINED -> TRANSFER_DST (stage source chan au smaphore d'acquisition)
+	auto barrier = VkImageMemoryBarrier{};
+	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	barrier.srcAccessMask = 0;
+	barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.image = swapChainImage;
+	barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+	m_context.dispatch->CmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+	                                       0, 0, nullptr, 0, nullptr, 1, &barrier);
+	// Mosaque incomplte (case vide ou reste de division) : le fond est effac avant les copies
+	if (m_tileColumns * m_tileRows != m_settings.viewCount || m_tileColumns * m_viewExtent.width != m_swapChainExtent.width
+		|| m_tileRows * m_viewExtent.height != m_swapChainExtent.height) {
+		const auto clearColor = VkClearColorValue{ { 0.0f, 0.0f, 0.0f, 1.0f } };
+		m_context.dispatch->CmdClearColorImage(commandBuffer, swapChainImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &clearColor, 1,
+		                                       &barrier.subresourceRange);
+		auto clearBarrier = barrier;
+		clearBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		clearBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		m_context.dispatch->CmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+		                                       0, 0, nullptr, 0, nullptr, 1, &clearBarrier);
+	}
+	// Mme format et mme taille : simple copie de chaque couche vers sa case
+	auto regions = std::array<VkImageCopy, MAX_VIEWS>{};
+	for (uint32_t view = 0; view < m_settings.viewCount; view++) {
+		auto& region = regions[view];
+		region.srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, view, 1 };
+		region.dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+		region.dstOffset = { static_cast<int32_t>((view % m_tileColumns) * m_viewExtent.width),
+		                     static_cast<int32_t>((view / m_tileColumns) * m_viewExtent.height), 0 };
+		region.extent = { m_viewExtent.width, m_viewExtent.height, 1 };
+	}
+	m_context.dispatch->CmdCopyImage(commandBuffer, target.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, swapChainImage,
+	                                 VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, m_settings.viewCount, regions.data());
+	barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.dstAccessMask = 0;
+	barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barrier.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+	m_context.dispatch->CmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+	                                       0, 0, nullptr, 0, nullptr, 1, &barrier);
+	if (m_timer.isSupported()) {
+		m_timer.write(commandBuffer, frameInFlight, TIMESTAMP_END, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+	}
+	if (m_context.dispatch->EndCommandBuffer(commandBuffer) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to end a multiview command buffer");
+	}
+	return commandBuffer;
+}
+
+void CMultiviewRenderer::recordViews(VkCommandBuffer commandBuffer, const RenderTarget& target) const {
+	const auto trianglesPerDraw = (m_settings.triangleCount + m_settings.drawCount - 1) / m_settings.drawCount;
+	auto renderPassInfo = VkRenderPassBeginInfo{};
+	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+	renderPassInfo.renderPass = m_renderPass;
+	renderPassInfo.renderArea.offset = { 0, 0 };
+	renderPassInfo.renderArea.extent = m_viewExtent;
+	auto clearColor = VkClearValue{ 0.0f, 0.0f, 0.0f, 1.0f };
+	renderPassInfo.clearValueCount = 1;
+	renderPassInfo.pClearValues = &clearColor;
+	auto viewport = VkViewport{ 0.0f, 0.0f, static_cast<float>(m_viewExtent.width), static_cast<float>(m_viewExtent.height), 0.0f, 1.0f };
+	auto scissor = VkRect2D{ { 0, 0 }, m_viewExtent };
+	// Une passe diffuse  toutes les vues, ou une passe (et les mmes dessins) par vue
+	for (uint32_t pass = 0; pass < target.framebuffers.size(); pass++) {
+		renderPassInfo.framebuffer = target.framebuffers[pass];
+		m_context.dispatch->CmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+		m_context.dispatch->CmdSetViewport(commandBuffer, 0, 1, &viewport);
+		m_context.dispatch->CmdSetScissor(commandBuffer, 0, 1, &scissor);
+		m_context.dispatch->CmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline);
+		m_context.dispatch->CmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineLayout, 0, 1, &m_descriptorSet, 0, nullptr);
+		const auto pushConstants = PushConstants{ pass, m_gridColumns };
+		m_context.dispatch->CmdPushConstants(commandBuffer, m_pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(PushConstants), &pushConstants);
+		for (uint32_t first = 0; first < m_settings.triangleCount; first += trianglesPerDraw) {
+			m_context.dispatch->CmdDraw(commandBuffer, 3, std::min(trianglesPerDraw, m_settings.triangleCount - first), 0, first);
+		}
+		m_context.dispatch->CmdEndRenderPass(commandBuffer);
+	}
+}
+
+void CMultiviewRenderer::createRenderPass() {
+	auto colorAttachment = VkAttachmentDescription{};
+	colorAttachment.format = m_format;
+	colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+	colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+	colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+	colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+	colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	// Prte pour la copie vers la swapchain
+	colorAttachment.finalLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+	auto colorAttachmentRef = VkAttachmentReference{};
+	colorAttachmentRef.attachment = 0;
+	colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+	auto subpass = VkSubpassDescription{};
+	subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+	subpass.colorAttachmentCount = 1;
+	subpass.pColorAttachments = &colorAttachmentRef;
+	VkSubpassDependency dependencies[2] = {};
+	// La copie prcdente de cette cible doit avoir fini de la lire
+	dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+	dependencies[0].dstSubpass = 0;
+	dependencies[0].srcStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+	dependencies[0].srcAccessMask = 0;
+	dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	// La copie lit ce que la passe a crit
+	dependencies[1].srcSubpass = 0;
+	dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+	dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	dependencies[1].dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+	dependencies[1].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+	auto renderPassInfo = VkRenderPassCreateInfo{};
+	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+	renderPassInfo.attachmentCount = 1;
+	renderPassInfo.pAttachments = &colorAttachment;
+	renderPassInfo.subpassCount = 1;
+	renderPassInfo.pSubpasses = &subpass;
+	renderPassInfo.dependencyCount = 2;
+	renderPassInfo.pDependencies = dependencies;
+	// Masque de vues : le sous-passe est excut pour chaque couche ; les vues, proches, sont dclares corrles
+	const auto viewMask = (1u << m_settings.viewCount) - 1;
+	auto multiviewInfo = VkRenderPassMultiviewCreateInfoKHR{};
+	multiviewInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_MULTIVIEW_CREATE_INFO_KHR;
+	multiviewInfo.subpassCount = 1;
+	multiviewInfo.pViewMasks = &viewMask;
+	multiviewInfo.correlationMaskCount = 1;
+	multiviewInfo.pCorrelationMasks = &viewMask;
+	if (m_settings.singlePass) { renderPassInfo.pNext = &multiviewInfo; }
+	if (vkCreateRenderPass(m_context.device, &renderPassInfo, m_context.allocator, &m_renderPass) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create the multiview render pass");
+	}
+}
+
+void CMultiviewRenderer::createViewBuffer() {
+	// Tableau de MAX_VIEWS matrices (std140) crit une fois : les camras sont fixes
+	auto matrices = viewMatrices();
+	matrices.resize(MAX_VIEWS, matrices.back());
+	const auto size = static_cast<VkDeviceSize>(MAX_VIEWS * sizeof(Mat4));
+	createBuffer(m_context, size, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+	             VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_viewBuffer, m_viewBufferMemory);
+	void* data;
+	vkMapMemory(m_context.device, m_viewBufferMemory, 0, size, 0, &data);
+	std::memcpy(data, matrices.data(), static_cast<size_t>(size));
+	vkUnmapMemory(m_context.device, m_viewBufferMemory);
+	auto binding = VkDescriptorSetLayoutBinding{};
+	binding.binding = 0;
+	binding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+	binding.descriptorCount = 1;
+	binding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+	auto layoutInfo = VkDescriptorSetLayoutCreateInfo{};
+	layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+	layoutInfo.bindingCount = 1;
+	layoutInfo.pBindings = &binding;
+	if (vkCreateDescriptorSetLayout(m_context.device, &layoutInfo, m_context.allocator, &m_descriptorSetLayout) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create the multiview descriptor set layout");
+	}
+	auto poolSize = VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1 };
+	auto poolInfo = VkDescriptorPoolCreateInfo{};
+	poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	poolInfo.maxSets = 1;
+	poolInfo.poolSizeCount = 1;
+	poolInfo.pPoolSizes = &poolSize;
+	if (vkCreateDescriptorPool(m_context.device, &poolInfo, m_context.allocator, &m_descriptorPool) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create the multiview descriptor pool");
+	}
+	auto allocInfo = VkDescriptorSetAllocateInfo{};
+	allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	allocInfo.descriptorPool = m_descriptorPool;
+	allocInfo.descriptorSetCount = 1;
+	allocInfo.pSetLayouts = &m_descriptorSetLayout;
+	if (vkAllocateDescriptorSets(m_context.device, &allocInfo, &m_descriptorSet) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to allocate the multiview descriptor set");
+	}
+	auto bufferInfo = VkDescriptorBufferInfo{ m_viewBuffer, 0, VK_WHOLE_SIZE };
+	auto write = VkWriteDescriptorSet{};
+	write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	write.dstSet = m_descriptorSet;
+	write.dstBinding = 0;
+	write.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+	write.descriptorCount = 1;
+	write.pBufferInfo = &bufferInfo;
+	vkUpdateDescriptorSets(m_context.device, 1, &write, 0, nullptr);
+}
+
+void CMultiviewRenderer::createPipeline() {
+	auto pushConstantRange = VkPushConstantRange{};
+	pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+	pushConstantRange.offset = 0;
+	pushConstantRange.size = sizeof(PushConstants);
+	auto pipelineLayoutInfo = VkPipelineLayoutCreateInfo{};
+	pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+	pipelineLayoutInfo.setLayoutCount = 1;
+	pipelineLayoutInfo.pSetLayouts = &m_descriptorSetLayout;
+	pipelineLayoutInfo.pushConstantRangeCount = 1;
+	pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+	if (vkCreatePipelineLayout(m_context.device, &pipelineLayoutInfo, m_context.allocator, &m_pipelineLayout) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create the multiview pipeline layout");
+	}
+	// shader.vert compil avec MULTIVIEW (matrice par vue), shader.frag inchang. Une passe par vue : variante sans
+	// gl_ViewIndex, dont la capacit MultiView n'est active sur le device qu'avec VK_KHR_multiview
+	const auto vertShaderModule = createShaderModule(m_context, CShaderLoader::readFile(
+		m_settings.singlePass ? "shaders/multiview_vert.spv" : "shaders/multiview_passes_vert.spv"));
+	const auto fragShaderModule = createShaderModule(m_context, CShaderLoader::readFile("shaders/frag.spv"));
+	VkPipelineShaderStageCreateInfo shaderStages[2] = {};
+	shaderStages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	shaderStages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+	shaderStages[0].module = vertShaderModule;
+	shaderStages[0].pName = "main";
+	shaderStages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+	shaderStages[1].module = fragShaderModule;
+	shaderStages[1].pName = "main";
+	auto vertexInputInfo = VkPipelineVertexInputStateCreateInfo{};
+	vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+	auto inputAssembly = VkPipelineInputAssemblyStateCreateInfo{};
+	inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+	inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+	auto viewportState = VkPipelineViewportStateCreateInfo{};
+	viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+	viewportState.viewportCount = 1;
+	viewportState.scissorCount = 1;
+	VkDynamicState dynamicStates[] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+	auto dynamicState = VkPipelineDynamicStateCreateInfo{};
+	dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+	dynamicState.dynamicStateCount = 2;
+	dynamicState.pDynamicStates = dynamicStates;
+	auto rasterizer = VkPipelineRasterizationStateCreateInfo{};
+	rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+	rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+	rasterizer.lineWidth = 1.0f;
+	// Triangles vus des deux cts selon la camra
+	rasterizer.cullMode = VK_CULL_MODE_NONE;
+	auto multisampling = VkPipelineMultisampleStateCreateInfo{};
+	multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+	multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+	auto colorBlendAttachment = VkPipelineColorBlendAttachmentState{};
+	colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT
+			| VK_COLOR_COMPONENT_A_BIT;
+	auto colorBlending = VkPipelineColorBlendStateCreateInfo{};
+	colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+	colorBlending.attachmentCount = 1;
+	colorBlending.pAttachments = &colorBlendAttachment;
+	auto pipelineInfo = VkGraphicsPipelineCreateInfo{};
+	pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+	pipelineInfo.stageCount = 2;
+	pipelineInfo.pStages = shaderStages;
+	pipelineInfo.pVertexInputState = &vertexInputInfo;
+	pipelineInfo.pInputAssemblyState = &inputAssembly;
+	pipelineInfo.pViewportState = &viewportState;
+	pipelineInfo.pRasterizationState = &rasterizer;
+	pipelineInfo.pMultisampleState = &multisampling;
+	pipelineInfo.pColorBlendState = &colorBlending;
+	pipelineInfo.pDynamicState = &dynamicState;
+	pipelineInfo.layout = m_pipelineLayout;
+	pipelineInfo.renderPass = m_renderPass;
+	pipelineInfo.subpass = 0;
+	pipelineInfo.basePipelineIndex = -1;
+	const auto result = vkCreateGraphicsPipelines(m_context.device, VK_NULL_HANDLE, 1, &pipelineInfo, m_context.allocator,
+	                                              &m_pipeline);
+	vkDestroyShaderModule(m_context.device, fragShaderModule, m_context.allocator);
+	vkDestroyShaderModule(m_context.device, vertShaderModule, m_context.allocator);
+	if (result != VK_SUCCESS) { throw std::runtime_error("Failed to create the multiview graphics pipeline"); }
+}
+
+void CMultiviewRenderer::createTarget(RenderTarget& target) {
+	const auto viewCount = m_settings.viewCount;
+	createImage(m_context, m_viewExtent, m_format, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+	            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, target.image, target.memory, MemoryCategory::Image, viewCount);
+	// Une passe : vue 2D_ARRAY sur toutes les couches (framebuffer  une couche, le masque de vues choisit les couches)
+	const auto passCount = m_settings.singlePass ? 1u : viewCount;
+	target.views.resize(passCount);
+	target.framebuffers.resize(passCount);
+	for (uint32_t pass = 0; pass < passCount; pass++) {
+		auto viewInfo = VkImageViewCreateInfo{};
+		viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		viewInfo.image = target.image;
+		viewInfo.viewType = m_settings.singlePass ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D;
+		viewInfo.format = m_format;
+		viewInfo.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, pass, m_settings.singlePass ? viewCount : 1u };
+		if (vkCreateImageView(m_context.device, &viewInfo, m_context.allocator, &target.views[pass]) != VK_SUCCESS) {
+			throw std::runtime_error("Failed to create a multiview image view");
+		}
+		auto framebufferInfo = VkFramebufferCreateInfo{};
+		framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+		framebufferInfo.renderPass = m_renderPass;
+		framebufferInfo.attachmentCount = 1;
+		framebufferInfo.pAttachments = &target.views[pass];
+		framebufferInfo.width = m_viewExtent.width;
+		framebufferInfo.height = m_viewExtent.height;
+		framebufferInfo.layers = 1;
+		if (vkCreateFramebuffer(m_context.device, &framebufferInfo, m_context.allocator, &target.framebuffers[pass]) != VK_SUCCESS) {
+			throw std::runtime_error("Failed to create a multiview framebuffer");
+		}
+	}
+}
+
+void CMultiviewRenderer::destroyTarget(RenderTarget& target) {
+	if (target.image == VK_NULL_HANDLE) { return; }
+	for (size_t i = 0; i < target.framebuffers.size(); i++) {
+		vkDestroyFramebuffer(m_context.device, target.framebuffers[i], m_context.allocator);
+		vkDestroyImageView(m_context.device, target.views[i], m_context.allocator);
+	}
+	destroyImage(m_context, target.image, target.memory);
+	target = RenderTarget{};
+}
+
+std::vector<Mat4> CMultiviewRenderer::viewMatrices() const {
+	const auto aspect = static_cast<float>(m_viewExtent.width) / static_cast<float>(m_viewExtent.height);
+	// Distance  laquelle toute la grille tient dans le champ vertical
+	const auto distance = static_cast<float>(m_gridColumns) / (2.0f * std::tan(CAMERA_FOV_Y * 0.5f)) + 2.0f;
+	const auto step = m_settings.viewCount == 2 ? STEREO_ANGLE : CAMERA_ARC_STEP;
+	const auto projection = perspective(CAMERA_FOV_Y, aspect, 0.1f, distance * 2.0f);
+	auto matrices = std::vector<Mat4>{};
+	for (uint32_t view = 0; view < m_settings.viewCount; view++) {
+		const auto angle = (static_cast<float>(view) - static_cast<float>(m_settings.viewCount - 1) * 0.5f) * step;
+		const auto eye = Vec3{ distance * std::sin(angle), 0.0f, distance * std::cos(angle) };
+		matrices.push_back(projection * lookAt(eye, { 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }));
+	}
+	return matrices;
+}
@@ -0,0 +1,36 @@
+#include <Benchmarks.h>
+#include <VulkanApplication.h>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+	constexpr uint64_t BENCHMARK_FRAMES = 240;
+}
+
+int runMultiviewBenchmark(const ApplicationSettings& base) {
+	std::cout << "[Multiview benchmark] " << BENCHMARK_FRAMES << " frames per configuration" << std::endl;
+	for (uint32_t views : { 2u, 4u, 6u }) {
+		for (auto singlePass : { false, true }) {
+			auto settings = base;
+			settings.scene = SceneType::Triangle;
+			settings.multiview = true;
+			settings.multiviewSettings.viewCount = views;
+			settings.multiviewSettings.singlePass = singlePass;
+			settings.maxFrames = BENCHMARK_FRAMES;
+			std::cout << views << " views | " << (singlePass ? "single pass" : "N passes   ") << " | ";
+			auto app = CVulkanApplication{settings};
+			try {
+				app.run();
+			}
+			catch (std::exception const& e) {
+				CLogger::flush();
+				std::cout << "skipped (" << e.what() << ")" << std::endl;
+				continue;
+			}
+			const auto stats = app.statistics();
+			std::cout << std::fixed << std::setprecision(3) << stats.averageFrameMs << " ms/frame (median "
+					<< stats.medianFrameMs << ") | GPU " << stats.gpuMultiviewMs << " ms/frame" << std::endl;
+		}
+	}
+	return 0;
+}
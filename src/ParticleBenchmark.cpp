@@ -0,0 +1,44 @@
+#include <Benchmarks.h>
+#include <VulkanApplication.h>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+	// Frames rendues par configuration : assez pour amortir la mise en route des premires frames
+	constexpr uint64_t BENCHMARK_FRAMES = 120;
+}
+
+int runParticleBenchmark(const ApplicationSettings& base) {
+	std::cout << "[Particle benchmark] " << BENCHMARK_FRAMES << " frames per configuration" << std::endl;
+	for (uint32_t count : { 1u << 18, 1u << 20, 1u << 22, 1u << 24 }) {
+		for (uint32_t workgroupSize : { 32u, 64u, 128u, 256u, 512u, 1024u }) {
+			auto settings = base;
+			settings.scene = SceneType::Particles;
+			settings.particleSettings.count = count;
+			settings.particleSettings.workgroupSize = workgroupSize;
+			settings.maxFrames = BENCHMARK_FRAMES;
+			std::cout << std::setw(9) << count << " particles | workgroup " << std::setw(4) << workgroupSize << " | ";
+			// Chaque configuration a son propre device : une limite dpasse n'interrompt pas la srie
+			auto app = CVulkanApplication{settings};
+			try {
+				app.run();
+			}
+			catch (std::exception const& e) {
+				CLogger::flush();
+				std::cout << "skipped (" << e.what() << ")" << std::endl;
+				continue;
+			}
+			const auto stats = app.statistics();
+			if (stats.gpuComputeMs <= 0.0) {
+				std::cout << "no GPU timestamps | " << std::fixed << std::setprecision(3) << stats.averageFrameMs
+						<< " ms/frame" << std::endl;
+				continue;
+			}
+			const auto rate = static_cast<double>(count) / (stats.gpuComputeMs / 1000.0);
+			std::cout << std::fixed << std::setprecision(3) << stats.gpuComputeMs << " ms compute | "
+					<< std::setprecision(1) << rate / 1.0e6 << " M particles/s | " << std::setprecision(3)
+					<< stats.averageFrameMs << " ms/frame" << std::endl;
+		}
+	}
+	return 0;
+}
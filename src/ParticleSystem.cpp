@@ -0,0 +1,295 @@
+#include <ParticleSystem.h>
+#include <ShaderLoader.h>
+#include <DepthBuffer.h>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+	// Composantes stockes par particule (position et vitesse)
+	constexpr uint32_t COMPONENTS = 6;
+	// Timestamps par mesure : avant et aprs le dispatch
+	constexpr uint32_t TIMESTAMP_BEGIN = 0;
+	constexpr uint32_t TIMESTAMP_END = 1;
+}
+
+void CParticleSystem::init(const DeviceContext& context, uint32_t queueFamily, VkQueue queue,
+                           const ParticleSettings& settings, uint32_t timerSlots) {
+	uint32_t queueFamilyCount = 0;
+	vkGetPhysicalDeviceQueueFamilyProperties(context.physicalDevice, &queueFamilyCount, nullptr);
+	std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+	vkGetPhysicalDeviceQueueFamilyProperties(context.physicalDevice, &queueFamilyCount, queueFamilies.data());
+	// Simulation et affichage sur la mme queue : pas de transfert de proprit du buffer
+	if (!(queueFamilies[queueFamily].queueFlags & VK_QUEUE_COMPUTE_BIT)) {
+		throw std::runtime_error("Failed to find compute support on the graphics queue");
+	}
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(context.physicalDevice, &properties);
+	const auto bufferSize = static_cast<VkDeviceSize>(settings.count) * COMPONENTS * sizeof(float);
+	if (bufferSize > properties.limits.maxStorageBufferRange) {
+		throw std::runtime_error("Particle count exceeds maxStorageBufferRange");
+	}
+	if (settings.workgroupSize > properties.limits.maxComputeWorkGroupSize[0]
+		|| settings.workgroupSize > properties.limits.maxComputeWorkGroupInvocations) {
+		throw std::runtime_error("Particle workgroup size exceeds device limits");
+	}
+	m_context = context;
+	m_settings = settings;
+	createBuffer(queue, queueFamily);
+	createDescriptors();
+	createComputePipeline();
+	m_timer.init(m_context, queueFamily, timerSlots, 2);
+	m_timerSlots = timerSlots;
+	m_totalUpdateMs = 0.0;
+	m_measuredUpdates = 0;
+}
+
+void CParticleSystem::reserveTimerSlots(uint32_t queueFamily, uint32_t timerSlots) {
+	if (timerSlots <= m_timerSlots) { return; }
+	m_timer.cleanup();
+	m_timer.init(m_context, queueFamily, timerSlots, 2);
+	m_timerSlots = timerSlots;
+}
+
+void CParticleSystem::cleanup() {
+	if (m_context.device == VK_NULL_HANDLE) { return; }
+	m_timer.cleanup();
+	destroyGraphicsPipeline();
+	vkDestroyPipeline(m_context.device, m_computePipeline, m_context.allocator);
+	vkDestroyPipelineLayout(m_context.device, m_pipelineLayout, m_context.allocator);
+	vkDestroyDescriptorPool(m_context.device, m_descriptorPool, m_context.allocator);
+	vkDestroyDescriptorSetLayout(m_context.device, m_descriptorSetLayout, m_context.allocator);
+	destroyBuffer(m_context, m_buffer, m_memory);
+	m_context.device = VK_NULL_HANDLE;
+}
+
+void CParticleSystem::createBuffer(VkQueue queue, uint32_t queueFamily) {
+	const auto count = static_cast<size_t>(m_settings.count);
+	const auto size = static_cast<VkDeviceSize>(count * COMPONENTS * sizeof(float));
+	::createBuffer(m_context, size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+	               VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_buffer, m_memory, MemoryCategory::Buffer);
+	// tat initial : disque alatoire en rotation, crit une fois via un buffer de staging
+	std::vector<float> data(count * COMPONENTS);
+	std::mt19937 rng{42};
+	std::uniform_real_distribution<float> angle{0.0f, 6.2831853f};
+	std::uniform_real_distribution<float> radius{0.1f, 0.9f};
+	std::uniform_real_distribution<float> height{-0.05f, 0.05f};
+	for (size_t i = 0; i < count; i++) {
+		const auto a = angle(rng);
+		const auto r = radius(rng);
+		data[i] = r * std::cos(a);
+		data[count + i] = height(rng);
+		data[2 * count + i] = r * std::sin(a);
+		data[3 * count + i] = -std::sin(a) * 0.3f;
+		data[4 * count + i] = 0.0f;
+		data[5 * count + i] = std::cos(a) * 0.3f;
+	}
+	uploadToBuffer(m_context, queueFamily, queue, m_buffer, data.data(), size);
+}
+
+void CParticleSystem::createDescriptors() {
+	auto binding = VkDescriptorSetLayoutBinding{};
+	binding.binding = 0;
+	binding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	binding.descriptorCount = 1;
+	binding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_VERTEX_BIT;
+	auto layoutInfo = VkDescriptorSetLayoutCreateInfo{};
+	layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+	layoutInfo.bindingCount = 1;
+	layoutInfo.pBindings = &binding;
+	if (vkCreateDescriptorSetLayout(m_context.device, &layoutInfo, m_context.allocator, &m_descriptorSetLayout) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create the particle descriptor set layout");
+	}
+	auto poolSize = VkDescriptorPoolSize{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1 };
+	auto poolInfo = VkDescriptorPoolCreateInfo{};
+	poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	poolInfo.maxSets = 1;
+	poolInfo.poolSizeCount = 1;
+	poolInfo.pPoolSizes = &poolSize;
+	if (vkCreateDescriptorPool(m_context.device, &poolInfo, m_context.allocator, &m_descriptorPool) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create the particle descriptor pool");
+	}
+	auto allocInfo = VkDescriptorSetAllocateInfo{};
+	allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	allocInfo.descriptorPool = m_descriptorPool;
+	allocInfo.descriptorSetCount = 1;
+	allocInfo.pSetLayouts = &m_descriptorSetLayout;
+	if (vkAllocateDescriptorSets(m_context.device, &allocInfo, &m_descriptorSet) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to allocate the particle descriptor set");
+	}
+	auto bufferInfo = VkDescriptorBufferInfo{ m_buffer, 0, VK_WHOLE_SIZE };
+	auto write = VkWriteDescriptorSet{};
+	write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	write.dstSet = m_descriptorSet;
+	write.dstBinding = 0;
+	write.descriptorCount = 1;
+	write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	write.pBufferInfo = &bufferInfo;
+	vkUpdateDescriptorSets(m_context.device, 1, &write, 0, nullptr);
+	auto pushConstantRange = VkPushConstantRange{};
+	pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_VERTEX_BIT;
+	pushConstantRange.offset = 0;
+	pushConstantRange.size = sizeof(PushConstants);
+	auto pipelineLayoutInfo = VkPipelineLayoutCreateInfo{};
+	pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+	pipelineLayoutInfo.setLayoutCount = 1;
+	pipelineLayoutInfo.pSetLayouts = &m_descriptorSetLayout;
+	pipelineLayoutInfo.pushConstantRangeCount = 1;
+	pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+	if (vkCreatePipelineLayout(m_context.device, &pipelineLayoutInfo, m_context.allocator, &m_pipelineLayout) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create the particle pipeline layout");
+	}
+}
+
+void CParticleSystem::createComputePipeline() {
+	const auto shaderModule = createShaderModule(m_context, CShaderLoader::readFile("shaders/particles_comp.spv"));
+	// local_size_x_id = 0
+	auto specializationEntry = VkSpecializationMapEntry{ 0, 0, sizeof(uint32_t) };
+	auto specializationInfo = VkSpecializationInfo{};
+	specializationInfo.mapEntryCount = 1;
+	specializationInfo.pMapEntries = &specializationEntry;
+	specializationInfo.dataSize = sizeof(uint32_t);
+	specializationInfo.pData = &m_settings.workgroupSize;
+	auto pipelineInfo = VkComputePipelineCreateInfo{};
+	pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+	pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+	pipelineInfo.stage.module = shaderModule;
+	pipelineInfo.stage.pName = "main";
+	pipelineInfo.stage.pSpecializationInfo = &specializationInfo;
+	pipelineInfo.layout = m_pipelineLayout;
+	const auto result = vkCreateComputePipelines(m_context.device, VK_NULL_HANDLE, 1, &pipelineInfo, m_context.allocator,
+	                                             &m_computePipeline);
+	vkDestroyShaderModule(m_context.device, shaderModule, m_context.allocator);
+	if (result != VK_SUCCESS) { throw std::runtime_error("Failed to create the particle compute pipeline"); }
+}
+
+void CParticleSystem::createGraphicsPipeline(VkRenderPass renderPass) {
+	const auto vertShaderModule = createShaderModule(m_context, CShaderLoader::readFile("shaders/particles_vert.spv"));
+	const auto fragShaderModule = createShaderModule(m_context, CShaderLoader::readFile("shaders/particles_frag.spv"));
+	VkPipelineShaderStageCreateInfo shaderStages[2] = {};
+	shaderStages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	shaderStages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+	shaderStages[0].module = vertShaderModule;
+	shaderStages[0].pName = "main";
+	shaderStages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+	shaderStages[1].module = fragShaderModule;
+	shaderStages[1].pName = "main";
+	// Pas d'attributs : le vertex shader lit le storage buffer avec gl_VertexIndex
+	auto vertexInputInfo = VkPipelineVertexInputStateCreateInfo{};
+	vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+	auto inputAssembly = VkPipelineInputAssemblyStateCreateInfo{};
+	inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+	inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_POINT_LIST;
+	auto viewportState = VkPipelineViewportStateCreateInfo{};
+	viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+	viewportState.viewportCount = 1;
+	viewportState.scissorCount = 1;
+	VkDynamicState dynamicStates[] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+	auto dynamicState = VkPipelineDynamicStateCreateInfo{};
+	dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+	dynamicState.dynamicStateCount = 2;
+	dynamicState.pDynamicStates = dynamicStates;
+	auto rasterizer = VkPipelineRasterizationStateCreateInfo{};
+	rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+	rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+	rasterizer.lineWidth = 1.0f;
+	rasterizer.cullMode = VK_CULL_MODE_NONE;
+	rasterizer.frontFace = VK_FRONT_FACE_CLOCKWISE;
+	auto multisampling = VkPipelineMultisampleStateCreateInfo{};
+	multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+	multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+	multisampling.minSampleShading = 1.0f;
+	// Mlange additif : les zones denses ressortent
+	auto colorBlendAttachment = VkPipelineColorBlendAttachmentState{};
+	colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT
+			| VK_COLOR_COMPONENT_A_BIT;
+	colorBlendAttachment.blendEnable = VK_TRUE;
+	colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_ONE;
+	colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE;
+	colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+	colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+	colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+	colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+	auto colorBlending = VkPipelineColorBlendStateCreateInfo{};
+	colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+	colorBlending.attachmentCount = 1;
+	colorBlending.pAttachments = &colorBlendAttachment;
+	// Particules additives : ni test ni criture de profondeur
+	const auto depthStencil = depthStencilState(DepthSettings{}, DepthPass::None);
+	auto pipelineInfo = VkGraphicsPipelineCreateInfo{};
+	pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+	pipelineInfo.stageCount = 2;
+	pipelineInfo.pStages = shaderStages;
+	pipelineInfo.pVertexInputState = &vertexInputInfo;
+	pipelineInfo.pInputAssemblyState = &inputAssembly;
+	pipelineInfo.pViewportState = &viewportState;
+	pipelineInfo.pRasterizationState = &rasterizer;
+	pipelineInfo.pMultisampleState = &multisampling;
+	pipelineInfo.pDepthStencilState = &depthStencil;
+	pipelineInfo.pColorBlendState = &colorBlending;
+	pipelineInfo.pDynamicState = &dynamicState;
+	pipelineInfo.layout = m_pipelineLayout;
+	pipelineInfo.renderPass = renderPass;
+	pipelineInfo.subpass = 0;
+	pipelineInfo.basePipelineIndex = -1;
+	const auto result = vkCreateGraphicsPipelines(m_context.device, VK_NULL_HANDLE, 1, &pipelineInfo, m_context.allocator,
+	                                              &m_graphicsPipeline);
+	vkDestroyShaderModule(m_context.device, fragShaderModule, m_context.allocator);
+	vkDestroyShaderModule(m_context.device, vertShaderModule, m_context.allocator);
+	if (result != VK_SUCCESS) { throw std::runtime_error("Failed to create the particle graphics pipeline"); }
+}
+
+void CParticleSystem::destroyGraphicsPipeline() {
+	if (m_graphicsPipeline == VK_NULL_HANDLE) { return; }
+	vkDestroyPipeline(m_context.device, m_graphicsPipeline, m_context.allocator);
+	m_graphicsPipeline = VK_NULL_HANDLE;
+}
+
+void CParticleSystem::recordUpdate(VkCommandBuffer commandBuffer, uint32_t timerSlot) {
+	// La frame prcdente lit encore le buffer dans son vertex shader (mme queue) : dpendance d'excution
+	m_context.dispatch->CmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+	                                       0, 0, nullptr, 0, nullptr, 0, nullptr);
+	if (m_timer.isSupported()) {
+		m_timer.reset(commandBuffer, timerSlot);
+		m_timer.write(commandBuffer, timerSlot, TIMESTAMP_BEGIN, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+	}
+	m_context.dispatch->CmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_computePipeline);
+	m_context.dispatch->CmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipelineLayout, 0, 1, &m_descriptorSet, 0, nullptr);
+	const auto pushConstants = PushConstants{ m_settings.count, m_settings.deltaTime };
+	m_context.dispatch->CmdPushConstants(commandBuffer, m_pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_VERTEX_BIT, 0,
+	                                     sizeof(PushConstants), &pushConstants);
+	m_context.dispatch->CmdDispatch(commandBuffer, (m_settings.count + m_settings.workgroupSize - 1) / m_settings.workgroupSize, 1, 1);
+	if (m_timer.isSupported()) {
+		m_timer.write(commandBuffer, timerSlot, TIMESTAMP_END, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+	}
+	// Les critures du compute shader doivent tre visibles du vertex shader
+	auto barrier = VkBufferMemoryBarrier{};
+	barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+	barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+	barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.buffer = m_buffer;
+	barrier.offset = 0;
+	barrier.size = VK_WHOLE_SIZE;
+	m_context.dispatch->CmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+	                                       0, 0, nullptr, 1, &barrier, 0, nullptr);
+}
+
+void CParticleSystem::recordDraw(VkCommandBuffer commandBuffer) const {
+	m_context.dispatch->CmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_graphicsPipeline);
+	m_context.dispatch->CmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineLayout, 0, 1, &m_descriptorSet, 0, nullptr);
+	const auto pushConstants = PushConstants{ m_settings.count, m_settings.deltaTime };
+	m_context.dispatch->CmdPushConstants(commandBuffer, m_pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_VERTEX_BIT, 0,
+	                                     sizeof(PushConstants), &pushConstants);
+	m_context.dispatch->CmdDraw(commandBuffer, m_settings.count, 1, 0, 0);
+}
+
+void CParticleSystem::onUpdateCompleted(uint32_t timerSlot) {
+	if (!m_timer.isSupported() || !m_timer.resolve(timerSlot)) { return; }
+	m_totalUpdateMs += m_timer.elapsedMs(timerSlot, TIMESTAMP_BEGIN, TIMESTAMP_END);
+	m_measuredUpdates++;
+}
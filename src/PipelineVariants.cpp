@@ -0,0 +1,226 @@
+#include <PipelineVariants.h>
+#include <Logger.h>
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+
+namespace {
+	// Une entre par constante : constant_id i lu  l'offset i * 4 des valeurs de la cl
+	const std::array<VkSpecializationMapEntry, PipelineVariantKey::MAX_CONSTANTS> SPECIALIZATION_ENTRIES = {{
+		{ 0, 0, sizeof(uint32_t) },
+		{ 1, sizeof(uint32_t), sizeof(uint32_t) },
+		{ 2, 2 * sizeof(uint32_t), sizeof(uint32_t) },
+		{ 3, 3 * sizeof(uint32_t), sizeof(uint32_t) }
+	}};
+
+	/*
+	 * Structures pointes par un VkGraphicsPipelineCreateInfo (doivent vivre jusqu' vkCreateGraphicsPipelines)
+	 */
+	struct PipelineCreateStorage {
+		VkPipelineShaderStageCreateInfo stages[2]{};
+		VkSpecializationInfo specialization{};
+		VkPipelineVertexInputStateCreateInfo vertexInput{};
+		VkPipelineViewportStateCreateInfo viewportState{};
+		VkDynamicState dynamicStates[2]{ VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+		VkPipelineDynamicStateCreateInfo dynamicState{};
+		VkPipelineColorBlendStateCreateInfo colorBlending{};
+
+		/*
+		 * key = nullptr : sans spcialisation (constantes par dfaut des shaders)
+		 */
+		VkGraphicsPipelineCreateInfo build(const GraphicsPipelineState& state, const PipelineVariantKey* key) {
+			if (key != nullptr) {
+				specialization.mapEntryCount = static_cast<uint32_t>(SPECIALIZATION_ENTRIES.size());
+				specialization.pMapEntries = SPECIALIZATION_ENTRIES.data();
+				specialization.dataSize = sizeof(key->constants);
+				specialization.pData = key->constants.data();
+			}
+			const VkShaderStageFlagBits stageBits[2] = { VK_SHADER_STAGE_VERTEX_BIT, VK_SHADER_STAGE_FRAGMENT_BIT };
+			const VkShaderModule modules[2] = { state.vertexShader, state.fragmentShader };
+			for (int i = 0; i < 2; i++) {
+				stages[i].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+				stages[i].stage = stageBits[i];
+				stages[i].module = modules[i];
+				stages[i].pName = "main";
+				stages[i].pSpecializationInfo = key != nullptr ? &specialization : nullptr;
+			}
+			vertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+			vertexInput.vertexBindingDescriptionCount = static_cast<uint32_t>(state.vertexBindings.size());
+			vertexInput.pVertexBindingDescriptions = state.vertexBindings.data();
+			vertexInput.vertexAttributeDescriptionCount = static_cast<uint32_t>(state.vertexAttributes.size());
+			vertexInput.pVertexAttributeDescriptions = state.vertexAttributes.data();
+			viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+			viewportState.viewportCount = 1;
+			viewportState.scissorCount = 1;
+			dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+			dynamicState.dynamicStateCount = 2;
+			dynamicState.pDynamicStates = dynamicStates;
+			colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+			colorBlending.attachmentCount = 1;
+			colorBlending.pAttachments = &state.colorBlendAttachment;
+			auto pipelineInfo = VkGraphicsPipelineCreateInfo{};
+			pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+			pipelineInfo.stageCount = 2;
+			pipelineInfo.pStages = stages;
+			pipelineInfo.pVertexInputState = &vertexInput;
+			pipelineInfo.pInputAssemblyState = &state.inputAssembly;
+			pipelineInfo.pViewportState = &viewportState;
+			pipelineInfo.pRasterizationState = &state.rasterizer;
+			pipelineInfo.pMultisampleState = &state.multisampling;
+			if (state.depthStencil.sType == VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO) {
+				pipelineInfo.pDepthStencilState = &state.depthStencil;
+			}
+			pipelineInfo.pColorBlendState = &colorBlending;
+			pipelineInfo.pDynamicState = &dynamicState;
+			pipelineInfo.layout = state.layout;
+			pipelineInfo.renderPass = state.renderPass;
+			pipelineInfo.subpass = 0;
+			pipelineInfo.basePipelineIndex = -1;
+			return pipelineInfo;
+		}
+	};
+}
+
+VkPipeline createVariantPipeline(const DeviceContext& context, VkPipelineCache pipelineCache,
+                                 const GraphicsPipelineState& state, const PipelineVariantKey* key) {
+	auto storage = PipelineCreateStorage{};
+	const auto pipelineInfo = storage.build(state, key);
+	auto pipeline = VkPipeline{VK_NULL_HANDLE};
+	if (vkCreateGraphicsPipelines(context.device, pipelineCache, 1, &pipelineInfo, context.allocator, &pipeline) != VK_SUCCESS) {
+		return VK_NULL_HANDLE;
+	}
+	return pipeline;
+}
+
+uint64_t PipelineVariantKey::hash() const {
+	uint64_t hash = 14695981039346656037ull;
+	for (const auto value : constants) {
+		for (int byte = 0; byte < 4; byte++) {
+			hash ^= (value >> (byte * 8)) & 0xFFu;
+			hash *= 1099511628211ull;
+		}
+	}
+	return hash;
+}
+
+void CPipelineVariantCache::init(const DeviceContext& context, CJobSystem& jobSystem, const GraphicsPipelineState& state) {
+	m_context = context;
+	m_jobSystem = &jobSystem;
+	m_state = state;
+	m_stats = PipelineVariantStats{};
+	// Partag par les lots : vkCreateGraphicsPipelines peut l'utiliser depuis plusieurs threads
+	auto cacheInfo = VkPipelineCacheCreateInfo{};
+	cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+	if (vkCreatePipelineCache(m_context.device, &cacheInfo, m_context.allocator, &m_pipelineCache) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create a pipeline cache");
+	}
+	m_fallback = createVariantPipeline(m_context, m_pipelineCache, m_state, nullptr);
+	if (m_fallback == VK_NULL_HANDLE) {
+		throw std::runtime_error("Failed to create graphic pipeline");
+	}
+}
+
+void CPipelineVariantCache::cleanup() {
+	if (m_context.device == VK_NULL_HANDLE) { return; }
+	{
+		// Les lots en cours rfrencent les shader modules et le cache
+		std::unique_lock<std::mutex> lock{m_mutex};
+		m_batchesDone.wait(lock, [this] { return m_pendingBatches == 0; });
+	}
+	CLogger::log(LogLevel::Verbose, "Pipeline", "Pipeline variants: " + std::to_string(m_stats.compiled) + " compiled, "
+	             + std::to_string(m_stats.failed) + " failed, " + std::to_string(m_stats.deduplicated) + " deduplicated in "
+	             + std::to_string(m_stats.batches) + " batches (" + std::to_string(m_stats.compileMs) + " ms on workers)");
+	for (auto& [key, variant] : m_variants) {
+		if (variant.pipeline != VK_NULL_HANDLE) { vkDestroyPipeline(m_context.device, variant.pipeline, m_context.allocator); }
+	}
+	m_variants.clear();
+	vkDestroyPipeline(m_context.device, m_fallback, m_context.allocator);
+	m_fallback = VK_NULL_HANDLE;
+	vkDestroyPipelineCache(m_context.device, m_pipelineCache, m_context.allocator);
+	m_pipelineCache = VK_NULL_HANDLE;
+	vkDestroyShaderModule(m_context.device, m_state.fragmentShader, m_context.allocator);
+	vkDestroyShaderModule(m_context.device, m_state.vertexShader, m_context.allocator);
+	m_context.device = VK_NULL_HANDLE;
+}
+
+void CPipelineVariantCache::request(const std::vector<PipelineVariantKey>& keys) {
+	std::vector<PipelineVariantKey> missing;
+	size_t batchCount;
+	{
+		std::lock_guard<std::mutex> lock{m_mutex};
+		for (const auto& key : keys) {
+			// Identique  la pipeline gnrique dj compile
+			if (key == PipelineVariantKey{}) { continue; }
+			if (!m_variants.emplace(key, Variant{}).second) {
+				m_stats.deduplicated++;
+				continue;
+			}
+			missing.push_back(key);
+		}
+		if (missing.empty()) { return; }
+		batchCount = std::min(missing.size(), std::max<size_t>(m_jobSystem->workerCount(), 1));
+		m_pendingBatches += static_cast<uint32_t>(batchCount);
+	}
+	// Lots de tailles gales ( une variante prs), un par worker : le thread de simulation n'en excute jamais
+	for (size_t b = 0; b < batchCount; b++) {
+		const auto begin = missing.size() * b / batchCount;
+		const auto end = missing.size() * (b + 1) / batchCount;
+		std::vector<PipelineVariantKey> batch(missing.begin() + static_cast<std::ptrdiff_t>(begin),
+		                                      missing.begin() + static_cast<std::ptrdiff_t>(end));
+		m_jobSystem->submitBackground([this, batch = std::move(batch)] { compileBatch(batch); });
+	}
+}
+
+VkPipeline CPipelineVariantCache::pipeline(const PipelineVariantKey& key) {
+	if (key == PipelineVariantKey{}) { return m_fallback; }
+	{
+		std::lock_guard<std::mutex> lock{m_mutex};
+		const auto found = m_variants.find(key);
+		if (found != m_variants.end()) {
+			return found->second.pipeline != VK_NULL_HANDLE ? found->second.pipeline : m_fallback;
+		}
+	}
+	request({ key });
+	return m_fallback;
+}
+
+PipelineVariantStats CPipelineVariantCache::stats() const {
+	std::lock_guard<std::mutex> lock{m_mutex};
+	return m_stats;
+}
+
+void CPipelineVariantCache::compileBatch(const std::vector<PipelineVariantKey>& keys) {
+	const auto start = std::chrono::steady_clock::now();
+	std::vector<PipelineCreateStorage> storages(keys.size());
+	std::vector<VkGraphicsPipelineCreateInfo> createInfos(keys.size());
+	for (size_t i = 0; i < keys.size(); i++) { createInfos[i] = storages[i].build(m_state, &keys[i]); }
+	std::vector<VkPipeline> pipelines(keys.size(), VK_NULL_HANDLE);
+	const auto result = vkCreateGraphicsPipelines(m_context.device, m_pipelineCache, static_cast<uint32_t>(keys.size()),
+	                                              createInfos.data(), m_context.allocator, pipelines.data());
+	const auto elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	if (result != VK_SUCCESS) {
+		CLogger::log(LogLevel::Warning, "Pipeline", "Failed to compile a batch of " + std::to_string(keys.size())
+		             + " pipeline variants: the generic pipeline stays in use");
+	}
+	{
+		std::lock_guard<std::mutex> lock{m_mutex};
+		// En cas d'chec, les pipelines cres restent valides et les autres valent VK_NULL_HANDLE
+		for (size_t i = 0; i < keys.size(); i++) {
+			auto& variant = m_variants[keys[i]];
+			variant.pipeline = pipelines[i];
+			variant.failed = pipelines[i] == VK_NULL_HANDLE;
+			if (variant.failed) { m_stats.failed++; }
+			else { m_stats.compiled++; }
+		}
+		m_stats.batches++;
+		m_stats.compileMs += elapsedMs;
+		m_generation.fetch_add(1, std::memory_order_release);
+	}
+	// Hors du verrou (le callback peut interroger le cache), avant la fin du lot : cleanup() attend son retour
+	if (m_batchCallback) { m_batchCallback(); }
+	std::lock_guard<std::mutex> lock{m_mutex};
+	m_pendingBatches--;
+	// Notifi sous le verrou : cleanup() ne peut pas dtruire le cache avant la fin de cette tche
+	m_batchesDone.notify_all();
+}
@@ -0,0 +1,723 @@
+#include <PostProcess.h>
+#include <ShaderLoader.h>
+#include <Logger.h>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace {
+	// Chane du bloom, flou et rsultats intermdiaires : assez de prcision pour les sommes du bloom
+	constexpr VkFormat INTERMEDIATE_FORMAT = VK_FORMAT_R16G16B16A16_SFLOAT;
+	// Sortie copie vers la swapchain quand elle ne peut pas tre crite directement
+	constexpr VkFormat OUTPUT_FORMAT = VK_FORMAT_R8G8B8A8_UNORM;
+	// Groupes de travail : tuiles de 16x16 pixels, lignes de 256 pixels pour la passe horizontale du flou
+	constexpr uint32_t TILE_SIZE = 16;
+	constexpr uint32_t BLUR_ROW_SIZE = 256;
+	constexpr uint32_t BINDING_COUNT = 6;
+	// Un fichier SPIR-V par CPostProcess::Kernel
+	const char* const KERNEL_SHADERS[] = {
+		"shaders/postprocess_prefilter_comp.spv",
+		"shaders/postprocess_prefilter_subgroup_comp.spv",
+		"shaders/postprocess_downsample_comp.spv",
+		"shaders/postprocess_upsample_comp.spv",
+		"shaders/postprocess_blur_comp.spv",
+		"shaders/postprocess_composite_comp.spv"
+	};
+}
+
+bool CPostProcess::isSupported(VkPhysicalDevice physicalDevice, VkFormat format) {
+	VkPhysicalDeviceFeatures features;
+	vkGetPhysicalDeviceFeatures(physicalDevice, &features);
+	if (!features.shaderStorageImageWriteWithoutFormat) { return false; }
+	VkFormatProperties properties;
+	vkGetPhysicalDeviceFormatProperties(physicalDevice, format, &properties);
+	const VkFormatFeatureFlags required = VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT;
+	if ((properties.optimalTilingFeatures & required) != required) { return false; }
+	// criture directe, ou blit de l'image de sortie
+	return canWriteDirectly(physicalDevice, format) || (properties.optimalTilingFeatures & VK_FORMAT_FEATURE_BLIT_DST_BIT);
+}
+
+bool CPostProcess::canWriteDirectly(VkPhysicalDevice physicalDevice, VkFormat format) {
+	VkFormatProperties properties;
+	vkGetPhysicalDeviceFormatProperties(physicalDevice, format, &properties);
+	return (properties.optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT) != 0;
+}
+
+bool CPostProcess::supportsSubgroups(VkPhysicalDevice physicalDevice, uint32_t instanceApiVersion) {
+	if (instanceApiVersion < VK_API_VERSION_1_1) { return false; }
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+	if (properties.apiVersion < VK_API_VERSION_1_1) { return false; }
+	auto subgroupProperties = VkPhysicalDeviceSubgroupProperties{};
+	subgroupProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_PROPERTIES;
+	auto properties2 = VkPhysicalDeviceProperties2{};
+	properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+	properties2.pNext = &subgroupProperties;
+	vkGetPhysicalDeviceProperties2(physicalDevice, &properties2);
+	const VkSubgroupFeatureFlags required = VK_SUBGROUP_FEATURE_BASIC_BIT | VK_SUBGROUP_FEATURE_ARITHMETIC_BIT;
+	return (subgroupProperties.supportedStages & VK_SHADER_STAGE_COMPUTE_BIT)
+			&& (subgroupProperties.supportedOperations & required) == required;
+}
+
+void CPostProcess::init(const DeviceContext& context, uint32_t queueFamily, VkFormat format, VkExtent2D extent,
+                        const std::vector<VkImage>& swapChainImages, VkImageUsageFlags swapChainUsage,
+                        uint32_t frameCount, bool subgroups, const PostProcessSettings& settings) {
+	uint32_t queueFamilyCount = 0;
+	vkGetPhysicalDeviceQueueFamilyProperties(context.physicalDevice, &queueFamilyCount, nullptr);
+	std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+	vkGetPhysicalDeviceQueueFamilyProperties(context.physicalDevice, &queueFamilyCount, queueFamilies.data());
+	// Rendu de la scne et post-traitement dans le mme command buffer
+	if (!(queueFamilies[queueFamily].queueFlags & VK_QUEUE_COMPUTE_BIT)) {
+		throw std::runtime_error("Failed to find compute support on the graphics queue");
+	}
+	m_context = context;
+	m_settings = settings;
+	m_settings.bloomLevels = std::clamp(m_settings.bloomLevels, 2u, 8u);
+	m_settings.blurRadius = std::min(m_settings.blurRadius, MAX_BLUR_RADIUS);
+	m_format = format;
+	m_extent = extent;
+	m_subgroups = subgroups;
+	m_directOutput = (swapChainUsage & VK_IMAGE_USAGE_STORAGE_BIT) != 0;
+	m_swapChainImages = swapChainImages;
+	createRenderPass();
+	auto samplerInfo = VkSamplerCreateInfo{};
+	samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+	samplerInfo.magFilter = VK_FILTER_LINEAR;
+	samplerInfo.minFilter = VK_FILTER_LINEAR;
+	samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+	samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	samplerInfo.maxLod = 0.0f;
+	if (vkCreateSampler(m_context.device, &samplerInfo, m_context.allocator, &m_sampler) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create the post-process sampler");
+	}
+	auto bindings = std::array<VkDescriptorSetLayoutBinding, BINDING_COUNT>{};
+	// 0 : source, 1 : destination, 2 et 3 : niveaux 0 et 1 du bloom, 4 : luminance, 5 : sortie
+	const VkDescriptorType types[BINDING_COUNT] = {
+		VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+		VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+		VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE
+	};
+	for (uint32_t i = 0; i < BINDING_COUNT; i++) {
+		bindings[i].binding = i;
+		bindings[i].descriptorType = types[i];
+		bindings[i].descriptorCount = 1;
+		bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+	}
+	auto layoutInfo = VkDescriptorSetLayoutCreateInfo{};
+	layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+	layoutInfo.bindingCount = BINDING_COUNT;
+	layoutInfo.pBindings = bindings.data();
+	if (vkCreateDescriptorSetLayout(m_context.device, &layoutInfo, m_context.allocator, &m_descriptorSetLayout) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create the post-process descriptor set layout");
+	}
+	auto pushConstantRange = VkPushConstantRange{};
+	pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+	pushConstantRange.offset = 0;
+	pushConstantRange.size = sizeof(PushConstants);
+	auto pipelineLayoutInfo = VkPipelineLayoutCreateInfo{};
+	pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+	pipelineLayoutInfo.setLayoutCount = 1;
+	pipelineLayoutInfo.pSetLayouts = &m_descriptorSetLayout;
+	pipelineLayoutInfo.pushConstantRangeCount = 1;
+	pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+	if (vkCreatePipelineLayout(m_context.device, &pipelineLayoutInfo, m_context.allocator, &m_pipelineLayout) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create the post-process pipeline layout");
+	}
+	planDispatches();
+	// Vues de stockage des images de la swapchain, crites par le dernier dispatch
+	if (m_directOutput) {
+		m_swapChainViews.resize(m_swapChainImages.size());
+		for (size_t i = 0; i < m_swapChainImages.size(); i++) {
+			auto viewInfo = VkImageViewCreateInfo{};
+			viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+			viewInfo.image = m_swapChainImages[i];
+			viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+			viewInfo.format = m_format;
+			viewInfo.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+			if (vkCreateImageView(m_context.device, &viewInfo, m_context.allocator, &m_swapChainViews[i]) != VK_SUCCESS) {
+				throw std::runtime_error("Failed to create a post-process swapchain view");
+			}
+		}
+	}
+	m_frames.assign(frameCount, FrameResources{});
+	for (auto& frame : m_frames) { createFrameResources(frame); }
+	createDescriptors();
+	auto poolInfo = VkCommandPoolCreateInfo{};
+	poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	poolInfo.queueFamilyIndex = queueFamily;
+	// Les command buffers sont renregistrs  chaque frame
+	poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+	if (vkCreateCommandPool(m_context.device, &poolInfo, m_context.allocator, &m_commandPool) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create the post-process command pool");
+	}
+	m_commandBuffers.resize(frameCount);
+	auto allocInfo = VkCommandBufferAllocateInfo{};
+	allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	allocInfo.commandPool = m_commandPool;
+	allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	allocInfo.commandBufferCount = frameCount;
+	if (vkAllocateCommandBuffers(m_context.device, &allocInfo, m_commandBuffers.data()) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to allocate the post-process command buffers");
+	}
+	// Un timestamp au dbut de la frame puis un  la fin de chaque tape
+	m_timer.init(m_context, queueFamily, frameCount, static_cast<uint32_t>(m_stageNames.size()) + 1);
+	m_stageTotalMs.assign(m_stageNames.size(), 0.0);
+	m_measuredFrames = 0;
+	CLogger::log(LogLevel::Info, "PostProcess", std::to_string(m_dispatches.size()) + " dispatches, "
+	             + (m_subgroups ? "subgroup" : "shared memory") + " luminance reduction, "
+	             + (m_directOutput ? "direct swapchain writes" : "blit to the swapchain"));
+}
+
+void CPostProcess::cleanup() {
+	if (m_context.device == VK_NULL_HANDLE) { return; }
+	m_timer.cleanup();
+	vkDestroyCommandPool(m_context.device, m_commandPool, m_context.allocator);
+	m_commandBuffers.clear();
+	for (auto& frame : m_frames) { destroyFrameResources(frame); }
+	m_frames.clear();
+	for (auto view : m_swapChainViews) { vkDestroyImageView(m_context.device, view, m_context.allocator); }
+	m_swapChainViews.clear();
+	m_dispatches.clear();
+	for (const auto& entry : m_pipelines) { vkDestroyPipeline(m_context.device, entry.second, m_context.allocator); }
+	m_pipelines.clear();
+	vkDestroyDescriptorPool(m_context.device, m_descriptorPool, m_context.allocator);
+	vkDestroyPipelineLayout(m_context.device, m_pipelineLayout, m_context.allocator);
+	vkDestroyDescriptorSetLayout(m_context.device, m_descriptorSetLayout, m_context.allocator);
+	vkDestroySampler(m_context.device, m_sampler, m_context.allocator);
+	vkDestroyRenderPass(m_context.device, m_renderPass, m_context.allocator);
+	m_descriptorPool = VK_NULL_HANDLE;
+	m_context.device = VK_NULL_HANDLE;
+}
+
+void CPostProcess::onFrameCompleted(uint32_t frameInFlight) {
+	if (!m_timer.isSupported() || !m_timer.resolve(frameInFlight)) { return; }
+	for (uint32_t stage = 0; stage < m_stageTotalMs.size(); stage++) {
+		m_stageTotalMs[stage] += m_timer.elapsedMs(frameInFlight, stage, stage + 1);
+	}
+	m_measuredFrames++;
+}
+
+std::vector<PostProcessStageTime> CPostProcess::stageTimes() const {
+	std::vector<PostProcessStageTime> times;
+	if (m_measuredFrames == 0) { return times; }
+	for (size_t stage = 0; stage < m_stageTotalMs.size(); stage++) {
+		times.push_back({ m_stageNames[stage], m_stageTotalMs[stage] / static_cast<double>(m_measuredFrames) });
+	}
+	return times;
+}
+
+double CPostProcess::averageGpuMs() const {
+	if (m_measuredFrames == 0) { return 0.0; }
+	double total = 0.0;
+	// L'tape 0 est le rendu de la scne
+	for (size_t stage = 1; stage < m_stageTotalMs.size(); stage++) { total += m_stageTotalMs[stage]; }
+	return total / static_cast<double>(m_measuredFrames);
+}
+
+VkCommandBuffer CPostProcess::record(uint32_t frameInFlight, uint32_t imageIndex, const RecordFunction& recordScene,
+                                     const RecordFunction& recordPrePass) {
+	auto& frame = m_frames[frameInFlight];
+	const auto swapChainImage = m_swapChainImages[imageIndex];
+	auto commandBuffer = m_commandBuffers[frameInFlight];
+	m_context.dispatch->ResetCommandBuffer(commandBuffer, 0);
+	auto beginInfo = VkCommandBufferBeginInfo{};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	if (m_context.dispatch->BeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to begin a post-process command buffer");
+	}
+	if (m_timer.isSupported()) {
+		m_timer.reset(commandBuffer, frameInFlight);
+		m_timer.write(commandBuffer, frameInFlight, 0, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+	}
+	if (recordPrePass) { recordPrePass(commandBuffer); }
+	// Images intermdiaires : le contenu de la frame prcdente est abandonn, layout GENERAL pour les lectures
+	// et critures des compute shaders. Image de la swapchain crite directement : le stage source est celui
+	// attendu par le smaphore d'acquisition (COLOR_ATTACHMENT_OUTPUT) afin de chaner les dpendances.
+	m_barriers.clear();
+	const auto addTransition = [this](VkImage image) {
+		if (image == VK_NULL_HANDLE) { return; }
+		auto barrier = VkImageMemoryBarrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.srcAccessMask = 0;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+		barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = image;
+		barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+		m_barriers.push_back(barrier);
+	};
+	for (const auto& level : frame.bloomLevels) { addTransition(level.image); }
+	addTransition(frame.blur.image);
+	for (const auto& stage : frame.stages) { addTransition(stage.image); }
+	addTransition(frame.dummy.image);
+	addTransition(frame.output.image);
+	if (m_directOutput) { addTransition(swapChainImage); }
+	// Luminance accumule par la premire rduction : remise  zro
+	m_context.dispatch->CmdFillBuffer(commandBuffer, frame.luminanceBuffer, 0, VK_WHOLE_SIZE, 0);
+	auto memoryBarrier = VkMemoryBarrier{};
+	memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	memoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+	m_context.dispatch->CmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+	                                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memoryBarrier, 0, nullptr,
+	                                       static_cast<uint32_t>(m_barriers.size()), m_barriers.data());
+	// Rendu de la scne dans la cible hors cran
+	auto renderPassInfo = VkRenderPassBeginInfo{};
+	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+	renderPassInfo.renderPass = m_renderPass;
+	renderPassInfo.framebuffer = frame.framebuffer;
+	renderPassInfo.renderArea.offset = { 0, 0 };
+	renderPassInfo.renderArea.extent = m_extent;
+	auto clearColor = VkClearValue{ 0.0f, 0.0f, 0.0f, 1.0f };
+	renderPassInfo.clearValueCount = 1;
+	renderPassInfo.pClearValues = &clearColor;
+	m_context.dispatch->CmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+	auto viewport = VkViewport{ 0.0f, 0.0f, static_cast<float>(m_extent.width), static_cast<float>(m_extent.height), 0.0f, 1.0f };
+	m_context.dispatch->CmdSetViewport(commandBuffer, 0, 1, &viewport);
+	auto scissor = VkRect2D{ { 0, 0 }, m_extent };
+	m_context.dispatch->CmdSetScissor(commandBuffer, 0, 1, &scissor);
+	recordScene(commandBuffer);
+	// La render pass laisse la cible en SHADER_READ_ONLY_OPTIMAL
+	m_context.dispatch->CmdEndRenderPass(commandBuffer);
+	if (m_timer.isSupported()) {
+		m_timer.write(commandBuffer, frameInFlight, 1, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+	}
+	// Chaque dispatch lit ce que les prcdents ont crit
+	memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+	memoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+	auto boundPipeline = VkPipeline{VK_NULL_HANDLE};
+	for (size_t i = 0; i < m_dispatches.size(); i++) {
+		const auto& dispatch = m_dispatches[i];
+		if (dispatch.pipeline != boundPipeline) {
+			m_context.dispatch->CmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, dispatch.pipeline);
+			boundPipeline = dispatch.pipeline;
+		}
+		const auto perImage = dispatch.sets.size() > m_frames.size();
+		const auto set = dispatch.sets[perImage ? frameInFlight * m_swapChainImages.size() + imageIndex : frameInFlight];
+		m_context.dispatch->CmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipelineLayout, 0, 1, &set, 0,
+		                                          nullptr);
+		m_context.dispatch->CmdPushConstants(commandBuffer, m_pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0,
+		                                     sizeof(PushConstants), &dispatch.parameters);
+		m_context.dispatch->CmdDispatch(commandBuffer, dispatch.groupCountX, dispatch.groupCountY, 1);
+		const auto lastOfStage = i + 1 == m_dispatches.size() || m_dispatches[i + 1].stage != dispatch.stage;
+		if (lastOfStage && m_timer.isSupported()) {
+			m_timer.write(commandBuffer, frameInFlight, dispatch.stage + 1, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+		}
+		if (i + 1 < m_dispatches.size()) {
+			m_context.dispatch->CmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			                                       0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+		}
+	}
+	auto barrier = VkImageMemoryBarrier{};
+	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.image = swapChainImage;
+	barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+	if (m_directOutput) {
+		barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		barrier.dstAccessMask = 0;
+		barrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+		barrier.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+		m_context.dispatch->CmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+		                                       0, 0, nullptr, 0, nullptr, 1, &barrier);
+	}
+	else {
+		// Sortie -> TRANSFER_SRC, image de la swapchain UNDEFINED -> TRANSFER_DST
+		VkImageMemoryBarrier copyBarriers[2] = { barrier, barrier };
+		copyBarriers[0].srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		copyBarriers[0].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+		copyBarriers[0].oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+		copyBarriers[0].newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+		copyBarriers[0].image = frame.output.image;
+		copyBarriers[1].srcAccessMask = 0;
+		copyBarriers[1].dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		copyBarriers[1].oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		copyBarriers[1].newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		m_context.dispatch->CmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+		                                       VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 2, copyBarriers);
+		// Mme taille : le blit ne fait que convertir le format (ordre des composantes, encodage sRGB)
+		auto blit = VkImageBlit{};
+		blit.srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+		blit.srcOffsets[1] = { static_cast<int32_t>(m_extent.width), static_cast<int32_t>(m_extent.height), 1 };
+		blit.dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+		blit.dstOffsets[1] = blit.srcOffsets[1];
+		m_context.dispatch->CmdBlitImage(commandBuffer, frame.output.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, swapChainImage,
+		                                 VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_NEAREST);
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = 0;
+		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+		m_context.dispatch->CmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+		                                       0, 0, nullptr, 0, nullptr, 1, &barrier);
+		if (m_timer.isSupported()) {
+			m_timer.write(commandBuffer, frameInFlight, static_cast<uint32_t>(m_stageNames.size()), VK_PIPELINE_STAGE_TRANSFER_BIT);
+		}
+	}
+	if (m_context.dispatch->EndCommandBuffer(commandBuffer) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to end a post-process command buffer");
+	}
+	return commandBuffer;
+}
+
+void CPostProcess::planDispatches() {
+	using Kind = ImageRef::Kind;
+	m_dispatches.clear();
+	m_stageNames = { "scene" };
+	const auto& settings = m_settings;
+	// Seuil du bloom et luminance moyenne calculs dans la mme lecture de la scne
+	if (settings.bloom || settings.tonemap) {
+		const auto flags = (settings.bloom ? COMPOSITE_BLOOM : 0u) | (settings.tonemap ? COMPOSITE_TONEMAP : 0u);
+		const auto* name = settings.bloom && settings.tonemap ? "bloom prefilter + luminance"
+				: settings.bloom ? "bloom prefilter" : "luminance";
+		addDispatch(m_subgroups ? Kernel::PrefilterSubgroups : Kernel::Prefilter, flags, ImageRef{ Kind::Scene, 0 },
+		            settings.bloom ? ImageRef{ Kind::Bloom, 0 } : ImageRef{}, bloomExtent(0), name);
+	}
+	if (settings.bloom) {
+		for (uint32_t level = 1; level < settings.bloomLevels; level++) {
+			addDispatch(Kernel::Downsample, 0, ImageRef{ Kind::Bloom, level - 1 }, ImageRef{ Kind::Bloom, level },
+			            bloomExtent(level), "bloom downsample/upsample");
+		}
+		// Remonte jusqu'au niveau 1 : l'ajout au niveau 0 est fait par le dernier dispatch
+		for (auto level = settings.bloomLevels - 1; level-- > 1;) {
+			addDispatch(Kernel::Upsample, 0, ImageRef{ Kind::Bloom, level + 1 }, ImageRef{ Kind::Bloom, level },
+			            bloomExtent(level), "bloom downsample/upsample");
+		}
+	}
+	if (settings.blur) {
+		addDispatch(Kernel::Blur, 0, ImageRef{ Kind::Scene, 0 }, ImageRef{ Kind::Blur, 0 }, m_extent, "blur (horizontal)");
+	}
+	// Effets du dernier dispatch, dans l'ordre d'application
+	std::vector<std::pair<uint32_t, std::string>> steps;
+	if (settings.blur) { steps.emplace_back(COMPOSITE_BLUR, "blur (vertical)"); }
+	if (settings.bloom) { steps.emplace_back(COMPOSITE_BLOOM, "bloom composite"); }
+	if (settings.tonemap) { steps.emplace_back(COMPOSITE_TONEMAP, "tonemap"); }
+	if (settings.colorGrading) { steps.emplace_back(COMPOSITE_GRADE, "color grading"); }
+	auto source = settings.blur ? ImageRef{ Kind::Blur, 0 } : ImageRef{ Kind::Scene, 0 };
+	if (steps.empty()) {
+		addDispatch(Kernel::Composite, COMPOSITE_FINAL, source, ImageRef{}, m_extent, "copy");
+	}
+	else if (settings.fused) {
+		auto flags = uint32_t{COMPOSITE_FINAL};
+		auto name = std::string{};
+		for (const auto& step : steps) {
+			flags |= step.first;
+			name += (name.empty() ? "" : " + ") + step.second;
+		}
+		addDispatch(Kernel::Composite, flags, source, ImageRef{}, m_extent, name);
+	}
+	else {
+		// Un dispatch par effet : les rsultats intermdiaires alternent entre deux images
+		for (size_t i = 0; i < steps.size(); i++) {
+			const auto last = i + 1 == steps.size();
+			const auto destination = last ? ImageRef{} : ImageRef{ Kind::Stage, static_cast<uint32_t>(i % 2) };
+			addDispatch(Kernel::Composite, steps[i].first | (last ? COMPOSITE_FINAL : 0u), source, destination, m_extent,
+			            steps[i].second);
+			source = destination;
+		}
+	}
+	if (!m_directOutput) { m_stageNames.emplace_back("copy to swapchain"); }
+}
+
+void CPostProcess::addDispatch(Kernel kernel, uint32_t flags, ImageRef source, ImageRef destination, VkExtent2D extent,
+                               const std::string& stage) {
+	if (m_stageNames.back() != stage) { m_stageNames.push_back(stage); }
+	auto dispatch = Dispatch{};
+	dispatch.kernel = kernel;
+	dispatch.flags = flags;
+	dispatch.source = source;
+	dispatch.destination = destination;
+	dispatch.extent = extent;
+	if (kernel == Kernel::Blur) {
+		dispatch.groupCountX = (extent.width + BLUR_ROW_SIZE - 1) / BLUR_ROW_SIZE;
+		dispatch.groupCountY = extent.height;
+	}
+	else {
+		dispatch.groupCountX = (extent.width + TILE_SIZE - 1) / TILE_SIZE;
+		dispatch.groupCountY = (extent.height + TILE_SIZE - 1) / TILE_SIZE;
+	}
+	dispatch.parameters = pushConstants(extent);
+	dispatch.stage = static_cast<uint32_t>(m_stageNames.size() - 1);
+	dispatch.pipeline = pipeline(kernel, flags);
+	m_dispatches.push_back(dispatch);
+}
+
+VkPipeline CPostProcess::pipeline(Kernel kernel, uint32_t flags) {
+	const auto key = (static_cast<uint32_t>(kernel) << 8) | flags;
+	const auto found = m_pipelines.find(key);
+	if (found != m_pipelines.end()) { return found->second; }
+	// Constantes de spcialisation : BLOOM et LUMINANCE pour la premire rduction, BLUR  FINAL pour le composite
+	std::vector<VkBool32> constants;
+	if (kernel == Kernel::Prefilter || kernel == Kernel::PrefilterSubgroups) {
+		constants = { (flags & COMPOSITE_BLOOM) ? VK_TRUE : VK_FALSE, (flags & COMPOSITE_TONEMAP) ? VK_TRUE : VK_FALSE };
+	}
+	else if (kernel == Kernel::Composite) {
+		for (uint32_t bit = 0; bit < 5; bit++) { constants.push_back((flags & (1u << bit)) ? VK_TRUE : VK_FALSE); }
+	}
+	std::vector<VkSpecializationMapEntry> entries;
+	for (uint32_t i = 0; i < constants.size(); i++) {
+		entries.push_back(VkSpecializationMapEntry{ i, static_cast<uint32_t>(i * sizeof(VkBool32)), sizeof(VkBool32) });
+	}
+	auto specializationInfo = VkSpecializationInfo{};
+	specializationInfo.mapEntryCount = static_cast<uint32_t>(entries.size());
+	specializationInfo.pMapEntries = entries.data();
+	specializationInfo.dataSize = constants.size() * sizeof(VkBool32);
+	specializationInfo.pData = constants.data();
+	const auto shaderModule = createShaderModule(m_context, CShaderLoader::readFile(KERNEL_SHADERS[static_cast<uint32_t>(kernel)]));
+	auto pipelineInfo = VkComputePipelineCreateInfo{};
+	pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+	pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+	pipelineInfo.stage.module = shaderModule;
+	pipelineInfo.stage.pName = "main";
+	pipelineInfo.stage.pSpecializationInfo = constants.empty() ? nullptr : &specializationInfo;
+	pipelineInfo.layout = m_pipelineLayout;
+	auto computePipeline = VkPipeline{VK_NULL_HANDLE};
+	const auto result = vkCreateComputePipelines(m_context.device, VK_NULL_HANDLE, 1, &pipelineInfo, m_context.allocator,
+	                                             &computePipeline);
+	vkDestroyShaderModule(m_context.device, shaderModule, m_context.allocator);
+	if (result != VK_SUCCESS) { throw std::runtime_error("Failed to create a post-process compute pipeline"); }
+	m_pipelines[key] = computePipeline;
+	return computePipeline;
+}
+
+void CPostProcess::createDescriptors() {
+	using Kind = ImageRef::Kind;
+	const auto frameCount = static_cast<uint32_t>(m_frames.size());
+	const auto imageCount = static_cast<uint32_t>(m_swapChainImages.size());
+	uint32_t setCount = 0;
+	for (const auto& dispatch : m_dispatches) {
+		const auto perImage = m_directOutput && (dispatch.flags & COMPOSITE_FINAL) && dispatch.kernel == Kernel::Composite;
+		setCount += frameCount * (perImage ? imageCount : 1);
+	}
+	const VkDescriptorPoolSize poolSizes[] = {
+		{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 3 * setCount },
+		{ VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 2 * setCount },
+		{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, setCount }
+	};
+	auto poolInfo = VkDescriptorPoolCreateInfo{};
+	poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	poolInfo.maxSets = setCount;
+	poolInfo.poolSizeCount = 3;
+	poolInfo.pPoolSizes = poolSizes;
+	if (vkCreateDescriptorPool(m_context.device, &poolInfo, m_context.allocator, &m_descriptorPool) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create the post-process descriptor pool");
+	}
+	std::vector<VkDescriptorSetLayout> layouts(setCount, m_descriptorSetLayout);
+	std::vector<VkDescriptorSet> sets(setCount);
+	auto allocInfo = VkDescriptorSetAllocateInfo{};
+	allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	allocInfo.descriptorPool = m_descriptorPool;
+	allocInfo.descriptorSetCount = setCount;
+	allocInfo.pSetLayouts = layouts.data();
+	if (vkAllocateDescriptorSets(m_context.device, &allocInfo, sets.data()) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to allocate the post-process descriptor sets");
+	}
+	// Tous les bindings sont crits : ceux d'un effet dsactiv dsignent l'image factice de la frame
+	size_t next = 0;
+	for (auto& dispatch : m_dispatches) {
+		const auto perImage = m_directOutput && (dispatch.flags & COMPOSITE_FINAL) && dispatch.kernel == Kernel::Composite;
+		for (uint32_t frameIndex = 0; frameIndex < frameCount; frameIndex++) {
+			const auto& frame = m_frames[frameIndex];
+			const auto sourceIsScene = dispatch.source.kind == Kind::Scene;
+			const auto hasBloom = !frame.bloomLevels.empty();
+			VkDescriptorImageInfo imageInfos[BINDING_COUNT] = {};
+			imageInfos[0] = { m_sampler, sourceIsScene ? frame.sceneView : storageImage(frame, dispatch.source).view,
+			                  sourceIsScene ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_GENERAL };
+			imageInfos[1] = { VK_NULL_HANDLE, storageImage(frame, dispatch.destination).view, VK_IMAGE_LAYOUT_GENERAL };
+			imageInfos[2] = { m_sampler, hasBloom ? frame.bloomLevels[0].view : frame.dummy.view, VK_IMAGE_LAYOUT_GENERAL };
+			imageInfos[3] = { m_sampler, hasBloom ? frame.bloomLevels[1].view : frame.dummy.view, VK_IMAGE_LAYOUT_GENERAL };
+			auto bufferInfo = VkDescriptorBufferInfo{ frame.luminanceBuffer, 0, VK_WHOLE_SIZE };
+			for (uint32_t image = 0; image < (perImage ? imageCount : 1); image++) {
+				const auto set = sets[next++];
+				dispatch.sets.push_back(set);
+				auto output = frame.dummy.view;
+				if (dispatch.flags & COMPOSITE_FINAL) { output = m_directOutput ? m_swapChainViews[image] : frame.output.view; }
+				imageInfos[5] = { VK_NULL_HANDLE, output, VK_IMAGE_LAYOUT_GENERAL };
+				VkWriteDescriptorSet writes[BINDING_COUNT] = {};
+				for (uint32_t binding = 0; binding < BINDING_COUNT; binding++) {
+					auto& write = writes[binding];
+					write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+					write.dstSet = set;
+					write.dstBinding = binding;
+					write.descriptorCount = 1;
+					if (binding == 4) {
+						write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+						write.pBufferInfo = &bufferInfo;
+					}
+					else {
+						write.descriptorType = binding == 1 || binding == 5 ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE
+								: VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+						write.pImageInfo = &imageInfos[binding];
+					}
+				}
+				vkUpdateDescriptorSets(m_context.device, BINDING_COUNT, writes, 0, nullptr);
+			}
+		}
+	}
+}
+
+void CPostProcess::createRenderPass() {
+	auto colorAttachment = VkAttachmentDescription{};
+	colorAttachment.format = m_format;
+	colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+	colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+	colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+	colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+	colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	// Prte  tre chantillonne par les compute shaders
+	colorAttachment.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	auto colorAttachmentRef = VkAttachmentReference{};
+	colorAttachmentRef.attachment = 0;
+	colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+	auto subpass = VkSubpassDescription{};
+	subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+	subpass.colorAttachmentCount = 1;
+	subpass.pColorAttachments = &colorAttachmentRef;
+	VkSubpassDependency dependencies[2] = {};
+	// Les compute shaders de la frame prcdente doivent avoir fini de lire la cible
+	dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+	dependencies[0].dstSubpass = 0;
+	dependencies[0].srcStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+	dependencies[0].srcAccessMask = 0;
+	dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	// Les compute shaders lisent ce que la passe a crit
+	dependencies[1].srcSubpass = 0;
+	dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+	dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	dependencies[1].dstStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+	dependencies[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+	auto renderPassInfo = VkRenderPassCreateInfo{};
+	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+	renderPassInfo.attachmentCount = 1;
+	renderPassInfo.pAttachments = &colorAttachment;
+	renderPassInfo.subpassCount = 1;
+	renderPassInfo.pSubpasses = &subpass;
+	renderPassInfo.dependencyCount = 2;
+	renderPassInfo.pDependencies = dependencies;
+	if (vkCreateRenderPass(m_context.device, &renderPassInfo, m_context.allocator, &m_renderPass) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create the post-process render pass");
+	}
+}
+
+void CPostProcess::createFrameResources(FrameResources& frame) {
+	using Kind = ImageRef::Kind;
+	createImage(m_context, m_extent, m_format, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+	            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, frame.sceneImage, frame.sceneMemory, MemoryCategory::Image);
+	auto viewInfo = VkImageViewCreateInfo{};
+	viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+	viewInfo.image = frame.sceneImage;
+	viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+	viewInfo.format = m_format;
+	viewInfo.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+	if (vkCreateImageView(m_context.device, &viewInfo, m_context.allocator, &frame.sceneView) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create a post-process image view");
+	}
+	auto framebufferInfo = VkFramebufferCreateInfo{};
+	framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+	framebufferInfo.renderPass = m_renderPass;
+	framebufferInfo.attachmentCount = 1;
+	framebufferInfo.pAttachments = &frame.sceneView;
+	framebufferInfo.width = m_extent.width;
+	framebufferInfo.height = m_extent.height;
+	framebufferInfo.layers = 1;
+	if (vkCreateFramebuffer(m_context.device, &framebufferInfo, m_context.allocator, &frame.framebuffer) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create a post-process framebuffer");
+	}
+	const VkImageUsageFlags usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+	if (m_settings.bloom) {
+		frame.bloomLevels.resize(m_settings.bloomLevels);
+		for (uint32_t level = 0; level < m_settings.bloomLevels; level++) {
+			createStorageImage(frame.bloomLevels[level], bloomExtent(level), INTERMEDIATE_FORMAT, usage);
+		}
+	}
+	if (m_settings.blur) { createStorageImage(frame.blur, m_extent, INTERMEDIATE_FORMAT, usage); }
+	// Images intermdiaires alloues seulement si un dispatch y crit (effets non fusionns)
+	for (const auto& dispatch : m_dispatches) {
+		if (dispatch.destination.kind != Kind::Stage) { continue; }
+		auto& stage = frame.stages[dispatch.destination.index];
+		if (stage.image == VK_NULL_HANDLE) { createStorageImage(stage, m_extent, INTERMEDIATE_FORMAT, usage); }
+	}
+	createStorageImage(frame.dummy, { 1, 1 }, INTERMEDIATE_FORMAT, usage);
+	if (!m_directOutput) {
+		createStorageImage(frame.output, m_extent, OUTPUT_FORMAT, VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
+	}
+	// Somme des log2(luminance) et nombre de pixels
+	createBuffer(m_context, 2 * sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+	             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, frame.luminanceBuffer, frame.luminanceMemory, MemoryCategory::Buffer);
+}
+
+void CPostProcess::destroyFrameResources(FrameResources& frame) {
+	if (frame.sceneImage == VK_NULL_HANDLE) { return; }
+	destroyBuffer(m_context, frame.luminanceBuffer, frame.luminanceMemory);
+	destroyStorageImage(frame.output);
+	destroyStorageImage(frame.dummy);
+	for (auto& stage : frame.stages) { destroyStorageImage(stage); }
+	destroyStorageImage(frame.blur);
+	for (auto& level : frame.bloomLevels) { destroyStorageImage(level); }
+	vkDestroyFramebuffer(m_context.device, frame.framebuffer, m_context.allocator);
+	vkDestroyImageView(m_context.device, frame.sceneView, m_context.allocator);
+	destroyImage(m_context, frame.sceneImage, frame.sceneMemory);
+	frame = FrameResources{};
+}
+
+void CPostProcess::createStorageImage(StorageImage& image, VkExtent2D extent, VkFormat format, VkImageUsageFlags usage) {
+	image.extent = extent;
+	createImage(m_context, extent, format, usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, image.image, image.memory,
+	            MemoryCategory::Image);
+	auto viewInfo = VkImageViewCreateInfo{};
+	viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+	viewInfo.image = image.image;
+	viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+	viewInfo.format = format;
+	viewInfo.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+	if (vkCreateImageView(m_context.device, &viewInfo, m_context.allocator, &image.view) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create a post-process image view");
+	}
+}
+
+void CPostProcess::destroyStorageImage(StorageImage& image) {
+	if (image.image == VK_NULL_HANDLE) { return; }
+	vkDestroyImageView(m_context.device, image.view, m_context.allocator);
+	destroyImage(m_context, image.image, image.memory);
+	image = StorageImage{};
+}
+
+const CPostProcess::StorageImage& CPostProcess::storageImage(const FrameResources& frame, ImageRef ref) const {
+	switch (ref.kind) {
+		case ImageRef::Kind::Bloom: return frame.bloomLevels[ref.index];
+		case ImageRef::Kind::Blur: return frame.blur;
+		case ImageRef::Kind::Stage: return frame.stages[ref.index];
+		default: return frame.dummy;
+	}
+}
+
+VkExtent2D CPostProcess::bloomExtent(uint32_t level) const {
+	return { std::max(1u, m_extent.width >> (level + 1)), std::max(1u, m_extent.height >> (level + 1)) };
+}
+
+CPostProcess::PushConstants CPostProcess::pushConstants(VkExtent2D extent) const {
+	auto parameters = PushConstants{};
+	parameters.size[0] = static_cast<int32_t>(extent.width);
+	parameters.size[1] = static_cast<int32_t>(extent.height);
+	parameters.threshold = m_settings.bloomThreshold;
+	parameters.intensity = m_settings.bloomIntensity;
+	parameters.grade[0] = m_settings.tint[0];
+	parameters.grade[1] = m_settings.tint[1];
+	parameters.grade[2] = m_settings.tint[2];
+	parameters.grade[3] = m_settings.saturation;
+	parameters.contrast = m_settings.contrast;
+	parameters.key = m_settings.exposureKey;
+	parameters.radius = static_cast<int32_t>(m_settings.blurRadius);
+	parameters.maxExposure = std::max(m_settings.maxExposure, 1.0f);
+	return parameters;
+}
@@ -0,0 +1,47 @@
+#include <Benchmarks.h>
+#include <VulkanApplication.h>
+#include <iomanip>
+#include <iostream>
+#include <utility>
+
+namespace {
+	constexpr uint64_t BENCHMARK_FRAMES = 240;
+}
+
+int runPostProcessBenchmark(const ApplicationSettings& base) {
+	std::cout << "[Post-process benchmark] " << BENCHMARK_FRAMES << " frames per configuration" << std::endl;
+	// Effets activs : flou, bloom (tonemapping et talonnage toujours actifs)
+	const std::pair<bool, bool> effectSets[] = { { false, false }, { false, true }, { true, true } };
+	for (const auto& effects : effectSets) {
+		for (auto fused : { false, true }) {
+			auto settings = base;
+			settings.postProcess = true;
+			settings.dynamicResolution = false;
+			settings.multiview = false;
+			settings.postProcessSettings.blur = effects.first;
+			settings.postProcessSettings.bloom = effects.second;
+			settings.postProcessSettings.tonemap = true;
+			settings.postProcessSettings.colorGrading = true;
+			settings.postProcessSettings.fused = fused;
+			settings.maxFrames = BENCHMARK_FRAMES;
+			std::cout << (effects.first ? "blur + " : "") << (effects.second ? "bloom + " : "") << "tonemap + grade | "
+					<< (fused ? "fused  " : "unfused") << " | ";
+			auto app = CVulkanApplication{settings};
+			try {
+				app.run();
+			}
+			catch (std::exception const& e) {
+				CLogger::flush();
+				std::cout << "skipped (" << e.what() << ")" << std::endl;
+				continue;
+			}
+			const auto stats = app.statistics();
+			std::cout << std::fixed << std::setprecision(3) << stats.averageFrameMs << " ms/frame (median "
+					<< stats.medianFrameMs << ") | GPU post-process " << stats.gpuPostProcessMs << " ms/frame" << std::endl;
+			for (const auto& stage : stats.postProcessStages) {
+				std::cout << "    " << std::left << std::setw(48) << stage.name << std::right << stage.averageMs << " ms" << std::endl;
+			}
+		}
+	}
+	return 0;
+}
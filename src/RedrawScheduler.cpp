@@ -0,0 +1,81 @@
+#include <RedrawScheduler.h>
+#include <algorithm>
+#include <cmath>
+
+const char* redrawReasonName(uint32_t index) {
+	switch (index) {
+		case 0: return "input";
+		case 1: return "resize";
+		case 2: return "animation";
+		case 3: return "data";
+		default: return "unknown";
+	}
+}
+
+void CRedrawScheduler::start(double refreshRate) {
+	m_refreshRate = refreshRate > 0.0 ? refreshRate : 60.0;
+	m_stats = RedrawStats{};
+	m_waited = false;
+	m_stopped = false;
+	m_start = Clock::now();
+	m_nextRefresh = m_start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(m_refreshInterval));
+	// Premire frame : la fentre vient d'apparatre. Les invalidations dj reues sont conserves.
+	m_pending.fetch_or(static_cast<uint32_t>(RedrawReason::Resize), std::memory_order_release);
+}
+
+void CRedrawScheduler::stop() {
+	m_stop = Clock::now();
+	m_stopped = true;
+}
+
+void CRedrawScheduler::invalidate(RedrawReason reason) {
+	const auto previous = m_pending.fetch_or(static_cast<uint32_t>(reason), std::memory_order_acq_rel);
+	// Dj invalide : la boucle a dj t rveille
+	if (previous == 0 && m_wake) { m_wake(); }
+}
+
+void CRedrawScheduler::setRefreshInterval(double interval) {
+	m_refreshInterval = std::max(interval, 0.0);
+	m_nextRefresh = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(m_refreshInterval));
+}
+
+RedrawReason CRedrawScheduler::consume() {
+	const auto now = Clock::now();
+	auto reasons = m_pending.exchange(0, std::memory_order_acq_rel);
+	if (m_animating) { reasons |= static_cast<uint32_t>(RedrawReason::Animation); }
+	if (m_refreshInterval > 0.0 && now >= m_nextRefresh) {
+		reasons |= static_cast<uint32_t>(RedrawReason::DataUpdate);
+		// Prochaine chance  partir de maintenant : pas de rattrapage aprs une pause
+		m_nextRefresh = now + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(m_refreshInterval));
+	}
+	if (reasons == 0) {
+		if (m_waited) { m_stats.idleWakeups++; }
+		m_waited = false;
+		return RedrawReason::None;
+	}
+	m_waited = false;
+	m_stats.renderedFrames++;
+	for (uint32_t i = 0; i < REDRAW_REASON_COUNT; i++) {
+		if ((reasons & (1u << i)) != 0) { m_stats.framesByReason[i]++; }
+	}
+	return static_cast<RedrawReason>(reasons);
+}
+
+double CRedrawScheduler::timeout() const {
+	if (m_refreshInterval <= 0.0) { return -1.0; }
+	return std::max(std::chrono::duration<double>(m_nextRefresh - Clock::now()).count(), 0.0);
+}
+
+void CRedrawScheduler::addWaitTime(double ms) {
+	m_stats.waitingMs += ms;
+	m_waited = true;
+}
+
+RedrawStats CRedrawScheduler::stats() const {
+	auto stats = m_stats;
+	stats.elapsedMs = std::chrono::duration<double, std::milli>((m_stopped ? m_stop : Clock::now()) - m_start).count();
+	// Rafrachissements de l'cran pendant la mesure, moins ceux qui ont reu une frame
+	const auto refreshes = static_cast<uint64_t>(std::floor(stats.elapsedMs * m_refreshRate / 1000.0));
+	stats.idleFrames = refreshes > stats.renderedFrames ? refreshes - stats.renderedFrames : 0;
+	return stats;
+}
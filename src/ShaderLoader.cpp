@@ -1,17 +1,44 @@
 #include <ShaderLoader.h>
+#include <condition_variable>
 #include <fstream>
+#include <map>
+#include <mutex>
 #include <stdexcept>
-#include <iostream>
+#include <Logger.h>
 
 using namespace std::string_literals;
 
+namespace {
+	struct PreloadedFile {
+		bool ready{false};
+		bool loaded{false};
+		std::vector<char> content;
+	};
+
+	std::mutex preloadMutex;
+	std::condition_variable preloadCondition;
+	std::map<std::string, PreloadedFile> preloadedFiles;
+}
+
 std::vector<char> CShaderLoader::readFile(const std::string& filename) {
+	{
+		auto lock = std::unique_lock{preloadMutex};
+		const auto it = preloadedFiles.find(filename);
+		if (it != preloadedFiles.end()) {
+			preloadCondition.wait(lock, [&] { return it->second.ready; });
+			if (it->second.loaded) {
+				CLogger::log(LogLevel::Verbose, "Shader Loader", "Preloaded file: "s + filename + " of size: "
+				             + std::to_string(it->second.content.size()));
+				return it->second.content;
+			}
+		}
+	}
 	auto file = std::ifstream{ filename, std::ios::ate | std::ios::binary };
 	if (!file.is_open()) {
 		throw std::runtime_error("Failed to open file: "s + filename);
 	}
 	const size_t fileSize = static_cast<size_t>(file.tellg());
-	std::cout << "[Shader Loader] Opened file: "s + filename << " of size: " << fileSize << std::endl;
+	CLogger::log(LogLevel::Info, "Shader Loader", "Opened file: "s + filename + " of size: " + std::to_string(fileSize));
 
 	auto buffer = std::vector<char>(fileSize);
 	file.seekg(0);
@@ -19,3 +46,31 @@ std::vector<char> CShaderLoader::readFile(const std::string& filename) {
 	file.close();
 	return buffer;
 }
+
+void CShaderLoader::preload(CAssetStreamer& streamer, const std::vector<std::string>& filenames) {
+	for (const auto& filename : filenames) {
+		{
+			auto lock = std::lock_guard{preloadMutex};
+			if (!preloadedFiles.emplace(filename, PreloadedFile{}).second) { continue; }
+		}
+		auto request = StreamRequest{};
+		request.path = filename;
+		request.priority = StreamPriority::High;
+		request.callback = [filename](StreamResult& result) {
+			{
+				auto lock = std::lock_guard{preloadMutex};
+				auto& file = preloadedFiles[filename];
+				file.ready = true;
+				file.loaded = result.status == StreamStatus::Completed;
+				file.content = std::move(result.data);
+			}
+			preloadCondition.notify_all();
+		};
+		streamer.request(std::move(request));
+	}
+}
+
+void CShaderLoader::clearCache() {
+	auto lock = std::lock_guard{preloadMutex};
+	preloadedFiles.clear();
+}
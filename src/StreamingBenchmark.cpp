@@ -0,0 +1,74 @@
+#include <Benchmarks.h>
+#include <AssetStreamer.h>
+#include <Logger.h>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace {
+	// Taille de la requte prioritaire lance au milieu de la lecture
+	constexpr uint64_t CRITICAL_READ_SIZE = 64 * 1024;
+	constexpr uint32_t BLOCK_SIZE = 1u << 20;
+}
+
+int runStreamingBenchmark(const std::string& path) {
+	auto error = std::error_code{};
+	const auto fileSize = std::filesystem::file_size(path, error);
+	if (error || fileSize == 0) {
+		std::cerr << "Cannot read " << path << std::endl;
+		return EXIT_FAILURE;
+	}
+	std::cout << "[Streaming benchmark] " << path << ": " << fileSize / (1024 * 1024) << " MiB, blocks of "
+			<< BLOCK_SIZE / 1024 << " KiB (the page cache is not dropped between runs)" << std::endl;
+	CLogger::setMinimumLevel(LogLevel::Warning);
+	auto destination = std::vector<char>(fileSize);
+	auto critical = std::vector<char>(CRITICAL_READ_SIZE);
+	for (const auto backend : { StreamBackend::ThreadPool, StreamBackend::IoUring }) {
+		for (const auto queueDepth : { 1u, 4u, 16u, 64u }) {
+			auto settings = AssetStreamerSettings{};
+			settings.backend = backend;
+			settings.queueDepth = queueDepth;
+			settings.blockSize = BLOCK_SIZE;
+			CAssetStreamer streamer;
+			streamer.init(settings);
+			if (streamer.backend() != backend) {
+				std::cout << streamBackendName(backend) << " | not available" << std::endl;
+				break;
+			}
+			auto bulk = StreamRequest{};
+			bulk.path = path;
+			bulk.size = fileSize;
+			bulk.destination = destination.data();
+			bulk.priority = StreamPriority::Background;
+			auto completed = std::atomic<bool>{false};
+			bulk.callback = [&completed](StreamResult& result) { completed = result.status == StreamStatus::Completed; };
+			const auto start = std::chrono::steady_clock::now();
+			streamer.request(std::move(bulk));
+			// Requte prioritaire pendant la lecture : elle passe devant les blocs restants
+			auto request = StreamRequest{};
+			request.path = path;
+			request.offset = fileSize / 2;
+			request.size = std::min<uint64_t>(CRITICAL_READ_SIZE, fileSize - request.offset);
+			request.destination = critical.data();
+			request.priority = StreamPriority::Critical;
+			auto criticalMs = std::atomic<double>{0.0};
+			const auto criticalStart = std::chrono::steady_clock::now();
+			request.callback = [&criticalMs, criticalStart](StreamResult&) {
+				criticalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - criticalStart).count();
+			};
+			streamer.request(std::move(request));
+			streamer.waitIdle();
+			const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			const auto stats = streamer.stats();
+			std::cout << std::setw(11) << streamBackendName(backend) << " | depth " << std::setw(2) << queueDepth << " | "
+					<< std::fixed << std::setprecision(1) << static_cast<double>(fileSize) / (1024.0 * 1024.0) / seconds
+					<< " MiB/s | critical read: " << std::setprecision(3) << criticalMs.load() << " ms | peak in flight: "
+					<< stats.peakReadsInFlight << (completed ? "" : " | FAILED") << std::endl;
+		}
+	}
+	CLogger::flush();
+	return 0;
+}
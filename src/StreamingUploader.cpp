@@ -0,0 +1,280 @@
+#include <StreamingUploader.h>
+#include <Logger.h>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+namespace {
+	// Alignement des zones du staging
+	constexpr VkDeviceSize STAGING_ALIGNMENT = 256;
+
+	VkDeviceSize alignStaging(VkDeviceSize size) {
+		return (size + STAGING_ALIGNMENT - 1) / STAGING_ALIGNMENT * STAGING_ALIGNMENT;
+	}
+}
+
+void CStreamingUploader::init(const DeviceContext& context, uint32_t queueFamily, uint32_t frameCount,
+                              CAssetStreamer& streamer, VkDeviceSize stagingSize) {
+	m_context = context;
+	m_streamer = &streamer;
+	m_stagingSize = std::max(alignStaging(stagingSize), 4 * STAGING_ALIGNMENT);
+	m_partSize = m_stagingSize / 4 / STAGING_ALIGNMENT * STAGING_ALIGNMENT;
+	// crit par le CPU (les lectures du disque), lu une seule fois par le GPU : mmoire cohrente non cache
+	createBuffer(m_context, m_stagingSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+	             VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+	             m_stagingBuffer, m_stagingMemory, MemoryCategory::Staging);
+	void* data;
+	if (vkMapMemory(m_context.device, m_stagingMemory, 0, m_stagingSize, 0, &data) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to map the streaming staging buffer");
+	}
+	m_mapped = static_cast<char*>(data);
+	m_freeRanges.clear();
+	m_freeRanges.emplace(0, m_stagingSize);
+	m_stagingUsage = 0;
+	m_stats = StreamingUploadStats{};
+	auto poolInfo = VkCommandPoolCreateInfo{};
+	poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	poolInfo.queueFamilyIndex = queueFamily;
+	poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+	if (vkCreateCommandPool(m_context.device, &poolInfo, m_context.allocator, &m_commandPool) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create the streaming command pool");
+	}
+	m_frames.resize(frameCount);
+	for (auto& frame : m_frames) {
+		auto allocInfo = VkCommandBufferAllocateInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocInfo.commandPool = m_commandPool;
+		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		allocInfo.commandBufferCount = 1;
+		if (vkAllocateCommandBuffers(m_context.device, &allocInfo, &frame.commandBuffer) != VK_SUCCESS) {
+			throw std::runtime_error("Failed to allocate a streaming command buffer");
+		}
+	}
+}
+
+void CStreamingUploader::cleanup() {
+	if (m_context.device == VK_NULL_HANDLE) { return; }
+	{
+		// Les lectures en cours crivent dans le staging : il reste mapp jusqu' leur fin
+		auto lock = std::unique_lock{m_mutex};
+		m_waiting.clear();
+		for (const auto& [id, upload] : m_uploads) {
+			for (const auto request : upload.requests) { m_streamer->cancel(request); }
+		}
+		m_condition.wait(lock, [this] { return m_readsInFlight == 0; });
+		m_uploads.clear();
+		m_ready.clear();
+	}
+	m_frames.clear();
+	vkDestroyCommandPool(m_context.device, m_commandPool, m_context.allocator);
+	vkUnmapMemory(m_context.device, m_stagingMemory);
+	destroyBuffer(m_context, m_stagingBuffer, m_stagingMemory);
+	m_mapped = nullptr;
+	m_freeRanges.clear();
+	m_streamer = nullptr;
+	m_context.device = VK_NULL_HANDLE;
+}
+
+uint64_t CStreamingUploader::upload(const std::string& path, uint64_t offset, VkDeviceSize size, VkBuffer buffer,
+                                    VkDeviceSize bufferOffset, StreamPriority priority, CompletionFunction onCompleted) {
+	if (size == 0) { throw std::runtime_error("Failed to upload " + path + ": empty upload"); }
+	auto lock = std::lock_guard{m_mutex};
+	const auto id = m_nextUpload++;
+	auto upload = Upload{};
+	upload.path = path;
+	upload.buffer = buffer;
+	upload.priority = priority;
+	upload.onCompleted = std::move(onCompleted);
+	for (VkDeviceSize done = 0; done < size; done += m_partSize) {
+		auto part = Part{};
+		part.upload = id;
+		part.buffer = buffer;
+		part.fileOffset = offset + done;
+		part.size = std::min(m_partSize, size - done);
+		part.bufferOffset = bufferOffset + done;
+		m_waiting.emplace(std::pair{-static_cast<int>(priority), m_nextPart++}, part);
+		upload.partsRemaining++;
+	}
+	m_uploads.emplace(id, std::move(upload));
+	issueWaitingParts();
+	return id;
+}
+
+bool CStreamingUploader::cancel(uint64_t id) {
+	auto lock = std::lock_guard{m_mutex};
+	const auto it = m_uploads.find(id);
+	if (it == m_uploads.end() || it->second.failed) { return false; }
+	it->second.failed = true;
+	// Parties pas encore lues : abandonnes  la prochaine frame ; parties en lecture : annules par le streamer
+	for (auto waiting = m_waiting.begin(); waiting != m_waiting.end();) {
+		if (waiting->second.upload != id) {
+			++waiting;
+			continue;
+		}
+		m_ready.push_back(waiting->second);
+		waiting = m_waiting.erase(waiting);
+	}
+	for (const auto request : it->second.requests) { m_streamer->cancel(request); }
+	return true;
+}
+
+void CStreamingUploader::issueWaitingParts() {
+	// Dans l'ordre strict : une partie prioritaire qui ne trouve pas de place n'est pas double
+	while (!m_waiting.empty()) {
+		auto next = m_waiting.begin();
+		auto part = next->second;
+		if (!allocateStaging(alignStaging(part.size), part.stagingOffset)) { return; }
+		m_waiting.erase(next);
+		part.staged = true;
+		auto& upload = m_uploads.at(part.upload);
+		auto request = StreamRequest{};
+		request.path = upload.path;
+		request.offset = part.fileOffset;
+		request.size = part.size;
+		request.destination = m_mapped + part.stagingOffset;
+		request.priority = upload.priority;
+		// Thread d'entre/sortie du streamer : la partie est range pour la prochaine frame
+		request.callback = [this, part](StreamResult& result) mutable {
+			{
+				auto lock = std::lock_guard{m_mutex};
+				part.success = result.status == StreamStatus::Completed && result.bytesRead == part.size;
+				auto& requests = m_uploads.at(part.upload).requests;
+				requests.erase(std::remove(requests.begin(), requests.end(), result.id), requests.end());
+				m_ready.push_back(part);
+				m_readsInFlight--;
+			}
+			m_condition.notify_all();
+		};
+		m_readsInFlight++;
+		upload.requests.push_back(m_streamer->request(std::move(request)));
+	}
+}
+
+VkCommandBuffer CStreamingUploader::record(uint32_t frameInFlight) {
+	auto& frame = m_frames[frameInFlight];
+	{
+		auto lock = std::lock_guard{m_mutex};
+		if (m_ready.empty()) { return VK_NULL_HANDLE; }
+		frame.parts.insert(frame.parts.end(), m_ready.begin(), m_ready.end());
+		m_ready.clear();
+	}
+	// Une copie par buffer de destination, avec une rgion par partie lue
+	std::sort(frame.parts.begin(), frame.parts.end(), [](const Part& a, const Part& b) { return a.buffer < b.buffer; });
+	const auto& dispatch = *m_context.dispatch;
+	auto begun = false;
+	for (size_t first = 0; first < frame.parts.size();) {
+		auto last = first;
+		m_regions.clear();
+		for (; last < frame.parts.size() && frame.parts[last].buffer == frame.parts[first].buffer; last++) {
+			const auto& part = frame.parts[last];
+			if (!part.success) { continue; }
+			auto region = VkBufferCopy{};
+			region.srcOffset = part.stagingOffset;
+			region.dstOffset = part.bufferOffset;
+			region.size = part.size;
+			m_regions.push_back(region);
+		}
+		if (!m_regions.empty()) {
+			if (!begun) {
+				dispatch.ResetCommandBuffer(frame.commandBuffer, 0);
+				auto beginInfo = VkCommandBufferBeginInfo{};
+				beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+				beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+				if (dispatch.BeginCommandBuffer(frame.commandBuffer, &beginInfo) != VK_SUCCESS) {
+					throw std::runtime_error("Failed to begin recording a streaming command buffer");
+				}
+				begun = true;
+			}
+			dispatch.CmdCopyBuffer(frame.commandBuffer, m_stagingBuffer, frame.parts[first].buffer,
+			                       static_cast<uint32_t>(m_regions.size()), m_regions.data());
+		}
+		first = last;
+	}
+	// Parties abandonnes seulement : rien  soumettre, elles sont libres  la fin de la frame
+	if (!begun) { return VK_NULL_HANDLE; }
+	auto barrier = VkMemoryBarrier{};
+	barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT
+		| VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT;
+	dispatch.CmdPipelineBarrier(frame.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+	                            VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT
+	                            | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT
+	                            | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+	                            0, 1, &barrier, 0, nullptr, 0, nullptr);
+	if (dispatch.EndCommandBuffer(frame.commandBuffer) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to record a streaming command buffer");
+	}
+	return frame.commandBuffer;
+}
+
+void CStreamingUploader::onFrameCompleted(uint32_t frameInFlight) {
+	auto& frame = m_frames[frameInFlight];
+	if (frame.parts.empty()) { return; }
+	auto completed = std::vector<std::pair<uint64_t, Upload>>{};
+	{
+		auto lock = std::lock_guard{m_mutex};
+		for (const auto& part : frame.parts) {
+			if (part.staged) { freeStaging(part.stagingOffset, alignStaging(part.size)); }
+			auto& upload = m_uploads.at(part.upload);
+			if (part.success) { m_stats.bytesUploaded += part.size; }
+			else { upload.failed = true; }
+			if (--upload.partsRemaining > 0) { continue; }
+			if (upload.failed) { m_stats.uploadsFailed++; }
+			else { m_stats.uploadsCompleted++; }
+			const auto it = m_uploads.find(part.upload);
+			completed.emplace_back(it->first, std::move(it->second));
+			m_uploads.erase(it);
+		}
+		frame.parts.clear();
+		// Zones libres : les parties en attente peuvent tre lues
+		issueWaitingParts();
+	}
+	for (auto& [id, upload] : completed) {
+		if (upload.failed) { CLogger::log(LogLevel::Warning, "Streaming", "Failed to upload " + upload.path); }
+		if (upload.onCompleted) { upload.onCompleted(id, !upload.failed); }
+	}
+}
+
+bool CStreamingUploader::idle() const {
+	auto lock = std::lock_guard{m_mutex};
+	return m_uploads.empty();
+}
+
+StreamingUploadStats CStreamingUploader::stats() const {
+	auto lock = std::lock_guard{m_mutex};
+	return m_stats;
+}
+
+bool CStreamingUploader::allocateStaging(VkDeviceSize size, VkDeviceSize& offset) {
+	// Premire zone assez grande
+	for (auto it = m_freeRanges.begin(); it != m_freeRanges.end(); ++it) {
+		if (it->second < size) { continue; }
+		offset = it->first;
+		const auto remaining = it->second - size;
+		m_freeRanges.erase(it);
+		if (remaining > 0) { m_freeRanges.emplace(offset + size, remaining); }
+		m_stagingUsage += size;
+		m_stats.peakStagingUsage = std::max(m_stats.peakStagingUsage, m_stagingUsage);
+		return true;
+	}
+	return false;
+}
+
+void CStreamingUploader::freeStaging(VkDeviceSize offset, VkDeviceSize size) {
+	m_stagingUsage -= size;
+	auto it = m_freeRanges.emplace(offset, size).first;
+	// Fusion avec la zone libre suivante puis la prcdente
+	const auto next = std::next(it);
+	if (next != m_freeRanges.end() && it->first + it->second == next->first) {
+		it->second += next->second;
+		m_freeRanges.erase(next);
+	}
+	if (it != m_freeRanges.begin()) {
+		const auto previous = std::prev(it);
+		if (previous->first + previous->second == it->first) {
+			previous->second += it->second;
+			m_freeRanges.erase(it);
+		}
+	}
+}
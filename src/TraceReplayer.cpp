@@ -0,0 +1,404 @@
+#include <TraceReplayer.h>
+#include <Logger.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+
+void CTraceReplayer::init(const DeviceContext& context, uint32_t queueFamily, VkQueue queue, const std::string& path) {
+	m_reader.open(path);
+	m_context = context;
+	m_queue = queue;
+	m_extent = { m_reader.header().width, m_reader.header().height };
+	createTarget();
+	// Pipeline layout de la capture : ni descripteurs ni push constants
+	auto pipelineLayoutInfo = VkPipelineLayoutCreateInfo{};
+	pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+	if (vkCreatePipelineLayout(m_context.device, &pipelineLayoutInfo, m_context.allocator, &m_pipelineLayout) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create the replay pipeline layout");
+	}
+	auto poolInfo = VkCommandPoolCreateInfo{};
+	poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	poolInfo.queueFamilyIndex = queueFamily;
+	// Command buffers renregistrs lorsque la trace les renregistre
+	poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+	if (vkCreateCommandPool(m_context.device, &poolInfo, m_context.allocator, &m_commandPool) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create the replay command pool");
+	}
+	auto fenceInfo = VkFenceCreateInfo{};
+	fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+	for (auto& fence : m_fences) {
+		if (vkCreateFence(m_context.device, &fenceInfo, m_context.allocator, &fence) != VK_SUCCESS) {
+			throw std::runtime_error("Failed to create a replay fence");
+		}
+	}
+	m_fenceSubmitted.fill(false);
+	createObjects();
+	CLogger::log(LogLevel::Info, "Trace", "Replaying " + path + " at " + std::to_string(m_extent.width) + "x"
+	             + std::to_string(m_extent.height) + ": " + std::to_string(m_pipelines.size()) + " pipelines, "
+	             + std::to_string(m_buffers.size()) + " buffers");
+}
+
+void CTraceReplayer::cleanup() {
+	if (m_context.device == VK_NULL_HANDLE) { return; }
+	for (auto& buffer : m_buffers) {
+		vkUnmapMemory(m_context.device, buffer.memory);
+		destroyBuffer(m_context, buffer.buffer, buffer.memory);
+	}
+	m_buffers.clear();
+	for (const auto pipeline : m_pipelines) { vkDestroyPipeline(m_context.device, pipeline, m_context.allocator); }
+	m_pipelines.clear();
+	for (const auto module : m_shaderModules) { vkDestroyShaderModule(m_context.device, module, m_context.allocator); }
+	m_shaderModules.clear();
+	m_livePipelines.clear();
+	m_liveBuffers.clear();
+	m_commandBuffers.clear();
+	m_pendingCommandBuffers.clear();
+	for (auto& fence : m_fences) {
+		vkDestroyFence(m_context.device, fence, m_context.allocator);
+		fence = VK_NULL_HANDLE;
+	}
+	vkDestroyCommandPool(m_context.device, m_commandPool, m_context.allocator);
+	vkDestroyPipelineLayout(m_context.device, m_pipelineLayout, m_context.allocator);
+	vkDestroyFramebuffer(m_context.device, m_framebuffer, m_context.allocator);
+	vkDestroyRenderPass(m_context.device, m_renderPass, m_context.allocator);
+	vkDestroyImageView(m_context.device, m_targetView, m_context.allocator);
+	destroyImage(m_context, m_targetImage, m_targetMemory);
+	m_context.device = VK_NULL_HANDLE;
+}
+
+TraceReplayStats CTraceReplayer::replay(const TraceReplaySettings& settings, std::vector<float>& frameTimes) {
+	auto stats = TraceReplayStats{};
+	m_livePipelines.clear();
+	m_liveBuffers.clear();
+	size_t nextPipeline = 0;
+	size_t nextBuffer = 0;
+	auto recording = VkCommandBuffer{VK_NULL_HANDLE};
+	uint32_t slot = 0;
+	// VkSubmitInfo du vkQueueSubmit captur en cours de lecture : plage de submitted de chacun
+	std::vector<VkCommandBuffer> submitted;
+	std::vector<std::pair<size_t, size_t>> submittedRanges;
+	std::vector<VkSubmitInfo> submitInfos;
+	// Cadence de la capture mesure  partir de la premire prsentation (l'initialisation n'est pas rejoue)
+	auto firstPresentNs = uint64_t{0};
+	auto hasPresented = false;
+	const auto start = std::chrono::steady_clock::now();
+	auto frameStart = start;
+	auto record = TraceRecord{};
+	m_reader.rewind();
+	while (m_reader.next(record)) {
+		if (record.op >= TraceOp::BeginRenderPass && record.op <= TraceOp::EndCommandBuffer && recording == VK_NULL_HANDLE) {
+			throw std::runtime_error("Failed to replay a command recorded outside of a command buffer");
+		}
+		switch (record.op) {
+		case TraceOp::Pipeline:
+			m_livePipelines[record.payload<TracePipeline>().id] = m_pipelines[nextPipeline++];
+			break;
+		case TraceOp::Buffer:
+			m_liveBuffers[record.payload<TraceBuffer>().id] = nextBuffer++;
+			break;
+		case TraceOp::BufferData: {
+			const auto write = record.payload<TraceBufferData>();
+			const auto data = record.trailing<TraceBufferData>(static_cast<size_t>(write.size));
+			const auto found = m_liveBuffers.find(write.id);
+			if (found == m_liveBuffers.end()) { break; }
+			auto& buffer = m_buffers[found->second];
+			if (write.offset + write.size > buffer.size) {
+				throw std::runtime_error("Failed to replay a write outside of its buffer");
+			}
+			std::memcpy(static_cast<char*>(buffer.mapped) + write.offset, data, static_cast<size_t>(write.size));
+			break;
+		}
+		case TraceOp::BeginCommandBuffer: {
+			const auto id = record.payload<uint64_t>();
+			// Renregistrement d'un command buffer dj soumis (nouvelles variantes de pipeline...) : rare, la queue est vide
+			if (m_pendingCommandBuffers.count(id) > 0) {
+				m_context.dispatch->QueueWaitIdle(m_queue);
+				m_pendingCommandBuffers.clear();
+			}
+			recording = commandBuffer(id);
+			auto beginInfo = VkCommandBufferBeginInfo{};
+			beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+			beginInfo.flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
+			if (m_context.dispatch->BeginCommandBuffer(recording, &beginInfo) != VK_SUCCESS) {
+				throw std::runtime_error("Failed to begin a replayed command buffer");
+			}
+			break;
+		}
+		case TraceOp::BeginRenderPass: {
+			const auto pass = record.payload<TraceRenderPass>();
+			auto clearValue = VkClearValue{};
+			std::copy(std::begin(pass.clearColor), std::end(pass.clearColor), clearValue.color.float32);
+			auto renderPassInfo = VkRenderPassBeginInfo{};
+			renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+			renderPassInfo.renderPass = m_renderPass;
+			renderPassInfo.framebuffer = m_framebuffer;
+			// Toutes les sorties de la capture partagent la cible : zone de rendu limite  ses dimensions
+			renderPassInfo.renderArea.extent = { std::min(pass.width, m_extent.width), std::min(pass.height, m_extent.height) };
+			renderPassInfo.clearValueCount = 1;
+			renderPassInfo.pClearValues = &clearValue;
+			m_context.dispatch->CmdBeginRenderPass(recording, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+			break;
+		}
+		case TraceOp::SetViewport: {
+			const auto viewport = record.payload<VkViewport>();
+			m_context.dispatch->CmdSetViewport(recording, 0, 1, &viewport);
+			break;
+		}
+		case TraceOp::SetScissor: {
+			auto scissor = record.payload<VkRect2D>();
+			scissor.extent.width = std::min(scissor.extent.width, m_extent.width);
+			scissor.extent.height = std::min(scissor.extent.height, m_extent.height);
+			m_context.dispatch->CmdSetScissor(recording, 0, 1, &scissor);
+			break;
+		}
+		case TraceOp::BindPipeline: {
+			const auto found = m_livePipelines.find(record.payload<uint64_t>());
+			if (found == m_livePipelines.end()) { throw std::runtime_error("Failed to replay a bind of an unknown pipeline"); }
+			m_context.dispatch->CmdBindPipeline(recording, VK_PIPELINE_BIND_POINT_GRAPHICS, found->second);
+			break;
+		}
+		case TraceOp::Draw: {
+			const auto draw = record.payload<TraceDraw>();
+			m_context.dispatch->CmdDraw(recording, draw.vertexCount, draw.instanceCount, draw.firstVertex, draw.firstInstance);
+			stats.draws++;
+			break;
+		}
+		case TraceOp::EndRenderPass:
+			m_context.dispatch->CmdEndRenderPass(recording);
+			break;
+		case TraceOp::EndCommandBuffer:
+			if (m_context.dispatch->EndCommandBuffer(recording) != VK_SUCCESS) {
+				throw std::runtime_error("Failed to end a replayed command buffer");
+			}
+			recording = VK_NULL_HANDLE;
+			break;
+		case TraceOp::Submit: {
+			const auto submit = record.payload<TraceSubmit>();
+			// Les smaphores (acquisition et prsentation  la capture) ne sont pas rejous : il n'y a ni swapchain ni
+			// prsentation, et l'ordre de soumission sur l'unique queue suffit  ordonner les lots
+			const auto idCount = static_cast<size_t>(submit.commandBufferCount) + submit.waitSemaphoreCount + submit.signalSemaphoreCount;
+			const auto ids = record.trailing<TraceSubmit>(idCount * sizeof(uint64_t));
+			const auto first = submitted.size();
+			for (uint32_t i = 0; i < submit.commandBufferCount; i++) {
+				uint64_t id;
+				std::memcpy(&id, ids + i * sizeof(uint64_t), sizeof(uint64_t));
+				const auto found = m_commandBuffers.find(id);
+				if (found == m_commandBuffers.end()) {
+					stats.skippedCommandBuffers++;
+					continue;
+				}
+				submitted.push_back(found->second);
+				m_pendingCommandBuffers.insert(id);
+			}
+			if (submitted.size() > first) { submittedRanges.emplace_back(first, submitted.size()); }
+			// Les VkSubmitInfo d'un mme appel sont soumis ensemble, comme  la capture
+			if (!submit.lastInBatch || submittedRanges.empty()) { break; }
+			submitInfos.clear();
+			for (const auto& [begin, end] : submittedRanges) {
+				auto submitInfo = VkSubmitInfo{};
+				submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+				submitInfo.commandBufferCount = static_cast<uint32_t>(end - begin);
+				submitInfo.pCommandBuffers = submitted.data() + begin;
+				submitInfos.push_back(submitInfo);
+			}
+			// La fence de la frame signale sa premire soumission (une seule soumission par frame  la capture)
+			const auto fence = m_fenceSubmitted[slot] ? VK_NULL_HANDLE : m_fences[slot];
+			if (m_context.dispatch->QueueSubmit(m_queue, static_cast<uint32_t>(submitInfos.size()), submitInfos.data(), fence) != VK_SUCCESS) {
+				throw std::runtime_error("Failed to submit a replayed command buffer");
+			}
+			m_fenceSubmitted[slot] = true;
+			stats.submits += submitInfos.size();
+			submitted.clear();
+			submittedRanges.clear();
+			break;
+		}
+		case TraceOp::Present: {
+			const auto present = record.payload<TracePresent>();
+			if (!hasPresented) {
+				firstPresentNs = present.timeNs;
+				hasPresented = true;
+			}
+			stats.capturedMs = static_cast<double>(present.timeNs - firstPresentNs) / 1e6;
+			if (settings.paced) {
+				std::this_thread::sleep_until(start + std::chrono::nanoseconds{present.timeNs - firstPresentNs});
+			}
+			// Comme  la capture, la frame suivante commence par attendre la fin de celle qui utilisait son slot
+			slot = (slot + 1) % FRAMES_IN_FLIGHT;
+			waitFrame(slot);
+			const auto now = std::chrono::steady_clock::now();
+			frameTimes.push_back(std::chrono::duration<float, std::milli>(now - frameStart).count());
+			frameStart = now;
+			stats.frames++;
+			break;
+		}
+		default:
+			// Objets dj crs par createObjects()
+			break;
+		}
+	}
+	for (uint32_t i = 0; i < FRAMES_IN_FLIGHT; i++) { waitFrame(i); }
+	m_context.dispatch->QueueWaitIdle(m_queue);
+	m_pendingCommandBuffers.clear();
+	stats.totalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	return stats;
+}
+
+void CTraceReplayer::createTarget() {
+	const auto format = static_cast<VkFormat>(m_reader.header().format);
+	createImage(m_context, m_extent, format, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+	            m_targetImage, m_targetMemory, MemoryCategory::Image);
+	auto viewInfo = VkImageViewCreateInfo{};
+	viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+	viewInfo.image = m_targetImage;
+	viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+	viewInfo.format = format;
+	viewInfo.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+	if (vkCreateImageView(m_context.device, &viewInfo, m_context.allocator, &m_targetView) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create the replay image view");
+	}
+	// Mme attachement que la render pass de l'application, laiss en COLOR_ATTACHMENT_OPTIMAL (pas de prsentation)
+	auto colorAttachment = VkAttachmentDescription{};
+	colorAttachment.format = format;
+	colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+	colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+	colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+	colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+	colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	colorAttachment.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+	auto colorAttachmentRef = VkAttachmentReference{};
+	colorAttachmentRef.attachment = 0;
+	colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+	auto subpass = VkSubpassDescription{};
+	subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+	subpass.colorAttachmentCount = 1;
+	subpass.pColorAttachments = &colorAttachmentRef;
+	// Les frames successives crivent la mme image
+	auto dependency = VkSubpassDependency{};
+	dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+	dependency.dstSubpass = 0;
+	dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	dependency.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	auto renderPassInfo = VkRenderPassCreateInfo{};
+	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+	renderPassInfo.attachmentCount = 1;
+	renderPassInfo.pAttachments = &colorAttachment;
+	renderPassInfo.subpassCount = 1;
+	renderPassInfo.pSubpasses = &subpass;
+	renderPassInfo.dependencyCount = 1;
+	renderPassInfo.pDependencies = &dependency;
+	if (vkCreateRenderPass(m_context.device, &renderPassInfo, m_context.allocator, &m_renderPass) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create the replay render pass");
+	}
+	auto framebufferInfo = VkFramebufferCreateInfo{};
+	framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+	framebufferInfo.renderPass = m_renderPass;
+	framebufferInfo.attachmentCount = 1;
+	framebufferInfo.pAttachments = &m_targetView;
+	framebufferInfo.width = m_extent.width;
+	framebufferInfo.height = m_extent.height;
+	framebufferInfo.layers = 1;
+	if (vkCreateFramebuffer(m_context.device, &framebufferInfo, m_context.allocator, &m_framebuffer) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create the replay framebuffer");
+	}
+}
+
+void CTraceReplayer::createObjects() {
+	std::unordered_map<uint64_t, VkShaderModule> modules;
+	auto state = GraphicsPipelineState{};
+	auto hasState = false;
+	auto record = TraceRecord{};
+	m_reader.rewind();
+	while (m_reader.next(record)) {
+		switch (record.op) {
+		case TraceOp::ShaderModule: {
+			const auto module = record.payload<TraceShaderModule>();
+			const auto code = record.trailing<TraceShaderModule>(module.codeSize);
+			m_shaderModules.push_back(createShaderModule(m_context, std::vector<char>(code, code + module.codeSize)));
+			modules[module.id] = m_shaderModules.back();
+			break;
+		}
+		case TraceOp::PipelineState: {
+			const auto traced = record.payload<TracePipelineState>();
+			const auto vertexShader = modules.find(traced.vertexShader);
+			const auto fragmentShader = modules.find(traced.fragmentShader);
+			if (vertexShader == modules.end() || fragmentShader == modules.end()) {
+				throw std::runtime_error("Failed to replay a pipeline state with unknown shader modules");
+			}
+			state = GraphicsPipelineState{};
+			state.vertexShader = vertexShader->second;
+			state.fragmentShader = fragmentShader->second;
+			state.inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+			state.inputAssembly.topology = static_cast<VkPrimitiveTopology>(traced.topology);
+			state.rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+			state.rasterizer.polygonMode = static_cast<VkPolygonMode>(traced.polygonMode);
+			state.rasterizer.cullMode = traced.cullMode;
+			state.rasterizer.frontFace = static_cast<VkFrontFace>(traced.frontFace);
+			state.rasterizer.lineWidth = traced.lineWidth;
+			state.multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+			state.multisampling.rasterizationSamples = static_cast<VkSampleCountFlagBits>(traced.samples);
+			state.multisampling.minSampleShading = 1.0f;
+			state.colorBlendAttachment.colorWriteMask = traced.colorWriteMask;
+			state.colorBlendAttachment.blendEnable = traced.blendEnable;
+			state.layout = m_pipelineLayout;
+			state.renderPass = m_renderPass;
+			hasState = true;
+			break;
+		}
+		case TraceOp::Pipeline: {
+			if (!hasState) { throw std::runtime_error("Failed to replay a pipeline traced before its state"); }
+			const auto traced = record.payload<TracePipeline>();
+			auto key = PipelineVariantKey{};
+			std::copy(std::begin(traced.constants), std::end(traced.constants), key.constants.begin());
+			const auto pipeline = createVariantPipeline(m_context, VK_NULL_HANDLE, state, traced.specialized != 0 ? &key : nullptr);
+			if (pipeline == VK_NULL_HANDLE) { throw std::runtime_error("Failed to create a replayed pipeline"); }
+			m_pipelines.push_back(pipeline);
+			break;
+		}
+		case TraceOp::Buffer: {
+			const auto traced = record.payload<TraceBuffer>();
+			// Mmoire visible par le CPU : le contenu trac y est recopi pendant le rejeu
+			auto buffer = ReplayBuffer{};
+			buffer.size = traced.size;
+			createBuffer(m_context, traced.size, traced.usage,
+			             VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			             buffer.buffer, buffer.memory, MemoryCategory::Buffer);
+			vkMapMemory(m_context.device, buffer.memory, 0, traced.size, 0, &buffer.mapped);
+			m_buffers.push_back(buffer);
+			break;
+		}
+		default:
+			break;
+		}
+	}
+}
+
+VkCommandBuffer CTraceReplayer::commandBuffer(uint64_t id) {
+	const auto found = m_commandBuffers.find(id);
+	if (found != m_commandBuffers.end()) { return found->second; }
+	auto allocInfo = VkCommandBufferAllocateInfo{};
+	allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	allocInfo.commandPool = m_commandPool;
+	allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	allocInfo.commandBufferCount = 1;
+	auto commandBuffer = VkCommandBuffer{VK_NULL_HANDLE};
+	if (vkAllocateCommandBuffers(m_context.device, &allocInfo, &commandBuffer) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to allocate a replayed command buffer");
+	}
+	m_commandBuffers[id] = commandBuffer;
+	return commandBuffer;
+}
+
+void CTraceReplayer::waitFrame(uint32_t slot) {
+	if (!m_fenceSubmitted[slot]) { return; }
+	m_context.dispatch->WaitForFences(m_context.device, 1, &m_fences[slot], VK_TRUE, std::numeric_limits<uint64_t>::max());
+	m_context.dispatch->ResetFences(m_context.device, 1, &m_fences[slot]);
+	m_fenceSubmitted[slot] = false;
+}
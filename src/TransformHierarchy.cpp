@@ -0,0 +1,165 @@
+#include <TransformHierarchy.h>
+#include <algorithm>
+#include <cstring>
+
+NodeId CTransformHierarchy::createNode(NodeId parent) {
+	const auto id = static_cast<NodeId>(m_parentId.size());
+	m_parentId.push_back(parent);
+	// Ajout en fin de tableau, l'ordre par profondeur est reconstruit au prochain update()
+	m_idToIndex.push_back(static_cast<uint32_t>(m_ids.size()));
+	m_ids.push_back(id);
+	m_translation.push_back({});
+	m_rotation.push_back({});
+	m_scale.push_back({ 1.0f, 1.0f, 1.0f });
+	m_world.emplace_back();
+	m_orderDirty = true;
+	return id;
+}
+
+void CTransformHierarchy::setLocalTransform(NodeId node, const Vec3& translation, const Quat& rotation,
+                                            const Vec3& scale) {
+	const auto index = m_idToIndex[node];
+	m_translation[index] = translation;
+	m_rotation[index] = rotation;
+	m_scale[index] = scale;
+	markDirty(index);
+}
+
+void CTransformHierarchy::setLocalTranslation(NodeId node, const Vec3& translation) {
+	const auto index = m_idToIndex[node];
+	m_translation[index] = translation;
+	markDirty(index);
+}
+
+void CTransformHierarchy::markDirty(uint32_t index) {
+	// Tout sera recalcul aprs la reconstruction de l'ordre
+	if (m_orderDirty || m_dirty[index]) { return; }
+	m_dirty[index] = 1;
+	const auto level = std::upper_bound(m_levelOffsets.begin(), m_levelOffsets.end(), index) - m_levelOffsets.begin() - 1;
+	m_dirtyByLevel[level].push_back(index);
+}
+
+void CTransformHierarchy::rebuildOrder() {
+	const auto count = m_parentId.size();
+	// Listes d'enfants par id (tri par comptage)
+	std::vector<uint32_t> childOffsets(count + 1, 0);
+	for (NodeId id = 0; id < count; id++) {
+		if (m_parentId[id] != INVALID_NODE) { childOffsets[m_parentId[id] + 1]++; }
+	}
+	for (size_t i = 0; i < count; i++) { childOffsets[i + 1] += childOffsets[i]; }
+	std::vector<NodeId> children(childOffsets[count]);
+	auto cursor = childOffsets;
+	for (NodeId id = 0; id < count; id++) {
+		if (m_parentId[id] != INVALID_NODE) { children[cursor[m_parentId[id]]++] = id; }
+	}
+	// Parcours en largeur : racines puis chaque niveau dans l'ordre de ses parents
+	std::vector<NodeId> order;
+	order.reserve(count);
+	for (NodeId id = 0; id < count; id++) {
+		if (m_parentId[id] == INVALID_NODE) { order.push_back(id); }
+	}
+	m_levelOffsets.assign(1, 0);
+	std::vector<uint32_t> newIndex(count);
+	m_parent.assign(count, INVALID_NODE);
+	m_firstChild.assign(count, 0);
+	m_childCount.assign(count, 0);
+	for (size_t levelBegin = 0; levelBegin < order.size();) {
+		const auto levelEnd = order.size();
+		for (auto i = levelBegin; i < levelEnd; i++) {
+			const auto id = order[i];
+			newIndex[id] = static_cast<uint32_t>(i);
+			m_firstChild[i] = static_cast<uint32_t>(order.size());
+			m_childCount[i] = childOffsets[id + 1] - childOffsets[id];
+			for (auto c = childOffsets[id]; c < childOffsets[id + 1]; c++) {
+				m_parent[order.size()] = static_cast<uint32_t>(i);
+				order.push_back(children[c]);
+			}
+		}
+		levelBegin = levelEnd;
+		if (levelBegin < order.size()) { m_levelOffsets.push_back(static_cast<uint32_t>(levelBegin)); }
+	}
+	// Permutation des donnes locales vers le nouvel ordre
+	auto permute = [&](auto& values) {
+		auto sorted = values;
+		for (NodeId id = 0; id < count; id++) { sorted[newIndex[id]] = values[m_idToIndex[id]]; }
+		values.swap(sorted);
+	};
+	permute(m_translation);
+	permute(m_rotation);
+	permute(m_scale);
+	m_ids = order;
+	m_idToIndex = newIndex;
+	m_dirty.assign(count, 0);
+	m_dirtyByLevel.assign(m_levelOffsets.size(), {});
+	m_orderDirty = false;
+	// Recalcul complet : marquer les racines suffit, la propagation couvre le reste
+	const auto rootCount = m_levelOffsets.size() > 1 ? m_levelOffsets[1] : static_cast<uint32_t>(count);
+	for (uint32_t i = 0; i < rootCount; i++) { markDirty(i); }
+	m_orderGeneration = m_generation + 1;
+}
+
+size_t CTransformHierarchy::update(CJobSystem& jobSystem) {
+	if (m_orderDirty) { rebuildOrder(); }
+	// Rien de modifi : la gnration reste la mme, les copies synchronises n'ont rien  recopier
+	const auto anyDirty = std::any_of(m_dirtyByLevel.begin(), m_dirtyByLevel.end(),
+	                                  [](const std::vector<uint32_t>& level) { return !level.empty(); });
+	if (!anyDirty) { return 0; }
+	m_generation++;
+	auto& changed = m_changedHistory[m_generation % HISTORY_LENGTH];
+	changed.clear();
+	std::vector<uint32_t> worklist;
+	for (size_t level = 0; level < m_levelOffsets.size(); level++) {
+		// Noeuds propags depuis le niveau prcdent + noeuds marqus explicitement  ce niveau
+		worklist.insert(worklist.end(), m_dirtyByLevel[level].begin(), m_dirtyByLevel[level].end());
+		m_dirtyByLevel[level].clear();
+		if (worklist.empty()) { continue; }
+		// Les parents sont tous  jour : les noeuds d'un mme niveau sont indpendants
+		jobSystem.parallelFor(worklist.size(), 1024, [&](size_t begin, size_t end, size_t) {
+			for (auto w = begin; w < end; w++) {
+				const auto i = worklist[w];
+				const auto local = composeTransform(m_translation[i], m_rotation[i], m_scale[i]);
+				m_world[i] = m_parent[i] == INVALID_NODE ? local : m_world[m_parent[i]] * local;
+			}
+		});
+		changed.insert(changed.end(), worklist.begin(), worklist.end());
+		// Les enfants des noeuds recalculs doivent l'tre aussi
+		std::vector<uint32_t> next;
+		for (const auto i : worklist) {
+			m_dirty[i] = 0;
+			for (auto c = m_firstChild[i]; c < m_firstChild[i] + m_childCount[i]; c++) {
+				if (!m_dirty[c]) {
+					m_dirty[c] = 1;
+					next.push_back(c);
+				}
+			}
+		}
+		worklist.swap(next);
+	}
+	return changed.size();
+}
+
+size_t CTransformHierarchy::writeInstances(Mat4* mapped, uint64_t& syncedGeneration) const {
+	if (syncedGeneration == m_generation) { return 0; }
+	size_t written = 0;
+	if (!isHistoryAvailable(syncedGeneration)) {
+		std::memcpy(mapped, m_world.data(), m_world.size() * sizeof(Mat4));
+		written = m_world.size();
+	}
+	else {
+		for (auto generation = syncedGeneration + 1; generation <= m_generation; generation++) {
+			for (const auto i : m_changedHistory[generation % HISTORY_LENGTH]) { mapped[i] = m_world[i]; }
+			written += m_changedHistory[generation % HISTORY_LENGTH].size();
+		}
+	}
+	syncedGeneration = m_generation;
+	return written;
+}
+
+bool CTransformHierarchy::changedSince(uint64_t since, std::vector<uint32_t>& changed) const {
+	if (!isHistoryAvailable(since)) { return false; }
+	for (auto generation = since + 1; generation <= m_generation; generation++) {
+		const auto& history = m_changedHistory[generation % HISTORY_LENGTH];
+		changed.insert(changed.end(), history.begin(), history.end());
+	}
+	return true;
+}
@@ -1,5 +1,7 @@
 #include <VulkanApplication.h>
 #include <ShaderLoader.h>
+#include <VulkanUtils.h>
+#include <Logger.h>
 #include <stdexcept>
 #include <functional>
 #include <iostream>
@@ -7,46 +9,122 @@
 #include <map>
 #include <string>
 #include <set>
+#include <filesystem>
 #include <algorithm>
 
 #define std_err(str) (std::runtime_error(str))
-// Fonction permettant de crer un VkDebugUtilsMessengerEXT
-VkResult CreateDebugUtilsMessengerEXT(VkInstance instance,
-                                      const VkDebugUtilsMessengerCreateInfoEXT* pCreateInfo,
-                                      const VkAllocationCallbacks* pAllocator,
-                                      VkDebugUtilsMessengerEXT* pCallback) {
-	const auto fn = reinterpret_cast<PFN_vkCreateDebugUtilsMessengerEXT>(vkGetInstanceProcAddr(
-		instance, "vkCreateDebugUtilsMessengerEXT"));
-	if (fn != nullptr) { return fn(instance, pCreateInfo, pAllocator, pCallback); }
-	return VK_ERROR_EXTENSION_NOT_PRESENT;
-}
-
-// Fonction permettant de dtruire le messager.
-void DestroyDebugUtilsMessengerEXT(VkInstance instance,
-                                   const VkDebugUtilsMessengerEXT callback,
-                                   const VkAllocationCallbacks* pAllocator) {
-	const auto fn = reinterpret_cast<PFN_vkDestroyDebugUtilsMessengerEXT>(vkGetInstanceProcAddr(
-		instance, "vkDestroyDebugUtilsMessengerEXT"));
-	if (fn != nullptr) { fn(instance, callback, pAllocator); }
+
+namespace {
+	/*
+	 * Callbacks GLFW de la fentre principale (pointeur utilisateur : le CRedrawScheduler de l'application)
+	 */
+	void invalidateWindow(GLFWwindow* window, RedrawReason reason) {
+		static_cast<CRedrawScheduler*>(glfwGetWindowUserPointer(window))->invalidate(reason);
+	}
 }
 
 void CVulkanApplication::run() {
+	m_startTime = std::chrono::steady_clock::now();
+	m_frameTimes.clear();
+	if (m_settings.maxFrames > 0) { m_frameTimes.reserve(m_settings.maxFrames); }
+	m_allocator = m_settings.customHostAllocator ? m_hostAllocator.callbacks() : nullptr;
+	CLogger::setMinimumLevel(m_settings.logLevel);
+	for (const auto messageId : m_settings.mutedMessages) { CLogger::muteMessage(messageId); }
+	// Les shaders sont lus pendant la cration de la fentre et du device
+	m_assetStreamer.init(m_settings.streamerSettings);
+	CShaderLoader::preload(m_assetStreamer, shaderFiles());
 	initWindow();
 	initVulkan();
-	mainLoop();
+	if (!m_settings.replayTrace.empty()) { replayCommandTrace(); }
+	else { mainLoop(); }
 	cleanup();
 }
 
+FrameStatistics CVulkanApplication::statistics() const {
+	auto stats = FrameStatistics{};
+	stats.startupMs = m_startupMs;
+	stats.frameCount = m_frameTimes.size();
+	stats.gpuComputeMs = m_particles.averageUpdateMs();
+	stats.averageTriangles = m_lodRenderer.averageTriangles();
+	stats.gpuMultiviewMs = m_multiview.averageGpuMs();
+	stats.gpuPostProcessMs = m_postProcess.averageGpuMs();
+	stats.postProcessStages = m_postProcess.stageTimes();
+	stats.streamedBytes = m_streamingUploader.stats().bytesUploaded;
+	stats.streamingMs = m_streamingMs;
+	stats.gpuLightCullingMs = m_lighting.averageCullingMs();
+	stats.gpuLightShadingMs = m_lighting.averageShadingMs();
+	stats.averageLightsPerCluster = m_lighting.averageLightsPerCluster();
+	stats.maxLightsPerCluster = m_lighting.maxLightsPerCluster();
+	stats.fragmentInvocations = m_fragmentCounter.averageInvocations();
+	const auto pixels = static_cast<double>(m_swapChainExtent.width) * static_cast<double>(m_swapChainExtent.height);
+	if (pixels > 0.0) { stats.fragmentsPerPixel = stats.fragmentInvocations / pixels; }
+	if (m_settings.onDemand) { stats.redraw = m_redraw.stats(); }
+	if (m_frameTimes.empty()) { return stats; }
+	auto sorted = m_frameTimes;
+	std::sort(sorted.begin(), sorted.end());
+	double total = 0.0;
+	for (const auto time : sorted) { total += time; }
+	stats.averageFrameMs = total / static_cast<double>(sorted.size());
+	stats.medianFrameMs = sorted[sorted.size() / 2];
+	return stats;
+}
+
 void CVulkanApplication::initWindow() {
+	m_extraOutputs.resize(std::max(m_settings.outputCount, 1u) - 1);
+	// Pas de fentre (ni de GLFW) en mode headless
+	if (m_settings.headless) {
+		if (m_settings.onDemand) {
+			CLogger::log(LogLevel::Warning, "Redraw", "On-demand rendering needs a window: disabled in headless mode");
+			m_settings.onDemand = false;
+		}
+		return;
+	}
 	// Initialisation de GLFW sans crer un contexte OpenGL
 	glfwInit();
 	glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
 
-	// La fentre ne peut pas tre redimensionne
-	glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
+	// La fentre ne peut pas tre redimensionne, sauf en rendu  la demande (swapchain recre par le thread de rendu)
+	glfwWindowHint(GLFW_RESIZABLE, m_settings.onDemand ? GLFW_TRUE : GLFW_FALSE);
 
 	// Cration de la fentre
-	m_window = glfwCreateWindow(WINDOW_WIDTH, WINDOW_HEIGHT, "Vulkan", nullptr, nullptr);
+	m_window = glfwCreateWindow(static_cast<int>(m_settings.width), static_cast<int>(m_settings.height), "Vulkan",
+	                            nullptr, nullptr);
+	int width = 0, height = 0;
+	glfwGetFramebufferSize(m_window, &width, &height);
+	m_framebufferExtent = { static_cast<uint32_t>(width), static_cast<uint32_t>(height) };
+	if (m_settings.onDemand) { installWindowCallbacks(); }
+	// Les sorties supplmentaires gardent leur taille
+	glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
+	for (size_t i = 0; i < m_extraOutputs.size(); i++) {
+		const auto title = "Vulkan (" + std::to_string(i + 2) + ")";
+		m_extraOutputs[i].window = glfwCreateWindow(static_cast<int>(m_settings.width), static_cast<int>(m_settings.height),
+		                                            title.c_str(), nullptr, nullptr);
+		glfwGetFramebufferSize(m_extraOutputs[i].window, &width, &height);
+		m_extraOutputs[i].framebufferExtent = { static_cast<uint32_t>(width), static_cast<uint32_t>(height) };
+	}
+}
+
+void CVulkanApplication::installWindowCallbacks() {
+	glfwSetWindowUserPointer(m_window, &m_redraw);
+	glfwSetKeyCallback(m_window, [](GLFWwindow* window, int, int, int, int) { invalidateWindow(window, RedrawReason::Input); });
+	glfwSetCharCallback(m_window, [](GLFWwindow* window, unsigned int) { invalidateWindow(window, RedrawReason::Input); });
+	glfwSetMouseButtonCallback(m_window, [](GLFWwindow* window, int, int, int) { invalidateWindow(window, RedrawReason::Input); });
+	glfwSetCursorPosCallback(m_window, [](GLFWwindow* window, double, double) { invalidateWindow(window, RedrawReason::Input); });
+	glfwSetScrollCallback(m_window, [](GLFWwindow* window, double, double) { invalidateWindow(window, RedrawReason::Input); });
+	// Nouvelle taille, fentre restaure ou contenu  redessiner (fentre dcouverte...)
+	glfwSetFramebufferSizeCallback(m_window, [](GLFWwindow* window, int, int) { invalidateWindow(window, RedrawReason::Resize); });
+	glfwSetWindowIconifyCallback(m_window, [](GLFWwindow* window, int) { invalidateWindow(window, RedrawReason::Resize); });
+	glfwSetWindowRefreshCallback(m_window, [](GLFWwindow* window) { invalidateWindow(window, RedrawReason::Resize); });
+	// Avant la cration du device : les variantes de pipeline peuvent invalider la frame ds leur compilation
+	m_redraw.setWakeFunction([] { glfwPostEmptyEvent(); });
+	m_redraw.setRefreshInterval(m_settings.onDemandRefreshInterval);
+	m_redraw.setAnimating(m_settings.scene != SceneType::Triangle);
+}
+
+bool CVulkanApplication::windowMinimized() const {
+	int width = 0, height = 0;
+	glfwGetFramebufferSize(m_window, &width, &height);
+	return width == 0 || height == 0 || glfwGetWindowAttrib(m_window, GLFW_ICONIFIED) == GLFW_TRUE;
 }
 
 void CVulkanApplication::initVulkan() {
@@ -56,79 +134,444 @@ void CVulkanApplication::initVulkan() {
 	pickPhysicalDevice();
 	createLogicalDevice();
 	createSwapChain();
+	createCommandTrace();
+	createFrameCapture();
 	createImageViews();
 	createRenderPass();
 	createGraphicsPipeline();
+	createParticleSystem();
+	createLodScene();
+	createDepthBuffer();
 	createFramebuffers();
 	createCommandPool();
+	// Avant les command buffers, qui peuvent rfrencer les buffers d'instances
+	createInstanceBuffers(std::max(INITIAL_INSTANCE_CAPACITY, m_scene.size()));
+	createStreaming();
+	createFragmentCounter();
 	createCommandBuffers();
+	createOutputSwapChains();
+	createMultiview();
+	createDynamicResolution();
+	createPostProcess();
 	createSyncObjects();
 }
 
 void CVulkanApplication::mainLoop() {
-	// Tant que l'vnement "fermer la fentre" n'est pas appel, couter les vnements
-	while (!glfwWindowShouldClose(m_window)) {
-		glfwPollEvents();
-		drawFrame();
+	m_stopRendering = false;
+	m_renderingDone = false;
+	m_acquiredSnapshots = 0;
+	m_publishedSnapshots = 0;
+	m_renderError = nullptr;
+	// Mesures du rendu  la demande sans le dmarrage,  la frquence de l'cran principal
+	if (m_settings.onDemand) {
+		const auto* monitor = glfwGetPrimaryMonitor();
+		const auto* mode = monitor != nullptr ? glfwGetVideoMode(monitor) : nullptr;
+		m_redraw.start(mode != nullptr ? static_cast<double>(mode->refreshRate) : 60.0);
 	}
-	vkDeviceWaitIdle(m_device);
+	m_renderThread = std::thread{[this] { renderLoop(); }};
+	// Sous le verrou : le thread de rendu peut attendre une publication
+	const auto stopRendering = [this] {
+		{
+			std::lock_guard<std::mutex> lock{m_snapshotMutex};
+			m_stopRendering = true;
+		}
+		m_snapshotPublished.notify_one();
+	};
+	try {
+		simulationLoop();
+	}
+	catch (...) {
+		stopRendering();
+		m_renderThread.join();
+		throw;
+	}
+	if (m_settings.onDemand) { m_redraw.stop(); }
+	stopRendering();
+	m_renderThread.join();
+	m_dispatch.DeviceWaitIdle(m_device);
+	if (m_renderError) { std::rethrow_exception(m_renderError); }
+}
+
+void CVulkanApplication::replayCommandTrace() {
+	const auto indices = findQueueFamilies(m_physicalDevice);
+	m_traceReplayer.init(deviceContext(), indices.graphicsFamily.value(), m_graphicsQueue, m_settings.replayTrace);
+	auto replaySettings = TraceReplaySettings{};
+	replaySettings.paced = m_settings.replayPaced;
+	m_frameTimes.clear();
+	m_traceReplayStats = m_traceReplayer.replay(replaySettings, m_frameTimes);
+	m_traceReplayer.cleanup();
+}
+
+void CVulkanApplication::simulationLoop() {
+	// Tant que l'vnement "fermer la fentre" n'est pas appel, couter les vnements et simuler
+	uint64_t published = 0;
+	while (!m_renderingDone.load(std::memory_order_acquire)) {
+		if (m_settings.onDemand) {
+			// Attente bloquante jusqu' ce que l'image change
+			if (!waitForRedraw()) { break; }
+		}
+		else if (!m_settings.headless) {
+			glfwPollEvents();
+			if (glfwWindowShouldClose(m_window)) { break; }
+			// Fentre rduite : aucune frame jusqu' sa restauration
+			if (windowMinimized()) {
+				glfwWaitEvents();
+				continue;
+			}
+		}
+		simulate(m_snapshots.writeBuffer(), published);
+		m_snapshots.publish();
+		published++;
+		{
+			std::lock_guard<std::mutex> lock{m_snapshotMutex};
+			m_publishedSnapshots.store(published, std::memory_order_release);
+		}
+		m_snapshotPublished.notify_one();
+		// Une seule frame d'avance : la simulation de la frame suivante chevauche le rendu de celle-ci.
+		// Les vnements continuent d'tre traits pendant l'attente (rveil par glfwPostEmptyEvent).
+		const auto acquired = [this, published] {
+			return m_acquiredSnapshots.load(std::memory_order_acquire) >= published || m_renderingDone.load(std::memory_order_acquire);
+		};
+		if (m_settings.headless) {
+			std::unique_lock<std::mutex> lock{m_snapshotMutex};
+			m_snapshotAcquired.wait(lock, acquired);
+		}
+		else {
+			while (!acquired()) {
+				glfwWaitEvents();
+				if (glfwWindowShouldClose(m_window)) { break; }
+			}
+		}
+		if (!m_settings.headless && glfwWindowShouldClose(m_window)) { break; }
+	}
+}
+
+void CVulkanApplication::renderLoop() {
+	try {
+		uint64_t frame = 0;
+		while (!m_stopRendering.load(std::memory_order_acquire)
+			&& (m_settings.maxFrames == 0 || frame < m_settings.maxFrames)) {
+			if (!m_snapshots.acquire()) {
+				// Attente sans scruter de la prochaine publication (qui peut se faire attendre : rendu  la demande,
+				// fentre rduite)
+				std::unique_lock<std::mutex> lock{m_snapshotMutex};
+				m_snapshotPublished.wait(lock, [this] {
+					return m_stopRendering.load(std::memory_order_acquire)
+						|| m_publishedSnapshots.load(std::memory_order_acquire) > m_acquiredSnapshots.load(std::memory_order_acquire);
+				});
+				continue;
+			}
+			{
+				std::lock_guard<std::mutex> lock{m_snapshotMutex};
+				m_acquiredSnapshots.fetch_add(1, std::memory_order_release);
+			}
+			if (m_settings.headless) { m_snapshotAcquired.notify_one(); }
+			else { glfwPostEmptyEvent(); }
+			const auto frameStart = std::chrono::steady_clock::now();
+			drawFrame(m_snapshots.readBuffer());
+			const auto frameEnd = std::chrono::steady_clock::now();
+			// Les copies du streaming n'avancent qu'avec les frames : une autre est demande tant qu'il en reste
+			if (m_settings.onDemand && m_pendingStreams > 0) { m_redraw.invalidate(RedrawReason::DataUpdate); }
+			if (frame == 0) { m_startupMs = std::chrono::duration<double, std::milli>(frameEnd - m_startTime).count(); }
+			// Dures conserves uniquement pour les excutions bornes (benchmarks, rgression)
+			if (m_settings.maxFrames > 0) {
+				m_frameTimes.push_back(std::chrono::duration<float, std::milli>(frameEnd - frameStart).count());
+			}
+			frame++;
+		}
+	}
+	catch (...) {
+		m_renderError = std::current_exception();
+	}
+	{
+		std::lock_guard<std::mutex> lock{m_snapshotMutex};
+		m_renderingDone.store(true, std::memory_order_release);
+	}
+	if (m_settings.headless) { m_snapshotAcquired.notify_one(); }
+	else { glfwPostEmptyEvent(); }
+}
+
+bool CVulkanApplication::waitForRedraw() {
+	while (!glfwWindowShouldClose(m_window) && !m_renderingDone.load(std::memory_order_acquire)) {
+		// Fentre rduite : les invalidations restent en attente, ni frame ni rafrachissement jusqu' sa restauration
+		const auto minimized = windowMinimized();
+		if (!minimized && m_redraw.consume() != RedrawReason::None) { return true; }
+		const auto timeout = minimized ? -1.0 : m_redraw.timeout();
+		const auto waitStart = std::chrono::steady_clock::now();
+		if (timeout < 0.0) { glfwWaitEvents(); }
+		else { glfwWaitEventsTimeout(timeout); }
+		m_redraw.addWaitTime(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - waitStart).count());
+	}
+	return false;
 }
 
 void CVulkanApplication::cleanup() {
+	if (m_commandTrace.isActive()) {
+		CLogger::log(LogLevel::Info, "Trace", "Command trace written: " + std::to_string(m_commandTrace.bytesWritten()) + " bytes");
+		m_commandTrace.close();
+	}
+	// Rendu  la demande : part des rafrachissements de l'cran ayant reu une frame, raisons des frames
+	if (m_settings.onDemand) {
+		const auto redraw = m_redraw.stats();
+		auto reasons = std::string{};
+		for (uint32_t i = 0; i < REDRAW_REASON_COUNT; i++) {
+			reasons += std::string{i > 0 ? ", " : ""} + redrawReasonName(i) + " " + std::to_string(redraw.framesByReason[i]);
+		}
+		const auto waiting = redraw.elapsedMs > 0.0 ? redraw.waitingMs / redraw.elapsedMs : 0.0;
+		CLogger::log(LogLevel::Info, "Redraw", std::to_string(redraw.renderedFrames) + " frames in "
+		             + std::to_string(redraw.elapsedMs / 1000.0) + " s: " + std::to_string(redraw.activeFrameRatio() * 100.0)
+		             + "% active / " + std::to_string(redraw.idleFrameRatio() * 100.0) + "% idle display refreshes, "
+		             + std::to_string(redraw.idleWakeups) + " idle wakeups, " + std::to_string(waiting * 100.0)
+		             + "% of the time waiting (" + reasons + ")");
+	}
+	// Cot GPU moyen de chaque tape du post-traitement
+	for (const auto& stage : m_postProcess.stageTimes()) {
+		CLogger::log(LogLevel::Info, "PostProcess", stage.name + ": " + std::to_string(stage.averageMs) + " ms");
+	}
+	// Surcot d'ombrage : invocations du fragment shader par pixel de la fentre principale
+	if (m_fragmentCounter.isActive()) {
+		const auto stats = statistics();
+		CLogger::log(LogLevel::Info, "Depth", std::to_string(stats.fragmentInvocations) + " fragment invocations per frame, "
+		             + std::to_string(stats.fragmentsPerPixel) + " per pixel");
+	}
+	m_fragmentCounter.cleanup();
 	cleanupSwapChain();
+	destroyRenderPass();
+	m_particles.cleanup();
+	m_lodRenderer.cleanup();
+	m_lighting.cleanup();
+	destroyInstanceBuffers();
+	// Les lectures encore en cours sont annules avant la libration du staging
+	m_streamingUploader.cleanup();
+	for (size_t i = 0; i < m_streamedBuffers.size(); i++) {
+		destroyBuffer(deviceContext(), m_streamedBuffers[i], m_streamedBuffersMemory[i]);
+	}
+	m_streamedBuffers.clear();
+	m_streamedBuffersMemory.clear();
+	const auto streamerStats = m_assetStreamer.stats();
+	CLogger::log(LogLevel::Info, "Streamer", std::string{streamBackendName(m_assetStreamer.backend())} + ": "
+	             + std::to_string(streamerStats.bytesRead) + " bytes in " + std::to_string(streamerStats.readsIssued)
+	             + " reads, " + std::to_string(streamerStats.peakReadsInFlight) + " in flight at most");
+	m_assetStreamer.shutdown();
+	CShaderLoader::clearCache();
 	// Destruction des sync objects
 	for(size_t i = 0; i < MAX_FRAMES_IN_FLIGHTS; i++) {
-		vkDestroySemaphore(m_device, m_imageAvailableSemaphores[i], nullptr);
-		vkDestroySemaphore(m_device, m_renderFinishedSemaphores[i], nullptr);
-		vkDestroyFence(m_device, m_inFlightFences[i], nullptr);
+		vkDestroySemaphore(m_device, m_imageAvailableSemaphores[i], m_allocator);
+		vkDestroySemaphore(m_device, m_renderFinishedSemaphores[i], m_allocator);
+		vkDestroyFence(m_device, m_inFlightFences[i], m_allocator);
 	}
 	// Destruction de la commandpool
-	vkDestroyCommandPool(m_device, m_commandPool, nullptr);
+	vkDestroyCommandPool(m_device, m_commandPool, m_allocator);
+	// Rapport mmoire tant que le device existe encore
+	if (m_settings.memoryReport) { m_memoryTelemetry.printReport(); }
 	// Destruction du logical device
-	vkDestroyDevice(m_device, nullptr);
+	vkDestroyDevice(m_device, m_allocator);
 	// Destruction du messenger si l'extension est prsente
-	if (enableValidationLayers) { DestroyDebugUtilsMessengerEXT(m_instance, m_debugMessenger, nullptr); }
-	// Destruction de la surface KHR
-	vkDestroySurfaceKHR(m_instance, m_surface, nullptr);
+	if (enableValidationLayers && m_instanceDispatch.DestroyDebugUtilsMessengerEXT != nullptr) {
+		m_instanceDispatch.DestroyDebugUtilsMessengerEXT(m_instance, m_debugMessenger, m_allocator);
+	}
+	// Destruction des surfaces KHR
+	for (auto& output : m_extraOutputs) { vkDestroySurfaceKHR(m_instance, output.surface, m_allocator); }
+	vkDestroySurfaceKHR(m_instance, m_surface, m_allocator);
 	// Destruction de l'instance Vulkan
-	vkDestroyInstance(m_instance, nullptr);
+	vkDestroyInstance(m_instance, m_allocator);
+	if (m_settings.hostAllocatorReport && m_allocator != nullptr) { m_hostAllocator.printReport(); }
 	// Destruction la fentre quand l'vnement "fermer" a t appel.
-	glfwDestroyWindow(m_window);
-	glfwTerminate();
+	if (!m_settings.headless) {
+		for (auto& output : m_extraOutputs) { glfwDestroyWindow(output.window); }
+		glfwDestroyWindow(m_window);
+		glfwTerminate();
+	}
 }
 
-void CVulkanApplication::drawFrame() {
-	vkWaitForFences(m_device, 1, &m_inFlightFences[m_currentFrame], VK_TRUE, std::numeric_limits<uint64_t>::max());
-	vkResetFences(m_device, 1, &m_inFlightFences[m_currentFrame]);
+void CVulkanApplication::drawFrame(const FrameSnapshot& snapshot) {
+	// Fentre redimensionne (rendu  la demande) ou swapchain refuse : recre avant la frame
+	const auto& extent = snapshot.framebufferExtent;
+	const auto resized = extent.width > 0 && extent.height > 0
+		&& (extent.width != m_framebufferExtent.width || extent.height != m_framebufferExtent.height);
+	if (resized || m_swapChainOutdated) {
+		if (resized) { m_framebufferExtent = extent; }
+		m_swapChainOutdated = false;
+		recreateSwapChain();
+	}
+	// Sorties supplmentaires redimensionnes ou refuses  la frame prcdente : seule leur swapchain est recre
+	for (size_t i = 0; i < snapshot.outputExtents.size() && i < m_extraOutputs.size(); i++) {
+		auto& output = m_extraOutputs[i];
+		const auto& outputExtent = snapshot.outputExtents[i];
+		if (outputExtent.width > 0 && outputExtent.height > 0
+			&& (outputExtent.width != output.framebufferExtent.width || outputExtent.height != output.framebufferExtent.height)) {
+			output.framebufferExtent = outputExtent;
+			output.outdated = true;
+		}
+	}
+	for (auto& output : m_extraOutputs) {
+		if (output.outdated) { recreateOutputSwapChain(output); }
+	}
+	m_dispatch.WaitForFences(m_device, 1, &m_inFlightFences[m_currentFrame], VK_TRUE, std::numeric_limits<uint64_t>::max());
+	// Acquisition avant les traitements de la frame termine : une frame abandonne ne les excute pas deux fois
 	uint32_t imageIndex;
-	vkAcquireNextImageKHR(m_device, m_swapchain, std::numeric_limits<uint64_t>::max(), m_imageAvailableSemaphores[m_currentFrame], VK_NULL_HANDLE, &imageIndex);
-	auto submitInfo = VkSubmitInfo{};
-	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-	VkSemaphore waitSemaphores[] = { m_imageAvailableSemaphores[m_currentFrame] };
-	VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-	submitInfo.waitSemaphoreCount = 1;
-	submitInfo.pWaitSemaphores = waitSemaphores;
-	submitInfo.pWaitDstStageMask = waitStages;
-	submitInfo.commandBufferCount = 1;
-	submitInfo.pCommandBuffers = &m_commandBuffers[imageIndex];
-	VkSemaphore signalSemaphores[] = { m_renderFinishedSemaphores[m_currentFrame] };
-	submitInfo.signalSemaphoreCount = 1;
-	submitInfo.pSignalSemaphores = signalSemaphores;
-	if(vkQueueSubmit(m_graphicsQueue, 1, &submitInfo, m_inFlightFences[m_currentFrame]) != VK_SUCCESS) {
+	const auto acquireResult = m_dispatch.AcquireNextImageKHR(m_device, m_swapchain, std::numeric_limits<uint64_t>::max(),
+	                                                          m_imageAvailableSemaphores[m_currentFrame], VK_NULL_HANDLE, &imageIndex);
+	if (acquireResult == VK_ERROR_OUT_OF_DATE_KHR) {
+		// Swapchain plus adapte  la fentre : frame abandonne (fence non rinitialise), puis redemande
+		m_swapChainOutdated = true;
+		if (m_settings.onDemand) { m_redraw.invalidate(RedrawReason::Resize); }
+		return;
+	}
+	if (acquireResult != VK_SUCCESS && acquireResult != VK_SUBOPTIMAL_KHR) {
+		throw std_err("Failed to acquire the swapchain image");
+	}
+	// Les copies de capture soumises avec cette fence sont termines : criture en arrire-plan
+	if (m_frameCapture.isActive()) { m_frameCapture.onFrameCompleted(static_cast<uint32_t>(m_currentFrame)); }
+	// Timestamps de cette frame disponibles : ajustement de l'chelle de rendu
+	if (m_dynamicResolution.isActive()) { m_dynamicResolution.onFrameCompleted(static_cast<uint32_t>(m_currentFrame)); }
+	if (m_multiview.isActive()) { m_multiview.onFrameCompleted(static_cast<uint32_t>(m_currentFrame)); }
+	if (m_postProcess.isActive()) { m_postProcess.onFrameCompleted(static_cast<uint32_t>(m_currentFrame)); }
+	// Copies du streaming termines : zones du staging libres, nouvelles lectures lances
+	if (m_streamingUploader.isActive()) { m_streamingUploader.onFrameCompleted(static_cast<uint32_t>(m_currentFrame)); }
+	if (m_particles.isActive() && m_particleTimerSlots[m_currentFrame] != UINT32_MAX) {
+		m_particles.onUpdateCompleted(m_particleTimerSlots[m_currentFrame]);
+	}
+	if (m_lighting.isActive()) { m_lighting.onFrameCompleted(static_cast<uint32_t>(m_currentFrame)); }
+	if (m_fragmentCounter.isActive()) { m_fragmentCounter.onFrameCompleted(static_cast<uint32_t>(m_currentFrame)); }
+	// Le GPU n'utilise plus les ressources de cette frame : mise  jour des instances
+	uploadInstances(snapshot);
+	// Niveaux de dtail choisis  partir des mmes matrices, crits dans les commandes indirectes de la frame
+	if (m_lodRenderer.isActive()) {
+		const auto view = LodView::forExtent(m_swapChainExtent, m_depth.reverseZ);
+		m_lodRenderer.select(static_cast<uint32_t>(m_currentFrame), snapshot.instances, view, &m_frustumCuller);
+		// Lumires animes au mme instant que la scne, rparties pour la camra du dessin
+		if (m_lighting.isActive()) {
+			m_lighting.update(static_cast<uint32_t>(m_currentFrame), snapshot.time, view.view, view.projection, view.eye);
+		}
+	}
+	m_memoryTelemetry.update();
+	// La fence n'est rinitialise qu'une fois la soumission certaine
+	m_dispatch.ResetFences(m_device, 1, &m_inFlightFences[m_currentFrame]);
+	// Toutes les sorties de la frame : un lot de soumission chacune, une seule soumission et une seule prsentation
+	auto& batch = m_presentBatch;
+	batch.clear();
+	batch.addOutput(m_imageAvailableSemaphores[m_currentFrame], m_renderFinishedSemaphores[m_currentFrame], m_swapchain, imageIndex);
+	const auto commandBufferIndex = static_cast<uint32_t>(imageIndex * MAX_FRAMES_IN_FLIGHTS + m_currentFrame);
+	// Nouvelles variantes de pipeline prtes : le command buffer de ce couple (image, frame) est inactif
+	// depuis l'attente de la fence, il peut tre renregistr
+	const auto rerecorded = m_dynamicResolution.isActive() || m_postProcess.isActive();
+	if (!rerecorded && m_commandBufferGenerations[commandBufferIndex] != m_pipelineVariants.generation()) {
+		recordCommandBuffer(commandBufferIndex);
+	}
+	auto sceneCommandBuffer = m_commandBuffers[commandBufferIndex];
+	// Mesure des particules : command buffer pr-enregistr utilis (sans rsolution dynamique)
+	if (m_particles.isActive()) { m_particleTimerSlots[m_currentFrame] = commandBufferIndex; }
+	// Rsolution dynamique ( l'chelle courante) ou post-traitement : command buffer renregistr  chaque frame
+	if (rerecorded) {
+		auto recordPrePass = CDynamicResolution::RecordFunction{};
+		if (m_particles.isActive()) {
+			const auto slot = static_cast<uint32_t>(m_currentFrame);
+			m_particleTimerSlots[m_currentFrame] = slot;
+			recordPrePass = [this, slot](VkCommandBuffer commandBuffer) { m_particles.recordUpdate(commandBuffer, slot); };
+		}
+		else if (m_lighting.isActive()) {
+			recordPrePass = [this](VkCommandBuffer commandBuffer) {
+				m_lighting.recordCulling(commandBuffer, static_cast<uint32_t>(m_currentFrame));
+			};
+		}
+		const auto recordFrameScene = [this](VkCommandBuffer commandBuffer) {
+			recordScene(commandBuffer, static_cast<uint32_t>(m_currentFrame));
+			if (m_lighting.isActive()) { m_lighting.recordShadingEnd(commandBuffer, static_cast<uint32_t>(m_currentFrame)); }
+		};
+		if (m_dynamicResolution.isActive()) {
+			sceneCommandBuffer = m_dynamicResolution.record(static_cast<uint32_t>(m_currentFrame), m_swapChainImages[imageIndex],
+			                                                recordFrameScene, recordPrePass);
+		}
+		else {
+			sceneCommandBuffer = m_postProcess.record(static_cast<uint32_t>(m_currentFrame), imageIndex, recordFrameScene,
+			                                          recordPrePass);
+		}
+	}
+	// Multi-vues : les vues rendues hors cran sont copies en mosaque dans l'image de la swapchain
+	if (m_multiview.isActive()) {
+		sceneCommandBuffer = m_multiview.record(static_cast<uint32_t>(m_currentFrame), m_swapChainImages[imageIndex]);
+	}
+	// Copies des fichiers lus depuis la frame prcdente, avant les dessins qui peuvent les utiliser
+	if (m_streamingUploader.isActive()) {
+		const auto uploadCommandBuffer = m_streamingUploader.record(static_cast<uint32_t>(m_currentFrame));
+		if (uploadCommandBuffer != VK_NULL_HANDLE) { batch.commandBuffers.push_back(uploadCommandBuffer); }
+	}
+	batch.commandBuffers.push_back(sceneCommandBuffer);
+	// Le command buffer de capture (absent si la frame est abandonne) est excut aprs le rendu dans le mme lot
+	if (m_frameCapture.isActive()) {
+		const auto captureCommandBuffer = m_frameCapture.recordCapture(m_swapChainImages[imageIndex], static_cast<uint32_t>(m_currentFrame));
+		if (captureCommandBuffer != VK_NULL_HANDLE) { batch.commandBuffers.push_back(captureCommandBuffer); }
+	}
+	for (auto& output : m_extraOutputs) {
+		// Acquisition sans attente : une sortie sans image disponible saute la frame au lieu de retarder les autres
+		uint32_t outputImage;
+		const auto result = m_dispatch.AcquireNextImageKHR(m_device, output.swapchain, 0, output.imageAvailableSemaphores[m_currentFrame],
+		                                                   VK_NULL_HANDLE, &outputImage);
+		if (result == VK_ERROR_OUT_OF_DATE_KHR) { output.outdated = true; }
+		if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) { continue; }
+		const auto outputIndex = outputImage * MAX_FRAMES_IN_FLIGHTS + m_currentFrame;
+		if (output.commandBufferGenerations[outputIndex] != m_pipelineVariants.generation()) {
+			recordOutputCommandBuffer(output, outputIndex);
+		}
+		batch.addOutput(output.imageAvailableSemaphores[m_currentFrame], output.renderFinishedSemaphores[m_currentFrame],
+		                output.swapchain, outputImage, &output);
+		batch.commandBuffers.push_back(output.commandBuffers[outputIndex]);
+	}
+	// Un lot par sortie : chacune n'attend que sa propre image. L'ordre de soumission garantit que la simulation
+	// des particules (lot de la fentre principale) prcde les dessins des autres sorties.
+	static const VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	const auto outputCount = batch.swapchains.size();
+	batch.submits.resize(outputCount);
+	for (size_t i = 0; i < outputCount; i++) {
+		const auto first = batch.firstCommandBuffers[i];
+		const auto last = i + 1 < outputCount ? batch.firstCommandBuffers[i + 1] : batch.commandBuffers.size();
+		auto& submitInfo = batch.submits[i];
+		submitInfo = VkSubmitInfo{};
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.waitSemaphoreCount = 1;
+		submitInfo.pWaitSemaphores = &batch.waitSemaphores[i];
+		submitInfo.pWaitDstStageMask = &waitStage;
+		submitInfo.commandBufferCount = static_cast<uint32_t>(last - first);
+		submitInfo.pCommandBuffers = batch.commandBuffers.data() + first;
+		submitInfo.signalSemaphoreCount = 1;
+		submitInfo.pSignalSemaphores = &batch.signalSemaphores[i];
+	}
+	if(m_dispatch.QueueSubmit(m_graphicsQueue, static_cast<uint32_t>(outputCount), batch.submits.data(), m_inFlightFences[m_currentFrame]) != VK_SUCCESS) {
 		throw std_err("Failed to send a command buffer");
 	}
+	m_commandTrace.submit(batch.submits.data(), static_cast<uint32_t>(outputCount));
 	auto presentInfo = VkPresentInfoKHR{};
 	presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
 	// Signal que la prsentation peut se drouler
-	presentInfo.waitSemaphoreCount = 1;
-	presentInfo.pWaitSemaphores = signalSemaphores;
-	// Swap chain qui prsentera les images
-	VkSwapchainKHR swapChains[] = { m_swapchain };
-	presentInfo.swapchainCount = 1;
-	presentInfo.pSwapchains = swapChains;
-	presentInfo.pImageIndices = &imageIndex;
-	//presentInfo.pResults = nullptr;
-	vkQueuePresentKHR(m_presentQueue, &presentInfo);
+	presentInfo.waitSemaphoreCount = static_cast<uint32_t>(outputCount);
+	presentInfo.pWaitSemaphores = batch.signalSemaphores.data();
+	// Swap chains qui prsenteront les images
+	presentInfo.swapchainCount = static_cast<uint32_t>(outputCount);
+	presentInfo.pSwapchains = batch.swapchains.data();
+	presentInfo.pImageIndices = batch.imageIndices.data();
+	// Rsultat par swapchain : l'chec d'une sortie n'empche pas la prsentation des autres
+	batch.results.resize(outputCount);
+	presentInfo.pResults = batch.results.data();
+	m_dispatch.QueuePresentKHR(m_presentQueue, &presentInfo);
+	m_commandTrace.present();
+	// Fentre principale : mme traitement qu' l'acquisition, la swapchain est recre avant la frame suivante
+	if (batch.results[0] == VK_ERROR_OUT_OF_DATE_KHR || batch.results[0] == VK_SUBOPTIMAL_KHR) {
+		m_swapChainOutdated = true;
+		if (m_settings.onDemand) { m_redraw.invalidate(RedrawReason::Resize); }
+	}
+	else if (batch.results[0] != VK_SUCCESS) {
+		throw std_err("Failed to present the swapchain image");
+	}
+	for (size_t i = 1; i < outputCount; i++) {
+		if (batch.results[i] == VK_ERROR_OUT_OF_DATE_KHR || batch.results[i] == VK_SUBOPTIMAL_KHR) {
+			batch.outputs[i]->outdated = true;
+		}
+		else if (batch.results[i] != VK_SUCCESS) {
+			CLogger::log(LogLevel::Warning, "Present", "Failed to present an extra output (VkResult "
+			             + std::to_string(static_cast<int>(batch.results[i])) + ")");
+		}
+	}
 	m_currentFrame = (m_currentFrame + 1) % MAX_FRAMES_IN_FLIGHTS;
 }
 
@@ -143,7 +586,16 @@ void CVulkanApplication::createInstance() {
 	appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
 	appInfo.pEngineName = "No Engine";
 	appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-	appInfo.apiVersion = VK_API_VERSION_1_0;
+	// Vulkan 1.1 si le loader le permet (rduction par sous-groupes du post-traitement), sinon 1.0
+	m_apiVersion = VK_API_VERSION_1_0;
+	const auto enumerateInstanceVersion = reinterpret_cast<PFN_vkEnumerateInstanceVersion>(
+			vkGetInstanceProcAddr(nullptr, "vkEnumerateInstanceVersion"));
+	uint32_t loaderVersion = VK_API_VERSION_1_0;
+	if (m_settings.postProcess && enumerateInstanceVersion != nullptr
+		&& enumerateInstanceVersion(&loaderVersion) == VK_SUCCESS && loaderVersion >= VK_API_VERSION_1_1) {
+		m_apiVersion = VK_API_VERSION_1_1;
+	}
+	appInfo.apiVersion = m_apiVersion;
 	/*
 	* Structure permettant d'informer le drivers des extensions que l'app va utiliser
 	* ainsi que des validation layers de manire globale.
@@ -151,8 +603,9 @@ void CVulkanApplication::createInstance() {
 	auto createInfo = VkInstanceCreateInfo{};
 	createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
 	createInfo.pApplicationInfo = &appInfo;
-	// Rcupration des extensions
+	// Rcupration des extensions (+ celles permettant d'interroger le budget mmoire)
 	auto extensions = getRequiredExtensions();
+	for (const auto* extension : CMemoryTelemetry::optionalInstanceExtensions()) { extensions.push_back(extension); }
 	createInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
 	createInfo.ppEnabledExtensionNames = extensions.data();
 	// Validation layers
@@ -168,22 +621,41 @@ void CVulkanApplication::createInstance() {
 		createInfo.pNext = nullptr;
 	}
 	// Cration de l'instance
-	if (vkCreateInstance(&createInfo, nullptr, &m_instance)) {
+	if (vkCreateInstance(&createInfo, m_allocator, &m_instance)) {
 		throw std::runtime_error("Failed to create VkInstance!");
 	}
+	m_instanceDispatch.load(m_instance);
 }
 
 void CVulkanApplication::createSurface() {
-	if (glfwCreateWindowSurface(m_instance, m_window, nullptr, &m_surface) != VK_SUCCESS) {
+	m_surface = createOutputSurface(m_window);
+	for (auto& output : m_extraOutputs) { output.surface = createOutputSurface(output.window); }
+}
+
+VkSurfaceKHR CVulkanApplication::createOutputSurface(GLFWwindow* window) {
+	auto surface = VkSurfaceKHR{VK_NULL_HANDLE};
+	if (m_settings.headless) {
+		// Surface sans fentre : les images de la swapchain sont "prsentes" sans affichage
+		const auto fn = reinterpret_cast<PFN_vkCreateHeadlessSurfaceEXT>(vkGetInstanceProcAddr(
+			m_instance, "vkCreateHeadlessSurfaceEXT"));
+		auto createInfo = VkHeadlessSurfaceCreateInfoEXT{};
+		createInfo.sType = VK_STRUCTURE_TYPE_HEADLESS_SURFACE_CREATE_INFO_EXT;
+		if (fn == nullptr || fn(m_instance, &createInfo, m_allocator, &surface) != VK_SUCCESS) {
+			throw std::runtime_error("Failed to create headless surface");
+		}
+		return surface;
+	}
+	if (glfwCreateWindowSurface(m_instance, window, m_allocator, &surface) != VK_SUCCESS) {
 		throw std::runtime_error("Failed to create window surface");
 	}
+	return surface;
 }
 
 void CVulkanApplication::createSwapChain() {
 	const SwapChainSupportDetails swapChainSupport = querySwapChainSupport(m_physicalDevice);
 	const auto surfaceFormat = chooseSwapSurfaceFormat(swapChainSupport.formats);
 	const auto presentMode = chooseSwapPresentMode(swapChainSupport.presentModes);
-	const auto extent = chooseSwapExtent(swapChainSupport.capabilities);
+	const auto extent = chooseSwapExtent(swapChainSupport.capabilities, m_framebufferExtent);
 	uint32_t imageCount = swapChainSupport.capabilities.minImageCount + 1;
 	if (swapChainSupport.capabilities.maxImageCount > 0 && imageCount > swapChainSupport.capabilities.maxImageCount) {
 		imageCount = swapChainSupport.capabilities.maxImageCount;
@@ -199,6 +671,36 @@ void CVulkanApplication::createSwapChain() {
 	createInfo.imageArrayLayers = 1;
 	// Spcifie le type d'opration appliqu sur les images ici le rendu est directement sur les images alors on prend color attachment
 	createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+	// La capture copie les images vers des buffers : elles doivent pouvoir tre source d'un transfert
+	if (m_settings.captureFrames) {
+		if (!(swapChainSupport.capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_SRC_BIT)) {
+			throw std::runtime_error("Frame capture requires TRANSFER_SRC swapchain images");
+		}
+		createInfo.imageUsage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+	}
+	// La rsolution dynamique remplit les images par un blit
+	if (m_settings.dynamicResolution
+		&& (swapChainSupport.capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_DST_BIT)) {
+		createInfo.imageUsage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+	}
+	// Le post-traitement y crit directement si le format le permet, sinon y copie son rsultat
+	if (m_settings.postProcess) {
+		if ((swapChainSupport.capabilities.supportedUsageFlags & VK_IMAGE_USAGE_STORAGE_BIT)
+			&& CPostProcess::canWriteDirectly(m_physicalDevice, surfaceFormat.format)) {
+			createInfo.imageUsage |= VK_IMAGE_USAGE_STORAGE_BIT;
+		}
+		else if (swapChainSupport.capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_DST_BIT) {
+			createInfo.imageUsage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+		}
+	}
+	// Le rendu multi-vues y copie ses vues
+	if (m_settings.multiview) {
+		if (!(swapChainSupport.capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_DST_BIT)) {
+			throw std::runtime_error("Multiview rendering requires TRANSFER_DST swapchain images");
+		}
+		createInfo.imageUsage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+	}
+	m_swapChainUsage = createInfo.imageUsage;
 	auto indices = findQueueFamilies(m_physicalDevice);
 	uint32_t queueFamilyIndices[] = {
 		indices.graphicsFamily.value(),
@@ -227,7 +729,7 @@ void CVulkanApplication::createSwapChain() {
 	createInfo.clipped = VK_TRUE;
 	// la swapchain peut devenir invalide aprs certains events (window resize etc.) et doit tre recre pour le moment pas besoin d'handle cela.
 	createInfo.oldSwapchain = nullptr;
-	if (vkCreateSwapchainKHR(m_device, &createInfo, nullptr, &m_swapchain) != VK_SUCCESS) {
+	if (vkCreateSwapchainKHR(m_device, &createInfo, m_allocator, &m_swapchain) != VK_SUCCESS) {
 		throw std::runtime_error("Failed to create swapchain");
 	}
 	vkGetSwapchainImagesKHR(m_device, m_swapchain, &imageCount, nullptr);
@@ -236,6 +738,9 @@ void CVulkanApplication::createSwapChain() {
 
 	m_swapChainImageFormat = surfaceFormat.format;
 	m_swapChainExtent = extent;
+	// Mmoire alloue par le driver : estimation  4 octets par pixel
+	m_memoryTelemetry.setExternalUsage(MemoryCategory::Swapchain,
+	                                   static_cast<VkDeviceSize>(extent.width) * extent.height * 4 * imageCount);
 }
 
 void CVulkanApplication::createLogicalDevice() {
@@ -265,25 +770,60 @@ void CVulkanApplication::createLogicalDevice() {
 	}
 	// Dfinition des fonctionnalits du physical device qu'on souhaite utiliser
 	auto deviceFeatures = VkPhysicalDeviceFeatures{};
+	VkPhysicalDeviceFeatures supportedFeatures;
+	vkGetPhysicalDeviceFeatures(m_physicalDevice, &supportedFeatures);
+	// Dessins indirects de la scne  niveaux de dtail (firstInstance = index d'instance, plusieurs dessins par appel)
+	deviceFeatures.drawIndirectFirstInstance = supportedFeatures.drawIndirectFirstInstance;
+	deviceFeatures.multiDrawIndirect = supportedFeatures.multiDrawIndirect;
+	// Le post-traitement crit les images de la swapchain quel que soit leur format
+	deviceFeatures.shaderStorageImageWriteWithoutFormat = m_settings.postProcess && supportedFeatures.shaderStorageImageWriteWithoutFormat;
+	// Comptage des invocations du fragment shader
+	deviceFeatures.pipelineStatisticsQuery = m_settings.countFragments && supportedFeatures.pipelineStatisticsQuery;
+	m_enabledFeatures = deviceFeatures;
 	// Cration du logical device
 	auto createInfo = VkDeviceCreateInfo{};
 	createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
 	createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
 	createInfo.pQueueCreateInfos = queueCreateInfos.data();
 	createInfo.pEnabledFeatures = &deviceFeatures;
-	// Activation des extensions
-	createInfo.enabledExtensionCount = static_cast<uint32_t>(device_extensions.size());
-	createInfo.ppEnabledExtensionNames = device_extensions.data();
+	// Activation des extensions (VK_EXT_memory_budget en option)
+	auto extensions = device_extensions;
+	m_memoryBudgetEnabled = CMemoryTelemetry::isBudgetExtensionSupported(m_physicalDevice)
+			&& !CMemoryTelemetry::optionalInstanceExtensions().empty();
+	if (m_memoryBudgetEnabled) { extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME); }
+	// Rendu multi-vues en une passe : VK_KHR_multiview (l'instance cible Vulkan 1.0), sa fonctionnalit est alors garantie
+	auto multiviewFeatures = VkPhysicalDeviceMultiviewFeaturesKHR{};
+	multiviewFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTIVIEW_FEATURES_KHR;
+	multiviewFeatures.multiview = VK_TRUE;
+	if (m_settings.multiview && m_settings.multiviewSettings.singlePass) {
+		if (!CMultiviewRenderer::isSupported(m_physicalDevice)) {
+			throw std::runtime_error("Failed to find VK_KHR_multiview support");
+		}
+		extensions.push_back(VK_KHR_MULTIVIEW_EXTENSION_NAME);
+		createInfo.pNext = &multiviewFeatures;
+	}
+	createInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+	createInfo.ppEnabledExtensionNames = extensions.data();
 	if (enableValidationLayers) {
 		createInfo.enabledLayerCount = static_cast<uint32_t>(validation_layers.size());
 		createInfo.ppEnabledLayerNames = validation_layers.data();
 	}
 	else { createInfo.enabledLayerCount = 0; }
-	if (vkCreateDevice(m_physicalDevice, &createInfo, nullptr, &m_device) != VK_SUCCESS) {
+	if (vkCreateDevice(m_physicalDevice, &createInfo, m_allocator, &m_device) != VK_SUCCESS) {
 		throw std::runtime_error("Failed to create a logical device");
 	}
+	// Appels directs au driver pour ce device (sans le trampoline du loader)
+	m_dispatch.load(m_instanceDispatch, m_device);
 	vkGetDeviceQueue(m_device, indices.graphicsFamily.value(), 0, &m_graphicsQueue);
 	vkGetDeviceQueue(m_device, indices.presentFamily.value(), 0, &m_presentQueue);
+	m_memoryTelemetry.init(m_instance, m_physicalDevice, m_memoryBudgetEnabled);
+	// Par dfaut un simple avertissement ; les systmes de streaming remplacent ce callback
+	if (!m_memoryTelemetry.hasThresholdCallback()) {
+		m_memoryTelemetry.setThresholdCallback(m_settings.memoryPressureThreshold, [](const HeapBudget& heap) {
+			CLogger::log(LogLevel::Warning, "Memory", "heap " + std::to_string(heap.heapIndex) + " above budget threshold: "
+			             + std::to_string(heap.usage) + " / " + std::to_string(heap.budget) + " bytes");
+		});
+	}
 }
 
 void CVulkanApplication::pickPhysicalDevice() {
@@ -306,9 +846,13 @@ void CVulkanApplication::pickPhysicalDevice() {
 void CVulkanApplication::populateDebugMessengerCreateInfo(VkDebugUtilsMessengerCreateInfoEXT& createInfo) {
 	createInfo = {};
 	createInfo.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_MESSENGER_CREATE_INFO_EXT;
-	createInfo.messageSeverity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT |
-			VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT
+	// Les svrits filtres par le logger ne sont mme pas demandes aux validation layers
+	createInfo.messageSeverity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT
 			| VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT;
+	if (CLogger::minimumLevel() <= LogLevel::Info) { createInfo.messageSeverity |= VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT; }
+	if (CLogger::minimumLevel() <= LogLevel::Verbose) {
+		createInfo.messageSeverity |= VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT;
+	}
 	createInfo.messageType = VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT |
 			VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT
 			| VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT;
@@ -319,7 +863,8 @@ void CVulkanApplication::setupDebugMessenger() {
 	if constexpr (!enableValidationLayers) return;
 	VkDebugUtilsMessengerCreateInfoEXT createInfo;
 	populateDebugMessengerCreateInfo(createInfo);
-	if (CreateDebugUtilsMessengerEXT(m_instance, &createInfo, nullptr, &m_debugMessenger) != VK_SUCCESS) {
+	if (m_instanceDispatch.CreateDebugUtilsMessengerEXT == nullptr
+		|| m_instanceDispatch.CreateDebugUtilsMessengerEXT(m_instance, &createInfo, m_allocator, &m_debugMessenger) != VK_SUCCESS) {
 		throw std::runtime_error("Failed to set up debug messenger");
 	}
 }
@@ -331,26 +876,215 @@ void CVulkanApplication::recreateSwapChain() {
 	cleanupSwapChain();
 	// Recration de la swapchain
 	createSwapChain();
+	createFrameCapture();
 	createImageViews();
-	createRenderPass();
-	createGraphicsPipeline();
+	// Variantes de pipeline (et leur VkPipelineCache) conserves tant que la render pass reste compatible
+	if (m_swapChainImageFormat != m_renderPassFormat) {
+		destroyRenderPass();
+		createRenderPass();
+		createGraphicsPipeline();
+	}
+	createParticleSystem();
+	createLodScene();
+	createDepthBuffer();
 	createFramebuffers();
 	createCommandBuffers();
+	createOutputSwapChains();
+	createMultiview();
+	createDynamicResolution();
+	createPostProcess();
 }
 
 void CVulkanApplication::cleanupSwapChain() {
-	for (size_t i = 0; i < m_swapChainFramebuffers.size(); i++) {
-		vkFreeCommandBuffers(m_device, m_commandPool, static_cast<uint32_t>(m_commandBuffers.size()), m_commandBuffers.data());
+	destroyOutputSwapChains();
+	for (auto& framebuffer : m_swapChainFramebuffers) {
+		vkDestroyFramebuffer(m_device, framebuffer, m_allocator);
 	}
-	vkDestroyPipeline(m_device, m_pipeline, nullptr);
-	vkDestroyPipelineLayout(m_device, m_pipelineLayout, nullptr);
-	vkDestroyRenderPass(m_device, m_renderPass, nullptr);
+	m_depthBuffer.cleanup();
+	vkFreeCommandBuffers(m_device, m_commandPool, static_cast<uint32_t>(m_commandBuffers.size()), m_commandBuffers.data());
+	m_particles.destroyGraphicsPipeline();
+	m_lodRenderer.destroyGraphicsPipeline();
 	for (auto& imageView : m_swapChainImagesViews) {
-		vkDestroyImageView(m_device, imageView, nullptr);
+		vkDestroyImageView(m_device, imageView, m_allocator);
+	}
+	m_dynamicResolution.cleanup();
+	m_multiview.cleanup();
+	m_postProcess.cleanup();
+	// crit les dernires captures avant de librer les buffers de relecture
+	m_frameCapture.cleanup();
+	vkDestroySwapchainKHR(m_device, m_swapchain, m_allocator);
+}
+
+void CVulkanApplication::destroyRenderPass() {
+	if (m_renderPassFormat == VK_FORMAT_UNDEFINED) { return; }
+	m_pipelineVariants.cleanup();
+	vkDestroyPipelineLayout(m_device, m_pipelineLayout, m_allocator);
+	vkDestroyRenderPass(m_device, m_renderPass, m_allocator);
+	m_renderPassFormat = VK_FORMAT_UNDEFINED;
+}
+
+void CVulkanApplication::createFrameCapture() {
+	if (!m_settings.captureFrames) { return; }
+	const auto indices = findQueueFamilies(m_physicalDevice);
+	m_frameCapture.init(deviceContext(), indices.graphicsFamily.value(), m_swapChainExtent, m_swapChainImageFormat,
+	                    m_settings.captureDirectory, m_settings.captureFormat, m_settings.captureLossless);
+}
+
+
+void CVulkanApplication::createCommandTrace() {
+	if (m_settings.commandTrace.empty()) { return; }
+	// Seules la scne du triangle et les command buffers pr-enregistrs sont tracs
+	if (m_settings.scene != SceneType::Triangle || m_settings.dynamicResolution || m_settings.multiview || m_settings.postProcess
+		|| !m_settings.streamFiles.empty()) {
+		CLogger::log(LogLevel::Warning, "Trace", "Command trace requires the triangle scene without dynamic resolution, multiview, post-processing or streaming: disabled");
+		return;
+	}
+	m_commandTrace.open(m_settings.commandTrace, m_swapChainImageFormat, m_swapChainExtent);
+}
+
+void CVulkanApplication::createDynamicResolution() {
+	// Le rendu multi-vues remplit dj les images de la swapchain
+	if (!m_settings.dynamicResolution || m_multiview.isActive()) { return; }
+	if (!(m_swapChainUsage & VK_IMAGE_USAGE_TRANSFER_DST_BIT)
+		|| !CDynamicResolution::isSupported(m_physicalDevice, m_swapChainImageFormat)) {
+		CLogger::log(LogLevel::Warning, "Resolution", "Swapchain format cannot be blitted: dynamic resolution disabled");
+		return;
 	}
-	vkDestroySwapchainKHR(m_device, m_swapchain, nullptr);
+	const auto indices = findQueueFamilies(m_physicalDevice);
+	m_dynamicResolution.init(deviceContext(), indices.graphicsFamily.value(), m_swapChainImageFormat, m_swapChainExtent,
+	                         MAX_FRAMES_IN_FLIGHTS, m_settings.dynamicResolutionSettings);
 }
 
+void CVulkanApplication::createPostProcess() {
+	// Rsolution dynamique et multi-vues remplissent dj les images de la swapchain
+	if (!m_settings.postProcess || m_dynamicResolution.isActive() || m_multiview.isActive()) { return; }
+	if (!(m_swapChainUsage & (VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT))
+		|| !m_enabledFeatures.shaderStorageImageWriteWithoutFormat
+		|| !CPostProcess::isSupported(m_physicalDevice, m_swapChainImageFormat)) {
+		CLogger::log(LogLevel::Warning, "PostProcess", "Swapchain cannot be written by compute shaders: post-processing disabled");
+		return;
+	}
+	const auto indices = findQueueFamilies(m_physicalDevice);
+	m_postProcess.init(deviceContext(), indices.graphicsFamily.value(), m_swapChainImageFormat, m_swapChainExtent,
+	                   m_swapChainImages, m_swapChainUsage, MAX_FRAMES_IN_FLIGHTS,
+	                   CPostProcess::supportsSubgroups(m_physicalDevice, m_apiVersion), m_settings.postProcessSettings);
+}
+
+std::vector<std::string> CVulkanApplication::shaderFiles() const {
+	auto files = std::vector<std::string>{ "shaders/vert.spv", "shaders/frag.spv" };
+	if (m_settings.scene == SceneType::Particles) {
+		files.insert(files.end(), { "shaders/particles_comp.spv", "shaders/particles_vert.spv", "shaders/particles_frag.spv" });
+	}
+	if (m_settings.scene == SceneType::Lod) {
+		files.insert(files.end(), { "shaders/lod_vert.spv", "shaders/lod_frag.spv" });
+		if (m_settings.lighting) { files.insert(files.end(), { "shaders/lod_lit_frag.spv", "shaders/lighting_cull_comp.spv" }); }
+	}
+	if (m_settings.multiview) {
+		files.emplace_back(m_settings.multiviewSettings.singlePass ? "shaders/multiview_vert.spv" : "shaders/multiview_passes_vert.spv");
+	}
+	if (m_settings.postProcess) {
+		files.insert(files.end(), {
+			"shaders/postprocess_prefilter_comp.spv", "shaders/postprocess_prefilter_subgroup_comp.spv",
+			"shaders/postprocess_downsample_comp.spv", "shaders/postprocess_upsample_comp.spv",
+			"shaders/postprocess_blur_comp.spv", "shaders/postprocess_composite_comp.spv"
+		});
+	}
+	return files;
+}
+
+void CVulkanApplication::createStreaming() {
+	if (m_settings.streamFiles.empty()) { return; }
+	const auto indices = findQueueFamilies(m_physicalDevice);
+	m_streamingUploader.init(deviceContext(), indices.graphicsFamily.value(), MAX_FRAMES_IN_FLIGHTS, m_assetStreamer,
+	                         m_settings.streamingStagingSize);
+	m_streamingStart = std::chrono::steady_clock::now();
+	for (const auto& path : m_settings.streamFiles) {
+		auto error = std::error_code{};
+		const auto size = std::filesystem::file_size(path, error);
+		if (error || size == 0) {
+			CLogger::log(LogLevel::Warning, "Streaming", "Cannot stream " + path + ": missing or empty file");
+			continue;
+		}
+		auto buffer = VkBuffer{VK_NULL_HANDLE};
+		auto memory = VkDeviceMemory{VK_NULL_HANDLE};
+		createBuffer(deviceContext(), size, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT
+		             | VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+		             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, buffer, memory, MemoryCategory::Buffer);
+		m_streamedBuffers.push_back(buffer);
+		m_streamedBuffersMemory.push_back(memory);
+		m_pendingStreams++;
+		// Thread de rendu, une fois la dernire copie du fichier termine
+		m_streamingUploader.upload(path, 0, size, buffer, 0, StreamPriority::Normal, [this, path, size](uint64_t, bool success) {
+			if (success) {
+				CLogger::log(LogLevel::Info, "Streaming", "Streamed " + path + " (" + std::to_string(size) + " bytes)");
+			}
+			if (--m_pendingStreams > 0) { return; }
+			m_streamingMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_streamingStart).count();
+			const auto megabytes = static_cast<double>(m_streamingUploader.stats().bytesUploaded) / (1024.0 * 1024.0);
+			CLogger::log(LogLevel::Info, "Streaming", "All files streamed in " + std::to_string(m_streamingMs) + " ms ("
+			             + std::to_string(megabytes * 1000.0 / std::max(m_streamingMs, 1e-3)) + " MiB/s)");
+		});
+	}
+}
+
+void CVulkanApplication::createMultiview() {
+	if (!m_settings.multiview) { return; }
+	if (m_settings.scene != SceneType::Triangle) {
+		CLogger::log(LogLevel::Warning, "Multiview", "Multiview rendering only draws the triangle scene: disabled");
+		return;
+	}
+	const auto indices = findQueueFamilies(m_physicalDevice);
+	m_multiview.init(deviceContext(), indices.graphicsFamily.value(), m_swapChainImageFormat, m_swapChainExtent,
+	                 MAX_FRAMES_IN_FLIGHTS, m_settings.multiviewSettings);
+}
+
+void CVulkanApplication::createParticleSystem() {
+	if (m_settings.scene != SceneType::Particles) { return; }
+	const auto indices = findQueueFamilies(m_physicalDevice);
+	// Une mesure par command buffer pr-enregistr (couples image / frame en vol)
+	const auto timerSlots = static_cast<uint32_t>(m_swapChainImages.size() * MAX_FRAMES_IN_FLIGHTS);
+	if (!m_particles.isActive()) {
+		m_particles.init(deviceContext(), indices.graphicsFamily.value(), m_graphicsQueue, m_settings.particleSettings,
+		                 timerSlots);
+	}
+	else {
+		// Swapchain recre : elle peut compter plus d'images
+		m_particles.reserveTimerSlots(indices.graphicsFamily.value(), timerSlots);
+	}
+	m_particleTimerSlots.assign(MAX_FRAMES_IN_FLIGHTS, UINT32_MAX);
+	m_particles.createGraphicsPipeline(m_renderPass);
+}
+
+void CVulkanApplication::createLodScene() {
+	if (m_settings.scene != SceneType::Lod) { return; }
+	if (!m_lodRenderer.isActive()) {
+		// Grille d'objets s'loignant de la camra, cre du plus lointain au plus proche (ordre de dessin correct mme avec --no-depth)
+		const auto count = m_settings.lodSettings.objectCount;
+		const auto side = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(count))));
+		constexpr auto spacing = 4.0f;
+		m_lodRoot = m_scene.createNode();
+		for (uint32_t i = 0; i < count; i++) {
+			const auto row = side - 1 - i / side;
+			const auto column = i % side;
+			const auto node = m_scene.createNode(m_lodRoot);
+			m_scene.setLocalTranslation(node, { (static_cast<float>(column) - static_cast<float>(side - 1) * 0.5f) * spacing,
+			                                    0.0f, -static_cast<float>(row) * spacing });
+		}
+		const auto indices = findQueueFamilies(m_physicalDevice);
+		auto lighting = LodLighting{};
+		if (m_settings.lighting) {
+			// Lumires autour de la grille sur toute la course de m_lodRoot (dplacement de -50  +10 en z)
+			const auto halfWidth = static_cast<float>(side - 1) * 0.5f * spacing + 2.0f;
+			const auto depth = static_cast<float>(side - 1) * spacing;
+			m_lighting.init(deviceContext(), indices.graphicsFamily.value(), MAX_FRAMES_IN_FLIGHTS, m_settings.lightingSettings,
+			                { -halfWidth, -0.5f, -depth - 52.0f }, { halfWidth, 2.0f, 12.0f });
+			lighting = LodLighting{ m_lighting.descriptorSetLayout(), m_lighting.bruteForce() };
+		}
+		m_lodRenderer.init(deviceContext(), indices.graphicsFamily.value(), m_graphicsQueue, m_settings.lodSettings,
+		                   static_cast<uint32_t>(m_scene.size()), MAX_FRAMES_IN_FLIGHTS, m_enabledFeatures, lighting);
+	}
+	m_lodRenderer.createGraphicsPipeline(m_renderPass, m_depth);
+}
 
 void CVulkanApplication::createImageViews() {
 	m_swapChainImagesViews.resize(m_swapChainImages.size());
@@ -371,100 +1105,197 @@ void CVulkanApplication::createImageViews() {
 		createInfo.subresourceRange.levelCount = 1;
 		createInfo.subresourceRange.baseArrayLayer = 0;
 		createInfo.subresourceRange.layerCount = 1;
-		if (vkCreateImageView(m_device, &createInfo, nullptr, &m_swapChainImagesViews[i]) != VK_SUCCESS) {
+		if (vkCreateImageView(m_device, &createInfo, m_allocator, &m_swapChainImagesViews[i]) != VK_SUCCESS) {
 			throw std::runtime_error("Failed to create ImageView");
 		}
 	}
 }
 
+void CVulkanApplication::createOutputSwapChains() {
+	if (m_extraOutputs.empty()) { return; }
+	for (auto& output : m_extraOutputs) { createOutputSwapChain(output); }
+	updateSwapchainMemory();
+}
+
+void CVulkanApplication::createOutputSwapChain(OutputSurface& output) {
+	const auto indices = findQueueFamilies(m_physicalDevice);
+	auto semaphoreInfo = VkSemaphoreCreateInfo{};
+	semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+	// Toutes les sorties sont prsentes par la mme queue, en un seul appel
+	auto presentSupport = VkBool32{VK_FALSE};
+	vkGetPhysicalDeviceSurfaceSupportKHR(m_physicalDevice, indices.presentFamily.value(), output.surface, &presentSupport);
+	if (!presentSupport) { throw std::runtime_error("Failed to create output: the present queue cannot present to its surface"); }
+	const auto support = querySwapChainSupport(m_physicalDevice, output.surface);
+	const auto surfaceFormat = chooseSwapSurfaceFormat(support.formats);
+	// La render pass (et donc les pipelines) est partage avec la fentre principale
+	if (surfaceFormat.format != m_swapChainImageFormat) {
+		throw std::runtime_error("Failed to create output: its surface format differs from the main window");
+	}
+	uint32_t imageCount = support.capabilities.minImageCount + 1;
+	if (support.capabilities.maxImageCount > 0 && imageCount > support.capabilities.maxImageCount) {
+		imageCount = support.capabilities.maxImageCount;
+	}
+	output.extent = chooseSwapExtent(support.capabilities, output.framebufferExtent);
+	// L'attachement de profondeur est partag par tous les framebuffers de la render pass
+	if (m_depthBuffer.isActive()
+		&& (output.extent.width > m_depthBuffer.extent().width || output.extent.height > m_depthBuffer.extent().height)) {
+		throw std::runtime_error("Failed to create output: its extent exceeds the depth buffer");
+	}
+	auto createInfo = VkSwapchainCreateInfoKHR{};
+	createInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
+	createInfo.surface = output.surface;
+	createInfo.minImageCount = imageCount;
+	createInfo.imageFormat = surfaceFormat.format;
+	createInfo.imageColorSpace = surfaceFormat.colorSpace;
+	createInfo.imageExtent = output.extent;
+	createInfo.imageArrayLayers = 1;
+	createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+	uint32_t queueFamilyIndices[] = { indices.graphicsFamily.value(), indices.presentFamily.value() };
+	if (indices.graphicsFamily != indices.presentFamily) {
+		createInfo.imageSharingMode = VK_SHARING_MODE_CONCURRENT;
+		createInfo.queueFamilyIndexCount = 2;
+		createInfo.pQueueFamilyIndices = queueFamilyIndices;
+	}
+	else { createInfo.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE; }
+	createInfo.preTransform = support.capabilities.currentTransform;
+	createInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+	createInfo.presentMode = chooseSwapPresentMode(support.presentModes);
+	createInfo.clipped = VK_TRUE;
+	if (vkCreateSwapchainKHR(m_device, &createInfo, m_allocator, &output.swapchain) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create swapchain");
+	}
+	vkGetSwapchainImagesKHR(m_device, output.swapchain, &imageCount, nullptr);
+	output.images.resize(imageCount);
+	vkGetSwapchainImagesKHR(m_device, output.swapchain, &imageCount, output.images.data());
+	// Image views et framebuffers
+	output.imageViews.resize(imageCount);
+	output.framebuffers.resize(imageCount);
+	for (uint32_t i = 0; i < imageCount; i++) {
+		auto viewInfo = VkImageViewCreateInfo{};
+		viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		viewInfo.image = output.images[i];
+		viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		viewInfo.format = surfaceFormat.format;
+		viewInfo.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+		if (vkCreateImageView(m_device, &viewInfo, m_allocator, &output.imageViews[i]) != VK_SUCCESS) {
+			throw std::runtime_error("Failed to create ImageView");
+		}
+		VkImageView attachments[] = {output.imageViews[i], m_depthBuffer.view()};
+		auto framebufferInfo = VkFramebufferCreateInfo{};
+		framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+		framebufferInfo.renderPass = m_renderPass;
+		framebufferInfo.attachmentCount = m_depth.enabled ? 2 : 1;
+		framebufferInfo.pAttachments = attachments;
+		framebufferInfo.width = output.extent.width;
+		framebufferInfo.height = output.extent.height;
+		framebufferInfo.layers = 1;
+		if (vkCreateFramebuffer(m_device, &framebufferInfo, m_allocator, &output.framebuffers[i]) != VK_SUCCESS) {
+			throw std::runtime_error("Failed to create a framebuffer");
+		}
+	}
+	// Command buffers pr-enregistrs
+	output.commandBuffers.resize(imageCount * MAX_FRAMES_IN_FLIGHTS);
+	output.commandBufferGenerations.assign(output.commandBuffers.size(), 0);
+	auto allocInfo = VkCommandBufferAllocateInfo{};
+	allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	allocInfo.commandPool = m_commandPool;
+	allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	allocInfo.commandBufferCount = static_cast<uint32_t>(output.commandBuffers.size());
+	if (vkAllocateCommandBuffers(m_device, &allocInfo, output.commandBuffers.data()) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to allocate a command buffer");
+	}
+	for (size_t i = 0; i < output.commandBuffers.size(); i++) { recordOutputCommandBuffer(output, i); }
+	// Smaphores par frame en vol
+	output.imageAvailableSemaphores.resize(MAX_FRAMES_IN_FLIGHTS);
+	output.renderFinishedSemaphores.resize(MAX_FRAMES_IN_FLIGHTS);
+	for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHTS; i++) {
+		if (vkCreateSemaphore(m_device, &semaphoreInfo, m_allocator, &output.imageAvailableSemaphores[i]) != VK_SUCCESS ||
+			vkCreateSemaphore(m_device, &semaphoreInfo, m_allocator, &output.renderFinishedSemaphores[i]) != VK_SUCCESS) {
+			throw std_err("Failed to create syncronization objects");
+		}
+	}
+	output.outdated = false;
+}
+
+void CVulkanApplication::updateSwapchainMemory() {
+	// Estimation de la mmoire des swapchains (4 octets par pixel), fentre principale comprise
+	auto swapchainBytes = static_cast<VkDeviceSize>(m_swapChainExtent.width) * m_swapChainExtent.height * 4 * m_swapChainImages.size();
+	for (const auto& output : m_extraOutputs) {
+		swapchainBytes += static_cast<VkDeviceSize>(output.extent.width) * output.extent.height * 4 * output.images.size();
+	}
+	m_memoryTelemetry.setExternalUsage(MemoryCategory::Swapchain, swapchainBytes);
+}
+
+void CVulkanApplication::destroyOutputSwapChains() {
+	for (auto& output : m_extraOutputs) { destroyOutputSwapChain(output); }
+}
+
+void CVulkanApplication::destroyOutputSwapChain(OutputSurface& output) {
+	if (output.swapchain == VK_NULL_HANDLE) { return; }
+	for (size_t i = 0; i < output.imageAvailableSemaphores.size(); i++) {
+		vkDestroySemaphore(m_device, output.imageAvailableSemaphores[i], m_allocator);
+		vkDestroySemaphore(m_device, output.renderFinishedSemaphores[i], m_allocator);
+	}
+	output.imageAvailableSemaphores.clear();
+	output.renderFinishedSemaphores.clear();
+	vkFreeCommandBuffers(m_device, m_commandPool, static_cast<uint32_t>(output.commandBuffers.size()), output.commandBuffers.data());
+	output.commandBuffers.clear();
+	for (size_t i = 0; i < output.framebuffers.size(); i++) {
+		vkDestroyFramebuffer(m_device, output.framebuffers[i], m_allocator);
+		vkDestroyImageView(m_device, output.imageViews[i], m_allocator);
+	}
+	output.framebuffers.clear();
+	output.imageViews.clear();
+	output.images.clear();
+	vkDestroySwapchainKHR(m_device, output.swapchain, m_allocator);
+	output.swapchain = VK_NULL_HANDLE;
+}
+
+void CVulkanApplication::recreateOutputSwapChain(OutputSurface& output) {
+	// Ses smaphores et command buffers peuvent encore tre utiliss par les frames en vol
+	m_dispatch.DeviceWaitIdle(m_device);
+	destroyOutputSwapChain(output);
+	const auto support = querySwapChainSupport(m_physicalDevice, output.surface);
+	const auto extent = chooseSwapExtent(support.capabilities, output.framebufferExtent);
+	if (m_depthBuffer.isActive() && (extent.width > m_depthBuffer.extent().width || extent.height > m_depthBuffer.extent().height)) {
+		recreateSwapChain();
+		return;
+	}
+	createOutputSwapChain(output);
+	updateSwapchainMemory();
+}
+
 void CVulkanApplication::createGraphicsPipeline() {
 	auto vertShaderCode = CShaderLoader::readFile("shaders/vert.spv");
 	auto fragShaderCode = CShaderLoader::readFile("shaders/frag.spv");
-	auto vertShaderModule = createShaderModule(vertShaderCode);
-	auto fragShaderModule = createShaderModule(fragShaderCode);
-	// Configuration des sommets
-	VkPipelineShaderStageCreateInfo fragShaderStageInfo = {};
-	fragShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-	fragShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-	fragShaderStageInfo.module = fragShaderModule;
-	fragShaderStageInfo.pName = "main";
-	VkPipelineShaderStageCreateInfo vertShaderStageInfo = {};
-	vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-	vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
-	vertShaderStageInfo.module = vertShaderModule;
-	vertShaderStageInfo.pName = "main";
-	VkPipelineShaderStageCreateInfo shaderStages[] = {vertShaderStageInfo, fragShaderStageInfo};
-	// Entre des sommets
-	auto vertexInputInfo = VkPipelineVertexInputStateCreateInfo{};
-	vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-	vertexInputInfo.vertexBindingDescriptionCount = 0;
-	vertexInputInfo.pVertexBindingDescriptions = nullptr;
-	vertexInputInfo.vertexAttributeDescriptionCount = 0;
-	vertexInputInfo.pVertexAttributeDescriptions = nullptr;
+	// tat commun  toutes les variantes (les shader modules sont confis au cache)
+	auto state = GraphicsPipelineState{};
+	state.vertexShader = createShaderModule(vertShaderCode);
+	state.fragmentShader = createShaderModule(fragShaderCode);
+	m_commandTrace.shaderModule(state.vertexShader, VK_SHADER_STAGE_VERTEX_BIT, vertShaderCode);
+	m_commandTrace.shaderModule(state.fragmentShader, VK_SHADER_STAGE_FRAGMENT_BIT, fragShaderCode);
 	// Input Assembly (nature de la gomtrie)
-	auto inputAssembly = VkPipelineInputAssemblyStateCreateInfo{};
-	inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-	inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-	inputAssembly.primitiveRestartEnable = VK_FALSE;
-	// View port (rgion du framebuffer sur laquelle le rendu sera effectu)
-	auto viewport = VkViewport{};
-	viewport.x = 0.0f;
-	viewport.y = 0.0f;
-	viewport.width = static_cast<float>(m_swapChainExtent.width);
-	viewport.height = static_cast<float>(m_swapChainExtent.height);
-	viewport.minDepth = 0.0f;
-	viewport.maxDepth = 1.0f;
-	// Scissor rectangle
-	auto scissor = VkRect2D{};
-	scissor.offset = {0, 0};
-	scissor.extent = m_swapChainExtent;
-	// Config viewport et scissors
-	auto viewportState = VkPipelineViewportStateCreateInfo{};
-	viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
-	viewportState.viewportCount = 1;
-	viewportState.pViewports = &viewport;
-	viewportState.scissorCount = 1;
-	viewportState.pScissors = &scissor;
+	state.inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+	state.inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+	state.inputAssembly.primitiveRestartEnable = VK_FALSE;
 	// Rasterizer
-	auto rasterizer = VkPipelineRasterizationStateCreateInfo{};
-	rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-	rasterizer.depthClampEnable = VK_FALSE;
-	rasterizer.rasterizerDiscardEnable = VK_FALSE;
-	rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
-	rasterizer.lineWidth = 1.0f;
-	rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
-	rasterizer.frontFace = VK_FRONT_FACE_CLOCKWISE;
-	rasterizer.depthBiasEnable = VK_FALSE;
-	rasterizer.depthBiasConstantFactor = 0.0f;
-	rasterizer.depthBiasClamp = 0.0f;
-	rasterizer.depthBiasSlopeFactor = 0.0f;
+	state.rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+	state.rasterizer.depthClampEnable = VK_FALSE;
+	state.rasterizer.rasterizerDiscardEnable = VK_FALSE;
+	state.rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+	state.rasterizer.lineWidth = 1.0f;
+	state.rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
+	state.rasterizer.frontFace = VK_FRONT_FACE_CLOCKWISE;
+	state.rasterizer.depthBiasEnable = VK_FALSE;
 	// Multisampling (= Anti aliasing)
-	auto multisampling = VkPipelineMultisampleStateCreateInfo{};
-	multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
-	multisampling.sampleShadingEnable = VK_FALSE;
-	multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
-	multisampling.minSampleShading = 1.0f;
-	multisampling.pSampleMask = nullptr;
-	multisampling.alphaToCoverageEnable = VK_FALSE;
-	multisampling.alphaToOneEnable = VK_FALSE;
-	// Tests de profondeurs et pochoir
-	auto depthStencil = nullptr;
+	state.multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+	state.multisampling.sampleShadingEnable = VK_FALSE;
+	state.multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+	state.multisampling.minSampleShading = 1.0f;
 	// Color blending Attachement
-	auto colorBlendAttachment = VkPipelineColorBlendAttachmentState{};
-	colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT
+	state.colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT
 			| VK_COLOR_COMPONENT_A_BIT;
-	colorBlendAttachment.blendEnable = VK_FALSE;
-	// Color blending 
-	VkPipelineColorBlendStateCreateInfo colorBlending = {};
-	colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-	colorBlending.logicOpEnable = VK_FALSE;
-	colorBlending.logicOp = VK_LOGIC_OP_COPY;
-	colorBlending.attachmentCount = 1;
-	colorBlending.pAttachments = &colorBlendAttachment;
-	colorBlending.blendConstants[0] = 0.0f;
-	colorBlending.blendConstants[1] = 0.0f;
-	colorBlending.blendConstants[2] = 0.0f;
-	colorBlending.blendConstants[3] = 0.0f;
+	state.colorBlendAttachment.blendEnable = VK_FALSE;
 	// Pipeline layout
 	VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
 	pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
@@ -472,36 +1303,46 @@ void CVulkanApplication::createGraphicsPipeline() {
 	pipelineLayoutInfo.pSetLayouts = nullptr;
 	pipelineLayoutInfo.pushConstantRangeCount = 0;
 	pipelineLayoutInfo.pPushConstantRanges = nullptr;
-	if (vkCreatePipelineLayout(m_device, &pipelineLayoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS) {
+	if (vkCreatePipelineLayout(m_device, &pipelineLayoutInfo, m_allocator, &m_pipelineLayout) != VK_SUCCESS) {
 		throw std::runtime_error("Failed to create pipeline layout");
 	}
-	// Cration de la pipeline graphique
-	auto pipelineInfo = VkGraphicsPipelineCreateInfo{};
-	pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-	pipelineInfo.stageCount = 2;
-	pipelineInfo.pStages = shaderStages;
-	pipelineInfo.pVertexInputState = &vertexInputInfo;
-	pipelineInfo.pInputAssemblyState = &inputAssembly;
-	pipelineInfo.pViewportState = &viewportState;
-	pipelineInfo.pRasterizationState = &rasterizer;
-	pipelineInfo.pMultisampleState = &multisampling;
-	pipelineInfo.pDepthStencilState = nullptr;
-	pipelineInfo.pColorBlendState = &colorBlending;
-	pipelineInfo.pDynamicState = nullptr;
-	pipelineInfo.layout = m_pipelineLayout;
-	pipelineInfo.renderPass = m_renderPass;
-	pipelineInfo.subpass = 0;
-	pipelineInfo.basePipelineHandle = nullptr;
-	pipelineInfo.basePipelineIndex = -1;
-	if (vkCreateGraphicsPipelines(m_device, nullptr, 1, &pipelineInfo, nullptr, &m_pipeline) != VK_SUCCESS) {
-		throw std::runtime_error("Failed to create graphic pipeline");
-	}
-	// Destruction des shader modules
-	vkDestroyShaderModule(m_device, fragShaderModule, nullptr);
-	vkDestroyShaderModule(m_device, vertShaderModule, nullptr);
+	// Le triangle seul n'a pas besoin du test de profondeur (l'attachement reste compatible avec la render pass)
+	state.depthStencil = depthStencilState(m_depth, DepthPass::None);
+	state.layout = m_pipelineLayout;
+	state.renderPass = m_renderPass;
+	m_commandTrace.pipelineState(state);
+	// Pipeline gnrique compile tout de suite, variantes (mode de couleur x gamma) en arrire-plan.
+	// Rendu  la demande : chaque lot prt redemande une frame pour tre affich
+	if (m_settings.onDemand) { m_pipelineVariants.setBatchCallback([this] { m_redraw.invalidate(RedrawReason::DataUpdate); }); }
+	m_pipelineVariants.init(deviceContext(), m_jobSystem, state);
+	auto keys = std::vector<PipelineVariantKey>{};
+	for (uint32_t colorMode = 0; colorMode < TRIANGLE_COLOR_MODES; colorMode++) {
+		for (uint32_t gamma = 0; gamma < 2; gamma++) {
+			// (0, 0) : constantes par dfaut, c'est la pipeline gnrique
+			if (colorMode == 0 && gamma == 0) { continue; }
+			auto key = PipelineVariantKey{};
+			key.constants = { colorMode, gamma, 0, 0 };
+			keys.push_back(key);
+		}
+	}
+	m_pipelineVariants.request(keys);
 }
 
 void CVulkanApplication::createRenderPass() {
+	// La rsolution dynamique et le post-traitement dessinent la scne dans leurs propres render passes, sans profondeur
+	m_depth = m_settings.depth;
+	if (m_depth.enabled && (m_settings.dynamicResolution || m_settings.postProcess)) {
+		// Profondeur active par dfaut : on ne prvient que si elle a t demande
+		if (m_depth.requested) {
+			CLogger::log(LogLevel::Warning, "Depth", "Depth testing is not supported with dynamic resolution or post-processing: disabled");
+		}
+		m_depth.enabled = false;
+	}
+	m_depthFormat = m_depth.enabled ? CDepthBuffer::findFormat(m_physicalDevice) : VK_FORMAT_UNDEFINED;
+	if (m_depth.enabled && m_depthFormat == VK_FORMAT_UNDEFINED) {
+		CLogger::log(LogLevel::Warning, "Depth", "No depth attachment format supported: depth testing disabled");
+		m_depth.enabled = false;
+	}
 	// Dfinition des attachements de couleurs
 	auto colorAttachment = VkAttachmentDescription{};
 	colorAttachment.format = m_swapChainImageFormat;
@@ -520,10 +1361,24 @@ void CVulkanApplication::createRenderPass() {
 	auto colorAttachmentRef = VkAttachmentReference{};
 	colorAttachmentRef.attachment = 0; // Rfrence vers un index d'un tableau contenant les attachments
 	colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL; // color buffer
+	// Profondeur : efface au dbut, jamais conserve (rien ne la relit aprs la render pass)
+	auto depthAttachment = VkAttachmentDescription{};
+	depthAttachment.format = m_depthFormat;
+	depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+	depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+	depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+	depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+	auto depthAttachmentRef = VkAttachmentReference{};
+	depthAttachmentRef.attachment = 1;
+	depthAttachmentRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 	auto subpass = VkSubpassDescription{};
 	subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
 	subpass.colorAttachmentCount = 1;
 	subpass.pColorAttachments = &colorAttachmentRef;
+	subpass.pDepthStencilAttachment = m_depth.enabled ? &depthAttachmentRef : nullptr;
 	// Cration du sous passe de rendu
 	auto dependency = VkSubpassDependency{};
 	dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
@@ -532,53 +1387,90 @@ void CVulkanApplication::createRenderPass() {
 	dependency.srcAccessMask = 0;
 	dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
 	dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	if (m_depth.enabled) {
+		// L'attachement de profondeur est partag : les tests de la render pass prcdente doivent tre termins.
+		// Les deux tapes des tests de chaque ct : l'criture peut avoir lieu dans l'une ou l'autre, et l'effacement
+		// (loadOp) se fait dans EARLY_FRAGMENT_TESTS
+		constexpr VkPipelineStageFlags depthStages = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+		dependency.srcStageMask |= depthStages;
+		dependency.srcAccessMask |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+		dependency.dstStageMask |= depthStages;
+		dependency.dstAccessMask |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+	}
 	// Cration du passe de rendu
+	const VkAttachmentDescription attachments[] = {colorAttachment, depthAttachment};
 	auto renderPassInfo = VkRenderPassCreateInfo{};
 	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-	renderPassInfo.attachmentCount = 1;
-	renderPassInfo.pAttachments = &colorAttachment;
+	renderPassInfo.attachmentCount = m_depth.enabled ? 2 : 1;
+	renderPassInfo.pAttachments = attachments;
 	renderPassInfo.subpassCount = 1;
 	renderPassInfo.pSubpasses = &subpass;
 	renderPassInfo.dependencyCount = 1;
 	renderPassInfo.pDependencies = &dependency;
-	if (vkCreateRenderPass(m_device, &renderPassInfo, nullptr, &m_renderPass) != VK_SUCCESS) {
+	if (vkCreateRenderPass(m_device, &renderPassInfo, m_allocator, &m_renderPass) != VK_SUCCESS) {
 		throw std::runtime_error("Failed to create render pass");
 	}
+	m_renderPassFormat = m_swapChainImageFormat;
 }
 
 void CVulkanApplication::createFramebuffers() {
 	m_swapChainFramebuffers.resize(m_swapChainImagesViews.size());
 	for (size_t i = 0; i < m_swapChainImagesViews.size(); i++) {
-		VkImageView attachments[] = {m_swapChainImagesViews[i]};
+		VkImageView attachments[] = {m_swapChainImagesViews[i], m_depthBuffer.view()};
 		auto framebufferInfo = VkFramebufferCreateInfo{};
 		framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
 		framebufferInfo.renderPass = m_renderPass;
-		framebufferInfo.attachmentCount = 1;
+		framebufferInfo.attachmentCount = m_depth.enabled ? 2 : 1;
 		framebufferInfo.pAttachments = attachments;
 		framebufferInfo.width = m_swapChainExtent.width;
 		framebufferInfo.height = m_swapChainExtent.height;
 		framebufferInfo.layers = 1;
 
-		if (vkCreateFramebuffer(m_device, &framebufferInfo, nullptr, &m_swapChainFramebuffers[i]) != VK_SUCCESS) {
+		if (vkCreateFramebuffer(m_device, &framebufferInfo, m_allocator, &m_swapChainFramebuffers[i]) != VK_SUCCESS) {
 			throw std::runtime_error("Failed to create a framebuffer");
 		}
 	}
 }
 
+void CVulkanApplication::createDepthBuffer() {
+	if (!m_depth.enabled) { return; }
+	// Assez grand pour la fentre principale et chaque sortie supplmentaire (leurs swapchains sont cres ensuite)
+	auto extent = m_swapChainExtent;
+	for (const auto& output : m_extraOutputs) {
+		const auto outputExtent = chooseSwapExtent(querySwapChainSupport(m_physicalDevice, output.surface).capabilities,
+		                                           output.framebufferExtent);
+		extent.width = std::max(extent.width, outputExtent.width);
+		extent.height = std::max(extent.height, outputExtent.height);
+	}
+	m_depthBuffer.init(deviceContext(), m_depthFormat, extent);
+	CLogger::log(LogLevel::Info, "Depth", "Depth buffer " + std::to_string(extent.width) + "x" + std::to_string(extent.height)
+	             + (m_depthBuffer.lazilyAllocated() ? " (lazily allocated)" : ""));
+}
+
+void CVulkanApplication::createFragmentCounter() {
+	if (!m_settings.countFragments) { return; }
+	if (!m_enabledFeatures.pipelineStatisticsQuery) {
+		CLogger::log(LogLevel::Warning, "Depth", "Pipeline statistics queries are not supported: fragment invocations not counted");
+		return;
+	}
+	m_fragmentCounter.init(deviceContext(), MAX_FRAMES_IN_FLIGHTS);
+}
+
 void CVulkanApplication::createCommandPool() {
 	const auto queueFamilyIndices = findQueueFamilies(m_physicalDevice);
 	auto poolInfo = VkCommandPoolCreateInfo{};
 	poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
 	poolInfo.queueFamilyIndex = queueFamilyIndices.graphicsFamily.value();
-	poolInfo.flags = 0;
-	if (vkCreateCommandPool(m_device, &poolInfo, nullptr, &m_commandPool) != VK_SUCCESS) {
+	// Command buffers renregistrs individuellement lorsque de nouvelles variantes de pipeline sont prtes
+	poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+	if (vkCreateCommandPool(m_device, &poolInfo, m_allocator, &m_commandPool) != VK_SUCCESS) {
 		throw std::runtime_error("Failed to create a command pool");
 	}
 }
 
 void CVulkanApplication::createCommandBuffers() {
 	// Allocation des commands buffers
-	m_commandBuffers.resize(m_swapChainFramebuffers.size());
+	m_commandBuffers.resize(m_swapChainFramebuffers.size() * MAX_FRAMES_IN_FLIGHTS);
 	auto allocInfo = VkCommandBufferAllocateInfo{};
 	allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
 	allocInfo.commandPool = m_commandPool;
@@ -587,38 +1479,106 @@ void CVulkanApplication::createCommandBuffers() {
 	if (vkAllocateCommandBuffers(m_device, &allocInfo, m_commandBuffers.data()) != VK_SUCCESS) {
 		throw std::runtime_error("Failed to allocate a command buffer");
 	}
+	m_commandBufferGenerations.assign(m_commandBuffers.size(), 0);
 	// Dbut des enregistrments des command buffers
 	for (size_t i = 0; i < m_commandBuffers.size(); i++) {
-		auto beginInfo = VkCommandBufferBeginInfo{};
-		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT; // Peut tre renvoy alors qu'il est en cours d'excution
-		beginInfo.pInheritanceInfo = nullptr;
-		if (vkBeginCommandBuffer(m_commandBuffers[i], &beginInfo) != VK_SUCCESS) {
-			throw std_err("Failed to begin a command buffer");
-		}
-		// Dbut de la render pass
-		auto renderPassInfo = VkRenderPassBeginInfo{};
-		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-		renderPassInfo.renderPass = m_renderPass;
-		renderPassInfo.framebuffer = m_swapChainFramebuffers[i];
-		// Dfinissent la taille du rendu
-		renderPassInfo.renderArea.offset = { 0, 0 };
-		renderPassInfo.renderArea.extent = m_swapChainExtent;
-		auto clearColor = VkClearValue{ 0.0f, 0.0f, 0.0f, 1.0f };
-		renderPassInfo.clearValueCount = 1;
-		renderPassInfo.pClearValues = &clearColor;
-		vkCmdBeginRenderPass(m_commandBuffers[i], &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
-		// Activation de la pipeline graphique
-		vkCmdBindPipeline(m_commandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline);
-		// Affichage du triangle
-		vkCmdDraw(m_commandBuffers[i], 3, 1, 0, 0);
-		// Fin de l'affichage
-		vkCmdEndRenderPass(m_commandBuffers[i]);
-		if(vkEndCommandBuffer(m_commandBuffers[i]) != VK_SUCCESS) {
-			throw std_err("Failed to end a command a buffer");
-		}
+		recordCommandBuffer(i);
 	}
+}
 
+void CVulkanApplication::recordCommandBuffer(size_t i) {
+	const auto image = i / MAX_FRAMES_IN_FLIGHTS;
+	const auto frame = static_cast<uint32_t>(i % MAX_FRAMES_IN_FLIGHTS);
+	// Lue avant l'enregistrement : une variante publie pendant celui-ci provoquera un nouvel enregistrement
+	m_commandBufferGenerations[i] = m_pipelineVariants.generation();
+	auto beginInfo = VkCommandBufferBeginInfo{};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT; // Peut tre renvoy alors qu'il est en cours d'excution
+	beginInfo.pInheritanceInfo = nullptr;
+	if (m_dispatch.BeginCommandBuffer(m_commandBuffers[i], &beginInfo) != VK_SUCCESS) {
+		throw std_err("Failed to begin a command buffer");
+	}
+	m_commandTrace.beginCommandBuffer(m_commandBuffers[i]);
+	// Simulation des particules avant la render pass (dispatch interdit  l'intrieur)
+	if (m_particles.isActive()) { m_particles.recordUpdate(m_commandBuffers[i], static_cast<uint32_t>(i)); }
+	// Rpartition des lumires de la frame avant les dessins qui lisent les listes des clusters
+	if (m_lighting.isActive()) { m_lighting.recordCulling(m_commandBuffers[i], frame); }
+	// Invocations du fragment shader comptes sur la render pass de la fentre principale seule
+	if (m_fragmentCounter.isActive()) { m_fragmentCounter.recordBegin(m_commandBuffers[i], frame); }
+	recordRenderPass(m_commandBuffers[i], m_swapChainFramebuffers[image], m_swapChainExtent, frame);
+	if (m_fragmentCounter.isActive()) { m_fragmentCounter.recordEnd(m_commandBuffers[i], frame); }
+	if (m_lighting.isActive()) { m_lighting.recordShadingEnd(m_commandBuffers[i], frame); }
+	if(m_dispatch.EndCommandBuffer(m_commandBuffers[i]) != VK_SUCCESS) {
+		throw std_err("Failed to end a command a buffer");
+	}
+	m_commandTrace.endCommandBuffer();
+}
+
+void CVulkanApplication::recordOutputCommandBuffer(OutputSurface& output, size_t i) {
+	const auto image = i / MAX_FRAMES_IN_FLIGHTS;
+	const auto frame = static_cast<uint32_t>(i % MAX_FRAMES_IN_FLIGHTS);
+	output.commandBufferGenerations[i] = m_pipelineVariants.generation();
+	auto beginInfo = VkCommandBufferBeginInfo{};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
+	if (m_dispatch.BeginCommandBuffer(output.commandBuffers[i], &beginInfo) != VK_SUCCESS) {
+		throw std_err("Failed to begin a command buffer");
+	}
+	m_commandTrace.beginCommandBuffer(output.commandBuffers[i]);
+	// Pas de simulation ici : elle est enregistre dans le command buffer de la fentre principale, soumis avant
+	recordRenderPass(output.commandBuffers[i], output.framebuffers[image], output.extent, frame);
+	if (m_dispatch.EndCommandBuffer(output.commandBuffers[i]) != VK_SUCCESS) {
+		throw std_err("Failed to end a command a buffer");
+	}
+	m_commandTrace.endCommandBuffer();
+}
+
+void CVulkanApplication::recordRenderPass(VkCommandBuffer commandBuffer, VkFramebuffer framebuffer, VkExtent2D extent, uint32_t frame) {
+	// Dbut de la render pass
+	auto renderPassInfo = VkRenderPassBeginInfo{};
+	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+	renderPassInfo.renderPass = m_renderPass;
+	renderPassInfo.framebuffer = framebuffer;
+	// Dfinissent la taille du rendu
+	renderPassInfo.renderArea.offset = { 0, 0 };
+	renderPassInfo.renderArea.extent = extent;
+	auto clearColor = VkClearValue{ 0.0f, 0.0f, 0.0f, 1.0f };
+	auto clearDepth = VkClearValue{};
+	clearDepth.depthStencil = { m_depth.clearDepth(), 0 };
+	const VkClearValue clearValues[] = {clearColor, clearDepth};
+	renderPassInfo.clearValueCount = m_depth.enabled ? 2 : 1;
+	renderPassInfo.pClearValues = clearValues;
+	m_dispatch.CmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+	m_commandTrace.beginRenderPass(extent, clearColor);
+	auto viewport = VkViewport{ 0.0f, 0.0f, static_cast<float>(extent.width), static_cast<float>(extent.height), 0.0f, 1.0f };
+	m_dispatch.CmdSetViewport(commandBuffer, 0, 1, &viewport);
+	m_commandTrace.setViewport(viewport);
+	auto scissor = VkRect2D{ { 0, 0 }, extent };
+	m_dispatch.CmdSetScissor(commandBuffer, 0, 1, &scissor);
+	m_commandTrace.setScissor(scissor);
+	recordScene(commandBuffer, frame);
+	// Fin de l'affichage
+	m_dispatch.CmdEndRenderPass(commandBuffer);
+	m_commandTrace.endRenderPass();
+}
+
+void CVulkanApplication::recordScene(VkCommandBuffer commandBuffer, uint32_t frame) {
+	if (m_particles.isActive()) {
+		m_particles.recordDraw(commandBuffer);
+		return;
+	}
+	if (m_lodRenderer.isActive()) {
+		m_lodRenderer.recordDraw(commandBuffer, frame, m_instanceBuffers[frame], LodView::forExtent(m_swapChainExtent, m_depth.reverseZ),
+		                         m_lighting.isActive() ? m_lighting.descriptorSet(frame) : VK_NULL_HANDLE);
+		return;
+	}
+	// Activation de la pipeline graphique (gnrique tant que la variante demande n'est pas compile)
+	const auto pipeline = m_pipelineVariants.pipeline(m_settings.triangleVariant);
+	m_dispatch.CmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+	m_commandTrace.bindPipeline(pipeline, pipeline == m_pipelineVariants.fallback() ? nullptr : &m_settings.triangleVariant);
+	// Affichage du triangle
+	m_dispatch.CmdDraw(commandBuffer, 3, 1, 0, 0);
+	m_commandTrace.draw(3, 1, 0, 0);
 }
 
 void CVulkanApplication::createSyncObjects() {
@@ -631,16 +1591,116 @@ void CVulkanApplication::createSyncObjects() {
 	fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
 	fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
 	for(size_t i = 0; i < MAX_FRAMES_IN_FLIGHTS; i++) {
-		if (vkCreateSemaphore(m_device, &semaphoreInfo, nullptr, &m_imageAvailableSemaphores[i]) != VK_SUCCESS ||
-			vkCreateSemaphore(m_device, &semaphoreInfo, nullptr, &m_renderFinishedSemaphores[i]) != VK_SUCCESS ||
-			vkCreateFence(m_device, &fenceInfo, nullptr, &m_inFlightFences[i])) {
+		if (vkCreateSemaphore(m_device, &semaphoreInfo, m_allocator, &m_imageAvailableSemaphores[i]) != VK_SUCCESS ||
+			vkCreateSemaphore(m_device, &semaphoreInfo, m_allocator, &m_renderFinishedSemaphores[i]) != VK_SUCCESS ||
+			vkCreateFence(m_device, &fenceInfo, m_allocator, &m_inFlightFences[i])) {
 			throw std_err("Failed to create syncronization objects");
 		}
 	}
 
 }
 
-std::vector<const char*> CVulkanApplication::getRequiredExtensions() {
+void CVulkanApplication::createInstanceBuffers(size_t capacity) {
+	m_instanceCapacity = capacity;
+	m_instanceBuffers.resize(MAX_FRAMES_IN_FLIGHTS);
+	m_instanceBuffersMemory.resize(MAX_FRAMES_IN_FLIGHTS);
+	m_instanceBuffersMapped.resize(MAX_FRAMES_IN_FLIGHTS);
+	// Gnration 0 : la premire criture sera une copie complte
+	m_instanceBuffersGeneration.assign(MAX_FRAMES_IN_FLIGHTS, 0);
+	const auto size = static_cast<VkDeviceSize>(capacity * sizeof(Mat4));
+	// Absents de la trace : les commandes captures (scne triangle) ne lient jamais ces buffers, seuls ceux lis par
+	// une commande trace y sont crits
+	for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHTS; i++) {
+		// Mmoire visible par le CPU : les matrices modifies sont crites directement, sans staging
+		createBuffer(deviceContext(), size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+		             VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+		             m_instanceBuffers[i], m_instanceBuffersMemory[i], MemoryCategory::Buffer);
+		void* data;
+		vkMapMemory(m_device, m_instanceBuffersMemory[i], 0, size, 0, &data);
+		m_instanceBuffersMapped[i] = static_cast<Mat4*>(data);
+	}
+}
+
+void CVulkanApplication::destroyInstanceBuffers() {
+	for (size_t i = 0; i < m_instanceBuffers.size(); i++) {
+		vkUnmapMemory(m_device, m_instanceBuffersMemory[i]);
+		destroyBuffer(deviceContext(), m_instanceBuffers[i], m_instanceBuffersMemory[i]);
+	}
+	m_instanceBuffers.clear();
+	m_instanceBuffersMemory.clear();
+	m_instanceBuffersMapped.clear();
+}
+
+void CVulkanApplication::simulate(FrameSnapshot& snapshot, uint64_t frameNumber) {
+	snapshot.frameNumber = frameNumber;
+	snapshot.time = m_settings.fixedFrameTime > 0.0
+		? static_cast<double>(frameNumber) * m_settings.fixedFrameTime
+		: std::chrono::duration<double>(std::chrono::steady_clock::now() - m_startTime).count();
+	// Scne  niveaux de dtail : la grille avance et recule devant la camra
+	if (m_lodRoot != INVALID_NODE) {
+		m_scene.setLocalTranslation(m_lodRoot, { 0.0f, 0.0f, 30.0f * static_cast<float>(std::sin(snapshot.time * 0.5)) - 20.0f });
+	}
+	// Seuls les sous-arbres modifis sont recalculs
+	m_scene.update(m_jobSystem);
+	// Le tampon reu contient une publication plus ancienne : seules les matrices modifies depuis sont recopies
+	if (snapshot.instances.size() != m_scene.size()) {
+		snapshot.instances.resize(m_scene.size());
+		snapshot.sceneGeneration = 0;
+	}
+	m_scene.writeInstances(snapshot.instances.data(), snapshot.sceneGeneration);
+	// Le buffer d'instances d'une frame en vol a quelques gnrations de retard : seules les matrices modifies
+	// depuis y seront recopies
+	snapshot.changedInstances.clear();
+	snapshot.changesSince = snapshot.sceneGeneration > MAX_FRAMES_IN_FLIGHTS ? snapshot.sceneGeneration - MAX_FRAMES_IN_FLIGHTS : 0;
+	if (!m_scene.changedSince(snapshot.changesSince, snapshot.changedInstances)) {
+		snapshot.changedInstances.clear();
+		snapshot.changesSince = snapshot.sceneGeneration;
+	}
+	// GLFW n'est interrog que par le thread principal
+	if (!m_settings.headless) {
+		int width = 0, height = 0;
+		glfwGetFramebufferSize(m_window, &width, &height);
+		snapshot.framebufferExtent = { static_cast<uint32_t>(width), static_cast<uint32_t>(height) };
+		snapshot.outputExtents.resize(m_extraOutputs.size());
+		for (size_t i = 0; i < m_extraOutputs.size(); i++) {
+			glfwGetFramebufferSize(m_extraOutputs[i].window, &width, &height);
+			snapshot.outputExtents[i] = { static_cast<uint32_t>(width), static_cast<uint32_t>(height) };
+		}
+	}
+}
+
+void CVulkanApplication::uploadInstances(const FrameSnapshot& snapshot) {
+	if (snapshot.instances.size() > m_instanceCapacity) {
+		// Rare : on attend que les autres frames aient fini d'utiliser les anciens buffers
+		vkDeviceWaitIdle(m_device);
+		destroyInstanceBuffers();
+		createInstanceBuffers(std::max(snapshot.instances.size(), m_instanceCapacity * 2));
+		// Les command buffers pr-enregistrs rfrencent les anciens buffers
+		vkFreeCommandBuffers(m_device, m_commandPool, static_cast<uint32_t>(m_commandBuffers.size()), m_commandBuffers.data());
+		createCommandBuffers();
+	}
+	// Une gnration identique garantit un contenu identique : rien  copier
+	auto& generation = m_instanceBuffersGeneration[m_currentFrame];
+	if (generation == snapshot.sceneGeneration) { return; }
+	auto* mapped = m_instanceBuffersMapped[m_currentFrame];
+	if (generation >= snapshot.changesSince) {
+		// Seules les matrices modifies depuis la dernire criture de ce buffer
+		for (const auto i : snapshot.changedInstances) {
+			mapped[i] = snapshot.instances[i];
+		}
+	}
+	else {
+		std::memcpy(mapped, snapshot.instances.data(), snapshot.instances.size() * sizeof(Mat4));
+	}
+	generation = snapshot.sceneGeneration;
+}
+
+std::vector<const char*> CVulkanApplication::getRequiredExtensions() const {
+	if (m_settings.headless) {
+		auto extensions = std::vector<const char*>{ VK_KHR_SURFACE_EXTENSION_NAME, VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME };
+		if (enableValidationLayers) { extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME); }
+		return extensions;
+	}
 	uint32_t glfwExtensionCount = 0;
 	// pointeur pointant sur un pointeur qui pointe un const char
 	const auto glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
@@ -673,7 +1733,10 @@ int CVulkanApplication::rateDeviceSuitability(const VkPhysicalDevice device) {
 	if (!deviceFeatures.geometryShader || !findQueueFamilies(device).isComplete()
 		|| !extensionsSupported
 		|| !swapChainAdequate) { return 0; }
-	std::cout << "Scored " << std::to_string(score) << " for device: " << deviceProperties.deviceName << std::endl;
+	// Carte impose (ex: driver logiciel pour les tests de rgression)
+	if (!m_settings.deviceFilter.empty()
+		&& std::string{deviceProperties.deviceName}.find(m_settings.deviceFilter) == std::string::npos) { return 0; }
+	CLogger::log(LogLevel::Info, "Device", "Scored " + std::to_string(score) + " for device: " + deviceProperties.deviceName);
 	return score;
 }
 
@@ -732,20 +1795,21 @@ QueueFamilyIndices CVulkanApplication::findQueueFamilies(VkPhysicalDevice device
 	return indices;
 }
 
-SwapChainSupportDetails CVulkanApplication::querySwapChainSupport(VkPhysicalDevice device) const {
+SwapChainSupportDetails CVulkanApplication::querySwapChainSupport(VkPhysicalDevice device, VkSurfaceKHR surface) const {
+	if (surface == VK_NULL_HANDLE) { surface = m_surface; }
 	SwapChainSupportDetails details;
-	vkGetPhysicalDeviceSurfaceCapabilitiesKHR(device, m_surface, &details.capabilities);
+	vkGetPhysicalDeviceSurfaceCapabilitiesKHR(device, surface, &details.capabilities);
 	uint32_t formatCount;
-	vkGetPhysicalDeviceSurfaceFormatsKHR(device, m_surface, &formatCount, nullptr);
+	vkGetPhysicalDeviceSurfaceFormatsKHR(device, surface, &formatCount, nullptr);
 	if (formatCount != 0) {
 		details.formats.resize(formatCount);
-		vkGetPhysicalDeviceSurfaceFormatsKHR(device, m_surface, &formatCount, details.formats.data());
+		vkGetPhysicalDeviceSurfaceFormatsKHR(device, surface, &formatCount, details.formats.data());
 	}
 	uint32_t presentModeCount;
-	vkGetPhysicalDeviceSurfacePresentModesKHR(device, m_surface, &presentModeCount, nullptr);
+	vkGetPhysicalDeviceSurfacePresentModesKHR(device, surface, &presentModeCount, nullptr);
 	if (presentModeCount != 0) {
 		details.presentModes.resize(presentModeCount);
-		vkGetPhysicalDeviceSurfacePresentModesKHR(device, m_surface, &presentModeCount, details.presentModes.data());
+		vkGetPhysicalDeviceSurfacePresentModesKHR(device, surface, &presentModeCount, details.presentModes.data());
 	}
 	return details;
 }
@@ -766,16 +1830,14 @@ VkPresentModeKHR CVulkanApplication::chooseSwapPresentMode(const std::vector<VkP
 	return VK_PRESENT_MODE_FIFO_KHR;
 }
 
-VkExtent2D CVulkanApplication::chooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabilities) const {
+VkExtent2D CVulkanApplication::chooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabilities, VkExtent2D framebufferExtent) const {
 	if (capabilities.currentExtent.width != std::numeric_limits<uint32_t>::max()) {
 		return capabilities.currentExtent;
 	}
-	int width, height;
-	glfwGetFramebufferSize(m_window, &width, &height);
-	VkExtent2D actualExtent = {
-		static_cast<uint32_t>(width),
-		static_cast<uint32_t>(height)
-	};
+	// La surface headless n'impose pas de taille : on garde celle des options.
+	// Fentres : taille lue par le thread principal (GLFW n'est pas appel par le thread de rendu, qui peut recrer
+	// les swapchains)
+	VkExtent2D actualExtent = m_settings.headless ? VkExtent2D{ m_settings.width, m_settings.height } : framebufferExtent;
 	actualExtent.width = std::max(capabilities.minImageExtent.width,
 	                            std::min(capabilities.maxImageExtent.width, actualExtent.width));
 	actualExtent.height = std::max(capabilities.minImageExtent.height,
@@ -789,7 +1851,7 @@ VkShaderModule CVulkanApplication::createShaderModule(const std::vector<char>& c
 	createInfo.codeSize = code.size();
 	createInfo.pCode = reinterpret_cast<const uint32_t*>(code.data());
 	VkShaderModule shaderModule;
-	if (vkCreateShaderModule(m_device, &createInfo, nullptr, &shaderModule) != VK_SUCCESS) {
+	if (vkCreateShaderModule(m_device, &createInfo, m_allocator, &shaderModule) != VK_SUCCESS) {
 		throw std::runtime_error("Failed to create a shader module");
 	}
 	return shaderModule;
@@ -800,6 +1862,11 @@ VKAPI_ATTR VkBool32 VKAPI_CALL CVulkanApplication::debugCallback(VkDebugUtilsMes
                                                                  const VkDebugUtilsMessengerCallbackDataEXT*
                                                                  pCallbackData,
                                                                  void* pUserdata) {
-	std::cerr << "validation layer: " << pCallbackData->pMessage << std::endl;
+	// Appel sur le thread du driver : simple copie dans la file du logger
+	auto level = LogLevel::Verbose;
+	if (messageSeverity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT) { level = LogLevel::Error; }
+	else if (messageSeverity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT) { level = LogLevel::Warning; }
+	else if (messageSeverity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT) { level = LogLevel::Info; }
+	CLogger::log(level, "Validation", pCallbackData->pMessage, pCallbackData->messageIdNumber);
 	return VK_FALSE;
 }
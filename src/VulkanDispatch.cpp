@@ -0,0 +1,19 @@
+#include <VulkanDispatch.h>
+#include <stdexcept>
+#include <string>
+
+void InstanceDispatch::load(VkInstance instance) {
+#define VULKAN_LOAD_INSTANCE_FUNCTION(name) name = reinterpret_cast<PFN_vk##name>(vkGetInstanceProcAddr(instance, "vk" #name));
+	VULKAN_INSTANCE_FUNCTIONS(VULKAN_LOAD_INSTANCE_FUNCTION)
+#undef VULKAN_LOAD_INSTANCE_FUNCTION
+	if (GetDeviceProcAddr == nullptr) { throw std::runtime_error("Failed to load vkGetDeviceProcAddr"); }
+}
+
+void DeviceDispatch::load(const InstanceDispatch& instance, VkDevice loadedDevice) {
+	device = loadedDevice;
+#define VULKAN_LOAD_DEVICE_FUNCTION(name) \
+	name = reinterpret_cast<PFN_vk##name>(instance.GetDeviceProcAddr(device, "vk" #name)); \
+	if (name == nullptr) { throw std::runtime_error("Failed to load vk" #name); }
+	VULKAN_DEVICE_FUNCTIONS(VULKAN_LOAD_DEVICE_FUNCTION)
+#undef VULKAN_LOAD_DEVICE_FUNCTION
+}
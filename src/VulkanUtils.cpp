@@ -0,0 +1,165 @@
+#include <VulkanUtils.h>
+#include <cstring>
+#include <stdexcept>
+
+uint32_t findMemoryType(VkPhysicalDevice physicalDevice, uint32_t typeFilter, VkMemoryPropertyFlags properties) {
+	VkPhysicalDeviceMemoryProperties memoryProperties;
+	vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+	for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++) {
+		if ((typeFilter & (1 << i)) && (memoryProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+			return i;
+		}
+	}
+	throw std::runtime_error("Failed to find a suitable memory type");
+}
+
+void createBuffer(const DeviceContext& context, VkDeviceSize size, VkBufferUsageFlags usage,
+                  VkMemoryPropertyFlags properties, VkBuffer& buffer, VkDeviceMemory& bufferMemory,
+                  MemoryCategory category) {
+	auto bufferInfo = VkBufferCreateInfo{};
+	bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	bufferInfo.size = size;
+	bufferInfo.usage = usage;
+	bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	if (vkCreateBuffer(context.device, &bufferInfo, context.allocator, &buffer) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create a buffer");
+	}
+	VkMemoryRequirements memoryRequirements;
+	vkGetBufferMemoryRequirements(context.device, buffer, &memoryRequirements);
+	auto allocInfo = VkMemoryAllocateInfo{};
+	allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	allocInfo.allocationSize = memoryRequirements.size;
+	try {
+		allocInfo.memoryTypeIndex = findMemoryType(context.physicalDevice, memoryRequirements.memoryTypeBits, properties);
+	}
+	catch (const std::runtime_error&) {
+		vkDestroyBuffer(context.device, buffer, context.allocator);
+		buffer = VK_NULL_HANDLE;
+		throw;
+	}
+	if (allocateMemory(context, allocInfo, category, &bufferMemory) != VK_SUCCESS) {
+		vkDestroyBuffer(context.device, buffer, context.allocator);
+		buffer = VK_NULL_HANDLE;
+		throw std::runtime_error("Failed to allocate buffer memory");
+	}
+	vkBindBufferMemory(context.device, buffer, bufferMemory, 0);
+}
+
+VkResult allocateMemory(const DeviceContext& context, const VkMemoryAllocateInfo& allocInfo, MemoryCategory category,
+                        VkDeviceMemory* memory) {
+	if (context.telemetry != nullptr) {
+		return context.telemetry->allocate(context.device, allocInfo, category, context.allocator, memory);
+	}
+	return vkAllocateMemory(context.device, &allocInfo, context.allocator, memory);
+}
+
+void freeMemory(const DeviceContext& context, VkDeviceMemory memory) {
+	if (context.telemetry != nullptr) { context.telemetry->release(context.device, memory, context.allocator); }
+	else { vkFreeMemory(context.device, memory, context.allocator); }
+}
+
+void destroyBuffer(const DeviceContext& context, VkBuffer buffer, VkDeviceMemory memory) {
+	vkDestroyBuffer(context.device, buffer, context.allocator);
+	freeMemory(context, memory);
+}
+
+void createImage(const DeviceContext& context, VkExtent2D extent, VkFormat format, VkImageUsageFlags usage,
+                 VkMemoryPropertyFlags properties, VkImage& image, VkDeviceMemory& imageMemory,
+                 MemoryCategory category, uint32_t arrayLayers) {
+	auto imageInfo = VkImageCreateInfo{};
+	imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+	imageInfo.imageType = VK_IMAGE_TYPE_2D;
+	imageInfo.format = format;
+	imageInfo.extent = { extent.width, extent.height, 1 };
+	imageInfo.mipLevels = 1;
+	imageInfo.arrayLayers = arrayLayers;
+	imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+	imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+	imageInfo.usage = usage;
+	imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	if (vkCreateImage(context.device, &imageInfo, context.allocator, &image) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create an image");
+	}
+	VkMemoryRequirements memoryRequirements;
+	vkGetImageMemoryRequirements(context.device, image, &memoryRequirements);
+	auto allocInfo = VkMemoryAllocateInfo{};
+	allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	allocInfo.allocationSize = memoryRequirements.size;
+	try {
+		allocInfo.memoryTypeIndex = findMemoryType(context.physicalDevice, memoryRequirements.memoryTypeBits, properties);
+	}
+	catch (const std::runtime_error&) {
+		vkDestroyImage(context.device, image, context.allocator);
+		image = VK_NULL_HANDLE;
+		throw;
+	}
+	if (allocateMemory(context, allocInfo, category, &imageMemory) != VK_SUCCESS) {
+		vkDestroyImage(context.device, image, context.allocator);
+		image = VK_NULL_HANDLE;
+		throw std::runtime_error("Failed to allocate image memory");
+	}
+	vkBindImageMemory(context.device, image, imageMemory, 0);
+}
+
+void destroyImage(const DeviceContext& context, VkImage image, VkDeviceMemory memory) {
+	vkDestroyImage(context.device, image, context.allocator);
+	freeMemory(context, memory);
+}
+
+void uploadToBuffer(const DeviceContext& context, uint32_t queueFamily, VkQueue queue, VkBuffer buffer,
+                    const void* data, VkDeviceSize size) {
+	VkBuffer stagingBuffer;
+	VkDeviceMemory stagingMemory;
+	createBuffer(context, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+	             VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+	             stagingBuffer, stagingMemory, MemoryCategory::Staging);
+	void* mapped;
+	vkMapMemory(context.device, stagingMemory, 0, size, 0, &mapped);
+	std::memcpy(mapped, data, static_cast<size_t>(size));
+	vkUnmapMemory(context.device, stagingMemory);
+	auto poolInfo = VkCommandPoolCreateInfo{};
+	poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+	poolInfo.queueFamilyIndex = queueFamily;
+	VkCommandPool commandPool;
+	if (vkCreateCommandPool(context.device, &poolInfo, context.allocator, &commandPool) != VK_SUCCESS) {
+		destroyBuffer(context, stagingBuffer, stagingMemory);
+		throw std::runtime_error("Failed to create an upload command pool");
+	}
+	auto allocInfo = VkCommandBufferAllocateInfo{};
+	allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	allocInfo.commandPool = commandPool;
+	allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	allocInfo.commandBufferCount = 1;
+	VkCommandBuffer commandBuffer;
+	vkAllocateCommandBuffers(context.device, &allocInfo, &commandBuffer);
+	auto beginInfo = VkCommandBufferBeginInfo{};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	vkBeginCommandBuffer(commandBuffer, &beginInfo);
+	auto region = VkBufferCopy{ 0, 0, size };
+	vkCmdCopyBuffer(commandBuffer, stagingBuffer, buffer, 1, &region);
+	vkEndCommandBuffer(commandBuffer);
+	auto submitInfo = VkSubmitInfo{};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &commandBuffer;
+	const auto result = vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE);
+	vkQueueWaitIdle(queue);
+	vkDestroyCommandPool(context.device, commandPool, context.allocator);
+	destroyBuffer(context, stagingBuffer, stagingMemory);
+	if (result != VK_SUCCESS) { throw std::runtime_error("Failed to upload a buffer"); }
+}
+
+VkShaderModule createShaderModule(const DeviceContext& context, const std::vector<char>& code) {
+	auto createInfo = VkShaderModuleCreateInfo{};
+	createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+	createInfo.codeSize = code.size();
+	createInfo.pCode = reinterpret_cast<const uint32_t*>(code.data());
+	VkShaderModule shaderModule;
+	if (vkCreateShaderModule(context.device, &createInfo, context.allocator, &shaderModule) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create a shader module");
+	}
+	return shaderModule;
+}
@@ -1,12 +1,203 @@
 #include <VulkanApplication.h>
+#include <Benchmarks.h>
+#include <algorithm>
 #include <iostream>
+#include <stdexcept>
+#include <string>
 
-int main() {
-	auto app = CVulkanApplication{};
+namespace {
+	void printUsage(const char* program) {
+		std::cerr << "Usage: " << program << " [options]\n"
+			"  Scenes: --particles [count] [--workgroup-size n] | --lod [count] [--no-lod-selection] [--no-frustum-culling]\n"
+			"          --lights [count] [--lights-brute-force] | --color-mode n [--gamma]\n"
+			"  Depth: --depth | --no-depth | --no-reverse-z | --depth-prepass | --fragment-stats\n"
+			"  Rendering: --headless | --on-demand [seconds] | --outputs n | --multiview [views] [--multiview-passes]\n"
+			"             --post-process [blur,bloom,tonemap,grade] [--post-process-unfused] | --dynamic-resolution [ms]\n"
+			"  Capture: --capture [directory] [--capture-format ppm|raw] [--capture-lossless] | --trace file\n"
+			"  Streaming: --stream file | --stream-backend io_uring|threads | --stream-queue-depth n\n"
+			"  Benchmarks: --bench-culling | --bench-streaming file | --bench-particles | --bench-lod | --bench-lights\n"
+			"              --bench-multiview | --bench-post-process | --bench-depth\n"
+			"  Diagnostics: --memory-report | --no-host-allocator | --host-allocator-report\n"
+			"               --log-level verbose|info|warning|error | --log-mute id" << std::endl;
+	}
+}
+
+int main(int argc, char** argv) {
+	// Benchmarks CPU : ne ncessitent pas de fentre ni de contexte Vulkan
+	if (argc > 1 && std::string{argv[1]} == "--bench-culling") { return runCullingBenchmark(); }
+	if (argc > 2 && std::string{argv[1]} == "--bench-streaming") { return runStreamingBenchmark(argv[2]); }
+	auto settings = ApplicationSettings{};
+	auto particleBenchmark = false;
+	auto lodBenchmark = false;
+	auto lightingBenchmark = false;
+	auto multiviewBenchmark = false;
+	auto postProcessBenchmark = false;
+	auto depthBenchmark = false;
+	// Valeurs numriques invalides (std::stoul, std::stof, std::stod) : usage au lieu d'une exception non rattrape
+	int i = 1;
+	try {
+		for (; i < argc; i++) {
+			const auto arg = std::string{argv[i]};
+			if (arg == "--capture") {
+				settings.captureFrames = true;
+				if (i + 1 < argc && argv[i + 1][0] != '-') { settings.captureDirectory = argv[++i]; }
+			}
+			else if (arg == "--capture-format" && i + 1 < argc) {
+				settings.captureFormat = std::string{argv[++i]} == "raw" ? CaptureFormat::Raw : CaptureFormat::PPM;
+			}
+			// Aucune frame ignore : le rendu attend l'criture des captures
+			else if (arg == "--capture-lossless") { settings.captureLossless = true; }
+			else if (arg == "--headless") { settings.headless = true; }
+			// Rendu  la demande : une frame seulement quand l'image change, rafrachissement priodique en secondes (optionnel)
+			else if (arg == "--on-demand") {
+				settings.onDemand = true;
+				if (i + 1 < argc && argv[i + 1][0] != '-') { settings.onDemandRefreshInterval = std::stod(argv[++i]); }
+			}
+			// Trace binaire du flux de commandes, rejoue par l'outil TraceReplay
+			else if (arg == "--trace" && i + 1 < argc) { settings.commandTrace = argv[++i]; }
+			// Fentres (ou surfaces headless) supplmentaires rendues et prsentes avec la fentre principale
+			else if (arg == "--outputs" && i + 1 < argc) {
+				settings.outputCount = std::max(1u, static_cast<uint32_t>(std::stoul(argv[++i])));
+			}
+			else if (arg == "--particles") {
+				settings.scene = SceneType::Particles;
+				// Nombre de particules (optionnel)
+				if (i + 1 < argc && argv[i + 1][0] != '-') { settings.particleSettings.count = static_cast<uint32_t>(std::stoul(argv[++i])); }
+			}
+			else if (arg == "--workgroup-size" && i + 1 < argc) {
+				settings.particleSettings.workgroupSize = static_cast<uint32_t>(std::stoul(argv[++i]));
+			}
+			else if (arg == "--lod") {
+				settings.scene = SceneType::Lod;
+				// Nombre d'objets (optionnel)
+				if (i + 1 < argc && argv[i + 1][0] != '-') { settings.lodSettings.objectCount = static_cast<uint32_t>(std::stoul(argv[++i])); }
+			}
+			// Scne  niveaux de dtail dessine entirement au niveau 0 (comparaison)
+			else if (arg == "--no-lod-selection") { settings.lodSettings.enabled = false; }
+			// Toutes les instances dessines, mme hors du champ de la camra (comparaison)
+			else if (arg == "--no-frustum-culling") { settings.lodSettings.frustumCulling = false; }
+			// Scne  niveaux de dtail claire par des lumires ponctuelles rparties en clusters
+			else if (arg == "--lights") {
+				settings.scene = SceneType::Lod;
+				settings.lighting = true;
+				// Nombre de lumires (optionnel)
+				if (i + 1 < argc && argv[i + 1][0] != '-') {
+					settings.lightingSettings.lightCount = std::max(1u, static_cast<uint32_t>(std::stoul(argv[++i])));
+				}
+			}
+			// Chaque pixel value toutes les lumires (comparaison)
+			else if (arg == "--lights-brute-force") { settings.lightingSettings.bruteForce = true; }
+			// Sans attachement de profondeur (l'ordre de dessin dcide des pixels visibles)
+			else if (arg == "--no-depth") { settings.depth.enabled = false; }
+			// Attachement de profondeur (actif par dfaut) : un avertissement signale s'il doit tre dsactiv
+			else if (arg == "--depth") { settings.depth.requested = true; }
+			// Profondeur classique (1 au plan lointain, test LESS) au lieu de la profondeur inverse
+			else if (arg == "--no-reverse-z") {
+				settings.depth.reverseZ = false;
+				settings.depth.requested = true;
+			}
+			// Pr-passe de profondeur de la scne  niveaux de dtail
+			else if (arg == "--depth-prepass") {
+				settings.depth.prePass = true;
+				settings.depth.requested = true;
+			}
+			// Invocations du fragment shader par frame et par pixel, affiches  la fin
+			else if (arg == "--fragment-stats") { settings.countFragments = true; }
+			// Variante de la pipeline du triangle (compile en arrire-plan, pipeline gnrique en attendant)
+			else if (arg == "--color-mode" && i + 1 < argc) {
+				const auto colorMode = static_cast<uint32_t>(std::stoul(argv[++i]));
+				if (colorMode >= TRIANGLE_COLOR_MODES) {
+					std::cerr << "Invalid color mode: " << colorMode << " (0 to " << TRIANGLE_COLOR_MODES - 1 << ")" << std::endl;
+					return EXIT_FAILURE;
+				}
+				settings.triangleVariant.constants[0] = colorMode;
+			}
+			else if (arg == "--gamma") { settings.triangleVariant.constants[1] = 1; }
+			else if (arg == "--multiview") {
+				settings.multiview = true;
+				// Nombre de vues (optionnel, 2 par dfaut : stro)
+				if (i + 1 < argc && argv[i + 1][0] != '-') {
+					settings.multiviewSettings.viewCount = std::clamp(static_cast<uint32_t>(std::stoul(argv[++i])), 1u, CMultiviewRenderer::MAX_VIEWS);
+				}
+			}
+			// Multi-vues rendu en une passe par vue (rfrence)
+			else if (arg == "--multiview-passes") { settings.multiviewSettings.singlePass = false; }
+			else if (arg == "--post-process") {
+				settings.postProcess = true;
+				// Effets spars par des virgules parmi blur, bloom, tonemap, grade (optionnel)
+				if (i + 1 < argc && argv[i + 1][0] != '-') {
+					const auto effects = "," + std::string{argv[++i]} + ",";
+					auto& postProcess = settings.postProcessSettings;
+					postProcess.blur = effects.find(",blur,") != std::string::npos;
+					postProcess.bloom = effects.find(",bloom,") != std::string::npos;
+					postProcess.tonemap = effects.find(",tonemap,") != std::string::npos;
+					postProcess.colorGrading = effects.find(",grade,") != std::string::npos;
+				}
+			}
+			// Un dispatch par effet au lieu des dispatchs fusionns (comparaison)
+			else if (arg == "--post-process-unfused") { settings.postProcessSettings.fused = false; }
+			// Fichier charg en arrire-plan dans un buffer du GPU (option rptable)
+			else if (arg == "--stream" && i + 1 < argc) { settings.streamFiles.emplace_back(argv[++i]); }
+			else if (arg == "--stream-backend" && i + 1 < argc) {
+				const auto backend = std::string{argv[++i]};
+				if (backend == "io_uring") { settings.streamerSettings.backend = StreamBackend::IoUring; }
+				else if (backend == "threads") { settings.streamerSettings.backend = StreamBackend::ThreadPool; }
+				else { settings.streamerSettings.backend = StreamBackend::Auto; }
+			}
+			else if (arg == "--stream-queue-depth" && i + 1 < argc) {
+				settings.streamerSettings.queueDepth = std::max(1u, static_cast<uint32_t>(std::stoul(argv[++i])));
+			}
+			// Benchmarks GPU : utilisent les autres options (--headless, device...) pour chaque configuration
+			else if (arg == "--bench-particles") { particleBenchmark = true; }
+			else if (arg == "--bench-lod") { lodBenchmark = true; }
+			else if (arg == "--bench-lights") { lightingBenchmark = true; }
+			else if (arg == "--bench-multiview") { multiviewBenchmark = true; }
+			else if (arg == "--bench-post-process") { postProcessBenchmark = true; }
+			else if (arg == "--bench-depth") { depthBenchmark = true; }
+			else if (arg == "--memory-report") { settings.memoryReport = true; }
+			else if (arg == "--no-host-allocator") { settings.customHostAllocator = false; }
+			else if (arg == "--host-allocator-report") { settings.hostAllocatorReport = true; }
+			else if (arg == "--log-level" && i + 1 < argc) {
+				const auto level = std::string{argv[++i]};
+				if (level == "verbose") { settings.logLevel = LogLevel::Verbose; }
+				else if (level == "warning") { settings.logLevel = LogLevel::Warning; }
+				else if (level == "error") { settings.logLevel = LogLevel::Error; }
+				else { settings.logLevel = LogLevel::Info; }
+			}
+			else if (arg == "--dynamic-resolution") {
+				settings.dynamicResolution = true;
+				// Temps GPU vis en millisecondes (optionnel)
+				if (i + 1 < argc && argv[i + 1][0] != '-') { settings.dynamicResolutionSettings.targetFrameMs = std::stof(argv[++i]); }
+			}
+			// Identifiant de message des validation layers (dcimal ou hexadcimal 0x...)
+			else if (arg == "--log-mute" && i + 1 < argc) {
+				settings.mutedMessages.push_back(static_cast<int32_t>(std::stoul(argv[++i], nullptr, 0)));
+			}
+			else {
+				std::cerr << "Unknown option: " << arg << std::endl;
+				printUsage(argv[0]);
+				return EXIT_FAILURE;
+			}
+		}
+	}
+	catch (const std::logic_error&) {
+		std::cerr << "Invalid value: " << argv[i] << std::endl;
+		printUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+	if (particleBenchmark) { return runParticleBenchmark(settings); }
+	if (lodBenchmark) { return runLodBenchmark(settings); }
+	if (lightingBenchmark) { return runLightingBenchmark(settings); }
+	if (multiviewBenchmark) { return runMultiviewBenchmark(settings); }
+	if (postProcessBenchmark) { return runPostProcessBenchmark(settings); }
+	if (depthBenchmark) { return runDepthBenchmark(settings); }
+	auto app = CVulkanApplication{settings};
 	try {
 		app.run();
 	}
 	catch (std::exception const& e) {
+		// Les messages en attente (validation layers) prcdent l'erreur
+		CLogger::flush();
 		std::cerr << e.what() << std::endl;
 		return EXIT_FAILURE;
 	}
@@ -0,0 +1,268 @@
+/*
+ * Suite de rgression image + performance.
+ * Lance le rendu sans fentre (de prfrence sur lavapipe, le driver Vulkan logiciel de Mesa),
+ * compare la dernire frame (capture sans perte)  une image de rfrence avec une tolrance, puis compare
+ * les temps de dmarrage et de frame aux valeurs de rfrence enregistres.
+ *
+ * Usage : RegressionRunner [--golden <dossier>] [--baseline <fichier>] [--tolerance <0-255>]
+ *                          [--max-bad-pixels <fraction>] [--threshold <fraction>] [--device <nom>] [--case <nom>] [--update]
+ * --update rcrit les images et mesures de rfrence au lieu de comparer ; --case limite l'excution  un scnario.
+ * Les images de rfrence (tools/golden) sont produites par --update sur le device de rfrence : un scnario
+ * sans image de rfrence choue.
+ * Cration ou mise  jour des rfrences, depuis la racine du dpt (shaders compils, Mesa avec lavapipe) :
+ *   VK_ICD_FILENAMES=/usr/share/vulkan/icd.d/lvp_icd.x86_64.json RegressionRunner --update
+ * puis ajouter les images .ppm et baseline.txt de tools/golden au dpt. Les mesures de baseline.txt ne valent
+ * que pour la machine qui les a produites : les rgnrer avec --update sur la machine d'intgration.
+ */
+#include <VulkanApplication.h>
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+	struct RegressionOptions {
+		std::string goldenDirectory{"tools/golden"};
+		std::string baselineFile{"tools/golden/baseline.txt"};
+		std::string outputDirectory{"regression_output"};
+		std::string device{"llvmpipe"};
+		// Seul scnario excut (vide : tous)
+		std::string caseName;
+		// cart maximal tolr par canal
+		int tolerance{2};
+		// Proportion de pixels pouvant dpasser la tolrance
+		double maxBadPixels{0.001};
+		// Rgression de performance tolre (0.25 = 25% plus lent que la rfrence)
+		double threshold{0.25};
+		bool update{false};
+	};
+
+	/*
+	 * Scnario de test : options de rendu + nombre de frames
+	 */
+	struct RegressionCase {
+		std::string name;
+		ApplicationSettings settings;
+	};
+
+	struct Image {
+		uint32_t width{0};
+		uint32_t height{0};
+		std::vector<uint8_t> rgb;
+	};
+
+	bool readPPM(const std::string& path, Image& image) {
+		auto file = std::ifstream{ path, std::ios::binary };
+		if (!file.is_open()) { return false; }
+		std::string magic;
+		int maxValue;
+		file >> magic >> image.width >> image.height >> maxValue;
+		file.get();
+		if (magic != "P6" || maxValue != 255) { return false; }
+		image.rgb.resize(static_cast<size_t>(image.width) * image.height * 3);
+		file.read(reinterpret_cast<char*>(image.rgb.data()), static_cast<std::streamsize>(image.rgb.size()));
+		return static_cast<bool>(file);
+	}
+
+	std::map<std::string, double> readBaseline(const std::string& path) {
+		std::map<std::string, double> values;
+		auto file = std::ifstream{path};
+		std::string key;
+		double value;
+		while (file >> key >> value) { values[key] = value; }
+		return values;
+	}
+
+	void writeBaseline(const std::string& path, const std::map<std::string, double>& values) {
+		auto file = std::ofstream{path};
+		for (const auto& [key, value] : values) { file << key << " " << value << "\n"; }
+	}
+
+	/*
+	 * Compare deux images, retourne un message d'erreur vide si elles sont quivalentes
+	 */
+	std::string compareImages(const Image& golden, const Image& actual, const RegressionOptions& options) {
+		if (golden.width != actual.width || golden.height != actual.height) {
+			std::ostringstream message;
+			message << "size mismatch " << actual.width << "x" << actual.height << " vs golden "
+					<< golden.width << "x" << golden.height;
+			return message.str();
+		}
+		size_t badPixels = 0;
+		int maxDifference = 0;
+		const auto pixelCount = static_cast<size_t>(golden.width) * golden.height;
+		for (size_t i = 0; i < pixelCount; i++) {
+			auto pixelDifference = 0;
+			for (size_t c = 0; c < 3; c++) {
+				pixelDifference = std::max(pixelDifference, std::abs(golden.rgb[i * 3 + c] - actual.rgb[i * 3 + c]));
+			}
+			maxDifference = std::max(maxDifference, pixelDifference);
+			if (pixelDifference > options.tolerance) { badPixels++; }
+		}
+		if (static_cast<double>(badPixels) > options.maxBadPixels * static_cast<double>(pixelCount)) {
+			std::ostringstream message;
+			message << badPixels << " pixels differ by more than " << options.tolerance << " (max difference "
+					<< maxDifference << ")";
+			return message.str();
+		}
+		return {};
+	}
+
+	/*
+	 * Vrifie qu'une mesure ne dpasse pas sa rfrence de plus du seuil
+	 */
+	bool checkMetric(const std::string& key, double value, const std::map<std::string, double>& baseline,
+	                 const RegressionOptions& options) {
+		const auto it = baseline.find(key);
+		if (it == baseline.end()) {
+			std::cout << "  " << key << ": " << value << " ms (no baseline)" << std::endl;
+			return true;
+		}
+		const auto limit = it->second * (1.0 + options.threshold);
+		const auto ok = value <= limit;
+		std::cout << "  " << key << ": " << value << " ms (baseline " << it->second << " ms, limit " << limit
+				<< " ms) " << (ok ? "OK" : "REGRESSION") << std::endl;
+		return ok;
+	}
+
+	std::vector<RegressionCase> makeCases(const RegressionOptions& options) {
+		auto base = ApplicationSettings{};
+		base.headless = true;
+		base.captureFrames = true;
+		base.captureFormat = CaptureFormat::PPM;
+		// Toujours la mme frame compare : aucune capture ignore quand l'criture prend du retard
+		base.captureLossless = true;
+		base.deviceFilter = options.device;
+		base.maxFrames = 60;
+		// Animations cales sur le numro de frame : la dernire image ne dpend pas de la vitesse du device
+		base.fixedFrameTime = 1.0 / 60.0;
+		std::vector<RegressionCase> cases;
+		cases.push_back({ "triangle", base });
+		// Un scnario par scne et par fonctionnalit de rendu
+		auto particles = base;
+		particles.scene = SceneType::Particles;
+		particles.particleSettings.count = 16384;
+		cases.push_back({ "particles", particles });
+		auto lod = base;
+		lod.scene = SceneType::Lod;
+		lod.lodSettings.objectCount = 256;
+		cases.push_back({ "lod", lod });
+		auto depthPrePass = lod;
+		depthPrePass.depth.prePass = true;
+		cases.push_back({ "lod_depth_prepass", depthPrePass });
+		auto noDepth = lod;
+		noDepth.depth.enabled = false;
+		cases.push_back({ "lod_no_depth", noDepth });
+		auto lighting = lod;
+		lighting.lighting = true;
+		lighting.lightingSettings.lightCount = 64;
+		cases.push_back({ "lighting", lighting });
+		auto multiview = base;
+		multiview.multiview = true;
+		cases.push_back({ "multiview", multiview });
+		auto multiviewPasses = multiview;
+		multiviewPasses.multiviewSettings.singlePass = false;
+		cases.push_back({ "multiview_passes", multiviewPasses });
+		auto postProcess = base;
+		postProcess.postProcess = true;
+		cases.push_back({ "post_process", postProcess });
+		if (options.caseName.empty()) { return cases; }
+		cases.erase(std::remove_if(cases.begin(), cases.end(), [&](const RegressionCase& regressionCase) {
+			return regressionCase.name != options.caseName;
+		}), cases.end());
+		return cases;
+	}
+}
+
+int main(int argc, char** argv) {
+	auto options = RegressionOptions{};
+	for (int i = 1; i < argc; i++) {
+		const auto arg = std::string{argv[i]};
+		const auto hasValue = i + 1 < argc;
+		if (arg == "--update") { options.update = true; }
+		else if (arg == "--golden" && hasValue) { options.goldenDirectory = argv[++i]; }
+		else if (arg == "--baseline" && hasValue) { options.baselineFile = argv[++i]; }
+		else if (arg == "--output" && hasValue) { options.outputDirectory = argv[++i]; }
+		else if (arg == "--device" && hasValue) { options.device = argv[++i]; }
+		else if (arg == "--case" && hasValue) { options.caseName = argv[++i]; }
+		else if (arg == "--tolerance" && hasValue) { options.tolerance = std::atoi(argv[++i]); }
+		else if (arg == "--max-bad-pixels" && hasValue) { options.maxBadPixels = std::atof(argv[++i]); }
+		else if (arg == "--threshold" && hasValue) { options.threshold = std::atof(argv[++i]); }
+		else {
+			std::cerr << "Unknown option: " << arg << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+	auto baseline = readBaseline(options.baselineFile);
+	auto failures{0};
+	for (auto& regressionCase : makeCases(options)) {
+		std::cout << "[Regression] " << regressionCase.name << std::endl;
+		const auto captureDirectory = std::filesystem::path{options.outputDirectory} / regressionCase.name;
+		std::filesystem::remove_all(captureDirectory);
+		regressionCase.settings.captureDirectory = captureDirectory.string();
+		FrameStatistics stats;
+		try {
+			auto app = CVulkanApplication{regressionCase.settings};
+			app.run();
+			stats = app.statistics();
+		}
+		catch (const std::exception& e) {
+			std::cout << "  FAILED: " << e.what() << std::endl;
+			failures++;
+			continue;
+		}
+		const auto goldenPath = (std::filesystem::path{options.goldenDirectory} / (regressionCase.name + ".ppm")).string();
+		// Dernire frame du scnario : son absence est une erreur (jamais remplace par une frame antrieure)
+		const auto framePath = CFrameCapture::framePath(captureDirectory.string(), CaptureFormat::PPM,
+		                                                regressionCase.settings.maxFrames - 1);
+		const auto frameCaptured = std::filesystem::exists(framePath);
+		const auto startupKey = regressionCase.name + ".startupMs";
+		const auto frameKey = regressionCase.name + ".frameMs";
+		if (options.update) {
+			if (!frameCaptured) {
+				std::cout << "  FAILED: " << framePath << " was not captured" << std::endl;
+				failures++;
+				continue;
+			}
+			std::filesystem::create_directories(options.goldenDirectory);
+			std::filesystem::copy_file(framePath, goldenPath, std::filesystem::copy_options::overwrite_existing);
+			baseline[startupKey] = stats.startupMs;
+			baseline[frameKey] = stats.medianFrameMs;
+			std::cout << "  golden and baseline updated" << std::endl;
+			continue;
+		}
+		Image golden, actual;
+		if (!readPPM(goldenPath, golden)) {
+			std::cout << "  FAILED: missing golden image " << goldenPath << " (run with --update)" << std::endl;
+			failures++;
+			continue;
+		}
+		if (!frameCaptured || !readPPM(framePath, actual)) {
+			std::cout << "  FAILED: " << framePath << " was not captured" << std::endl;
+			failures++;
+			continue;
+		}
+		const auto imageError = compareImages(golden, actual, options);
+		if (!imageError.empty()) {
+			std::cout << "  FAILED image: " << imageError << std::endl;
+			failures++;
+		}
+		else { std::cout << "  image: OK" << std::endl; }
+		// Mdiane plutt que moyenne : moins sensible aux frames perturbes par le systme
+		if (!checkMetric(startupKey, stats.startupMs, baseline, options)) { failures++; }
+		if (!checkMetric(frameKey, stats.medianFrameMs, baseline, options)) { failures++; }
+	}
+	if (options.update) {
+		std::filesystem::create_directories(std::filesystem::path{options.baselineFile}.parent_path());
+		writeBaseline(options.baselineFile, baseline);
+		return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+	std::cout << "[Regression] " << (failures == 0 ? "all cases passed" : std::to_string(failures) + " failure(s)")
+			<< std::endl;
+	return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
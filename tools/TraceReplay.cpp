@@ -0,0 +1,56 @@
+/*
+ * Rejeu d'une trace du flux de commandes (crite par l'application avec --trace <fichier>).
+ * Le rejeu est fait sans fentre, aussi vite que possible ou  la cadence de la capture (--paced) : une mme
+ * trace rejoue sur deux drivers, ou avant et aprs une modification, compare des charges de travail identiques.
+ *
+ * Usage : TraceReplay <trace> [--paced] [--device <nom>] [--runs <n>]
+ */
+#include <VulkanApplication.h>
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+int main(int argc, char** argv) {
+	if (argc < 2 || argv[1][0] == '-') {
+		std::cerr << "Usage: TraceReplay <trace> [--paced] [--device <name>] [--runs <n>]" << std::endl;
+		return EXIT_FAILURE;
+	}
+	auto settings = ApplicationSettings{};
+	settings.headless = true;
+	settings.replayTrace = argv[1];
+	auto runs = 1;
+	for (int i = 2; i < argc; i++) {
+		const auto arg = std::string{argv[i]};
+		const auto hasValue = i + 1 < argc;
+		if (arg == "--paced") { settings.replayPaced = true; }
+		else if (arg == "--device" && hasValue) { settings.deviceFilter = argv[++i]; }
+		else if (arg == "--runs" && hasValue) { runs = std::max(1, std::atoi(argv[++i])); }
+		else {
+			std::cerr << "Unknown option: " << arg << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+	// Plusieurs excutions : la premire paie la compilation des pipelines par le driver
+	for (auto run = 0; run < runs; run++) {
+		auto app = CVulkanApplication{settings};
+		try {
+			app.run();
+		}
+		catch (const std::exception& e) {
+			CLogger::flush();
+			std::cerr << "[Replay] " << e.what() << std::endl;
+			return EXIT_FAILURE;
+		}
+		const auto& replay = app.traceReplayStats();
+		const auto stats = app.statistics();
+		std::cout << "[Replay] run " << run + 1 << ": " << replay.frames << " frames, " << replay.submits << " submits, "
+				<< replay.draws << " draws recorded";
+		if (replay.skippedCommandBuffers > 0) { std::cout << ", " << replay.skippedCommandBuffers << " untraced command buffers skipped"; }
+		std::cout << std::endl << std::fixed << std::setprecision(3) << "  " << replay.totalMs << " ms (captured "
+				<< replay.capturedMs << " ms) | " << stats.averageFrameMs << " ms/frame (median " << stats.medianFrameMs
+				<< ")" << std::endl;
+	}
+	return EXIT_SUCCESS;
+}